@@ -0,0 +1,99 @@
+/*  ***************************************************************************
+*   bitops.h - Header for the bit counting operations shared by the ALFA
+*   dataset libraries (with the compiler intrinsics when available).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_BITOPS_H
+#define ALFA_BITOPS_H
+
+#include <cstdint>
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace alfa
+{
+
+// This class counts the bits of the 64-bit words (e.g., of the bit masks and the encoded numbers)
+class BitOps
+{
+public:
+    // Member Functions
+    static int PopCount(uint64_t value);
+    static int CountLeadingZeros(uint64_t value);
+    static int CountTrailingZeros(uint64_t value);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Count the set bits of a value
+int BitOps::PopCount(uint64_t value)
+{
+#if defined __GNUC__ || defined __clang__
+    return __builtin_popcountll(value);
+#else
+    // Count the bits of each 2, 4 and 8 bits in parallel, then add the bytes
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((value * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Count the leading zero bits of a non-zero value
+int BitOps::CountLeadingZeros(uint64_t value)
+{
+#if defined __GNUC__ || defined __clang__
+    return __builtin_clzll(value);
+#elif defined _MSC_VER && (defined _M_X64 || defined _M_ARM64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (int)index;
+#else
+    int count = 0;
+    while ((value & ((uint64_t)1 << 63)) == 0) { value <<= 1; ++count; }
+    return count;
+#endif
+}
+
+// Count the trailing zero bits of a non-zero value (the index of the lowest set bit)
+int BitOps::CountTrailingZeros(uint64_t value)
+{
+#if defined __GNUC__ || defined __clang__
+    return __builtin_ctzll(value);
+#elif defined _MSC_VER && (defined _M_X64 || defined _M_ARM64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (int)index;
+#else
+    int count = 0;
+    while ((value & 1) == 0) { value >>= 1; ++count; }
+    return count;
+#endif
+}
+
+}
+#endif
@@ -0,0 +1,380 @@
+/*  ***************************************************************************
+*   bus.h - Header for broadcasting ALFA messages to multiple subscribers
+*   (e.g., fault detectors) in the same process.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_BUS_H
+#define ALFA_BUS_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "commons.h"
+#include "message.h"
+#include "sequence.h"
+#include "ringbuffer.h"
+
+namespace alfa
+{
+
+// This class broadcasts the messages of a sequence to the registered subscribers, so a single pass
+// over the data feeds all of them. The messages can come from the sequence itself (PublishSequence)
+// or from a live source that calls Publish from any number of threads. Each subscriber runs in its
+// own thread and receives pointers to the shared messages through its own lock-free ring buffer.
+// PublishSequence reads the topics through Sequence::GetTopic, so a sequence in a memory budget loads
+// its unloaded topics again; its messages are copied, since the budget may unload them at any time.
+class TopicBus
+{
+public:
+
+    // Local enum definitions
+    enum BackPressurePolicy             // What to do when the buffer of a subscriber is full
+    {
+        Block,                          // Wait until the subscriber makes room (nothing is lost)
+        DropOldest                      // Discard the oldest queued message (the publisher never waits)
+    };
+
+    // Local struct definitions
+    struct BusMessage                   // Structure for a published message
+    {
+        int TopicIdx = -1;              // Index of the topic in the sequence
+        const Message *Msg = NULL;      // The message (owned by the sequence, the live source or MessageCopy)
+        std::shared_ptr<const Message> MessageCopy; // Copy of the message if the sequence has a topic tracker
+        long long Time = 0;             // Recorded time of the message (nanoseconds, see DateTime::ToNanoseconds)
+    };
+
+    struct SubscriberStats              // Structure for the statistics of a subscriber
+    {
+        size_t Published = 0;           // Number of messages queued for the subscriber
+        size_t Delivered = 0;           // Number of messages processed by the subscriber
+        size_t Dropped = 0;             // Number of messages discarded by the drop-oldest policy
+        size_t Lag = 0;                 // Number of messages waiting in the buffer
+        size_t MaxLag = 0;              // Largest number of messages waiting in the buffer so far
+        double BlockedTime = 0;         // Total time the publishers waited for the subscriber (seconds)
+    };
+
+    typedef std::function<void(const BusMessage &)> SubscriberCallback;
+
+    // Constructors & Deconstructors
+    TopicBus(const Sequence &sequence);
+    ~TopicBus();
+
+    // Member Functions
+    int Subscribe(const std::string &topic_name, const SubscriberCallback &callback, BackPressurePolicy policy = Block, size_t buffer_size = 4096);
+    int Subscribe(const VecString &topic_names, const SubscriberCallback &callback, BackPressurePolicy policy = Block, size_t buffer_size = 4096);
+    bool Start();
+    bool Publish(int topic_idx, const Message &msg);
+    size_t PublishSequence(size_t start_idx = 0);
+    void Close();
+    bool IsRunning() const;
+    SubscriberStats GetSubscriberStats(int subscriber_idx) const;
+    int GetNumberOfSubscribers() const;
+
+private:
+    // Local struct definitions
+    struct Subscriber                   // Structure for a registered subscriber
+    {
+        SubscriberCallback Callback;
+        BackPressurePolicy Policy;
+        std::unique_ptr<MPMCRingBuffer<BusMessage> > Buffer;
+        std::thread Thread;
+        std::atomic<size_t> Published, Delivered, Dropped, MaxLag;
+        std::atomic<long long> BlockedTime;
+    };
+
+    // Member Functions
+    bool PublishMessage(int topic_idx, const Message &msg, const std::shared_ptr<const Message> &message_copy);
+    void Deliver(Subscriber &subscriber, const BusMessage &bus_msg);
+    void RunSubscriber(Subscriber &subscriber);
+
+    // The bus cannot be copied while the threads are running
+    TopicBus(const TopicBus &);
+    TopicBus &operator=(const TopicBus &);
+
+    // Data Members
+    const Sequence &sequence;
+    std::vector<std::unique_ptr<Subscriber> > subscribers;
+    std::vector<std::vector<int> > topic_subscribers;      // Subscribers of each topic
+    std::atomic<bool> is_running, is_closed;
+    std::atomic<int> n_publishers;      // Threads inside Publish (Close waits for them before the subscribers stop)
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for TopicBus. The sequence should stay valid while the bus is running.
+TopicBus::TopicBus(const Sequence &sequence)
+    : sequence(sequence), topic_subscribers(sequence.Topics.size()), is_running(false), is_closed(false), n_publishers(0)
+{
+}
+
+// Destructor function for TopicBus. Lets the subscribers finish their queued messages.
+TopicBus::~TopicBus()
+{
+    Close();
+}
+
+// Register a subscriber for the messages of a topic. Returns the index of the subscriber or -1 on error.
+int TopicBus::Subscribe(const std::string &topic_name, const SubscriberCallback &callback, BackPressurePolicy policy, size_t buffer_size)
+{
+    return Subscribe(VecString(1, topic_name), callback, policy, buffer_size);
+}
+
+// Register a subscriber for the messages of the given topics. Returns the index of the subscriber or -1 on error.
+int TopicBus::Subscribe(const VecString &topic_names, const SubscriberCallback &callback, BackPressurePolicy policy, size_t buffer_size)
+{
+    if (IsRunning())
+    {
+        std::cerr << "Subscribe Error! Cannot add subscribers while the bus is running." << std::endl;
+        return -1;
+    }
+
+    // Find the topics before registering anything
+    std::vector<int> topic_indices;
+    for (int i = 0; i < (int)topic_names.size(); ++i)
+    {
+        int topic_idx = sequence.FindTopicIndex(topic_names[i]);
+        if (topic_idx < 0)
+        {
+            std::cerr << "Subscribe Error! Topic '" << topic_names[i] << "' not found in the sequence." << std::endl;
+            return -1;
+        }
+        topic_indices.push_back(topic_idx);
+    }
+
+    std::unique_ptr<Subscriber> subscriber(new Subscriber());
+    subscriber->Callback = callback;
+    subscriber->Policy = policy;
+    subscriber->Buffer.reset(new MPMCRingBuffer<BusMessage>(buffer_size));
+    subscriber->Published = 0; subscriber->Delivered = 0; subscriber->Dropped = 0; subscriber->MaxLag = 0;
+    subscriber->BlockedTime = 0;
+    subscribers.push_back(std::move(subscriber));
+
+    // Route the topics to the new subscriber
+    int subscriber_idx = (int)subscribers.size() - 1;
+    topic_subscribers.resize(std::max(topic_subscribers.size(), sequence.Topics.size()));
+    for (int i = 0; i < (int)topic_indices.size(); ++i)
+        if (std::find(topic_subscribers[topic_indices[i]].begin(), topic_subscribers[topic_indices[i]].end(), subscriber_idx) ==
+                topic_subscribers[topic_indices[i]].end())
+            topic_subscribers[topic_indices[i]].push_back(subscriber_idx);
+
+    return subscriber_idx;
+}
+
+// Start the subscriber threads. Returns false if the bus is already running.
+bool TopicBus::Start()
+{
+    if (IsRunning())
+    {
+        std::cerr << "Start Error! The bus is already running." << std::endl;
+        return false;
+    }
+
+    // Wait for the previous run to finish
+    Close();
+
+    is_closed = false;
+    is_running = true;
+    for (int i = 0; i < (int)subscribers.size(); ++i)
+        subscribers[i]->Thread = std::thread(&TopicBus::RunSubscriber, this, std::ref(*subscribers[i]));
+
+    return true;
+}
+
+// Publish a message of a topic to its subscribers. Can be called from multiple threads.
+// The message should stay valid until the subscribers have processed it.
+bool TopicBus::Publish(int topic_idx, const Message &msg)
+{
+    return PublishMessage(topic_idx, msg, std::shared_ptr<const Message>());
+}
+
+// Publish the messages of the sequence in their recording order, starting from the given index
+// in the message list. Returns the index after the last published message, so the publishing can
+// continue from there after refreshing a sequence in follow mode.
+size_t TopicBus::PublishSequence(size_t start_idx)
+{
+    const std::vector<Sequence::MessageIndex> &index_list = sequence.MessageIndexList;
+    bool has_tracker = sequence.GetTopicTracker() != NULL;
+    size_t i = start_idx;
+    for (; i < index_list.size() && IsRunning(); ++i)
+    {
+        // Skip the message if its topic could not be loaded again
+        const Topic &topic = sequence.GetTopic(index_list[i].TopicIdx);
+        if (index_list[i].MessageIdx >= (int)topic.Messages.size()) continue;
+
+        const Message &msg = topic.Messages[index_list[i].MessageIdx];
+        std::shared_ptr<const Message> message_copy;
+        if (has_tracker) message_copy = std::make_shared<const Message>(msg);
+        PublishMessage(index_list[i].TopicIdx, has_tracker ? *message_copy : msg, message_copy);
+    }
+    return i;
+}
+
+// Stop accepting messages and wait until the subscribers process the queued ones.
+// The messages that are being published when it is called are delivered first.
+void TopicBus::Close()
+{
+    is_running = false;
+    while (n_publishers > 0)
+        std::this_thread::yield();
+    is_closed = true;
+    for (int i = 0; i < (int)subscribers.size(); ++i)
+        if (subscribers[i]->Thread.joinable()) subscribers[i]->Thread.join();
+}
+
+// Returns true if the bus is accepting messages
+bool TopicBus::IsRunning() const
+{
+    return is_running;
+}
+
+// Get the statistics of a subscriber. Can be called while the bus is running.
+TopicBus::SubscriberStats TopicBus::GetSubscriberStats(int subscriber_idx) const
+{
+    SubscriberStats stats;
+    if (subscriber_idx < 0 || subscriber_idx >= (int)subscribers.size()) return stats;
+
+    const Subscriber &subscriber = *subscribers[subscriber_idx];
+    stats.Published = subscriber.Published;
+    stats.Delivered = subscriber.Delivered;
+    stats.Dropped = subscriber.Dropped;
+    stats.Lag = subscriber.Buffer->Size();
+    stats.MaxLag = subscriber.MaxLag;
+    stats.BlockedTime = subscriber.BlockedTime / 1e9;
+    return stats;
+}
+
+// Get the number of registered subscribers
+int TopicBus::GetNumberOfSubscribers() const
+{
+    return (int)subscribers.size();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Publish a message to the subscribers of its topic. The copy of the message (if any) is shared by
+// the subscribers and freed after the last one has processed it.
+bool TopicBus::PublishMessage(int topic_idx, const Message &msg, const std::shared_ptr<const Message> &message_copy)
+{
+    if (topic_idx < 0 || topic_idx >= (int)topic_subscribers.size()) return false;
+
+    // Count the publisher before checking the bus, so Close either waits for it or it sees the bus closed
+    ++n_publishers;
+    if (!IsRunning())
+    {
+        --n_publishers;
+        std::cerr << "Publish Error! The bus is not running." << std::endl;
+        return false;
+    }
+
+    // Prepare the message once for all the subscribers
+    const std::vector<int> &targets = topic_subscribers[topic_idx];
+    BusMessage bus_msg;
+    bus_msg.TopicIdx = topic_idx;
+    bus_msg.Msg = &msg;
+    bus_msg.MessageCopy = message_copy;
+    bus_msg.Time = msg.DateTime.ToNanoseconds();
+
+    for (int i = 0; i < (int)targets.size(); ++i)
+        Deliver(*subscribers[targets[i]], bus_msg);
+
+    --n_publishers;
+    return true;
+}
+
+// Put a message in the buffer of a subscriber, applying its back-pressure policy when the buffer is full
+void TopicBus::Deliver(Subscriber &subscriber, const BusMessage &bus_msg)
+{
+    if (!subscriber.Buffer->TryPush(bus_msg))
+    {
+        if (subscriber.Policy == DropOldest)
+        {
+            // Make room by discarding the oldest messages (the subscriber may take some in the meantime)
+            BusMessage oldest;
+            do
+            {
+                if (subscriber.Buffer->TryPop(oldest))
+                    subscriber.Dropped.fetch_add(1, std::memory_order_relaxed);
+            } while (!subscriber.Buffer->TryPush(bus_msg));
+        }
+        else
+        {
+            // Wait for the subscriber to make room
+            std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+            int wait_count = 0;
+            while (!subscriber.Buffer->TryPush(bus_msg))
+            {
+                if (++wait_count < 100)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            subscriber.BlockedTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - wait_start).count(), std::memory_order_relaxed);
+        }
+    }
+    subscriber.Published.fetch_add(1, std::memory_order_relaxed);
+
+    // Keep track of the largest lag of the subscriber
+    size_t lag = subscriber.Buffer->Size();
+    size_t max_lag = subscriber.MaxLag.load(std::memory_order_relaxed);
+    while (lag > max_lag && !subscriber.MaxLag.compare_exchange_weak(max_lag, lag, std::memory_order_relaxed)) {}
+}
+
+// Receive the messages from the buffer of a subscriber and pass them to its callback
+void TopicBus::RunSubscriber(Subscriber &subscriber)
+{
+    BusMessage bus_msg;
+    int idle_count = 0;
+    while (true)
+    {
+        if (subscriber.Buffer->TryPop(bus_msg))
+        {
+            subscriber.Callback(bus_msg);
+            subscriber.Delivered.fetch_add(1, std::memory_order_relaxed);
+            idle_count = 0;
+            continue;
+        }
+
+        // Finish when the bus is closed and the buffer is empty
+        if (is_closed && subscriber.Buffer->IsEmpty()) break;
+
+        // Spin for a while before sleeping to keep the latency low
+        if (++idle_count < 100)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+}
+#endif
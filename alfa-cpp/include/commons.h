@@ -33,6 +33,8 @@
 #include <ctime>
 #include <cstdlib>
 #include <algorithm>
+#include "numparse.h"
+#include "bitops.h"
 
 // Define different headers for Windows and Unix-based systems
 #if defined _WIN32 || defined __CYGWIN__
@@ -70,6 +72,7 @@ namespace alfa
 		static VecString GetFileList(const std::string &dir_path);
 		static VecString FilterFileList(const VecString &file_list, const std::string &extension, const bool remove_extension = false);
 		static bool ExtractFilenameAndExtension(const std::string &file_path, std::string &out_filename, std::string &out_extension, std::string &out_directory);
+		static bool MatchPattern(const std::string &pattern, const std::string &text);
 	};
 
 	/******************************************************************************/
@@ -140,6 +143,10 @@ namespace alfa
 	// Convert a string to a long long integer. Returns false if the string is not exactly a long long integer.
 	bool Commons::StringToLongLong(const std::string &str, long long &out_number)
 	{
+		// Parse the plain integers directly, and let strtoll handle the rest (spaces, overflow, etc.)
+		if (NumberParser::ParseInt64(str.data(), str.data() + str.size(), out_number))
+			return true;
+
 		char *endptr;
 		long long value = std::strtoll(str.c_str(), &endptr, 10);
 
@@ -154,7 +161,11 @@ namespace alfa
 	// Convert a string to a double. Returns false if the string is not exactly a double.
 	bool Commons::StringToDouble(const std::string &str, double &out_number)
 	{
-		// Convert to long double first
+		// Parse the numbers directly to a double (correctly rounded)
+		if (NumberParser::ParseDouble(str.data(), str.data() + str.size(), out_number))
+			return true;
+
+		// Otherwise, convert to long double first
 		long double temp;
 		if (!StringToLongDouble(str, temp)) return false;
 
@@ -213,6 +224,23 @@ namespace alfa
 		return file_list;
 	}
 
+	// Check if a text matches a glob pattern, where '*' matches any characters and '?' matches one character
+	bool Commons::MatchPattern(const std::string &pattern, const std::string &text)
+	{
+		size_t p = 0, t = 0, star = std::string::npos, star_text = 0;
+		while (t < text.size())
+		{
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) { ++p; ++t; }
+			else if (p < pattern.size() && pattern[p] == '*') { star = p++; star_text = t; }
+			else if (star != std::string::npos) { p = star + 1; t = ++star_text; }
+			else return false;
+		}
+
+		// The rest of the pattern can only be stars
+		while (p < pattern.size() && pattern[p] == '*') ++p;
+		return p == pattern.size();
+	}
+
 	// Return the filename, directory and the extension from the file path
 	bool Commons::ExtractFilenameAndExtension(const std::string &file_path, std::string &out_filename,
 		std::string &out_extension, std::string &out_directory)
@@ -299,8 +327,16 @@ namespace alfa
 		bool operator!= (const DateTime &dt) const;
 		static DateTime StringToTime(const std::string &strdatetime, const std::string &format);
 		static DateTime EpochStringToTime(const std::string &epoch);
+		static DateTime EpochToTime(long long seconds, int nanoseconds);
+		static DateTime NanosecondsToTime(long long nanoseconds);
+		long long ToNanoseconds() const;
+		long long ToEpochNanoseconds() const;
 		std::string ToString() const;
 		double operator-(const DateTime &dt) const;
+
+	private:
+		// Member Functions
+		static bool EpochToLocalTime(long long seconds, std::tm &out_tm);
 	};
 
 	// Overload the << operator for DateTime
@@ -398,7 +434,11 @@ namespace alfa
 	// Convert a given UNIX epoch string in nanoseconds to a DateTime object
 	DateTime DateTime::EpochStringToTime(const std::string &epoch)
 	{
-		DateTime dt;
+		// Parse the usual timestamps (only digits) directly
+		long long secs;
+		int nanos;
+		if (NumberParser::ParseEpochNanoseconds(epoch.data(), epoch.data() + epoch.size(), secs, nanos))
+			return EpochToTime(secs, nanos);
 
 		// Get the nanoseconds substring (last 9 digits)
 		std::string nano_str;
@@ -411,32 +451,141 @@ namespace alfa
 		std::string sec_str = epoch.substr(0, epoch.size() - nano_str.size());
 
 		// Read the nanoseconds
-		if (!Commons::StringToInt(nano_str, dt.Nanosecond))
+		if (!Commons::StringToInt(nano_str, nanos))
 			return DateTime();
 
 		// Get the epoch seconds
-		long long secs;
 		if (!Commons::StringToLongLong(sec_str, secs))
 			return DateTime();
 
-		// Convert the seconds to time_t structure
-		std::time_t time = secs;
+		return EpochToTime(secs, nanos);
+	}
 
-		// Convert time_t structure to DateTime
-		std::tm *temp_tm;
+	// Convert the UNIX epoch seconds and nanoseconds to a DateTime object in the local time.
+	// The local start of the hour is cached, since most consecutive calls fall in the same hour.
+	DateTime DateTime::EpochToTime(long long seconds, int nanoseconds)
+	{
+		static thread_local long long cached_start = 1, cached_end = 0;
+		static thread_local DateTime cached_hour;
 
-		//Set local dst fields of struct tm ?
-		std::time_t tvsec = std::time(NULL);
-		temp_tm = localtime(&tvsec);
+		DateTime dt;
+		if (seconds >= cached_start && seconds < cached_end)
+		{
+			dt = cached_hour;
+			dt.Minute = (int)((seconds - cached_start) / 60);
+			dt.Second = (int)((seconds - cached_start) % 60);
+			dt.Nanosecond = nanoseconds;
+			return dt;
+		}
+
+		// Convert the seconds to DateTime (with the reentrant version, so the files can be parsed in parallel)
+		std::tm temp_tm;
+		if (!EpochToLocalTime(seconds, temp_tm))
+			return DateTime();
+		dt.Year = 1900 + temp_tm.tm_year;
+		dt.Month = temp_tm.tm_mon + 1;
+		dt.Day = temp_tm.tm_mday;
+		dt.Hour = temp_tm.tm_hour;
+		dt.Minute = temp_tm.tm_min;
+		dt.Second = temp_tm.tm_sec;
+		dt.Nanosecond = nanoseconds;
+
+		// Cache the hour if its first and last seconds are in the same hour (no time zone change in between)
+		long long start = seconds - temp_tm.tm_min * 60 - temp_tm.tm_sec;
+		std::tm start_tm, end_tm;
+		if (EpochToLocalTime(start, start_tm) && EpochToLocalTime(start + 3599, end_tm) &&
+			start_tm.tm_hour == temp_tm.tm_hour && start_tm.tm_mday == temp_tm.tm_mday && start_tm.tm_min == 0 && start_tm.tm_sec == 0 &&
+			end_tm.tm_hour == temp_tm.tm_hour && end_tm.tm_mday == temp_tm.tm_mday && end_tm.tm_min == 59 && end_tm.tm_sec == 59)
+		{
+			cached_start = start;
+			cached_end = start + 3600;
+			cached_hour = dt;
+		}
+
+		return dt;
+	}
+
+	// Convert the UNIX epoch seconds to the local calendar time. Returns false if the conversion fails.
+	bool DateTime::EpochToLocalTime(long long seconds, std::tm &out_tm)
+	{
+		std::time_t time = (std::time_t)seconds;
+#if defined _WIN32
+		return localtime_s(&out_tm, &time) == 0;
+#else
+		return localtime_r(&time, &out_tm) != nullptr;
+#endif
+	}
+
+	// Convert the calendar fields to nanoseconds since 1970/01/01 00:00:00 of the same calendar.
+	// No time zone conversion is done, so the result keeps the exact order of the DateTime objects
+	// and can be converted back with NanosecondsToTime. Uses the civil-from-days algorithm.
+	long long DateTime::ToNanoseconds() const
+	{
+		// Count the days since the epoch, starting the year from March to handle the leap days
+		int y = Year - (Month <= 2 ? 1 : 0);
+		int era = (y >= 0 ? y : y - 399) / 400;
+		int yoe = y - era * 400;
+		int doy = (153 * (Month + (Month > 2 ? -3 : 9)) + 2) / 5 + Day - 1;
+		int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+		long long days = (long long)era * 146097 + doe - 719468;
+
+		// Add the time of the day
+		long long secs = days * 86400 + Hour * 3600 + Minute * 60 + Second;
+		return secs * 1000000000LL + Nanosecond;
+	}
+
+	// Convert the local time to nanoseconds since the Unix epoch (inverse of EpochStringToTime).
+	// The epoch of the start of the hour is cached, since most consecutive calls fall in the same hour.
+	long long DateTime::ToEpochNanoseconds() const
+	{
+		static thread_local int cached_year = -1, cached_month = -1, cached_day = -1, cached_hour = -1;
+		static thread_local long long cached_secs = 0;
+
+		if (Year != cached_year || Month != cached_month || Day != cached_day || Hour != cached_hour)
+		{
+			// Let the system find the epoch of the local hour (including the daylight saving time)
+			std::tm temp_tm = std::tm();
+			temp_tm.tm_year = Year - 1900;
+			temp_tm.tm_mon = Month - 1;
+			temp_tm.tm_mday = Day;
+			temp_tm.tm_hour = Hour;
+			temp_tm.tm_isdst = -1;
+			cached_secs = (long long)std::mktime(&temp_tm);
+			cached_year = Year; cached_month = Month; cached_day = Day; cached_hour = Hour;
+		}
+
+		return (cached_secs + Minute * 60 + Second) * 1000000000LL + Nanosecond;
+	}
+
+	// Convert nanoseconds since 1970/01/01 00:00:00 to a DateTime object (inverse of ToNanoseconds)
+	DateTime DateTime::NanosecondsToTime(long long nanoseconds)
+	{
+		DateTime dt;
 
-		// Perform the conversion
-		temp_tm = localtime(&time);
-		dt.Year = 1900 + temp_tm->tm_year;
-		dt.Month = temp_tm->tm_mon + 1;
-		dt.Day = temp_tm->tm_mday;
-		dt.Hour = temp_tm->tm_hour;
-		dt.Minute = temp_tm->tm_min;
-		dt.Second = temp_tm->tm_sec;
+		// Split to the days, the seconds of the day and the nanoseconds (rounding towards negative infinity)
+		long long secs = nanoseconds / 1000000000LL;
+		long long nanos = nanoseconds % 1000000000LL;
+		if (nanos < 0) { nanos += 1000000000LL; --secs; }
+		long long days = secs / 86400;
+		long long sod = secs % 86400;
+		if (sod < 0) { sod += 86400; --days; }
+
+		// Convert the days to the calendar date
+		days += 719468;
+		long long era = (days >= 0 ? days : days - 146096) / 146097;
+		int doe = (int)(days - era * 146097);
+		int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+		int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+		int mp = (5 * doy + 2) / 153;
+		dt.Day = doy - (153 * mp + 2) / 5 + 1;
+		dt.Month = mp < 10 ? mp + 3 : mp - 9;
+		dt.Year = (int)(yoe + era * 400) + (dt.Month <= 2 ? 1 : 0);
+
+		// Set the time of the day
+		dt.Hour = (int)(sod / 3600);
+		dt.Minute = (int)(sod % 3600) / 60;
+		dt.Second = (int)(sod % 60);
+		dt.Nanosecond = (int)nanos;
 
 		return dt;
 	}
@@ -0,0 +1,1225 @@
+/*  ***************************************************************************
+*   compression.h - Header for keeping ALFA topics compressed in memory.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_COMPRESSION_H
+#define ALFA_COMPRESSION_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <stdint.h>
+#include "commons.h"
+#include "bitops.h"
+#include "message.h"
+#include "topic.h"
+#include "sequence.h"
+
+namespace alfa
+{
+
+// This class keeps a stream of bits packed in 64-bit words
+class BitStream
+{
+public:
+    // Member Functions
+    void Write(uint64_t value, int n_bits);
+    uint64_t Read(size_t &bit_pos, int n_bits) const;
+    size_t GetSizeInBytes() const;
+    void ShrinkToFit();
+
+private:
+    // Data Members
+    std::vector<uint64_t> words;
+    size_t total_bits = 0;
+};
+
+// This class keeps a topic in a compressed columnar form. The timestamps, the header fields
+// and the integer fields are stored as delta-of-delta codes, the float fields are stored as
+// XOR-ed floats (Gorilla encoding) and the fault topics and the other fields are stored as
+// run-lengths of dictionary codes.
+// The messages are split into blocks, so any block can be decoded independently.
+class CompressedTopic
+{
+public:
+
+    // Local definitions
+    enum ColumnEncoding { DeltaOfDelta, XORFloat, RunLength };
+    static const int DefaultBlockSize;
+
+    // Class Data Members
+    std::string Name = "N/A";
+    std::string FileName;
+    VecString FieldLabels;
+
+    // Constructors & Deconstructors
+    CompressedTopic();
+    CompressedTopic(const Topic &topic, int block_size = DefaultBlockSize);
+
+    // Member Functions
+    bool Compress(const Topic &topic, int block_size = DefaultBlockSize);
+    Topic Decompress() const;
+    bool IsInitialized() const;
+    bool IsFaultTopic() const;
+    bool HasHeaderField() const;
+    int FindLabelIndex(const std::string &label) const;
+    void Clear();
+    size_t Size() const;
+    int GetBlockSize() const;
+    int GetNumberOfBlocks() const;
+    ColumnEncoding GetFieldEncoding(int field_index) const;
+    size_t GetMemoryFootprint() const;
+
+    void DecodeBlock(int block_index, std::vector<Message> &out_messages) const;
+    Message GetMessage(int msg_index) const;
+    std::vector<DateTime> GetTimes(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<Message::HeaderType> GetHeaders(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<std::string> GetFieldsAsString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<std::string> GetFieldsAsString(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<double> GetFieldsAsDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<double> GetFieldsAsDouble(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+private:
+    // Local definitions
+    struct Column                       // Structure for a compressed column
+    {
+        ColumnEncoding Encoding = DeltaOfDelta;
+        VecString Dictionary;                   // Distinct values (for run-length columns)
+        std::vector<double> DictionaryValues;   // Numeric values of the dictionary entries
+        int CodeBits = 1;                       // Number of bits for each dictionary code
+        std::vector<BitStream> Blocks;          // Encoded data of each block
+    };
+
+    // Member Functions
+    int GetBlockLength(int block_index) const;
+    bool ClampRange(int &start_msg_index, int &n_messages, const std::string &func_name) const;
+    void EncodeIntegerColumn(const std::vector<long long> &values, Column &column);
+    void EncodeStringColumn(const std::vector<const std::string *> &values, Column &column);
+    bool EncodeNumberColumn(const std::vector<const std::string *> &values, Column &column);
+    void DecodeStrings(const Column &column, int block_index, VecString &out_values) const;
+    void DecodeDoubles(const Column &column, int block_index, std::vector<double> &out_values) const;
+    static void EncodeDeltaOfDelta(const long long *values, int n_values, BitStream &bits);
+    static void DecodeDeltaOfDelta(const BitStream &bits, int n_values, std::vector<long long> &out_values);
+    static void EncodeXOR(const double *values, int n_values, BitStream &bits);
+    static void DecodeXOR(const BitStream &bits, int n_values, std::vector<double> &out_values);
+    static void EncodeRuns(const int *codes, int n_values, int code_bits, BitStream &bits);
+    static void DecodeRuns(const BitStream &bits, int n_values, int code_bits, std::vector<int> &out_codes);
+    static void WriteUnsigned(uint64_t value, BitStream &bits);
+    static uint64_t ReadUnsigned(const BitStream &bits, size_t &bit_pos);
+    static int FormatNumber(double value, char *out_buffer);
+
+    // Data Members
+    bool is_initialized = false;
+    int block_size = DefaultBlockSize;
+    size_t total_messages = 0;
+    Column time_column, seqid_column, stamp_column, frameid_column;
+    std::vector<Column> field_columns;
+
+    std::map<std::string, int> labels_map;
+
+    // Topic information restored to the decompressed topic, including its reading state (see Topic::ExportState)
+    Topic::State topic_state;
+};
+
+// This class keeps all the topics of a dataset sequence compressed in memory
+class CompressedSequence
+{
+public:
+
+    // Class Data Members
+    std::string Name = "N/A";
+    std::string DirectoryPath;
+    std::vector<CompressedTopic> Topics;
+    std::vector<Sequence::MessageIndex> MessageIndexList;
+
+    // Constructors & Deconstructors
+    CompressedSequence();
+    CompressedSequence(const Sequence &sequence, int block_size = CompressedTopic::DefaultBlockSize);
+
+    // Member Functions
+    bool Compress(const Sequence &sequence, int block_size = CompressedTopic::DefaultBlockSize);
+    Sequence Decompress() const;
+    bool IsInitialized() const;
+    void Clear();
+    Message GetMessage(size_t msg_idx) const;
+    int FindTopicIndex(const std::string &topic_name) const;
+    size_t GetMemoryFootprint() const;
+
+private:
+    // Data Members
+    bool is_initialized = false;
+    Sequence::OrderingMode ordering_mode = Sequence::FullMessage;
+    std::map<std::string, int> topic_map;
+
+    // Settings restored to the decompressed sequence
+    bool follow_mode = false;
+    int zone_map_block_size = 0;
+    LoadSpec load_spec;
+    int n_threads = 0;
+    bool batched_reading = false;
+    double fault_gap_threshold = FaultTimeline::DefaultGapThreshold;
+};
+
+/******************************************************************************/
+/********************* BitStream Function Definitions *************************/
+/******************************************************************************/
+
+// Append the lowest n_bits of a value to the stream (up to 64 bits)
+void BitStream::Write(uint64_t value, int n_bits)
+{
+    if (n_bits <= 0) return;
+    if (n_bits < 64) value &= ((uint64_t)1 << n_bits) - 1;
+
+    // Start a new word if the last one is full
+    int offset = (int)(total_bits % 64);
+    if (offset == 0) words.push_back(0);
+
+    // Write the bits, spilling the higher bits to the next word if needed
+    words.back() |= value << offset;
+    if (offset + n_bits > 64)
+        words.push_back(value >> (64 - offset));
+
+    total_bits += n_bits;
+}
+
+// Read n_bits from the given bit position and advance the position
+uint64_t BitStream::Read(size_t &bit_pos, int n_bits) const
+{
+    if (n_bits <= 0) return 0;
+
+    size_t word = bit_pos / 64;
+    int offset = (int)(bit_pos % 64);
+
+    // Read the bits, taking the higher bits from the next word if needed
+    uint64_t value = words[word] >> offset;
+    if (offset + n_bits > 64)
+        value |= words[word + 1] << (64 - offset);
+    if (n_bits < 64) value &= ((uint64_t)1 << n_bits) - 1;
+
+    bit_pos += n_bits;
+    return value;
+}
+
+// Get the memory used by the stream in bytes
+size_t BitStream::GetSizeInBytes() const
+{
+    return sizeof(BitStream) + words.capacity() * sizeof(uint64_t);
+}
+
+// Release the extra capacity of the stream
+void BitStream::ShrinkToFit()
+{
+    std::vector<uint64_t>(words).swap(words);
+}
+
+/******************************************************************************/
+/****************** CompressedTopic Function Definitions **********************/
+/******************************************************************************/
+
+// The default number of messages in each compressed block
+const int CompressedTopic::DefaultBlockSize = 1024;
+
+// Default constructor for CompressedTopic
+CompressedTopic::CompressedTopic()
+{
+}
+
+// Constructor function for CompressedTopic. Compresses the given topic.
+CompressedTopic::CompressedTopic(const Topic &topic, int block_size)
+{
+    Compress(topic, block_size);
+}
+
+// Compress all the messages of a topic. Returns false if the topic cannot be compressed.
+bool CompressedTopic::Compress(const Topic &topic, int block_size)
+{
+    // Clear the previous data from the object
+    this->Clear();
+
+    // Check the block size
+    if (block_size <= 0)
+    {
+        std::cerr << "Compress Error! Block size should be positive." << std::endl;
+        return false;
+    }
+
+    // Copy the topic information
+    this->topic_state = topic.ExportState();
+    this->Name = topic.Name;
+    this->FileName = topic.FileName;
+    this->FieldLabels = topic.FieldLabels;
+    for (int i = 0; i < (int)FieldLabels.size(); ++i)
+        this->labels_map.insert(std::make_pair(FieldLabels[i], i));
+    this->block_size = block_size;
+    this->total_messages = topic.Messages.size();
+
+    // Encode the recording times
+    std::vector<long long> values(total_messages);
+    for (size_t i = 0; i < total_messages; ++i)
+    {
+        values[i] = topic.Messages[i].DateTime.ToNanoseconds();
+        if (DateTime::NanosecondsToTime(values[i]) != topic.Messages[i].DateTime)
+        {
+            std::cerr << "Compress Error! Invalid recording time in message #" << i << " of '" << Name << "' topic." << std::endl;
+            this->Clear();
+            return false;
+        }
+    }
+    EncodeIntegerColumn(values, time_column);
+
+    // Encode the header fields
+    std::vector<const std::string *> strings(total_messages);
+    if (topic_state.HasHeader)
+    {
+        for (size_t i = 0; i < total_messages; ++i)
+            values[i] = topic.Messages[i].Header.SequenceID;
+        EncodeIntegerColumn(values, seqid_column);
+
+        for (size_t i = 0; i < total_messages; ++i)
+            values[i] = topic.Messages[i].Header.Stamp;
+        EncodeIntegerColumn(values, stamp_column);
+
+        for (size_t i = 0; i < total_messages; ++i)
+            strings[i] = &topic.Messages[i].Header.FrameID;
+        EncodeStringColumn(strings, frameid_column);
+    }
+
+    // Encode the other fields. Fault topics and non-numeric fields are kept as run-lengths.
+    field_columns.resize(FieldLabels.size());
+    for (int f = 0; f < (int)FieldLabels.size(); ++f)
+    {
+        for (size_t i = 0; i < total_messages; ++i)
+            strings[i] = &topic.Messages[i].Fields[f];
+
+        if (topic_state.IsFaultTopic || !EncodeNumberColumn(strings, field_columns[f]))
+            EncodeStringColumn(strings, field_columns[f]);
+    }
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Decompress all the messages to a regular topic
+Topic CompressedTopic::Decompress() const
+{
+    Topic topic;
+
+    // Restore the topic information (with the name and the labels of this object)
+    Topic::State state = topic_state;
+    state.Name = Name;
+    state.FileName = FileName;
+    state.FieldLabels = FieldLabels;
+    topic.ImportState(state);
+
+    // Decode all the blocks
+    std::vector<Message> messages, block;
+    messages.reserve(total_messages);
+    for (int b = 0; b < GetNumberOfBlocks(); ++b)
+    {
+        DecodeBlock(b, block);
+        messages.insert(messages.end(), block.begin(), block.end());
+    }
+
+    // Give the messages to the topic, which stores the values in the field types again
+    topic.RestoreMessages(messages);
+    return topic;
+}
+
+// Returns the initialization status
+bool CompressedTopic::IsInitialized() const
+{
+    return is_initialized;
+}
+
+// Returns true if the compressed topic is a fault topic
+bool CompressedTopic::IsFaultTopic() const
+{
+    return topic_state.IsFaultTopic;
+}
+
+// Returns true if the compressed topic has the header field
+bool CompressedTopic::HasHeaderField() const
+{
+    return topic_state.HasHeader;
+}
+
+// Find the index of a given field label (case sensitive)
+int CompressedTopic::FindLabelIndex(const std::string &label) const
+{
+    std::map<std::string, int>::const_iterator it = labels_map.find(label);
+
+    // Return -1 if not found
+    if (it == labels_map.end()) return -1;
+
+    return it->second;
+}
+
+// Clear the entire compressed topic object
+void CompressedTopic::Clear()
+{
+    Name = "";
+    FileName = "";
+    FieldLabels.clear();
+    is_initialized = false;
+    block_size = DefaultBlockSize;
+    total_messages = 0;
+    time_column = Column();
+    seqid_column = Column();
+    stamp_column = Column();
+    frameid_column = Column();
+    field_columns.clear();
+    labels_map.clear();
+    topic_state = Topic::State();
+}
+
+// Get the number of messages in the compressed topic
+size_t CompressedTopic::Size() const
+{
+    return total_messages;
+}
+
+// Get the number of messages in each block
+int CompressedTopic::GetBlockSize() const
+{
+    return block_size;
+}
+
+// Get the number of the compressed blocks
+int CompressedTopic::GetNumberOfBlocks() const
+{
+    return (int)((total_messages + block_size - 1) / block_size);
+}
+
+// Get the encoding used for a field
+CompressedTopic::ColumnEncoding CompressedTopic::GetFieldEncoding(int field_index) const
+{
+    return field_columns[field_index].Encoding;
+}
+
+// Get the number of bytes used by the compressed topic in memory
+size_t CompressedTopic::GetMemoryFootprint() const
+{
+    // Collect all the columns
+    std::vector<const Column *> columns;
+    columns.push_back(&time_column);
+    columns.push_back(&seqid_column);
+    columns.push_back(&stamp_column);
+    columns.push_back(&frameid_column);
+    for (int i = 0; i < (int)field_columns.size(); ++i)
+        columns.push_back(&field_columns[i]);
+
+    // Add the size of the blocks and the dictionaries
+    size_t total = sizeof(CompressedTopic) + field_columns.capacity() * sizeof(Column);
+    for (int i = 0; i < (int)columns.size(); ++i)
+    {
+        for (int b = 0; b < (int)columns[i]->Blocks.size(); ++b)
+            total += columns[i]->Blocks[b].GetSizeInBytes();
+        total += columns[i]->DictionaryValues.capacity() * sizeof(double);
+        for (int d = 0; d < (int)columns[i]->Dictionary.size(); ++d)
+            total += sizeof(std::string) + columns[i]->Dictionary[d].capacity();
+    }
+    return total;
+}
+
+// Decode all the messages of a block
+void CompressedTopic::DecodeBlock(int block_index, std::vector<Message> &out_messages) const
+{
+    int n_block = GetBlockLength(block_index);
+    out_messages.assign(n_block, Message());
+
+    // Decode the recording times
+    std::vector<long long> values;
+    DecodeDeltaOfDelta(time_column.Blocks[block_index], n_block, values);
+    for (int i = 0; i < n_block; ++i)
+        out_messages[i].DateTime = DateTime::NanosecondsToTime(values[i]);
+
+    // Decode the header fields
+    VecString strings;
+    if (topic_state.HasHeader)
+    {
+        DecodeDeltaOfDelta(seqid_column.Blocks[block_index], n_block, values);
+        for (int i = 0; i < n_block; ++i)
+            out_messages[i].Header.SequenceID = (int)values[i];
+
+        DecodeDeltaOfDelta(stamp_column.Blocks[block_index], n_block, values);
+        for (int i = 0; i < n_block; ++i)
+            out_messages[i].Header.Stamp = values[i];
+
+        DecodeStrings(frameid_column, block_index, strings);
+        for (int i = 0; i < n_block; ++i)
+            out_messages[i].Header.FrameID.swap(strings[i]);
+    }
+
+    // Decode the other fields
+    for (int i = 0; i < n_block; ++i)
+        out_messages[i].Fields.resize(field_columns.size());
+    for (int f = 0; f < (int)field_columns.size(); ++f)
+    {
+        DecodeStrings(field_columns[f], block_index, strings);
+        for (int i = 0; i < n_block; ++i)
+            out_messages[i].Fields[f].swap(strings[i]);
+    }
+}
+
+// Get a single message by its index. Use DecodeBlock for the sequential access.
+Message CompressedTopic::GetMessage(int msg_index) const
+{
+    // Check if the index is in range
+    if (msg_index < 0 || msg_index >= (int)total_messages)
+        return Message();
+
+    std::vector<Message> block;
+    DecodeBlock(msg_index / block_size, block);
+    return block[msg_index % block_size];
+}
+
+// Retrieve the DateTime of a desired number of messages starting from the desired index
+std::vector<DateTime> CompressedTopic::GetTimes(int start_msg_index, int n_messages) const
+{
+    // Initialize the output
+    std::vector<DateTime> vec_output;
+    if (!ClampRange(start_msg_index, n_messages, "GetTimes")) return vec_output;
+
+    // Decode the overlapping blocks and copy the desired part
+    std::vector<long long> values;
+    vec_output.reserve(n_messages);
+    for (int b = start_msg_index / block_size; b * block_size < start_msg_index + n_messages; ++b)
+    {
+        DecodeDeltaOfDelta(time_column.Blocks[b], GetBlockLength(b), values);
+        int first = std::max(start_msg_index - b * block_size, 0);
+        int last = std::min(start_msg_index + n_messages - b * block_size, (int)values.size());
+        for (int i = first; i < last; ++i)
+            vec_output.push_back(DateTime::NanosecondsToTime(values[i]));
+    }
+
+    return vec_output;
+}
+
+// Retrieve the Header of a desired number of messages starting from the desired index
+std::vector<Message::HeaderType> CompressedTopic::GetHeaders(int start_msg_index, int n_messages) const
+{
+    // Initialize the output
+    std::vector<Message::HeaderType> vec_output;
+    if (!ClampRange(start_msg_index, n_messages, "GetHeaders")) return vec_output;
+
+    // Return the default headers if the topic does not have them
+    if (!topic_state.HasHeader)
+        return std::vector<Message::HeaderType>(n_messages);
+
+    // Decode the overlapping blocks and copy the desired part
+    std::vector<long long> seqids, stamps;
+    VecString frameids;
+    vec_output.reserve(n_messages);
+    for (int b = start_msg_index / block_size; b * block_size < start_msg_index + n_messages; ++b)
+    {
+        DecodeDeltaOfDelta(seqid_column.Blocks[b], GetBlockLength(b), seqids);
+        DecodeDeltaOfDelta(stamp_column.Blocks[b], GetBlockLength(b), stamps);
+        DecodeStrings(frameid_column, b, frameids);
+        int first = std::max(start_msg_index - b * block_size, 0);
+        int last = std::min(start_msg_index + n_messages - b * block_size, (int)seqids.size());
+        for (int i = first; i < last; ++i)
+        {
+            Message::HeaderType header;
+            header.SequenceID = (int)seqids[i];
+            header.Stamp = stamps[i];
+            header.FrameID = frameids[i];
+            vec_output.push_back(header);
+        }
+    }
+
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<std::string> CompressedTopic::GetFieldsAsString(int field_index, int start_msg_index, int n_messages) const
+{
+    // Initialize the output
+    std::vector<std::string> vec_output;
+
+    // Print error if the field index is out of range
+    if (field_index < 0 || field_index >= (int)field_columns.size())
+    {
+        std::cerr << "GetFieldsAsString Error! Field index is out of range." << std::endl;
+        return vec_output;
+    }
+    if (!ClampRange(start_msg_index, n_messages, "GetFieldsAsString")) return vec_output;
+
+    // Decode the overlapping blocks and copy the desired part
+    VecString values;
+    vec_output.reserve(n_messages);
+    for (int b = start_msg_index / block_size; b * block_size < start_msg_index + n_messages; ++b)
+    {
+        DecodeStrings(field_columns[field_index], b, values);
+        int first = std::max(start_msg_index - b * block_size, 0);
+        int last = std::min(start_msg_index + n_messages - b * block_size, (int)values.size());
+        vec_output.insert(vec_output.end(), values.begin() + first, values.begin() + last);
+    }
+
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<std::string> CompressedTopic::GetFieldsAsString(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    // Find the field index
+    int field_index = FindLabelIndex(field_label);
+
+    // Print error if the field name is not found
+    if (field_index < 0)
+    {
+        std::cerr << "GetFieldsAsString Error! '" << field_label << "' field not found." << std::endl;
+        return std::vector<std::string>();
+    }
+
+    // Return the desired output
+    return GetFieldsAsString(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index.
+// The numeric fields are decoded directly without parsing any strings, and the values that are not numbers are NaN.
+std::vector<double> CompressedTopic::GetFieldsAsDouble(int field_index, int start_msg_index, int n_messages) const
+{
+    // Initialize the output
+    std::vector<double> vec_output;
+
+    // Print error if the field index is out of range
+    if (field_index < 0 || field_index >= (int)field_columns.size())
+    {
+        std::cerr << "GetFieldsAsDouble Error! Field index is out of range." << std::endl;
+        return vec_output;
+    }
+    if (!ClampRange(start_msg_index, n_messages, "GetFieldsAsDouble")) return vec_output;
+
+    // Decode the overlapping blocks and copy the desired part
+    std::vector<double> values;
+    vec_output.reserve(n_messages);
+    for (int b = start_msg_index / block_size; b * block_size < start_msg_index + n_messages; ++b)
+    {
+        DecodeDoubles(field_columns[field_index], b, values);
+        int first = std::max(start_msg_index - b * block_size, 0);
+        int last = std::min(start_msg_index + n_messages - b * block_size, (int)values.size());
+        vec_output.insert(vec_output.end(), values.begin() + first, values.begin() + last);
+    }
+
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<double> CompressedTopic::GetFieldsAsDouble(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    // Find the field index
+    int field_index = FindLabelIndex(field_label);
+
+    // Print error if the field name is not found
+    if (field_index < 0)
+    {
+        std::cerr << "GetFieldsAsDouble Error! '" << field_label << "' field not found." << std::endl;
+        return std::vector<double>();
+    }
+
+    // Return the desired output
+    return GetFieldsAsDouble(field_index, start_msg_index, n_messages);
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Get the number of messages in a block (the last block may be shorter)
+int CompressedTopic::GetBlockLength(int block_index) const
+{
+    return (int)std::min((size_t)block_size, total_messages - (size_t)block_index * block_size);
+}
+
+// Check the start index and limit the number of messages to the topic size
+bool CompressedTopic::ClampRange(int &start_msg_index, int &n_messages, const std::string &func_name) const
+{
+    // Print error if the start index is negative
+    if (start_msg_index < 0)
+    {
+        std::cerr << func_name << " Error! Starting index is negative." << std::endl;
+        return false;
+    }
+
+    // If the number of messages is negative, use all the messages
+    if (n_messages < 0 || start_msg_index + n_messages > (int)total_messages)
+        n_messages = (int)total_messages - start_msg_index;
+
+    return n_messages > 0;
+}
+
+// Encode an integer column block by block using delta-of-delta codes
+void CompressedTopic::EncodeIntegerColumn(const std::vector<long long> &values, Column &column)
+{
+    column.Encoding = DeltaOfDelta;
+    column.Blocks.resize(GetNumberOfBlocks());
+    for (int b = 0; b < (int)column.Blocks.size(); ++b)
+    {
+        EncodeDeltaOfDelta(&values[b * block_size], GetBlockLength(b), column.Blocks[b]);
+        column.Blocks[b].ShrinkToFit();
+    }
+}
+
+// Encode a string column block by block as the run-lengths of the dictionary codes
+void CompressedTopic::EncodeStringColumn(const std::vector<const std::string *> &values, Column &column)
+{
+    column = Column();
+    column.Encoding = RunLength;
+
+    // Build the dictionary and convert the values to codes
+    std::map<std::string, int> dictionary;
+    std::vector<int> codes(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        std::map<std::string, int>::iterator it = dictionary.find(*values[i]);
+        if (it == dictionary.end())
+        {
+            it = dictionary.insert(std::make_pair(*values[i], (int)column.Dictionary.size())).first;
+            column.Dictionary.push_back(*values[i]);
+        }
+        codes[i] = it->second;
+    }
+
+    // Keep the numeric values of the dictionary for the numeric access (NaN for the values that are
+    // not numbers, as in Topic::FieldToDouble)
+    column.DictionaryValues.assign(column.Dictionary.size(), 0);
+    for (int d = 0; d < (int)column.Dictionary.size(); ++d)
+        column.DictionaryValues[d] = Topic::FieldToDouble(column.Dictionary[d]);
+
+    // Find the number of bits needed for the codes
+    while (((size_t)1 << column.CodeBits) < column.Dictionary.size())
+        ++column.CodeBits;
+
+    // Encode the blocks
+    column.Blocks.resize(GetNumberOfBlocks());
+    for (int b = 0; b < (int)column.Blocks.size(); ++b)
+    {
+        EncodeRuns(&codes[b * block_size], GetBlockLength(b), column.CodeBits, column.Blocks[b]);
+        column.Blocks[b].ShrinkToFit();
+    }
+}
+
+// Encode a numeric column block by block, as delta-of-delta codes for the integers and as XOR-ed
+// floats for the other numbers. Returns false if any value cannot be restored to exactly the same
+// text, so the column should be kept as strings.
+bool CompressedTopic::EncodeNumberColumn(const std::vector<const std::string *> &values, Column &column)
+{
+    column = Column();
+    if (values.empty()) return true;
+
+    // Try the integers if the first value looks like an integer
+    char buffer[64];
+    if (values[0]->find_first_not_of("-0123456789") == std::string::npos)
+    {
+        std::vector<long long> integers(values.size());
+        size_t i = 0;
+        for (; i < values.size(); ++i)
+        {
+            if (values[i]->empty() || !Commons::StringToLongLong(*values[i], integers[i])) break;
+            if (values[i]->compare(0, std::string::npos, buffer, sprintf(buffer, "%lld", integers[i])) != 0) break;
+        }
+
+        if (i == values.size())
+        {
+            EncodeIntegerColumn(integers, column);
+            return true;
+        }
+    }
+
+    // Convert the values to doubles and check that they can be restored. Uses strtod directly,
+    // since it rounds correctly to the nearest double.
+    std::vector<double> numbers(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        char *endptr;
+        numbers[i] = std::strtod(values[i]->c_str(), &endptr);
+        if (values[i]->empty() || *endptr != '\0')
+            return false;
+        if (values[i]->compare(0, std::string::npos, buffer, FormatNumber(numbers[i], buffer)) != 0)
+            return false;
+    }
+
+    // Encode the blocks
+    column.Encoding = XORFloat;
+    column.Blocks.resize(GetNumberOfBlocks());
+    for (int b = 0; b < (int)column.Blocks.size(); ++b)
+    {
+        EncodeXOR(&numbers[b * block_size], GetBlockLength(b), column.Blocks[b]);
+        column.Blocks[b].ShrinkToFit();
+    }
+    return true;
+}
+
+// Decode the values of a block of a field column as strings
+void CompressedTopic::DecodeStrings(const Column &column, int block_index, VecString &out_values) const
+{
+    int n_block = GetBlockLength(block_index);
+    out_values.resize(n_block);
+
+    char buffer[64];
+    if (column.Encoding == RunLength)
+    {
+        std::vector<int> codes;
+        DecodeRuns(column.Blocks[block_index], n_block, column.CodeBits, codes);
+        for (int i = 0; i < n_block; ++i)
+            out_values[i] = column.Dictionary[codes[i]];
+    }
+    else if (column.Encoding == DeltaOfDelta)
+    {
+        std::vector<long long> integers;
+        DecodeDeltaOfDelta(column.Blocks[block_index], n_block, integers);
+        for (int i = 0; i < n_block; ++i)
+            out_values[i].assign(buffer, sprintf(buffer, "%lld", integers[i]));
+    }
+    else
+    {
+        std::vector<double> numbers;
+        DecodeXOR(column.Blocks[block_index], n_block, numbers);
+        for (int i = 0; i < n_block; ++i)
+            out_values[i].assign(buffer, FormatNumber(numbers[i], buffer));
+    }
+}
+
+// Decode the values of a block of a field column as doubles
+void CompressedTopic::DecodeDoubles(const Column &column, int block_index, std::vector<double> &out_values) const
+{
+    int n_block = GetBlockLength(block_index);
+
+    if (column.Encoding == XORFloat)
+        DecodeXOR(column.Blocks[block_index], n_block, out_values);
+    else if (column.Encoding == DeltaOfDelta)
+    {
+        std::vector<long long> integers;
+        DecodeDeltaOfDelta(column.Blocks[block_index], n_block, integers);
+        out_values.assign(integers.begin(), integers.end());
+    }
+    else
+    {
+        std::vector<int> codes;
+        DecodeRuns(column.Blocks[block_index], n_block, column.CodeBits, codes);
+        out_values.resize(n_block);
+        for (int i = 0; i < n_block; ++i)
+            out_values[i] = column.DictionaryValues[codes[i]];
+    }
+}
+
+// Encode the integers with delta-of-delta codes. Each code is a prefix of up to four 1s
+// selecting the number of bits (0, 12, 24, 36 or 64) of the zigzag-encoded value.
+void CompressedTopic::EncodeDeltaOfDelta(const long long *values, int n_values, BitStream &bits)
+{
+    static const int bucket_bits[] = { 12, 24, 36, 64 };
+    if (n_values <= 0) return;
+
+    // Write the first value completely
+    bits.Write((uint64_t)values[0], 64);
+
+    long long prev_delta = 0;
+    for (int i = 1; i < n_values; ++i)
+    {
+        long long delta = values[i] - values[i - 1];
+        long long dod = delta - prev_delta;
+        prev_delta = delta;
+
+        // Zigzag encoding puts the small negative and positive values close to zero
+        uint64_t zigzag = ((uint64_t)dod << 1) ^ (uint64_t)(dod >> 63);
+        if (zigzag == 0)
+        {
+            bits.Write(0, 1);
+            continue;
+        }
+
+        // Find the smallest bucket that fits the value
+        int bucket = 0;
+        while (bucket < 3 && (zigzag >> bucket_bits[bucket]) != 0)
+            ++bucket;
+
+        // Write the prefix and the value
+        bits.Write(((uint64_t)1 << (bucket + 1)) - 1, bucket + 1);
+        if (bucket < 3) bits.Write(0, 1);
+        bits.Write(zigzag, bucket_bits[bucket]);
+    }
+}
+
+// Decode the integers encoded with delta-of-delta codes
+void CompressedTopic::DecodeDeltaOfDelta(const BitStream &bits, int n_values, std::vector<long long> &out_values)
+{
+    static const int bucket_bits[] = { 12, 24, 36, 64 };
+    out_values.resize(n_values);
+    if (n_values <= 0) return;
+
+    size_t pos = 0;
+    out_values[0] = (long long)bits.Read(pos, 64);
+
+    long long delta = 0;
+    for (int i = 1; i < n_values; ++i)
+    {
+        // Count the prefix bits
+        int ones = 0;
+        while (ones < 4 && bits.Read(pos, 1) == 1)
+            ++ones;
+
+        // Read the value and undo the zigzag encoding
+        if (ones > 0)
+        {
+            uint64_t zigzag = bits.Read(pos, bucket_bits[ones - 1]);
+            delta += (long long)(zigzag >> 1) ^ -(long long)(zigzag & 1);
+        }
+        out_values[i] = out_values[i - 1] + delta;
+    }
+}
+
+// Encode the doubles by XOR-ing each value with the previous one (Gorilla encoding)
+void CompressedTopic::EncodeXOR(const double *values, int n_values, BitStream &bits)
+{
+    if (n_values <= 0) return;
+
+    // Write the first value completely
+    uint64_t prev;
+    std::memcpy(&prev, &values[0], sizeof(prev));
+    bits.Write(prev, 64);
+
+    int prev_lead = 65, prev_trail = 0;
+    for (int i = 1; i < n_values; ++i)
+    {
+        uint64_t curr;
+        std::memcpy(&curr, &values[i], sizeof(curr));
+        uint64_t xor_value = curr ^ prev;
+        prev = curr;
+
+        // Write a single bit for the repeated values
+        if (xor_value == 0)
+        {
+            bits.Write(0, 1);
+            continue;
+        }
+        bits.Write(1, 1);
+
+        int lead = std::min(BitOps::CountLeadingZeros(xor_value), 31);
+        int trail = BitOps::CountTrailingZeros(xor_value);
+
+        if (lead >= prev_lead && trail >= prev_trail)
+        {
+            // The meaningful bits fit in the previous window
+            bits.Write(0, 1);
+            bits.Write(xor_value >> prev_trail, 64 - prev_lead - prev_trail);
+        }
+        else
+        {
+            // Write the new window and the meaningful bits
+            int n_meaningful = 64 - lead - trail;
+            bits.Write(1, 1);
+            bits.Write(lead, 5);
+            bits.Write(n_meaningful - 1, 6);
+            bits.Write(xor_value >> trail, n_meaningful);
+            prev_lead = lead;
+            prev_trail = trail;
+        }
+    }
+}
+
+// Decode the doubles encoded with XOR (Gorilla encoding)
+void CompressedTopic::DecodeXOR(const BitStream &bits, int n_values, std::vector<double> &out_values)
+{
+    out_values.resize(n_values);
+    if (n_values <= 0) return;
+
+    size_t pos = 0;
+    uint64_t prev = bits.Read(pos, 64);
+    std::memcpy(&out_values[0], &prev, sizeof(prev));
+
+    int lead = 0, n_meaningful = 64;
+    for (int i = 1; i < n_values; ++i)
+    {
+        if (bits.Read(pos, 1) == 1)
+        {
+            // Read a new window if the control bit is set
+            if (bits.Read(pos, 1) == 1)
+            {
+                lead = (int)bits.Read(pos, 5);
+                n_meaningful = (int)bits.Read(pos, 6) + 1;
+            }
+            prev ^= bits.Read(pos, n_meaningful) << (64 - lead - n_meaningful);
+        }
+        std::memcpy(&out_values[i], &prev, sizeof(prev));
+    }
+}
+
+// Encode the dictionary codes as (code, run-length) pairs
+void CompressedTopic::EncodeRuns(const int *codes, int n_values, int code_bits, BitStream &bits)
+{
+    for (int i = 0; i < n_values; )
+    {
+        int run = 1;
+        while (i + run < n_values && codes[i + run] == codes[i])
+            ++run;
+
+        bits.Write(codes[i], code_bits);
+        WriteUnsigned(run - 1, bits);
+        i += run;
+    }
+}
+
+// Decode the dictionary codes encoded as (code, run-length) pairs
+void CompressedTopic::DecodeRuns(const BitStream &bits, int n_values, int code_bits, std::vector<int> &out_codes)
+{
+    out_codes.resize(n_values);
+
+    size_t pos = 0;
+    for (int i = 0; i < n_values; )
+    {
+        int code = (int)bits.Read(pos, code_bits);
+        int run = (int)ReadUnsigned(bits, pos) + 1;
+        for (int j = 0; j < run && i < n_values; ++j)
+            out_codes[i++] = code;
+    }
+}
+
+// Write an unsigned integer with a prefix selecting 4, 12, 20 or 64 bits
+void CompressedTopic::WriteUnsigned(uint64_t value, BitStream &bits)
+{
+    static const int bucket_bits[] = { 4, 12, 20, 64 };
+
+    int bucket = 0;
+    while (bucket < 3 && (value >> bucket_bits[bucket]) != 0)
+        ++bucket;
+
+    bits.Write(((uint64_t)1 << bucket) - 1, bucket);
+    if (bucket < 3) bits.Write(0, 1);
+    bits.Write(value, bucket_bits[bucket]);
+}
+
+// Read an unsigned integer written by WriteUnsigned
+uint64_t CompressedTopic::ReadUnsigned(const BitStream &bits, size_t &bit_pos)
+{
+    static const int bucket_bits[] = { 4, 12, 20, 64 };
+
+    int ones = 0;
+    while (ones < 3 && bits.Read(bit_pos, 1) == 1)
+        ++ones;
+
+    return bits.Read(bit_pos, bucket_bits[ones]);
+}
+
+// Write the shortest text that restores the same double and return the text length.
+// The layout matches the floats in the dataset CSV files (e.g. '0.0', '1.25', '1e-05').
+int CompressedTopic::FormatNumber(double value, char *out_buffer)
+{
+    // Handle the special values
+    if (value != value) return sprintf(out_buffer, "nan");
+    if (value > 1.7976931348623157e308) return sprintf(out_buffer, "inf");
+    if (value < -1.7976931348623157e308) return sprintf(out_buffer, "-inf");
+
+    // Find the smallest precision that restores the same value
+    char buffer[40];
+    int low = 0, high = 16;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        sprintf(buffer, "%.*e", mid, value);
+        if (std::strtod(buffer, NULL) == value) high = mid; else low = mid + 1;
+    }
+    sprintf(buffer, "%.*e", low, value);
+
+    // Extract the sign, the digits and the exponent
+    const char *p = buffer;
+    char *out = out_buffer;
+    if (*p == '-') { *out++ = '-'; ++p; }
+    char digits[20] = { '0' };
+    int n_digits = 0;
+    for (; *p != 'e'; ++p)
+        if (*p != '.') digits[n_digits++] = *p;
+    int exponent = std::atoi(p + 1);
+
+    if (exponent < -4 || exponent >= 16)
+    {
+        // Scientific notation
+        *out++ = digits[0];
+        if (n_digits > 1)
+        {
+            *out++ = '.';
+            for (int i = 1; i < n_digits; ++i) *out++ = digits[i];
+        }
+        out += sprintf(out, "e%c%02d", exponent < 0 ? '-' : '+', std::abs(exponent));
+    }
+    else if (exponent >= 0)
+    {
+        // Fixed notation for the numbers larger than one
+        for (int i = 0; i <= exponent; ++i)
+            *out++ = (i < n_digits) ? digits[i] : '0';
+        *out++ = '.';
+        if (n_digits <= exponent + 1) *out++ = '0';
+        for (int i = exponent + 1; i < n_digits; ++i) *out++ = digits[i];
+    }
+    else
+    {
+        // Fixed notation for the numbers smaller than one
+        *out++ = '0';
+        *out++ = '.';
+        for (int i = 0; i < -exponent - 1; ++i) *out++ = '0';
+        for (int i = 0; i < n_digits; ++i) *out++ = digits[i];
+    }
+
+    *out = '\0';
+    return (int)(out - out_buffer);
+}
+
+/******************************************************************************/
+/***************** CompressedSequence Function Definitions ********************/
+/******************************************************************************/
+
+// Default constructor for CompressedSequence
+CompressedSequence::CompressedSequence()
+{
+}
+
+// Constructor function for CompressedSequence. Compresses all the topics of the given sequence.
+CompressedSequence::CompressedSequence(const Sequence &sequence, int block_size)
+{
+    Compress(sequence, block_size);
+}
+
+// Compress all the topics of a sequence. The sequence can be released afterwards.
+bool CompressedSequence::Compress(const Sequence &sequence, int block_size)
+{
+    // Clear the previous data from the object
+    this->Clear();
+
+    // Save the sequence information
+    Name = sequence.Name;
+    DirectoryPath = sequence.DirectoryPath;
+    MessageIndexList = sequence.MessageIndexList;
+    ordering_mode = sequence.ordering_mode;
+    topic_map = sequence.topic_map;
+    follow_mode = sequence.follow_mode;
+    zone_map_block_size = sequence.zone_map_block_size;
+    load_spec = sequence.load_spec;
+    n_threads = sequence.n_threads;
+    batched_reading = sequence.batched_reading;
+    fault_gap_threshold = sequence.fault_gap_threshold;
+
+    // Compress all the topics
+    Topics.resize(sequence.Topics.size());
+    for (int i = 0; i < (int)sequence.Topics.size(); ++i)
+    {
+        if (!Topics[i].Compress(sequence.Topics[i], block_size))
+        {
+            std::cerr << "Failed to compress '" << sequence.Topics[i].Name << "' topic." << std::endl;
+            this->Clear();
+            return false;
+        }
+    }
+
+    // Initialization done
+    is_initialized = sequence.IsInitialized();
+
+    return IsInitialized();
+}
+
+// Decompress all the topics to a regular sequence
+Sequence CompressedSequence::Decompress() const
+{
+    Sequence sequence;
+    sequence.Name = Name;
+    sequence.DirectoryPath = DirectoryPath;
+    sequence.MessageIndexList = MessageIndexList;
+    sequence.ordering_mode = ordering_mode;
+    sequence.topic_map = topic_map;
+    sequence.follow_mode = follow_mode;
+    sequence.zone_map_block_size = zone_map_block_size;
+    sequence.load_spec = load_spec;
+    sequence.n_threads = n_threads;
+    sequence.batched_reading = batched_reading;
+    sequence.fault_gap_threshold = fault_gap_threshold;
+
+    sequence.Topics.reserve(Topics.size());
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        sequence.Topics.push_back(Topics[i].Decompress());
+
+    sequence.BuildFaultIndex();
+    sequence.is_initialized = is_initialized;
+    return sequence;
+}
+
+// Returns the initialization status
+bool CompressedSequence::IsInitialized() const
+{
+    return is_initialized;
+}
+
+// Clear the entire compressed sequence object
+void CompressedSequence::Clear()
+{
+    Name = "N/A";
+    DirectoryPath = "";
+    Topics.clear();
+    MessageIndexList.clear();
+    is_initialized = false;
+    ordering_mode = Sequence::FullMessage;
+    topic_map.clear();
+    follow_mode = false;
+    zone_map_block_size = 0;
+    load_spec = LoadSpec();
+    n_threads = 0;
+    batched_reading = false;
+    fault_gap_threshold = FaultTimeline::DefaultGapThreshold;
+}
+
+// Get messages by index from the message collection sorted by the recording time
+Message CompressedSequence::GetMessage(size_t msg_idx) const
+{
+    // Check if the index is in range
+    if (msg_idx >= MessageIndexList.size())
+        return Message();
+
+    return Topics[MessageIndexList[msg_idx].TopicIdx].GetMessage(MessageIndexList[msg_idx].MessageIdx);
+}
+
+// Find the index of a given topic (case sensitive)
+int CompressedSequence::FindTopicIndex(const std::string &topic_name) const
+{
+    std::map<std::string, int>::const_iterator it = topic_map.find(topic_name);
+
+    // Return -1 if not found
+    if (it == topic_map.end()) return -1;
+
+    return it->second;
+}
+
+// Get the number of bytes used by the compressed sequence in memory
+size_t CompressedSequence::GetMemoryFootprint() const
+{
+    size_t total = sizeof(CompressedSequence) + MessageIndexList.capacity() * sizeof(Sequence::MessageIndex);
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        total += Topics[i].GetMemoryFootprint();
+    return total;
+}
+
+}
+#endif
@@ -0,0 +1,146 @@
+/*  ***************************************************************************
+*   csvscan.h - Header for finding the field delimiters and the line ends
+*   of the CSV data of ALFA dataset topics with vector instructions.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_CSVSCAN_H
+#define ALFA_CSVSCAN_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "bitops.h"
+
+// Use the widest vector instructions enabled for the build (AVX2 with -mavx2, SSE2 on all the x86-64 CPUs)
+#if defined __AVX2__
+#include <immintrin.h>
+#define ALFA_CSVSCAN_AVX2
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ALFA_CSVSCAN_SSE2
+#endif
+
+namespace alfa
+{
+
+// This class finds the positions of the field delimiters and the newlines of a whole buffer of CSV data
+// in one pass. Each block of 64 bytes is compared with both characters at once using the vector
+// instructions, and the positions are read from the resulting bit mask. The tokenizer of the topics
+// walks the positions instead of searching each line and field separately.
+class CSVScanner
+{
+public:
+
+    // Member Functions
+    static void FindSeparators(const char *data, size_t size, char delimiter, std::vector<uint32_t> &out_positions);
+    static void FindSeparatorsScalar(const char *data, size_t size, char delimiter, std::vector<uint32_t> &out_positions);
+    static std::string GetInstructionSet();
+
+private:
+    // Member Functions
+    static void AddPositions(uint64_t mask, size_t offset, std::vector<uint32_t> &out_positions);
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Find the positions of the delimiters and the newlines in the data (which should be smaller than 4 GB).
+// The positions are relative to the start of the data and sorted.
+void CSVScanner::FindSeparators(const char *data, size_t size, char delimiter, std::vector<uint32_t> &out_positions)
+{
+    out_positions.clear();
+    size_t i = 0;
+
+#if defined ALFA_CSVSCAN_AVX2
+    const __m256i delimiters = _mm256_set1_epi8(delimiter), newlines = _mm256_set1_epi8('\n');
+    for (; i + 64 <= size; i += 64)
+    {
+        __m256i low = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(data + i + 32));
+        uint32_t low_mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(low, delimiters), _mm256_cmpeq_epi8(low, newlines)));
+        uint32_t high_mask = (uint32_t)_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(high, delimiters), _mm256_cmpeq_epi8(high, newlines)));
+        AddPositions(((uint64_t)high_mask << 32) | low_mask, i, out_positions);
+    }
+#elif defined ALFA_CSVSCAN_SSE2
+    const __m128i delimiters = _mm_set1_epi8(delimiter), newlines = _mm_set1_epi8('\n');
+    for (; i + 64 <= size; i += 64)
+    {
+        uint64_t mask = 0;
+        for (int b = 0; b < 4; ++b)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i *)(data + i + 16 * b));
+            uint32_t block_mask = (uint32_t)_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(block, delimiters), _mm_cmpeq_epi8(block, newlines)));
+            mask |= (uint64_t)block_mask << (16 * b);
+        }
+        AddPositions(mask, i, out_positions);
+    }
+#endif
+
+    // Scan the rest of the data one character at a time
+    for (; i < size; ++i)
+        if (data[i] == delimiter || data[i] == '\n')
+            out_positions.push_back((uint32_t)i);
+}
+
+// Find the positions of the delimiters and the newlines one character at a time (for comparison)
+void CSVScanner::FindSeparatorsScalar(const char *data, size_t size, char delimiter, std::vector<uint32_t> &out_positions)
+{
+    out_positions.clear();
+    for (size_t i = 0; i < size; ++i)
+        if (data[i] == delimiter || data[i] == '\n')
+            out_positions.push_back((uint32_t)i);
+}
+
+// Get the name of the vector instructions used for scanning
+std::string CSVScanner::GetInstructionSet()
+{
+#if defined ALFA_CSVSCAN_AVX2
+    return "AVX2";
+#elif defined ALFA_CSVSCAN_SSE2
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Add the positions of the set bits of a block mask
+void CSVScanner::AddPositions(uint64_t mask, size_t offset, std::vector<uint32_t> &out_positions)
+{
+    while (mask != 0)
+    {
+        out_positions.push_back((uint32_t)(offset + BitOps::CountTrailingZeros(mask)));
+        mask &= mask - 1;
+    }
+}
+
+}
+#endif
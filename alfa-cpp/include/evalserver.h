@@ -0,0 +1,505 @@
+/*  ***************************************************************************
+*   evalserver.h - Header for evaluating many fault detection streams (runs
+*   and fault channels) concurrently with sharded lock-free event queues.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_EVALSERVER_H
+#define ALFA_EVALSERVER_H
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "evaluator.h"
+#include "ringbuffer.h"
+
+namespace alfa
+{
+
+// This class evaluates the detections of many flights (runs) and fault channels at the same time. Each
+// (run id, channel) pair is a separate stream with its own FaultEvaluator state machine, so the faults of
+// different runs and channels do not overwrite each other. The streams are spread over the shards by
+// their keys; each shard has a thread that owns its streams (no locks) and receives the events from any
+// number of publishing threads through its own lock-free ring buffer. The results are collected by the
+// shards and handed to the batch function in batches.
+class EvaluationServer
+{
+public:
+
+    // Local enum definitions
+    enum EventType                      // Types of the stream events
+    {
+        GroundTruth,                    // A ground truth message of a stream (active or inactive)
+        Detection,                      // A detection of a stream
+        Clock,                          // The time of a run has advanced (reports the timeouts of its streams)
+        EndOfRun                        // A run has finished (reports its pending faults and drops its streams)
+    };
+
+    // Local struct definitions
+    struct StreamEvent                  // Structure for an event (time in nanoseconds of the run)
+    {
+        EventType Type = GroundTruth;
+        long long RunId = 0;
+        int Channel = 0;                // Fault channel of the stream (ignored by the run events)
+        bool IsActive = true;           // Is the ground truth reporting the fault
+        long long Time = 0;
+    };
+
+    struct StreamResult                 // Structure for a result of a stream
+    {
+        long long RunId = 0;
+        int Channel = 0;
+        FaultEvaluator::Result Result;
+    };
+
+    struct ServerStats                  // Structure for the statistics of the server
+    {
+        size_t Events = 0;              // Number of events processed by the shards
+        size_t Results = 0;             // Number of results handed to the batch function
+        size_t Batches = 0;             // Number of calls to the batch function
+        size_t Streams = 0;             // Number of streams being evaluated
+        size_t Lag = 0;                 // Number of events waiting in the buffers
+        size_t MaxLag = 0;              // Largest number of events waiting in a buffer so far
+        int NumDetected = 0, NumMissed = 0, NumFalsePositives = 0;
+        double BlockedTime = 0;         // Total time the publishers waited for full buffers (seconds)
+    };
+
+    // The batch function is called by the shard threads (at the same time for different shards)
+    typedef std::function<void(const std::vector<StreamResult> &)> BatchFunction;
+
+    // Default number of results in a batch and the longest time a result waits in a batch (seconds)
+    static const size_t DefaultBatchSize;
+    static const double DefaultFlushInterval;
+
+    // Constructors & Deconstructors
+    explicit EvaluationServer(int n_shards = 0, double timeout = FaultEvaluator::DefaultTimeout, size_t buffer_size = 65536);
+    ~EvaluationServer();
+
+    // Member Functions
+    void SetGapThreshold(double gap_threshold);
+    void SetBatchFunction(const BatchFunction &function, size_t batch_size = DefaultBatchSize, double flush_interval = DefaultFlushInterval);
+    bool Start();
+    bool Publish(const StreamEvent &event);
+    bool AddGroundTruth(long long run_id, int channel, long long time, bool is_active = true);
+    bool AddDetection(long long run_id, int channel, long long time);
+    bool AdvanceRun(long long run_id, long long time);
+    bool FinishRun(long long run_id, long long time);
+    void Close();
+    bool IsRunning() const;
+    ServerStats GetStats() const;
+    int GetNumberOfShards() const;
+
+private:
+    // Local struct definitions
+    struct ChannelState                 // Structure for a stream of a run
+    {
+        int Channel;
+        FaultEvaluator Evaluator;
+    };
+
+    struct Shard                        // Structure for a shard and the streams it owns
+    {
+        std::unique_ptr<MPMCRingBuffer<StreamEvent> > Buffer;
+        std::thread Thread;
+        std::unordered_map<long long, std::vector<ChannelState> > Runs;    // Streams of each run (shard thread only)
+        std::vector<StreamResult> Batch;                                    // Results waiting for the batch function
+        std::chrono::steady_clock::time_point BatchStart;                   // When the first result entered the batch
+        long long CurrentRun = 0;                                           // Stream whose evaluator is running
+        int CurrentChannel = 0;
+        std::atomic<size_t> Events, Results, Batches, Streams, MaxLag;
+        std::atomic<int> NumDetected, NumMissed, NumFalsePositives;
+        std::atomic<long long> BlockedTime;
+    };
+
+    // Member Functions
+    void Deliver(Shard &shard, const StreamEvent &event);
+    void RunShard(Shard &shard);
+    void ProcessEvent(Shard &shard, const StreamEvent &event);
+    ChannelState &FindStream(Shard &shard, long long run_id, int channel);
+    void CollectResult(Shard &shard, const FaultEvaluator::Result &result);
+    void FlushBatch(Shard &shard);
+    static size_t HashStream(long long run_id, int channel);
+
+    // The server cannot be copied while the threads are running
+    EvaluationServer(const EvaluationServer &);
+    EvaluationServer &operator=(const EvaluationServer &);
+
+    // Data Members
+    std::vector<std::unique_ptr<Shard> > shards;
+    double timeout;
+    double gap_threshold;
+    BatchFunction batch_function;
+    size_t batch_size;
+    long long flush_interval_ns;
+    std::atomic<bool> is_running, is_closed;
+    std::atomic<int> n_publishers;      // Threads inside Publish (Close waits for them before the shards stop)
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The batches are small enough to keep the results timely and large enough to make the calls cheap
+const size_t EvaluationServer::DefaultBatchSize = 256;
+const double EvaluationServer::DefaultFlushInterval = 0.01;
+
+// Constructor function for EvaluationServer. Uses one shard per core if the number of shards is not given.
+// Each stream allows the given time (seconds) to detect its faults.
+EvaluationServer::EvaluationServer(int n_shards, double timeout, size_t buffer_size)
+    : timeout(timeout), gap_threshold(FaultEvaluator::DefaultGapThreshold), batch_size(DefaultBatchSize),
+    flush_interval_ns((long long)(DefaultFlushInterval * 1e9)), is_running(false), is_closed(false), n_publishers(0)
+{
+    if (n_shards <= 0) n_shards = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int i = 0; i < n_shards; ++i)
+    {
+        std::unique_ptr<Shard> shard(new Shard());
+        shard->Buffer.reset(new MPMCRingBuffer<StreamEvent>(buffer_size));
+        shard->Events = 0; shard->Results = 0; shard->Batches = 0; shard->Streams = 0; shard->MaxLag = 0;
+        shard->NumDetected = 0; shard->NumMissed = 0; shard->NumFalsePositives = 0;
+        shard->BlockedTime = 0;
+        shards.push_back(std::move(shard));
+    }
+}
+
+// Destructor function for EvaluationServer. Lets the shards finish their queued events.
+EvaluationServer::~EvaluationServer()
+{
+    Close();
+}
+
+// Set the largest gap between the ground truth messages of the same fault (seconds) for the new streams
+void EvaluationServer::SetGapThreshold(double gap_threshold)
+{
+    this->gap_threshold = gap_threshold;
+}
+
+// Set the function that receives the results in batches of up to the given size. A result waits at most
+// the given time (seconds) while events keep arriving; the batch is also handed over when the shard is idle.
+void EvaluationServer::SetBatchFunction(const BatchFunction &function, size_t batch_size, double flush_interval)
+{
+    if (IsRunning())
+    {
+        std::cerr << "SetBatchFunction Error! Cannot change the batch function while the server is running." << std::endl;
+        return;
+    }
+    batch_function = function;
+    this->batch_size = std::max((size_t)1, batch_size);
+    flush_interval_ns = (long long)(flush_interval * 1e9);
+}
+
+// Start the shard threads. Returns false if the server is already running.
+bool EvaluationServer::Start()
+{
+    if (IsRunning())
+    {
+        std::cerr << "Start Error! The server is already running." << std::endl;
+        return false;
+    }
+
+    // Wait for the previous run to finish
+    Close();
+
+    is_closed = false;
+    is_running = true;
+    for (int i = 0; i < (int)shards.size(); ++i)
+        shards[i]->Thread = std::thread(&EvaluationServer::RunShard, this, std::ref(*shards[i]));
+
+    return true;
+}
+
+// Publish an event. Can be called from multiple threads; the events of a stream are processed in the order
+// they are published. The run events go to all the shards, since the streams of a run can be in any of them.
+bool EvaluationServer::Publish(const StreamEvent &event)
+{
+    // Count the publisher before checking the server, so Close either waits for it or it sees the server closed
+    ++n_publishers;
+    if (!IsRunning())
+    {
+        --n_publishers;
+        std::cerr << "Publish Error! The server is not running." << std::endl;
+        return false;
+    }
+
+    if (event.Type == Clock || event.Type == EndOfRun)
+        for (int i = 0; i < (int)shards.size(); ++i)
+            Deliver(*shards[i], event);
+    else
+        Deliver(*shards[HashStream(event.RunId, event.Channel) % shards.size()], event);
+
+    --n_publishers;
+    return true;
+}
+
+// Publish a ground truth message of a stream at the given time (nanoseconds)
+bool EvaluationServer::AddGroundTruth(long long run_id, int channel, long long time, bool is_active)
+{
+    StreamEvent event;
+    event.Type = GroundTruth;
+    event.RunId = run_id;
+    event.Channel = channel;
+    event.IsActive = is_active;
+    event.Time = time;
+    return Publish(event);
+}
+
+// Publish a detection of a stream at the given time (nanoseconds)
+bool EvaluationServer::AddDetection(long long run_id, int channel, long long time)
+{
+    StreamEvent event;
+    event.Type = Detection;
+    event.RunId = run_id;
+    event.Channel = channel;
+    event.Time = time;
+    return Publish(event);
+}
+
+// Publish the current time of a run (nanoseconds), so the faults of its streams that were not detected
+// within the timeout are reported even if no more events arrive (as the timer of alfa-evaluate)
+bool EvaluationServer::AdvanceRun(long long run_id, long long time)
+{
+    StreamEvent event;
+    event.Type = Clock;
+    event.RunId = run_id;
+    event.Time = time;
+    return Publish(event);
+}
+
+// Publish the end of a run at the given time (nanoseconds). Its pending faults are reported as missed and
+// its streams are released.
+bool EvaluationServer::FinishRun(long long run_id, long long time)
+{
+    StreamEvent event;
+    event.Type = EndOfRun;
+    event.RunId = run_id;
+    event.Time = time;
+    return Publish(event);
+}
+
+// Stop accepting events and wait until the shards process the queued ones and hand over their last results.
+// The events that are being published when it is called are delivered first.
+void EvaluationServer::Close()
+{
+    is_running = false;
+    while (n_publishers > 0)
+        std::this_thread::yield();
+    is_closed = true;
+    for (int i = 0; i < (int)shards.size(); ++i)
+        if (shards[i]->Thread.joinable()) shards[i]->Thread.join();
+}
+
+// Returns true if the server is accepting events
+bool EvaluationServer::IsRunning() const
+{
+    return is_running;
+}
+
+// Get the statistics of all the shards. Can be called while the server is running.
+EvaluationServer::ServerStats EvaluationServer::GetStats() const
+{
+    ServerStats stats;
+    long long blocked_time = 0;
+    for (int i = 0; i < (int)shards.size(); ++i)
+    {
+        const Shard &shard = *shards[i];
+        stats.Events += shard.Events;
+        stats.Results += shard.Results;
+        stats.Batches += shard.Batches;
+        stats.Streams += shard.Streams;
+        stats.Lag += shard.Buffer->Size();
+        stats.MaxLag = std::max(stats.MaxLag, (size_t)shard.MaxLag);
+        stats.NumDetected += shard.NumDetected;
+        stats.NumMissed += shard.NumMissed;
+        stats.NumFalsePositives += shard.NumFalsePositives;
+        blocked_time += shard.BlockedTime;
+    }
+    stats.BlockedTime = blocked_time / 1e9;
+    return stats;
+}
+
+// Get the number of shards (and shard threads)
+int EvaluationServer::GetNumberOfShards() const
+{
+    return (int)shards.size();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Put an event in the buffer of a shard, waiting for the shard to make room if the buffer is full
+void EvaluationServer::Deliver(Shard &shard, const StreamEvent &event)
+{
+    if (!shard.Buffer->TryPush(event))
+    {
+        std::chrono::steady_clock::time_point wait_start = std::chrono::steady_clock::now();
+        int wait_count = 0;
+        while (!shard.Buffer->TryPush(event))
+        {
+            if (++wait_count < 100)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        shard.BlockedTime.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wait_start).count(), std::memory_order_relaxed);
+    }
+
+    // Keep track of the largest lag of the shards
+    size_t lag = shard.Buffer->Size();
+    size_t max_lag = shard.MaxLag.load(std::memory_order_relaxed);
+    while (lag > max_lag && !shard.MaxLag.compare_exchange_weak(max_lag, lag, std::memory_order_relaxed)) {}
+}
+
+// Receive the events from the buffer of a shard and evaluate its streams
+void EvaluationServer::RunShard(Shard &shard)
+{
+    StreamEvent event;
+    int idle_count = 0;
+    size_t n_processed = 0;
+    while (true)
+    {
+        if (shard.Buffer->TryPop(event))
+        {
+            ProcessEvent(shard, event);
+            shard.Events.fetch_add(1, std::memory_order_relaxed);
+            idle_count = 0;
+
+            // Hand over the full batches, and check the age of the batch from time to time
+            if (shard.Batch.size() >= batch_size)
+                FlushBatch(shard);
+            else if (!shard.Batch.empty() && (++n_processed & 255) == 0 && std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - shard.BatchStart).count() >= flush_interval_ns)
+                FlushBatch(shard);
+            continue;
+        }
+
+        // Nothing else is coming for now, so the results should not wait
+        FlushBatch(shard);
+
+        // Finish when the server is closed and the buffer is empty
+        if (is_closed && shard.Buffer->IsEmpty()) break;
+
+        // Spin for a while before sleeping to keep the latency low
+        if (++idle_count < 100)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+// Pass an event to the evaluators of its stream (or of all the streams of its run in the shard)
+void EvaluationServer::ProcessEvent(Shard &shard, const StreamEvent &event)
+{
+    if (event.Type == GroundTruth || event.Type == Detection)
+    {
+        ChannelState &stream = FindStream(shard, event.RunId, event.Channel);
+        shard.CurrentRun = event.RunId;
+        shard.CurrentChannel = event.Channel;
+        if (event.Type == GroundTruth)
+            stream.Evaluator.AddGroundTruth(event.Time, event.IsActive);
+        else
+            stream.Evaluator.AddDetection(event.Time);
+        return;
+    }
+
+    std::unordered_map<long long, std::vector<ChannelState> >::iterator run = shard.Runs.find(event.RunId);
+    if (run == shard.Runs.end()) return;
+    shard.CurrentRun = event.RunId;
+    for (ChannelState &stream : run->second)
+    {
+        shard.CurrentChannel = stream.Channel;
+        stream.Evaluator.AdvanceTo(event.Time);
+        if (event.Type == EndOfRun) stream.Evaluator.Finish();
+    }
+    if (event.Type == EndOfRun)
+    {
+        shard.Streams.fetch_sub(run->second.size(), std::memory_order_relaxed);
+        shard.Runs.erase(run);
+    }
+}
+
+// Find the stream of a run and channel in a shard, creating it on its first event
+EvaluationServer::ChannelState &EvaluationServer::FindStream(Shard &shard, long long run_id, int channel)
+{
+    // A run has only a few channels, so they are searched linearly
+    std::vector<ChannelState> &streams = shard.Runs[run_id];
+    for (ChannelState &stream : streams)
+        if (stream.Channel == channel) return stream;
+
+    // The evaluators report to the shard, which knows the stream being evaluated
+    ChannelState stream;
+    stream.Channel = channel;
+    stream.Evaluator.SetTimeout(timeout);
+    stream.Evaluator.SetGapThreshold(gap_threshold);
+    Shard *owner = &shard;
+    stream.Evaluator.SetResultFunction([this, owner](const FaultEvaluator::Result &result) { CollectResult(*owner, result); });
+    streams.push_back(std::move(stream));
+    shard.Streams.fetch_add(1, std::memory_order_relaxed);
+    return streams.back();
+}
+
+// Add a result of the current stream of a shard to its batch
+void EvaluationServer::CollectResult(Shard &shard, const FaultEvaluator::Result &result)
+{
+    if (shard.Batch.empty()) shard.BatchStart = std::chrono::steady_clock::now();
+    StreamResult stream_result;
+    stream_result.RunId = shard.CurrentRun;
+    stream_result.Channel = shard.CurrentChannel;
+    stream_result.Result = result;
+    shard.Batch.push_back(stream_result);
+
+    if (result.Type == FaultEvaluator::Detected)
+        shard.NumDetected.fetch_add(1, std::memory_order_relaxed);
+    else if (result.Type == FaultEvaluator::Missed)
+        shard.NumMissed.fetch_add(1, std::memory_order_relaxed);
+    else
+        shard.NumFalsePositives.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Hand the batch of a shard to the batch function
+void EvaluationServer::FlushBatch(Shard &shard)
+{
+    if (shard.Batch.empty()) return;
+    if (batch_function) batch_function(shard.Batch);
+    shard.Results.fetch_add(shard.Batch.size(), std::memory_order_relaxed);
+    shard.Batches.fetch_add(1, std::memory_order_relaxed);
+    shard.Batch.clear();
+}
+
+// Mix the key of a stream, so the consecutive run ids and channels are spread evenly over the shards
+size_t EvaluationServer::HashStream(long long run_id, int channel)
+{
+    unsigned long long hash = (unsigned long long)run_id * 0x9E3779B97F4A7C15ULL + (unsigned long long)(unsigned int)channel;
+    hash ^= hash >> 31;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 27;
+    return (size_t)hash;
+}
+
+}
+#endif
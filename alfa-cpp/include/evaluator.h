@@ -0,0 +1,282 @@
+/*  ***************************************************************************
+*   evaluator.h - Header for evaluating a fault detector on the timestamped
+*   ground truth and detection events (used by alfa-evaluate and offline).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_EVALUATOR_H
+#define ALFA_EVALUATOR_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace alfa
+{
+
+// This class judges the alarms of a fault detector against the fault ground truth. It consumes the
+// ground truth messages (the failure_status topics) and the detections as events with their own times in
+// nanoseconds, so the delays do not depend on when the events are processed. It has no other
+// dependencies, so it runs in the ROS node as well as offline on the sequences at full speed.
+//
+// A fault starts at its first active ground truth message and lasts while the messages keep arriving
+// (closer than the gap threshold) until an inactive one. The ground truth can come from several channels
+// (e.g., the engines and the control surfaces), and the fault lasts while any of them reports it. The
+// first detection within the timeout after the start reports the fault as detected with its delay (even
+// if the fault has ended meanwhile); otherwise the fault is reported as missed at the timeout. The other
+// detections during a reported fault are ignored, and the detections outside the faults are reported as
+// false positives.
+class FaultEvaluator
+{
+public:
+
+    // Local enum definitions
+    enum ResultType                     // Types of the evaluation results
+    {
+        Detected,                       // A fault was detected within the timeout
+        Missed,                         // A fault was not detected within the timeout
+        FalsePositive                   // A detection without a fault
+    };
+
+    // Local struct definitions
+    struct Result                       // Structure for an evaluation result (times in nanoseconds)
+    {
+        ResultType Type = Detected;
+        long long FaultTime = 0;        // Start of the fault (Detected and Missed)
+        long long DetectionTime = 0;    // Time of the detection (Detected and FalsePositive)
+        long long Delay = 0;            // Time from the start of the fault to its detection (Detected)
+    };
+
+    struct Summary                      // Structure for the counts of the results
+    {
+        int NumDetected = 0, NumMissed = 0, NumFalsePositives = 0;
+        long long TotalDelay = 0, MaxDelay = 0;
+    };
+
+    // A callback receives each result as soon as it is decided
+    typedef std::function<void(const Result &)> ResultFunction;
+
+    // Default time to detect a fault and largest gap between the messages of the same fault (seconds)
+    static const double DefaultTimeout;
+    static const double DefaultGapThreshold;
+
+    // Constructors & Deconstructors
+    FaultEvaluator(double timeout = DefaultTimeout);
+
+    // Member Functions
+    void SetTimeout(double timeout);
+    void SetGapThreshold(double gap_threshold);
+    void SetResultFunction(const ResultFunction &function);
+    void AddGroundTruth(long long time, bool is_active = true, int channel = 0);
+    void AddDetection(long long time);
+    void AdvanceTo(long long time);
+    void Finish();
+    void Reset();
+    bool IsFaultActive() const;
+    const Summary &GetSummary() const;
+
+private:
+    // Local enum definitions
+    enum State                          // States of the evaluation
+    {
+        NoFault,                        // No fault is active or waiting for a detection
+        FaultPending,                   // A fault waits for a detection (until its timeout)
+        FaultReported                   // A fault is active and its result is reported
+    };
+
+    // Member Functions
+    void UpdateFaultActivity(long long time);
+    void Report(ResultType type, long long fault_time, long long detection_time);
+
+    // Data Members
+    long long timeout_ns;
+    long long max_gap_ns;
+    ResultFunction result_function;
+    State state = NoFault;
+    bool is_fault_active = false;       // Are the ground truth messages reporting the fault
+    long long fault_time = 0;           // Start of the current fault
+    std::vector<long long> channel_times;   // Last active ground truth message of each channel (-1 if inactive)
+    Summary summary;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The time allowed for the detection (the timeout parameter of alfa-evaluate) and the gap between the
+// fault messages of the same fault (as FaultTimeline::DefaultGapThreshold)
+const double FaultEvaluator::DefaultTimeout = 5.0;
+const double FaultEvaluator::DefaultGapThreshold = 1.0;
+
+// Constructor function for FaultEvaluator. Allows the given time (seconds) to detect each fault.
+FaultEvaluator::FaultEvaluator(double timeout)
+    : timeout_ns((long long)(timeout * 1e9)), max_gap_ns((long long)(DefaultGapThreshold * 1e9))
+{
+}
+
+// Set the time allowed to detect a fault after its start (seconds)
+void FaultEvaluator::SetTimeout(double timeout)
+{
+    timeout_ns = (long long)(timeout * 1e9);
+}
+
+// Set the largest gap between the ground truth messages of the same fault (seconds)
+void FaultEvaluator::SetGapThreshold(double gap_threshold)
+{
+    max_gap_ns = (long long)(gap_threshold * 1e9);
+}
+
+// Set a function that receives each result as soon as it is decided
+void FaultEvaluator::SetResultFunction(const ResultFunction &function)
+{
+    result_function = function;
+}
+
+// Process a ground truth message of a channel at the given time (nanoseconds). The active messages start
+// or continue a fault and the inactive ones end it unless another channel still reports it.
+void FaultEvaluator::AddGroundTruth(long long time, bool is_active, int channel)
+{
+    AdvanceTo(time);
+    if (channel < 0) channel = 0;
+    if (channel >= (int)channel_times.size()) channel_times.resize(channel + 1, -1);
+
+    if (!is_active)
+    {
+        channel_times[channel] = -1;
+        UpdateFaultActivity(time);
+        return;
+    }
+
+    UpdateFaultActivity(time);
+    channel_times[channel] = std::max(channel_times[channel], time);
+
+    if (!is_fault_active)
+    {
+        // A new fault starts (the previous one is missed if it still waits for a detection)
+        if (state == FaultPending) Report(Missed, fault_time, 0);
+        state = FaultPending;
+        fault_time = time;
+        is_fault_active = true;
+    }
+}
+
+// Process a detection at the given time (nanoseconds)
+void FaultEvaluator::AddDetection(long long time)
+{
+    AdvanceTo(time);
+    UpdateFaultActivity(time);
+
+    if (state == NoFault)
+        Report(FalsePositive, 0, time);
+    else if (state == FaultPending)
+    {
+        Report(Detected, fault_time, std::max(time, fault_time));
+        state = is_fault_active ? FaultReported : NoFault;
+    }
+}
+
+// Move the evaluation to the given time (nanoseconds), reporting the fault whose timeout has passed.
+// The events call it with their own times; a live evaluation also calls it periodically with the clock.
+void FaultEvaluator::AdvanceTo(long long time)
+{
+    if (state == FaultPending && time - fault_time > timeout_ns)
+    {
+        Report(Missed, fault_time, 0);
+        state = is_fault_active ? FaultReported : NoFault;
+    }
+}
+
+// Finish the evaluation at the end of the events: a fault waiting for its detection is reported as missed
+void FaultEvaluator::Finish()
+{
+    if (state == FaultPending) Report(Missed, fault_time, 0);
+    state = NoFault;
+    is_fault_active = false;
+    channel_times.assign(channel_times.size(), -1);
+}
+
+// Clear the state and the summary (the settings are kept)
+void FaultEvaluator::Reset()
+{
+    state = NoFault;
+    is_fault_active = false;
+    fault_time = 0;
+    channel_times.clear();
+    summary = Summary();
+}
+
+// Returns true if the ground truth reports an active fault
+bool FaultEvaluator::IsFaultActive() const
+{
+    return is_fault_active;
+}
+
+// Get the counts of the reported results
+const FaultEvaluator::Summary &FaultEvaluator::GetSummary() const
+{
+    return summary;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// End the active fault if none of the channels reports it anymore (the channels whose ground truth
+// messages have stopped for longer than the gap threshold are inactive)
+void FaultEvaluator::UpdateFaultActivity(long long time)
+{
+    if (!is_fault_active) return;
+    bool is_any_active = false;
+    for (long long &channel_time : channel_times)
+    {
+        if (channel_time >= 0 && time - channel_time > max_gap_ns) channel_time = -1;
+        if (channel_time >= 0) is_any_active = true;
+    }
+    if (is_any_active) return;
+    is_fault_active = false;
+    if (state == FaultReported) state = NoFault;
+}
+
+// Count a result and hand it to the result function
+void FaultEvaluator::Report(ResultType type, long long fault_time, long long detection_time)
+{
+    Result result;
+    result.Type = type;
+    result.FaultTime = fault_time;
+    result.DetectionTime = detection_time;
+    if (type == Detected)
+    {
+        result.Delay = detection_time - fault_time;
+        ++summary.NumDetected;
+        summary.TotalDelay += result.Delay;
+        summary.MaxDelay = std::max(summary.MaxDelay, result.Delay);
+    }
+    else if (type == Missed)
+        ++summary.NumMissed;
+    else
+        ++summary.NumFalsePositives;
+
+    if (result_function) result_function(result);
+}
+
+}
+#endif
@@ -0,0 +1,446 @@
+/*  ***************************************************************************
+*   export.h - Header for exporting (slices of) ALFA dataset sequences to CSV
+*   and TSV files.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_EXPORT_H
+#define ALFA_EXPORT_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include "commons.h"
+#include "message.h"
+#include "topic.h"
+#include "sequence.h"
+#include "threadpool.h"
+
+namespace alfa
+{
+
+// This class collects the output in a large buffer and writes it to a file in big chunks
+class BufferedWriter
+{
+public:
+
+    // Default size of the buffer (bytes)
+    static const size_t DefaultBufferSize;
+
+    // Constructors & Deconstructors
+    explicit BufferedWriter(size_t buffer_size = DefaultBufferSize);
+    ~BufferedWriter();
+
+    // Member Functions
+    bool Open(const std::string &filename);
+    bool Close();
+    bool IsOpen() const;
+    void Write(const char *data, size_t size);
+    void Write(const std::string &str);
+    void WriteChar(char c);
+    void WriteInteger(long long number);
+    bool Flush();
+
+private:
+    // The writer owns the file and cannot be copied
+    BufferedWriter(const BufferedWriter &);
+    BufferedWriter &operator=(const BufferedWriter &);
+
+    // Data Members
+    std::FILE *file = NULL;
+    std::vector<char> buffer;
+    size_t used = 0;
+    bool has_error = false;
+};
+
+// This class writes selected topics, fields and time ranges of a sequence to files with the same
+// layout as the original dataset (<sequence>-<topic>.csv), so the exported slices can be loaded
+// again with Sequence::LoadSequence. The field values are kept as text, so they are copied exactly.
+class SequenceExporter
+{
+public:
+
+    // Local enum definitions
+    enum FileFormat
+    {
+        CSV,                            // Comma-separated values (.csv), same as the dataset
+        TSV                             // Tab-separated values (.tsv)
+    };
+
+    // Constructors & Deconstructors
+    SequenceExporter(const Sequence &sequence);
+
+    // Member Functions
+    bool SelectTopic(const std::string &topic_name, const VecString &field_labels = VecString());
+    void SetTimeRange(double start_time, double end_time);
+    void SetFormat(FileFormat format);
+    void SetNumberOfThreads(int n_threads);
+    int Export(const std::string &output_dir, const std::string &sequence_name = "") const;
+    bool ExportTopic(int topic_idx, const std::string &filename) const;
+
+private:
+    // Local struct definitions
+    struct TopicSelection               // Structure for a selected topic
+    {
+        int TopicIdx = -1;
+        std::vector<bool> Fields;       // Selected fields of the topic (empty for all)
+    };
+
+    // Member Functions
+    const TopicSelection *FindSelection(int topic_idx) const;
+    void FindMessageRange(const Topic &topic, int &out_first, int &out_last) const;
+
+    // Data Members
+    const Sequence &sequence;
+    std::vector<TopicSelection> selections;     // Selected topics (empty for all)
+    double start_time = -1, end_time = -1;      // Time range relative to the start of the sequence (seconds)
+    FileFormat format = CSV;
+    int n_threads = 1;
+};
+
+/******************************************************************************/
+/******************** BufferedWriter Function Definitions *********************/
+/******************************************************************************/
+
+// The buffer is large enough to make the number of system calls negligible
+const size_t BufferedWriter::DefaultBufferSize = 1 << 20;
+
+// Constructor function for BufferedWriter
+BufferedWriter::BufferedWriter(size_t buffer_size)
+    : buffer(std::max(buffer_size, (size_t)64))
+{
+}
+
+// Destructor function for BufferedWriter. Writes the remaining data and closes the file.
+BufferedWriter::~BufferedWriter()
+{
+    Close();
+}
+
+// Open a file for writing (replaces the existing file). Returns false if it cannot be opened.
+bool BufferedWriter::Open(const std::string &filename)
+{
+    Close();
+    file = std::fopen(filename.c_str(), "wb");
+    if (file == NULL)
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return false;
+    }
+    used = 0;
+    has_error = false;
+    return true;
+}
+
+// Write the remaining data and close the file. Returns false if any of the writes failed.
+bool BufferedWriter::Close()
+{
+    if (file == NULL) return !has_error;
+
+    Flush();
+    if (std::fclose(file) != 0) has_error = true;
+    file = NULL;
+    return !has_error;
+}
+
+// Returns true if a file is open
+bool BufferedWriter::IsOpen() const
+{
+    return file != NULL;
+}
+
+// Add a block of data to the output
+void BufferedWriter::Write(const char *data, size_t size)
+{
+    // Write the large blocks directly
+    if (used + size > buffer.size())
+    {
+        Flush();
+        if (size > buffer.size())
+        {
+            if (file != NULL && std::fwrite(data, 1, size, file) != size) has_error = true;
+            return;
+        }
+    }
+
+    std::memcpy(&buffer[used], data, size);
+    used += size;
+}
+
+// Add a string to the output
+void BufferedWriter::Write(const std::string &str)
+{
+    Write(str.data(), str.size());
+}
+
+// Add a character to the output
+void BufferedWriter::WriteChar(char c)
+{
+    if (used == buffer.size()) Flush();
+    buffer[used++] = c;
+}
+
+// Add the decimal digits of an integer to the output
+void BufferedWriter::WriteInteger(long long number)
+{
+    // Fill the digits from the end of a small buffer
+    char digits[24];
+    int pos = sizeof(digits);
+    unsigned long long value = (number < 0) ? 0ULL - (unsigned long long)number : (unsigned long long)number;
+    do
+    {
+        digits[--pos] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    if (number < 0) digits[--pos] = '-';
+
+    Write(digits + pos, sizeof(digits) - pos);
+}
+
+// Write the buffered data to the file. Returns false if the write failed.
+bool BufferedWriter::Flush()
+{
+    if (file != NULL && used > 0 && std::fwrite(&buffer[0], 1, used, file) != used) has_error = true;
+    used = 0;
+    return !has_error;
+}
+
+/******************************************************************************/
+/******************* SequenceExporter Function Definitions ********************/
+/******************************************************************************/
+
+// Constructor function for SequenceExporter. The sequence should stay valid while exporting.
+SequenceExporter::SequenceExporter(const Sequence &sequence)
+    : sequence(sequence)
+{
+}
+
+// Select a topic (and optionally some of its fields) for exporting. If no topics are selected, all
+// the topics are exported with all their fields. Returns false if the topic or a field is not found.
+bool SequenceExporter::SelectTopic(const std::string &topic_name, const VecString &field_labels)
+{
+    int topic_idx = sequence.FindTopicIndex(topic_name);
+    if (topic_idx < 0)
+    {
+        std::cerr << "SelectTopic Error! Topic '" << topic_name << "' not found in the sequence." << std::endl;
+        return false;
+    }
+
+    TopicSelection selection;
+    selection.TopicIdx = topic_idx;
+    if (!field_labels.empty())
+    {
+        const Topic &topic = sequence.Topics[topic_idx];
+        selection.Fields.assign(topic.FieldLabels.size(), false);
+        for (int i = 0; i < (int)field_labels.size(); ++i)
+        {
+            int field_idx = topic.FindLabelIndex(field_labels[i]);
+            if (field_idx < 0)
+            {
+                std::cerr << "SelectTopic Error! Field '" << field_labels[i] << "' not found in '" << topic_name << "' topic." << std::endl;
+                return false;
+            }
+            selection.Fields[field_idx] = true;
+        }
+    }
+
+    selections.push_back(selection);
+    return true;
+}
+
+// Set the time range to export, in seconds since the first message of the sequence (both ends included).
+// Negative values leave that end of the range open.
+void SequenceExporter::SetTimeRange(double start_time, double end_time)
+{
+    this->start_time = start_time;
+    this->end_time = end_time;
+}
+
+// Set the format of the output files
+void SequenceExporter::SetFormat(FileFormat format)
+{
+    this->format = format;
+}
+
+// Set the number of topics exported at the same time (0 for one per core)
+void SequenceExporter::SetNumberOfThreads(int n_threads)
+{
+    this->n_threads = n_threads;
+}
+
+// Export the selected topics to <output_dir><sequence_name>-<topic>.csv (or .tsv) files. Uses the name
+// of the sequence if no name is given. Returns the number of exported topics, or -1 on errors.
+int SequenceExporter::Export(const std::string &output_dir, const std::string &sequence_name) const
+{
+    if (!sequence.IsInitialized())
+    {
+        std::cerr << "Export Error! The sequence is not initialized." << std::endl;
+        return -1;
+    }
+
+    // Find the topics to export
+    std::vector<int> topics;
+    for (int i = 0; i < (int)sequence.Topics.size(); ++i)
+        if (selections.empty() || FindSelection(i) != NULL)
+            topics.push_back(i);
+
+    std::string prefix = output_dir + (sequence_name.empty() ? sequence.Name : sequence_name) + "-";
+    std::string extension = (format == TSV) ? "tsv" : Commons::CSVFileExtension;
+
+    // Each topic is written to its own file, so the topics can be exported in parallel
+    std::atomic<int> n_exported(0);
+    std::atomic<bool> has_error(false);
+    {
+        ThreadPool pool(n_threads);
+        for (int i = 0; i < (int)topics.size(); ++i)
+        {
+            int topic_idx = topics[i];
+            pool.Submit([this, topic_idx, &prefix, &extension, &n_exported, &has_error]()
+            {
+                if (ExportTopic(topic_idx, prefix + sequence.Topics[topic_idx].Name + "." + extension))
+                    n_exported++;
+                else
+                    has_error = true;
+            });
+        }
+        pool.WaitAll();
+    }
+
+    return has_error ? -1 : (int)n_exported;
+}
+
+// Export the selected fields and the messages in the time range of a topic to a file.
+// Returns false if the file cannot be written.
+bool SequenceExporter::ExportTopic(int topic_idx, const std::string &filename) const
+{
+    if (topic_idx < 0 || topic_idx >= (int)sequence.Topics.size()) return false;
+    const Topic &topic = sequence.Topics[topic_idx];
+    const TopicSelection *selection = FindSelection(topic_idx);
+    char separator = (format == TSV) ? '\t' : Commons::CSVDelimiter;
+
+    // Find the content of each column in the original order of the file
+    enum ColumnType { TimeColumn, SeqColumn, StampColumn, FrameColumn, FieldColumn };
+    const VecString &labels = topic.GetOriginalFieldLabels();
+    std::vector<int> column_types, column_fields;
+    VecString column_labels;
+    int field_idx = 0;
+    for (int i = 0; i < (int)labels.size(); ++i)
+    {
+        int type = FieldColumn, curr_field = -1;
+        if (labels[i] == "%time") type = TimeColumn;
+        else if (labels[i] == Commons::CSVFieldsPrefix + "header.seq") type = SeqColumn;
+        else if (labels[i] == Commons::CSVFieldsPrefix + "header.stamp") type = StampColumn;
+        else if (labels[i] == Commons::CSVFieldsPrefix + "header.frame_id") type = FrameColumn;
+        else curr_field = field_idx++;
+
+        // Skip the fields that are not selected
+        if (type == FieldColumn && selection != NULL && !selection->Fields.empty() && !selection->Fields[curr_field]) continue;
+
+        column_types.push_back(type);
+        column_fields.push_back(curr_field);
+        column_labels.push_back(labels[i]);
+    }
+
+    BufferedWriter writer;
+    if (!writer.Open(filename)) return false;
+
+    // Write the header line
+    for (int c = 0; c < (int)column_labels.size(); ++c)
+    {
+        if (c > 0) writer.WriteChar(separator);
+        writer.Write(column_labels[c]);
+    }
+    writer.WriteChar('\n');
+
+    // Write the messages in the time range
+    int first_msg, last_msg;
+    FindMessageRange(topic, first_msg, last_msg);
+    for (int m = first_msg; m <= last_msg; ++m)
+    {
+        const Message &msg = topic.Messages[m];
+        for (int c = 0; c < (int)column_types.size(); ++c)
+        {
+            if (c > 0) writer.WriteChar(separator);
+            switch (column_types[c])
+            {
+            case TimeColumn: writer.WriteInteger(msg.DateTime.ToEpochNanoseconds()); break;
+            case SeqColumn: writer.WriteInteger(msg.Header.SequenceID); break;
+            case StampColumn: writer.WriteInteger(msg.Header.Stamp); break;
+            case FrameColumn: writer.Write(msg.Header.FrameID); break;
+            default:
+                if (column_fields[c] < (int)msg.Fields.size()) writer.Write(msg.Fields[column_fields[c]]);
+            }
+        }
+        writer.WriteChar('\n');
+    }
+
+    if (!writer.Close())
+    {
+        std::cerr << "Export Error! Failed to write '" << filename << "' file." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Find the selection of a topic. Returns NULL if the topic is not selected.
+const SequenceExporter::TopicSelection *SequenceExporter::FindSelection(int topic_idx) const
+{
+    for (int i = 0; i < (int)selections.size(); ++i)
+        if (selections[i].TopicIdx == topic_idx)
+            return &selections[i];
+    return NULL;
+}
+
+// Find the first and the last messages of a topic in the time range (the last is before the first if none)
+void SequenceExporter::FindMessageRange(const Topic &topic, int &out_first, int &out_last) const
+{
+    out_first = 0;
+    out_last = (int)topic.Messages.size() - 1;
+    if (sequence.MessageIndexList.empty()) return;
+
+    // The messages of a topic are sorted by time, so the range ends are found by binary search
+    long long sequence_start = sequence.GetMessage(0).DateTime.ToNanoseconds();
+    std::vector<Message>::const_iterator begin = topic.Messages.begin(), end = topic.Messages.end();
+    if (start_time >= 0)
+    {
+        DateTime start = DateTime::NanosecondsToTime(sequence_start + (long long)(start_time * 1e9));
+        out_first = (int)(std::lower_bound(begin, end, start,
+            [](const Message &msg, const DateTime &dt) { return msg.DateTime < dt; }) - begin);
+    }
+    if (end_time >= 0)
+    {
+        DateTime end_dt = DateTime::NanosecondsToTime(sequence_start + (long long)(end_time * 1e9));
+        out_last = (int)(std::upper_bound(begin, end, end_dt,
+            [](const DateTime &dt, const Message &msg) { return dt < msg.DateTime; }) - begin) - 1;
+    }
+}
+
+}
+#endif
@@ -0,0 +1,292 @@
+/*  ***************************************************************************
+*   faults.h - Header for the fault ground truth timeline of ALFA dataset
+*   sequences.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_FAULTS_H
+#define ALFA_FAULTS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "commons.h"
+#include "topic.h"
+
+namespace alfa
+{
+
+// This class keeps the fault intervals of a sequence for each fault channel (engines, aileron, rudder,
+// elevator, etc.). The intervals are built from the messages of the failure_status topics: consecutive
+// fault messages belong to the same interval unless they are farther apart than the gap threshold.
+// All the times are in nanoseconds (see DateTime::ToNanoseconds).
+class FaultTimeline
+{
+public:
+
+    // Local struct definitions
+    struct Interval                     // Structure for a fault interval (both ends included)
+    {
+        long long Onset = 0;            // Time of the first fault message
+        long long Offset = 0;           // Time of the last fault message
+    };
+
+    struct Channel                      // Structure for the intervals of a fault channel
+    {
+        std::string Name;               // Topic name without the fault topic prefix (e.g., "engines")
+        int TopicIdx = -1;              // Index of the failure_status topic in the sequence
+        std::vector<Interval> Intervals;
+    };
+
+    // Default largest gap between the messages of the same fault interval (seconds)
+    static const double DefaultGapThreshold;
+
+    // Member Functions
+    void Build(const std::vector<Topic> &topics, double gap_threshold = DefaultGapThreshold);
+    void Clear();
+    bool HasFault() const;
+    int GetNumberOfChannels() const;
+    const Channel &GetChannel(int channel_idx) const;
+    int FindChannel(const std::string &channel_name) const;
+    long long GetOnset(int channel_idx = -1) const;
+    long long GetOffset(int channel_idx = -1) const;
+    bool IsFaultAt(long long time, int channel_idx = -1) const;
+    std::vector<unsigned char> GetLabels(const std::vector<long long> &times, int channel_idx = -1) const;
+    std::vector<unsigned int> GetChannelMasks(const std::vector<long long> &times) const;
+    static bool IsActiveMessage(const Message &msg);
+
+private:
+    // Member Functions
+    const std::vector<Interval> *GetIntervals(int channel_idx) const;
+
+    // Data Members
+    std::vector<Channel> channels;
+    std::vector<Interval> all_intervals;        // Union of the intervals of all the channels
+    std::map<std::string, int> channel_map;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The fault topics are published a few times per second while the fault is active
+const double FaultTimeline::DefaultGapThreshold = 1.0;
+
+// Build the fault intervals from the fault topics of a sequence
+void FaultTimeline::Build(const std::vector<Topic> &topics, double gap_threshold)
+{
+    Clear();
+    long long max_gap = (long long)(gap_threshold * 1e9);
+
+    for (int t = 0; t < (int)topics.size(); ++t)
+    {
+        if (!topics[t].IsFaultTopic()) continue;
+
+        // Name the channel after the topic (failure_status-engines -> engines)
+        Channel channel;
+        channel.TopicIdx = t;
+        channel.Name = topics[t].Name.substr(Commons::FaultTopicPrefix.length());
+        if (!channel.Name.empty() && (channel.Name[0] == '-' || channel.Name[0] == '_'))
+            channel.Name = channel.Name.substr(1);
+
+        // Group the active fault messages into intervals
+        bool is_open = false;
+        for (int i = 0; i < (int)topics[t].Messages.size(); ++i)
+        {
+            const Message &msg = topics[t].Messages[i];
+            if (!IsActiveMessage(msg))
+            {
+                is_open = false;
+                continue;
+            }
+
+            long long time = msg.DateTime.ToNanoseconds();
+            if (is_open && time - channel.Intervals.back().Offset <= max_gap)
+                channel.Intervals.back().Offset = std::max(channel.Intervals.back().Offset, time);
+            else
+            {
+                Interval interval;
+                interval.Onset = interval.Offset = time;
+                channel.Intervals.push_back(interval);
+                is_open = true;
+            }
+        }
+
+        channel_map.insert(std::make_pair(channel.Name, (int)channels.size()));
+        channels.push_back(channel);
+    }
+
+    // Merge the intervals of all the channels
+    for (int c = 0; c < (int)channels.size(); ++c)
+        all_intervals.insert(all_intervals.end(), channels[c].Intervals.begin(), channels[c].Intervals.end());
+    std::sort(all_intervals.begin(), all_intervals.end(),
+        [](const Interval &a, const Interval &b) { return a.Onset < b.Onset; });
+
+    std::vector<Interval> merged;
+    for (int i = 0; i < (int)all_intervals.size(); ++i)
+    {
+        if (!merged.empty() && all_intervals[i].Onset <= merged.back().Offset)
+            merged.back().Offset = std::max(merged.back().Offset, all_intervals[i].Offset);
+        else
+            merged.push_back(all_intervals[i]);
+    }
+    all_intervals.swap(merged);
+}
+
+// Remove all the channels
+void FaultTimeline::Clear()
+{
+    channels.clear();
+    all_intervals.clear();
+    channel_map.clear();
+}
+
+// Returns true if there is at least one fault interval
+bool FaultTimeline::HasFault() const
+{
+    return !all_intervals.empty();
+}
+
+// Get the number of fault channels (the fault topics of the sequence)
+int FaultTimeline::GetNumberOfChannels() const
+{
+    return (int)channels.size();
+}
+
+// Get a fault channel by index
+const FaultTimeline::Channel &FaultTimeline::GetChannel(int channel_idx) const
+{
+    return channels[channel_idx];
+}
+
+// Find the index of a fault channel by its name (e.g., "engines"). Returns -1 if not found.
+int FaultTimeline::FindChannel(const std::string &channel_name) const
+{
+    std::map<std::string, int>::const_iterator it = channel_map.find(channel_name);
+
+    // Return -1 if not found
+    if (it == channel_map.end()) return -1;
+
+    return it->second;
+}
+
+// Get the time of the first fault of a channel (or of any channel for -1). Returns -1 if there is no fault.
+long long FaultTimeline::GetOnset(int channel_idx) const
+{
+    const std::vector<Interval> *intervals = GetIntervals(channel_idx);
+    if (intervals == NULL || intervals->empty()) return -1;
+    return intervals->front().Onset;
+}
+
+// Get the time of the last fault message of a channel (or of any channel for -1). Returns -1 if there is no fault.
+long long FaultTimeline::GetOffset(int channel_idx) const
+{
+    const std::vector<Interval> *intervals = GetIntervals(channel_idx);
+    if (intervals == NULL || intervals->empty()) return -1;
+    return intervals->back().Offset;
+}
+
+// Returns true if a channel (or any channel for -1) is faulty at the given time
+bool FaultTimeline::IsFaultAt(long long time, int channel_idx) const
+{
+    const std::vector<Interval> *intervals = GetIntervals(channel_idx);
+    if (intervals == NULL) return false;
+
+    // Find the first interval that has not ended before the time
+    std::vector<Interval>::const_iterator it = std::lower_bound(intervals->begin(), intervals->end(), time,
+        [](const Interval &interval, long long t) { return interval.Offset < t; });
+    return it != intervals->end() && it->Onset <= time;
+}
+
+// Get the fault label (1 for faulty, 0 for normal) of a channel (or any channel for -1) at each of the
+// given times. Sorted times are labeled in a single pass; unsorted times are also handled, but slower.
+std::vector<unsigned char> FaultTimeline::GetLabels(const std::vector<long long> &times, int channel_idx) const
+{
+    std::vector<unsigned char> labels(times.size(), 0);
+    const std::vector<Interval> *intervals = GetIntervals(channel_idx);
+    if (intervals == NULL || intervals->empty()) return labels;
+
+    const Interval *begin = intervals->data(), *end = begin + intervals->size();
+    const Interval *curr = begin;
+    long long prev_time = times.empty() ? 0 : times[0];
+    for (size_t i = 0; i < times.size(); ++i)
+    {
+        long long time = times[i];
+
+        // Go back to the right interval if the times are not sorted
+        if (time < prev_time)
+            curr = std::lower_bound(begin, end, time, [](const Interval &interval, long long t) { return interval.Offset < t; });
+        prev_time = time;
+
+        // Skip the intervals that ended before the time
+        while (curr != end && curr->Offset < time) ++curr;
+        labels[i] = (curr != end && curr->Onset <= time);
+    }
+
+    return labels;
+}
+
+// Get a bit mask of the faulty channels at each of the given times (bit i is set if channel i is faulty).
+// Only the first 32 channels are reported.
+std::vector<unsigned int> FaultTimeline::GetChannelMasks(const std::vector<long long> &times) const
+{
+    std::vector<unsigned int> masks(times.size(), 0);
+    for (int c = 0; c < (int)channels.size() && c < 32; ++c)
+    {
+        if (channels[c].Intervals.empty()) continue;
+        std::vector<unsigned char> labels = GetLabels(times, c);
+        for (size_t i = 0; i < times.size(); ++i)
+            masks[i] |= (unsigned int)labels[i] << c;
+    }
+    return masks;
+}
+
+// Check if a fault message reports an active fault. The messages without a value or with a
+// value other than false/0 are considered active.
+bool FaultTimeline::IsActiveMessage(const Message &msg)
+{
+    if (msg.Fields.empty()) return true;
+
+    const std::string &value = msg.Fields[0];
+    if (value == "False" || value == "false") return false;
+
+    double number = 0;
+    if (!value.empty() && Commons::StringToDouble(value, number) && number == 0) return false;
+
+    return true;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Get the intervals of a channel or the merged intervals for -1. Returns NULL for invalid indices.
+const std::vector<FaultTimeline::Interval> *FaultTimeline::GetIntervals(int channel_idx) const
+{
+    if (channel_idx == -1) return &all_intervals;
+    if (channel_idx < 0 || channel_idx >= (int)channels.size()) return NULL;
+    return &channels[channel_idx].Intervals;
+}
+
+}
+#endif
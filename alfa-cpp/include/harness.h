@@ -0,0 +1,293 @@
+/*  ***************************************************************************
+*   harness.h - Header for evaluating fault detectors on many ALFA dataset
+*   sequences in parallel.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_HARNESS_H
+#define ALFA_HARNESS_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include "commons.h"
+#include "sequence.h"
+#include "threadpool.h"
+
+namespace alfa
+{
+
+// This class evaluates a set of fault detectors on a set of sequences. Every (detector, sequence)
+// pair is a separate task on a work-stealing thread pool. Each sequence is loaded once, shared
+// read-only by the tasks of all the detectors and released after the last one is finished.
+class DetectorHarness
+{
+public:
+
+    // A detector processes a sequence and returns the indices of the messages (in the sequence
+    // message list) at which it raised an alarm, in increasing order
+    typedef std::function<std::vector<int>(const Sequence &)> DetectorFunction;
+
+    // Local struct definitions
+    struct Result                       // Structure for the result of a detector on a sequence
+    {
+        std::string DetectorName;
+        std::string SequenceName;
+        bool IsLoaded = false;          // False if the sequence could not be loaded
+        bool HasFault = false;          // True if the sequence has a fault ground truth
+        double FaultTime = -1;          // Time of the first fault message since the start (seconds)
+        double DetectionTime = -1;      // Time of the first alarm at or after the fault (seconds)
+        double DetectionDelay = -1;     // Time from the fault until it was detected (seconds)
+        int FalseAlarms = 0;            // Number of alarms before the fault (or in a no-fault sequence)
+        double RunTime = 0;             // Time spent in the detector (seconds)
+    };
+
+    // Constructors & Deconstructors
+    DetectorHarness(int n_threads = 0);
+
+    // Member Functions
+    int AddDetector(const std::string &name, const DetectorFunction &detector);
+    int AddSequence(const std::string &sequence_dir, const std::string &sequence_name);
+    bool Run();
+    const std::vector<Result> &GetResults() const;
+    void PrintReport(std::ostream &os = std::cout) const;
+    double GetWallTime() const;
+
+private:
+    // Local struct definitions
+    struct DetectorInfo                 // Structure for a registered detector
+    {
+        std::string Name;
+        DetectorFunction Function;
+    };
+
+    struct SequenceInfo                 // Structure for a registered sequence
+    {
+        std::string DirectoryPath;
+        std::string Name;
+        std::unique_ptr<Sequence> Data;                 // Loaded sequence (shared by the detector tasks)
+        std::unique_ptr<std::atomic<int> > Remaining;   // Number of unfinished detector tasks
+    };
+
+    // Member Functions
+    void LoadSequenceTask(int sequence_idx);
+    void DetectorTask(int sequence_idx, int detector_idx);
+
+    // Data Members
+    int n_threads;
+    std::vector<DetectorInfo> detectors;
+    std::vector<SequenceInfo> sequences;
+    std::vector<Result> results;                        // Results in sequence-major order
+    ThreadPool *pool = NULL;
+    double wall_time = 0;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for DetectorHarness. Uses one thread per core if the number of threads is not given.
+DetectorHarness::DetectorHarness(int n_threads)
+    : n_threads(n_threads)
+{
+}
+
+// Register a detector. Returns the index of the detector.
+int DetectorHarness::AddDetector(const std::string &name, const DetectorFunction &detector)
+{
+    DetectorInfo info;
+    info.Name = name;
+    info.Function = detector;
+    detectors.push_back(info);
+    return (int)detectors.size() - 1;
+}
+
+// Register a sequence (it is loaded when running). Returns the index of the sequence.
+int DetectorHarness::AddSequence(const std::string &sequence_dir, const std::string &sequence_name)
+{
+    SequenceInfo info;
+    info.DirectoryPath = sequence_dir;
+    info.Name = sequence_name;
+    info.Remaining.reset(new std::atomic<int>(0));
+    sequences.push_back(std::move(info));
+    return (int)sequences.size() - 1;
+}
+
+// Run all the detectors on all the sequences. Returns false if there is nothing to run.
+bool DetectorHarness::Run()
+{
+    if (detectors.empty() || sequences.empty())
+    {
+        std::cerr << "Run Error! At least one detector and one sequence are needed." << std::endl;
+        return false;
+    }
+
+    // Prepare the result slots, so the tasks can fill them without locking
+    results.assign(sequences.size() * detectors.size(), Result());
+    for (int s = 0; s < (int)sequences.size(); ++s)
+        for (int d = 0; d < (int)detectors.size(); ++d)
+        {
+            results[s * detectors.size() + d].SequenceName = sequences[s].Name;
+            results[s * detectors.size() + d].DetectorName = detectors[d].Name;
+        }
+
+    // Loading a sequence is a task that submits the detector tasks for that sequence
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        ThreadPool thread_pool(n_threads);
+        pool = &thread_pool;
+        for (int s = 0; s < (int)sequences.size(); ++s)
+            thread_pool.Submit(std::bind(&DetectorHarness::LoadSequenceTask, this, s));
+        thread_pool.WaitAll();
+        pool = NULL;
+    }
+    wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return true;
+}
+
+// Get the results of the last run in sequence-major order
+const std::vector<DetectorHarness::Result> &DetectorHarness::GetResults() const
+{
+    return results;
+}
+
+// Print the results of all the pairs and a summary for each detector
+void DetectorHarness::PrintReport(std::ostream &os) const
+{
+    int n_detectors = (int)detectors.size();
+
+    os << std::left << std::setw(24) << "Detector" << std::setw(48) << "Sequence" << std::right << std::setw(10) << "Fault" <<
+        std::setw(10) << "Detected" << std::setw(10) << "Delay" << std::setw(8) << "FA" << std::setw(10) << "Run" << std::endl;
+    os << std::fixed << std::setprecision(2);
+    for (int i = 0; i < (int)results.size(); ++i)
+    {
+        const Result &res = results[i];
+        os << std::left << std::setw(24) << res.DetectorName << std::setw(48) << res.SequenceName << std::right;
+        if (!res.IsLoaded)
+        {
+            os << std::setw(10) << "N/A" << "  (Sequence could not be loaded)" << std::endl;
+            continue;
+        }
+
+        os << std::setw(10);
+        if (res.HasFault) os << res.FaultTime; else os << "-";
+        os << std::setw(10);
+        if (res.DetectionTime >= 0) os << res.DetectionTime; else os << "-";
+        os << std::setw(10);
+        if (res.DetectionDelay >= 0) os << res.DetectionDelay; else os << "-";
+        os << std::setw(8) << res.FalseAlarms << std::setw(10) << res.RunTime << std::endl;
+    }
+
+    // Summarize the detectors over all the sequences
+    os << std::endl << "Summary:" << std::endl;
+    for (int d = 0; d < n_detectors; ++d)
+    {
+        int n_faults = 0, n_detected = 0, n_false_alarms = 0;
+        double total_delay = 0;
+        for (int s = 0; s < (int)sequences.size(); ++s)
+        {
+            const Result &res = results[s * n_detectors + d];
+            if (!res.IsLoaded) continue;
+            if (res.HasFault) ++n_faults;
+            if (res.DetectionDelay >= 0) { ++n_detected; total_delay += res.DetectionDelay; }
+            n_false_alarms += res.FalseAlarms;
+        }
+
+        os << std::left << std::setw(24) << detectors[d].Name << std::right << "Detected " << n_detected << "/" << n_faults <<
+            " faults, mean delay ";
+        if (n_detected > 0) os << total_delay / n_detected << " secs"; else os << "-";
+        os << ", false alarms " << n_false_alarms << std::endl;
+    }
+    os << std::endl << "Total wall time: " << wall_time << " secs" << std::endl;
+}
+
+// Get the wall time of the last run in seconds
+double DetectorHarness::GetWallTime() const
+{
+    return wall_time;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Load a sequence and submit the tasks of all the detectors for it
+void DetectorHarness::LoadSequenceTask(int sequence_idx)
+{
+    SequenceInfo &info = sequences[sequence_idx];
+    info.Data.reset(new Sequence(info.DirectoryPath, info.Name));
+    if (!info.Data->IsInitialized())
+    {
+        info.Data.reset();
+        return;
+    }
+
+    // The last detector task releases the sequence
+    info.Remaining->store((int)detectors.size());
+    for (int d = 0; d < (int)detectors.size(); ++d)
+        pool->Submit(std::bind(&DetectorHarness::DetectorTask, this, sequence_idx, d));
+}
+
+// Run a detector on a loaded sequence and evaluate its alarms against the fault ground truth
+void DetectorHarness::DetectorTask(int sequence_idx, int detector_idx)
+{
+    SequenceInfo &info = sequences[sequence_idx];
+    const Sequence &sequence = *info.Data;
+    Result &res = results[sequence_idx * detectors.size() + detector_idx];
+    res.IsLoaded = true;
+
+    // Run the detector
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<int> alarms = detectors[detector_idx].Function(sequence);
+    res.RunTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Alarms before the first fault message are false alarms, the first one after it is the detection
+    int fault_idx = sequence.FindFirstFaultMessage();
+    res.HasFault = (fault_idx >= 0);
+    DateTime start_time = sequence.GetMessage(0).DateTime;
+    if (res.HasFault) res.FaultTime = sequence.GetMessage(fault_idx).DateTime - start_time;
+
+    for (int i = 0; i < (int)alarms.size(); ++i)
+    {
+        if (!res.HasFault || alarms[i] < fault_idx)
+            res.FalseAlarms++;
+        else
+        {
+            res.DetectionTime = sequence.GetMessage(alarms[i]).DateTime - start_time;
+            res.DetectionDelay = res.DetectionTime - res.FaultTime;
+            break;
+        }
+    }
+
+    // Release the sequence after its last detector
+    if (info.Remaining->fetch_sub(1) == 1)
+        info.Data.reset();
+}
+
+}
+#endif
@@ -0,0 +1,643 @@
+/*  ***************************************************************************
+*   ingest.h - Header for reading many ALFA dataset files at once with batched
+*   I/O (io_uring on Linux, or readahead hints and a thread pool).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_INGEST_H
+#define ALFA_INGEST_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <cerrno>
+#include <cstring>
+#include "commons.h"
+#include "threadpool.h"
+
+#if defined __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+// The io_uring reads only need the kernel headers (see the ALFA_USE_IO_URING option of CMakeLists.txt)
+#if defined __linux__ && defined ALFA_USE_IO_URING
+#define ALFA_INGEST_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+namespace alfa
+{
+
+// This class reads a list of files at once and hands the contents of each file to a callback as soon as
+// it is read, so the parsing of the first files overlaps with the reading of the others. With io_uring,
+// the reads of up to the queue depth of files are submitted to the kernel together and the callbacks run
+// on a thread pool. Otherwise (or if the kernel does not allow io_uring), the kernel is asked to read ahead
+// the next files (posix_fadvise) while the threads of the pool read and process the current ones.
+class FileIngestor
+{
+public:
+
+    // A callback processes the contents of a file given its index in the list. The callbacks may run on
+    // several threads at once, and they may take the contents (e.g., with std::move).
+    typedef std::function<void(int, std::string &)> FileFunction;
+
+    // Local enum definitions
+    enum ReadMethod                     // How the files are read
+    {
+        IOUring,                        // Reads submitted together with io_uring
+        ReadaheadThreads                // Readahead hints and reads on the threads of a pool
+    };
+
+    // Reads in flight with io_uring (and files read ahead otherwise) by default
+    static const int DefaultQueueDepth;
+
+    // Constructors & Deconstructors
+    FileIngestor(int n_threads = 0);
+
+    // Member Functions
+    int AddFile(const std::string &path);
+    void Clear();
+    int GetNumberOfFiles() const;
+    const std::string &GetFilePath(int file_idx) const;
+    void SetQueueDepth(int queue_depth);
+    void SetNumberOfThreads(int n_threads);
+    void SetUseIOUring(bool use_io_uring);
+    int ReadAll(const FileFunction &process);
+    ReadMethod GetLastReadMethod() const;
+    size_t GetBytesRead() const;
+    const std::vector<int> &GetFailedFiles() const;
+    static bool IsIOUringAvailable();
+    static bool EvictFromPageCache(const std::string &path);
+
+private:
+#if defined ALFA_INGEST_IO_URING
+    // Local struct definitions
+    struct SubmissionRing               // Structure for the mapped rings of an io_uring instance
+    {
+        int Fd = -1;
+        unsigned *SQHead = NULL, *SQTail = NULL, *SQMask = NULL, *SQArray = NULL;
+        unsigned *CQHead = NULL, *CQTail = NULL, *CQMask = NULL;
+        io_uring_sqe *SQEs = NULL;
+        io_uring_cqe *CQEs = NULL;
+        void *SQPtr = NULL, *CQPtr = NULL;
+        size_t SQSize = 0, CQSize = 0, SQEsSize = 0;
+        unsigned NumberOfPending = 0;   // Entries added since the last submission
+    };
+
+    struct PendingFile                  // Structure for a file being read with io_uring
+    {
+        int Fd = -1;
+        std::string Data;
+        size_t Offset = 0;
+    };
+
+    // Member Functions
+    int ReadWithIOUring(const FileFunction &process, ThreadPool &pool, std::vector<int> &out_unfinished);
+    static bool SetupRing(unsigned entries, SubmissionRing &out_ring);
+    static void CloseRing(SubmissionRing &ring);
+    static void QueueRead(SubmissionRing &ring, int file_idx, PendingFile &file);
+    static bool SubmitAndWait(SubmissionRing &ring, unsigned n_wait);
+    static bool DrainRing(SubmissionRing &ring, unsigned n_submitted);
+#endif
+    int ReadWithThreads(const FileFunction &process, ThreadPool &pool, const std::vector<int> &file_indices);
+    static void AdviseReadahead(const std::string &path);
+    static bool ReadWholeFile(const std::string &path, std::string &out_data);
+
+    // Data Members
+    VecString file_paths;
+    int queue_depth;
+    int n_threads;
+    bool use_io_uring = true;
+    ReadMethod last_method = ReadaheadThreads;
+    std::atomic<size_t> bytes_read;
+
+    // Files read by the last ReadAll (each file is only marked by the thread that reads it) and the failed ones
+    std::vector<char> is_file_read;
+    std::vector<int> failed_files;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+const int FileIngestor::DefaultQueueDepth = 32;
+
+// Constructor function for FileIngestor. Processes the files on one thread per core if the number of
+// threads is not given.
+FileIngestor::FileIngestor(int n_threads)
+    : queue_depth(DefaultQueueDepth), n_threads(n_threads), bytes_read(0)
+{
+}
+
+// Add a file to the end of the list. Returns the index of the file.
+int FileIngestor::AddFile(const std::string &path)
+{
+    file_paths.push_back(path);
+    return (int)file_paths.size() - 1;
+}
+
+// Remove all the files from the list
+void FileIngestor::Clear()
+{
+    file_paths.clear();
+}
+
+// Get the number of files in the list
+int FileIngestor::GetNumberOfFiles() const
+{
+    return (int)file_paths.size();
+}
+
+// Get the path of a file in the list
+const std::string &FileIngestor::GetFilePath(int file_idx) const
+{
+    return file_paths[file_idx];
+}
+
+// Set the number of reads in flight with io_uring, or the number of files read ahead otherwise (at least one).
+// A deeper queue keeps more files in memory at once.
+void FileIngestor::SetQueueDepth(int queue_depth)
+{
+    this->queue_depth = std::max(1, queue_depth);
+}
+
+// Set the number of threads for processing the files (0 for one per core, the default)
+void FileIngestor::SetNumberOfThreads(int n_threads)
+{
+    this->n_threads = n_threads;
+}
+
+// Set if io_uring is used when it is available (the default)
+void FileIngestor::SetUseIOUring(bool use_io_uring)
+{
+    this->use_io_uring = use_io_uring;
+}
+
+// Read all the files of the list and process the contents of each one with the callback. The files that
+// cannot be read are skipped with an error (see GetFailedFiles). Returns the number of files read and processed.
+int FileIngestor::ReadAll(const FileFunction &process)
+{
+    bytes_read = 0;
+    is_file_read.assign(file_paths.size(), 0);
+    failed_files.clear();
+    if (file_paths.empty()) return 0;
+
+    ThreadPool pool(n_threads);
+    int n_read = -1;
+#if defined ALFA_INGEST_IO_URING
+    // Fall back to the threads if the kernel does not allow io_uring (e.g., blocked in a container), and
+    // read the files left by a failed ring on the threads
+    if (use_io_uring)
+    {
+        std::vector<int> unfinished;
+        n_read = ReadWithIOUring(process, pool, unfinished);
+        if (n_read >= 0)
+        {
+            last_method = IOUring;
+            if (!unfinished.empty()) n_read += ReadWithThreads(process, pool, unfinished);
+        }
+    }
+#endif
+    if (n_read < 0)
+    {
+        std::vector<int> file_indices(file_paths.size());
+        for (int i = 0; i < (int)file_indices.size(); ++i)
+            file_indices[i] = i;
+        last_method = ReadaheadThreads;
+        n_read = ReadWithThreads(process, pool, file_indices);
+    }
+
+    // Report the files that could not be read
+    for (int i = 0; i < (int)file_paths.size(); ++i)
+        if (!is_file_read[i]) failed_files.push_back(i);
+    if (!failed_files.empty())
+        std::cerr << "ReadAll Error! " << failed_files.size() << " of " << file_paths.size() << " files could not be read." << std::endl;
+    return n_read;
+}
+
+// Get the method used by the last ReadAll
+FileIngestor::ReadMethod FileIngestor::GetLastReadMethod() const
+{
+    return last_method;
+}
+
+// Get the number of bytes read by the last ReadAll
+size_t FileIngestor::GetBytesRead() const
+{
+    return bytes_read;
+}
+
+// Get the indices of the files that could not be read by the last ReadAll
+const std::vector<int> &FileIngestor::GetFailedFiles() const
+{
+    return failed_files;
+}
+
+// Returns true if the files can be read with io_uring (it is built in and the kernel allows it)
+bool FileIngestor::IsIOUringAvailable()
+{
+#if defined ALFA_INGEST_IO_URING
+    static const bool is_available = []()
+    {
+        SubmissionRing ring;
+        if (!SetupRing(1, ring)) return false;
+        CloseRing(ring);
+        return true;
+    }();
+    return is_available;
+#else
+    return false;
+#endif
+}
+
+// Drop the cached pages of a file, so the next read comes from the disk (e.g., for measuring the reading
+// on a cold page cache). Returns false if it is not supported.
+bool FileIngestor::EvictFromPageCache(const std::string &path)
+{
+#if defined __linux__
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool is_evicted = (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+    close(fd);
+    return is_evicted;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+#if defined ALFA_INGEST_IO_URING
+// Read the files with io_uring, keeping up to the queue depth of reads in flight, and process each file on
+// the pool once it is read. If the ring fails, the files that are not read yet are given in out_unfinished.
+// Returns the number of files read, or -1 if io_uring cannot be set up.
+int FileIngestor::ReadWithIOUring(const FileFunction &process, ThreadPool &pool, std::vector<int> &out_unfinished)
+{
+    // The files are created before the ring, so their buffers outlive the reads
+    std::unique_ptr<std::vector<PendingFile> > file_list(new std::vector<PendingFile>(file_paths.size()));
+    std::vector<PendingFile> &files = *file_list;
+    SubmissionRing ring;
+    if (!SetupRing((unsigned)queue_depth, ring)) return -1;
+
+    std::atomic<int> n_read(0);
+    int next_file = 0, n_in_flight = 0;
+    bool is_ring_failed = false;
+    std::function<void(int)> finish_file = [this, &process, &pool, &files, &n_read](int file_idx)
+    {
+        close(files[file_idx].Fd);
+        files[file_idx].Fd = -1;
+        is_file_read[file_idx] = 1;
+        bytes_read += files[file_idx].Data.size();
+        pool.Submit([&process, &files, &n_read, file_idx]()
+        {
+            process(file_idx, files[file_idx].Data);
+            std::string().swap(files[file_idx].Data);
+            ++n_read;
+        });
+    };
+
+    while (next_file < (int)files.size() || n_in_flight > 0)
+    {
+        // Open the next files and queue their reads while there is room in the ring
+        while (next_file < (int)files.size() && n_in_flight < queue_depth)
+        {
+            int file_idx = next_file++;
+            PendingFile &file = files[file_idx];
+            struct stat file_stat;
+            file.Fd = open(file_paths[file_idx].c_str(), O_RDONLY | O_CLOEXEC);
+            if (file.Fd < 0 || fstat(file.Fd, &file_stat) != 0)
+            {
+                std::cerr << "Failed to open '" << file_paths[file_idx] << "' file." << std::endl;
+                if (file.Fd >= 0) close(file.Fd);
+                file.Fd = -1;
+                continue;
+            }
+            file.Data.resize((size_t)file_stat.st_size);
+            if (file.Data.empty())
+                finish_file(file_idx);
+            else
+            {
+                QueueRead(ring, file_idx, file);
+                ++n_in_flight;
+            }
+        }
+        if (n_in_flight == 0) continue;
+
+        // Submit the queued reads and wait for at least one of them
+        if (!SubmitAndWait(ring, 1))
+        {
+            std::cerr << "ReadAll Error! io_uring failed (" << std::strerror(errno) << "). The rest of the files "
+                "are read on the threads." << std::endl;
+            is_ring_failed = true;
+            break;
+        }
+
+        // Take the finished reads. The short reads are queued again for the rest of the file.
+        unsigned head = *ring.CQHead;
+        while (head != __atomic_load_n(ring.CQTail, __ATOMIC_ACQUIRE))
+        {
+            const io_uring_cqe &cqe = ring.CQEs[head & *ring.CQMask];
+            int file_idx = (int)cqe.user_data, result = cqe.res;
+            __atomic_store_n(ring.CQHead, ++head, __ATOMIC_RELEASE);
+            --n_in_flight;
+
+            PendingFile &file = files[file_idx];
+            if (result == -EINTR || result == -EAGAIN)
+                result = 0;
+            else if (result < 0)
+            {
+                // Older kernels do not support the plain reads, so the file is read directly
+                bool is_read = (result == -EINVAL) && ReadWholeFile(file_paths[file_idx], file.Data);
+                if (!is_read)
+                {
+                    std::cerr << "Failed to read '" << file_paths[file_idx] << "' file." << std::endl;
+                    close(file.Fd);
+                    file.Fd = -1;
+                    std::string().swap(file.Data);
+                    continue;
+                }
+                result = (int)(file.Data.size() - file.Offset);
+            }
+            else if (result == 0)
+                file.Data.resize(file.Offset);  // The file was truncated while being read
+
+            file.Offset += (size_t)result;
+            if (file.Offset >= file.Data.size())
+                finish_file(file_idx);
+            else
+            {
+                QueueRead(ring, file_idx, file);
+                ++n_in_flight;
+            }
+        }
+    }
+
+    // After a failure, wait for the reads that the kernel has taken (the queued reads that were not submitted
+    // never start), so their buffers are not released under them
+    if (is_ring_failed && !DrainRing(ring, (unsigned)n_in_flight - ring.NumberOfPending))
+    {
+        std::cerr << "ReadAll Error! Failed to wait for the reads in flight (" << std::strerror(errno) << ")." << std::endl;
+        file_list.release();    // The kernel may still write to the buffers, so they are never freed
+    }
+
+    // Close the ring and give the files that are open or not opened yet to the threads
+    CloseRing(ring);
+    for (int i = 0; i < (int)files.size(); ++i)
+    {
+        if (files[i].Fd >= 0) close(files[i].Fd);
+        if (is_ring_failed && (files[i].Fd >= 0 || i >= next_file)) out_unfinished.push_back(i);
+    }
+    pool.WaitAll();
+
+    return n_read;
+}
+
+// Create an io_uring instance with the given number of entries and map its rings
+bool FileIngestor::SetupRing(unsigned entries, SubmissionRing &out_ring)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) return false;
+    out_ring.Fd = fd;
+
+    // Map the submission and the completion rings (a single mapping on the newer kernels) and the entries
+    out_ring.SQSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    out_ring.CQSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        out_ring.SQSize = out_ring.CQSize = std::max(out_ring.SQSize, out_ring.CQSize);
+    out_ring.SQPtr = mmap(NULL, out_ring.SQSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (out_ring.SQPtr == MAP_FAILED)
+    {
+        out_ring.SQPtr = NULL;
+        CloseRing(out_ring);
+        return false;
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        out_ring.CQPtr = out_ring.SQPtr;
+    else
+    {
+        out_ring.CQPtr = mmap(NULL, out_ring.CQSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (out_ring.CQPtr == MAP_FAILED)
+        {
+            out_ring.CQPtr = NULL;
+            CloseRing(out_ring);
+            return false;
+        }
+    }
+    out_ring.SQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(NULL, out_ring.SQEsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        CloseRing(out_ring);
+        return false;
+    }
+    out_ring.SQEs = (io_uring_sqe *)sqes;
+
+    // Keep the pointers to the ring fields
+    char *sq = (char *)out_ring.SQPtr, *cq = (char *)out_ring.CQPtr;
+    out_ring.SQHead = (unsigned *)(sq + params.sq_off.head);
+    out_ring.SQTail = (unsigned *)(sq + params.sq_off.tail);
+    out_ring.SQMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    out_ring.SQArray = (unsigned *)(sq + params.sq_off.array);
+    out_ring.CQHead = (unsigned *)(cq + params.cq_off.head);
+    out_ring.CQTail = (unsigned *)(cq + params.cq_off.tail);
+    out_ring.CQMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    out_ring.CQEs = (io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+// Unmap the rings and close an io_uring instance
+void FileIngestor::CloseRing(SubmissionRing &ring)
+{
+    if (ring.SQEs != NULL) munmap(ring.SQEs, ring.SQEsSize);
+    if (ring.CQPtr != NULL && ring.CQPtr != ring.SQPtr) munmap(ring.CQPtr, ring.CQSize);
+    if (ring.SQPtr != NULL) munmap(ring.SQPtr, ring.SQSize);
+    if (ring.Fd >= 0) close(ring.Fd);
+    ring = SubmissionRing();
+}
+
+// Add the read of the rest of a file to the submission ring (submitted by SubmitAndWait)
+void FileIngestor::QueueRead(SubmissionRing &ring, int file_idx, PendingFile &file)
+{
+    unsigned tail = *ring.SQTail, index = tail & *ring.SQMask;
+    io_uring_sqe &sqe = ring.SQEs[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = file.Fd;
+    sqe.addr = (unsigned long long)(&file.Data[0] + file.Offset);
+    sqe.len = (unsigned)std::min<size_t>(file.Data.size() - file.Offset, 1u << 30);
+    sqe.off = file.Offset;
+    sqe.user_data = (unsigned long long)file_idx;
+    ring.SQArray[index] = index;
+
+    // Publish the entry to the kernel
+    __atomic_store_n(ring.SQTail, tail + 1, __ATOMIC_RELEASE);
+    ++ring.NumberOfPending;
+}
+
+// Submit the queued reads and wait until the given number of reads are finished
+bool FileIngestor::SubmitAndWait(SubmissionRing &ring, unsigned n_wait)
+{
+    while (true)
+    {
+        int n_submitted = (int)syscall(__NR_io_uring_enter, ring.Fd, ring.NumberOfPending, n_wait, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (n_submitted >= 0)
+        {
+            ring.NumberOfPending -= (unsigned)n_submitted;
+            return true;
+        }
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return false;
+    }
+}
+
+// Wait until the given number of submitted reads are finished, dropping their results. Returns false if
+// the ring cannot be waited on.
+bool FileIngestor::DrainRing(SubmissionRing &ring, unsigned n_submitted)
+{
+    while (true)
+    {
+        unsigned head = *ring.CQHead;
+        for (; head != __atomic_load_n(ring.CQTail, __ATOMIC_ACQUIRE) && n_submitted > 0; ++head)
+            --n_submitted;
+        __atomic_store_n(ring.CQHead, head, __ATOMIC_RELEASE);
+        if (n_submitted == 0) return true;
+
+        if (syscall(__NR_io_uring_enter, ring.Fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 &&
+            errno != EINTR && errno != EAGAIN && errno != EBUSY)
+            return false;
+    }
+}
+#endif
+
+// Read the given files on the threads of the pool while the kernel reads ahead the next files. Returns the
+// number of files read.
+int FileIngestor::ReadWithThreads(const FileFunction &process, ThreadPool &pool, const std::vector<int> &file_indices)
+{
+    // Ask for the first files at once; each task then asks for the file one queue depth ahead of it
+    int n_files = (int)file_indices.size();
+    for (int i = 0; i < std::min(queue_depth, n_files); ++i)
+        AdviseReadahead(file_paths[file_indices[i]]);
+
+    // The threads take the files in order, so the files read ahead are the next ones to be read
+    std::atomic<int> n_read(0), next_file(0);
+    for (int t = 0; t < pool.GetNumberOfThreads(); ++t)
+        pool.Submit([this, &process, &file_indices, n_files, &n_read, &next_file]()
+        {
+            for (int i = next_file++; i < n_files; i = next_file++)
+            {
+                if (i + queue_depth < n_files)
+                    AdviseReadahead(file_paths[file_indices[i + queue_depth]]);
+
+                std::string data;
+                int file_idx = file_indices[i];
+                if (!ReadWholeFile(file_paths[file_idx], data)) continue;
+                is_file_read[file_idx] = 1;
+                bytes_read += data.size();
+                process(file_idx, data);
+                ++n_read;
+            }
+        });
+    pool.WaitAll();
+
+    return n_read;
+}
+
+// Ask the kernel to start reading a file into the page cache without waiting for it
+void FileIngestor::AdviseReadahead(const std::string &path)
+{
+#if defined __linux__
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+// Read a whole file to a string. Prints an error and returns false if the file cannot be read.
+bool FileIngestor::ReadWholeFile(const std::string &path, std::string &out_data)
+{
+#if defined __linux__
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat file_stat;
+    if (fd < 0 || fstat(fd, &file_stat) != 0)
+    {
+        std::cerr << "Failed to open '" << path << "' file." << std::endl;
+        if (fd >= 0) close(fd);
+        return false;
+    }
+
+    // Read until the end of the file (the reads may be short)
+    out_data.resize((size_t)file_stat.st_size);
+    size_t offset = 0;
+    while (offset < out_data.size())
+    {
+        ssize_t result = pread(fd, &out_data[offset], out_data.size() - offset, (off_t)offset);
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0)
+        {
+            std::cerr << "Failed to read '" << path << "' file." << std::endl;
+            close(fd);
+            return false;
+        }
+        if (result == 0) break;
+        offset += (size_t)result;
+    }
+    out_data.resize(offset);
+    close(fd);
+    return true;
+#else
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open())
+    {
+        std::cerr << "Failed to open '" << path << "' file." << std::endl;
+        return false;
+    }
+    ifs.seekg(0, std::ios::end);
+    out_data.resize((size_t)ifs.tellg());
+    ifs.seekg(0);
+    if (!out_data.empty() && !ifs.read(&out_data[0], out_data.size()))
+    {
+        std::cerr << "Failed to read '" << path << "' file." << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
+
+}
+#endif
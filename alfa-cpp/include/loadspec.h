@@ -0,0 +1,135 @@
+/*  ***************************************************************************
+*   loadspec.h - Header for selecting the topics and the fields of ALFA
+*   dataset sequences to load (projection of the sequence).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_LOADSPEC_H
+#define ALFA_LOADSPEC_H
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "commons.h"
+
+namespace alfa
+{
+
+// This class keeps which topics of a sequence to load and which fields of each topic to read (see
+// Sequence::SetLoadSpec). The topics and the fields are given as names or glob patterns (e.g.,
+// 'mavros-imu-*' and 'orientation.*'). The files of the other topics are never opened, and the other
+// fields are skipped when the files are read. An empty spec loads everything.
+class LoadSpec
+{
+public:
+
+    // Member Functions
+    void AddTopic(const std::string &topic_pattern, const VecString &field_patterns = VecString());
+    void SetIncludeFaultTopics(bool include);
+    bool IsEmpty() const;
+    bool IsTopicSelected(const std::string &topic_name) const;
+    VecString GetFieldPatterns(const std::string &topic_name) const;
+    void Clear();
+
+private:
+    // Local struct definitions
+    struct TopicPattern                 // Structure for a selected topic pattern and its fields
+    {
+        std::string Pattern;
+        VecString Fields;               // All the fields if empty
+    };
+
+    // Data Members
+    std::vector<TopicPattern> topic_patterns;
+
+    // The fault topics are loaded with all their fields unless they are excluded
+    bool include_fault_topics = true;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Select the topics matching a name pattern, with the given fields (all the fields if empty). The fields
+// of the topics matching more than one pattern are joined.
+void LoadSpec::AddTopic(const std::string &topic_pattern, const VecString &field_patterns)
+{
+    TopicPattern pattern;
+    pattern.Pattern = topic_pattern;
+    pattern.Fields = field_patterns;
+    topic_patterns.push_back(pattern);
+}
+
+// Set if the fault ground truth topics are loaded even if they are not selected (the default), since
+// they are small and needed for the fault information of the sequence
+void LoadSpec::SetIncludeFaultTopics(bool include)
+{
+    include_fault_topics = include;
+}
+
+// Returns true if nothing is selected, which loads all the topics and fields
+bool LoadSpec::IsEmpty() const
+{
+    return topic_patterns.empty();
+}
+
+// Check if a topic is selected to be loaded
+bool LoadSpec::IsTopicSelected(const std::string &topic_name) const
+{
+    if (IsEmpty()) return true;
+
+    // Check the fault topics
+    if (include_fault_topics && topic_name.substr(0, Commons::FaultTopicPrefix.length()) == Commons::FaultTopicPrefix)
+        return true;
+
+    for (int i = 0; i < (int)topic_patterns.size(); ++i)
+        if (Commons::MatchPattern(topic_patterns[i].Pattern, topic_name))
+            return true;
+    return false;
+}
+
+// Get the fields (names or patterns) selected for a topic. Returns an empty list to read all the fields.
+VecString LoadSpec::GetFieldPatterns(const std::string &topic_name) const
+{
+    VecString fields;
+    for (int i = 0; i < (int)topic_patterns.size(); ++i)
+    {
+        if (!Commons::MatchPattern(topic_patterns[i].Pattern, topic_name)) continue;
+
+        // A pattern without the fields selects all of them
+        if (topic_patterns[i].Fields.empty()) return VecString();
+        for (int f = 0; f < (int)topic_patterns[i].Fields.size(); ++f)
+            if (std::find(fields.begin(), fields.end(), topic_patterns[i].Fields[f]) == fields.end())
+                fields.push_back(topic_patterns[i].Fields[f]);
+    }
+    return fields;
+}
+
+// Clear the selection, which loads everything again
+void LoadSpec::Clear()
+{
+    topic_patterns.clear();
+    include_fault_topics = true;
+}
+
+}
+#endif
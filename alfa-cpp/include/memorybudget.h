@@ -0,0 +1,395 @@
+/*  ***************************************************************************
+*   memorybudget.h - Header for the memory budget of the loaded ALFA dataset
+*   sequences (least-recently-used unloading of the topics).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_MEMORYBUDGET_H
+#define ALFA_MEMORYBUDGET_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <iostream>
+#include "commons.h"
+#include "topic.h"
+#include "sequence.h"
+#include "compression.h"
+
+namespace alfa
+{
+
+// This class keeps the memory used by the topics of a set of sequences under a budget. It keeps the
+// footprint of each topic and, when the total goes over the budget, unloads the least recently used
+// topics. An unloaded topic is loaded again (from its CSV file or from a compressed copy in memory)
+// the next time it is accessed through Sequence::GetTopic or Sequence::GetMessage.
+// The reference returned by GetTopic is valid until the next access to another topic of the budget,
+// which may unload it. The typed access to the fields (see Topic::GetColumn) grows a topic after it is
+// returned; the growth is counted on the next access to the topic. Topics of the sequences in the follow
+// mode are never unloaded. A sequence is removed from the budget when it is cleared or destroyed. Its
+// copies are not tracked; they read their unloaded topics from the files again on the access.
+class MemoryBudget : public TopicTracker
+{
+public:
+
+    // Local enum definitions
+    enum UnloadMode                     // Where the unloaded topics are read from on the next access
+    {
+        ReloadFromFile,                 // Free the messages and read the CSV file again
+        KeepCompressed                  // Keep a compressed copy in memory (see CompressedTopic)
+    };
+
+    // Local struct definitions
+    struct Statistics                   // Structure for the counters of the budget
+    {
+        size_t Hits = 0;                // Accesses to loaded topics
+        size_t Misses = 0;              // Accesses to unloaded topics (which are loaded again)
+        size_t Evictions = 0;           // Number of times a topic was unloaded
+        size_t UsedBytes = 0;           // Bytes used by the tracked topics (and their compressed copies)
+        size_t PeakBytes = 0;           // Largest number of used bytes
+        size_t BudgetBytes = 0;         // The budget (0 for no limit)
+    };
+
+    // Constructors & Deconstructors
+    MemoryBudget(size_t budget_bytes = 0, UnloadMode mode = ReloadFromFile);
+    ~MemoryBudget();
+
+    // Member Functions
+    static MemoryBudget &GetGlobal();
+    void SetBudget(size_t budget_bytes);
+    void SetUnloadMode(UnloadMode mode);
+    bool AddSequence(Sequence &sequence);
+    void RemoveSequence(Sequence &sequence);
+    size_t GetUsedBytes() const;
+    size_t GetSequenceFootprint(const Sequence &sequence) const;
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+
+    // Topic tracker interface (called by the sequences)
+    virtual void OnTopicAccess(const Sequence &sequence, int topic_idx);
+    virtual void OnSequenceCleared(const Sequence &sequence);
+
+private:
+    // Local definitions
+    typedef std::pair<const Sequence *, int> TopicKey;
+
+    struct TopicEntry                   // Structure for a tracked topic
+    {
+        Sequence *Owner = NULL;
+        size_t Bytes = 0;               // Current footprint (the compressed copy if unloaded)
+        std::shared_ptr<CompressedTopic> Compressed;
+        bool IsListed = false;          // Is the topic in the recently used list (loaded by the budget)
+        std::list<TopicKey>::iterator Position;
+        size_t MeasuredMessages = 0;    // Number of messages, typed fields and zone map block size of
+        int MeasuredColumns = 0;        // the topic when its footprint was last measured (the typed
+        int MeasuredBlockSize = 0;      // access and the zone maps grow the topic after it is loaded)
+    };
+
+    // Member Functions
+    void EnforceBudget(const TopicKey &keep);
+    void Evict(const TopicKey &key, TopicEntry &entry);
+    bool Load(const TopicKey &key, TopicEntry &entry);
+    void SetBytes(TopicEntry &entry, size_t bytes);
+    void Measure(TopicEntry &entry, const Topic &topic);
+    bool IsMeasured(const TopicEntry &entry, const Topic &topic) const;
+    void RemoveEntries(const Sequence *sequence);
+
+    // Data Members
+    mutable std::mutex mutex;
+    std::map<TopicKey, TopicEntry> entries;
+    std::list<TopicKey> recently_used;  // Loaded topics, the most recently used first
+    UnloadMode unload_mode;
+    Statistics stats;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for MemoryBudget. A budget of 0 bytes only counts the memory.
+MemoryBudget::MemoryBudget(size_t budget_bytes, UnloadMode mode) : unload_mode(mode)
+{
+    stats.BudgetBytes = budget_bytes;
+}
+
+// Destructor function for MemoryBudget. Detaches the tracked sequences (their unloaded topics are loaded back).
+MemoryBudget::~MemoryBudget()
+{
+    std::vector<Sequence *> sequences;
+    for (std::map<TopicKey, TopicEntry>::iterator it = entries.begin(); it != entries.end(); ++it)
+        if (sequences.empty() || sequences.back() != it->second.Owner)
+            sequences.push_back(it->second.Owner);
+    for (int i = 0; i < (int)sequences.size(); ++i)
+        RemoveSequence(*sequences[i]);
+}
+
+// Get the budget shared by the whole process (no limit until SetBudget is called)
+MemoryBudget &MemoryBudget::GetGlobal()
+{
+    static MemoryBudget global_budget;
+    return global_budget;
+}
+
+// Set the budget in bytes (0 for no limit). Unloads topics now if the used memory is over the new budget.
+void MemoryBudget::SetBudget(size_t budget_bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.BudgetBytes = budget_bytes;
+    EnforceBudget(TopicKey(NULL, -1));
+}
+
+// Set where the unloaded topics are read from (applies to the topics unloaded after the call)
+void MemoryBudget::SetUnloadMode(UnloadMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    unload_mode = mode;
+}
+
+// Start tracking the topics of a loaded sequence. The least recently used topics (of any tracked sequence)
+// are unloaded if the budget is exceeded. Returns false if the sequence is not loaded or has another tracker.
+bool MemoryBudget::AddSequence(Sequence &sequence)
+{
+    if (!sequence.IsInitialized())
+    {
+        std::cerr << "AddSequence Error! The sequence is not initialized." << std::endl;
+        return false;
+    }
+    if (sequence.GetTopicTracker() == this) return true;
+    if (sequence.GetTopicTracker() != NULL)
+    {
+        std::cerr << "AddSequence Error! The sequence is already tracked by another object." << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    sequence.SetTopicTracker(this);
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+    {
+        TopicKey key(&sequence, t);
+        TopicEntry &entry = entries[key];
+        entry.Owner = &sequence;
+        Measure(entry, sequence.Topics[t]);
+        recently_used.push_front(key);
+        entry.Position = recently_used.begin();
+        entry.IsListed = true;
+    }
+    EnforceBudget(TopicKey(NULL, -1));
+
+    return true;
+}
+
+// Stop tracking a sequence. Its unloaded topics are loaded back.
+void MemoryBudget::RemoveSequence(Sequence &sequence)
+{
+    if (sequence.GetTopicTracker() != this) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+    {
+        std::map<TopicKey, TopicEntry>::iterator it = entries.find(TopicKey(&sequence, t));
+        if (it != entries.end() && !sequence.Topics[t].IsLoaded())
+            Load(it->first, it->second);
+    }
+    RemoveEntries(&sequence);
+    sequence.SetTopicTracker(NULL);
+}
+
+// Get the number of bytes used by the tracked topics (and the compressed copies of the unloaded topics)
+size_t MemoryBudget::GetUsedBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats.UsedBytes;
+}
+
+// Get the number of bytes used by the topics of a tracked sequence
+size_t MemoryBudget::GetSequenceFootprint(const Sequence &sequence) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t total = 0;
+    std::map<TopicKey, TopicEntry>::const_iterator it = entries.lower_bound(TopicKey(&sequence, -1));
+    for (; it != entries.end() && it->first.first == &sequence; ++it)
+        total += it->second.Bytes;
+    return total;
+}
+
+// Get the counters of the budget
+MemoryBudget::Statistics MemoryBudget::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+// Reset the hit, miss and eviction counters (and the peak to the current usage)
+void MemoryBudget::ResetStatistics()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.Hits = stats.Misses = stats.Evictions = 0;
+    stats.PeakBytes = stats.UsedBytes;
+}
+
+// Load the topic if it is unloaded, mark it as the most recently used and unload others if needed. A loaded
+// topic is measured again if it grew since the last access (e.g., by the typed access to its fields).
+void MemoryBudget::OnTopicAccess(const Sequence &sequence, int topic_idx)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    TopicKey key(&sequence, topic_idx);
+    std::map<TopicKey, TopicEntry>::iterator it = entries.find(key);
+    if (it == entries.end()) return;
+    TopicEntry &entry = it->second;
+
+    const Topic &topic = entry.Owner->Topics[topic_idx];
+    if (topic.IsLoaded())
+    {
+        stats.Hits++;
+        if (entry.IsListed)
+            recently_used.splice(recently_used.begin(), recently_used, entry.Position);
+        if (!IsMeasured(entry, topic))
+        {
+            Measure(entry, topic);
+            EnforceBudget(key);
+        }
+        return;
+    }
+
+    stats.Misses++;
+    if (Load(key, entry)) EnforceBudget(key);
+}
+
+// Stop tracking a sequence that is cleared or destroyed
+void MemoryBudget::OnSequenceCleared(const Sequence &sequence)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    RemoveEntries(&sequence);
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Unload the least recently used topics until the used memory is within the budget. The given topic
+// (just accessed) and the topics in the follow mode are kept, even if they alone are over the budget.
+void MemoryBudget::EnforceBudget(const TopicKey &keep)
+{
+    if (stats.BudgetBytes == 0) return;
+
+    std::list<TopicKey>::iterator it = recently_used.end();
+    while (stats.UsedBytes > stats.BudgetBytes && it != recently_used.begin())
+    {
+        --it;
+        TopicEntry &entry = entries.find(*it)->second;
+        const Topic &topic = entry.Owner->Topics[it->second];
+        if (*it == keep || topic.IsFollowMode()) continue;
+
+        TopicKey key = *it;
+        it = recently_used.erase(it);
+        entry.IsListed = false;
+        Evict(key, entry);
+    }
+
+    // Drop the compressed copies if unloading is not enough (these topics are read from the files again)
+    for (std::map<TopicKey, TopicEntry>::iterator e = entries.begin(); e != entries.end() && stats.UsedBytes > stats.BudgetBytes; ++e)
+    {
+        if (!e->second.Compressed) continue;
+        e->second.Compressed.reset();
+        Measure(e->second, e->second.Owner->Topics[e->first.second]);
+    }
+}
+
+// Unload a topic (it is already removed from the recently used list)
+void MemoryBudget::Evict(const TopicKey &key, TopicEntry &entry)
+{
+    Topic &topic = entry.Owner->Topics[key.second];
+    if (unload_mode == KeepCompressed)
+    {
+        entry.Compressed.reset(new CompressedTopic(topic));
+        if (!entry.Compressed->IsInitialized()) entry.Compressed.reset();
+    }
+    topic.Unload();
+    Measure(entry, topic);
+    if (entry.Compressed) SetBytes(entry, entry.Compressed->GetMemoryFootprint());
+    stats.Evictions++;
+}
+
+// Load an unloaded topic back and mark it as the most recently used. Returns false if the topic
+// could not be read again (it stays unloaded and is tried again on the next access).
+bool MemoryBudget::Load(const TopicKey &key, TopicEntry &entry)
+{
+    Topic &topic = entry.Owner->Topics[key.second];
+    if (entry.Compressed)
+    {
+        Topic decompressed = entry.Compressed->Decompress();
+        topic.RestoreMessages(decompressed.Messages);
+        entry.Compressed.reset();
+    }
+    else if (!topic.Reload())
+        return false;
+
+    Measure(entry, topic);
+    if (entry.IsListed) recently_used.erase(entry.Position);
+    recently_used.push_front(key);
+    entry.Position = recently_used.begin();
+    entry.IsListed = true;
+    return true;
+}
+
+// Update the footprint of a topic and the total
+void MemoryBudget::SetBytes(TopicEntry &entry, size_t bytes)
+{
+    stats.UsedBytes = stats.UsedBytes - entry.Bytes + bytes;
+    stats.PeakBytes = std::max(stats.PeakBytes, stats.UsedBytes);
+    entry.Bytes = bytes;
+}
+
+// Measure the footprint of a topic and keep what it depends on (see IsMeasured)
+void MemoryBudget::Measure(TopicEntry &entry, const Topic &topic)
+{
+    entry.MeasuredMessages = topic.Messages.size();
+    entry.MeasuredColumns = topic.GetNumberOfStoredColumns();
+    entry.MeasuredBlockSize = topic.GetZoneMaps().BlockSize;
+    SetBytes(entry, topic.GetMemoryFootprint());
+}
+
+// Check if the footprint of a topic is still the measured one (without going through all its messages)
+bool MemoryBudget::IsMeasured(const TopicEntry &entry, const Topic &topic) const
+{
+    return entry.MeasuredMessages == topic.Messages.size() && entry.MeasuredColumns == topic.GetNumberOfStoredColumns()
+        && entry.MeasuredBlockSize == topic.GetZoneMaps().BlockSize;
+}
+
+// Remove all the topics of a sequence from the budget
+void MemoryBudget::RemoveEntries(const Sequence *sequence)
+{
+    std::map<TopicKey, TopicEntry>::iterator it = entries.lower_bound(TopicKey(sequence, -1));
+    while (it != entries.end() && it->first.first == sequence)
+    {
+        SetBytes(it->second, 0);
+        if (it->second.IsListed)
+            recently_used.erase(it->second.Position);
+        entries.erase(it++);
+    }
+}
+
+}
+#endif
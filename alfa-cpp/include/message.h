@@ -43,7 +43,7 @@ public:
     struct HeaderType           // Structure for the message headers
     {
         int SequenceID = -1;
-        long long int Stamp;
+        long long int Stamp = 0;
         std::string FrameID = "N/A";
     };
     
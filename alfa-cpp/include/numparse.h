@@ -0,0 +1,354 @@
+/*  ***************************************************************************
+*   numparse.h - Header for parsing the numbers and the epoch timestamps of
+*   the ALFA dataset topics without memory allocations.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_NUMPARSE_H
+#define ALFA_NUMPARSE_H
+
+#include <string>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "bitops.h"
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace alfa
+{
+
+// This class parses the numbers of the CSV fields directly from their characters. The integers and the
+// epoch timestamps (nanoseconds, up to 19 digits) are read digit by digit. The real numbers with a mantissa
+// up to 2^53 (about 15 digits) and a small exponent, which are most of the dataset values, are converted exactly
+// with a single multiplication or division by a power of ten (Clinger's fast path). The ones with up to 19
+// digits (e.g., the 17 digits of the printed doubles) are converted by multiplying with a 128-bit power of
+// five (the Eisel-Lemire algorithm). The rest (more digits, large exponents, the subnormal numbers, 'nan',
+// 'inf', etc.) are converted by strtod from a copy on the stack. All the results are correctly rounded,
+// and a text is only accepted if all its characters are used.
+class NumberParser
+{
+public:
+
+    // Member Functions
+    static bool ParseInt64(const char *begin, const char *end, long long &out_number);
+    static bool ParseDouble(const char *begin, const char *end, double &out_number);
+    static bool ParseEpochNanoseconds(const char *begin, const char *end, long long &out_seconds, int &out_nanoseconds);
+
+private:
+    // Member Functions
+    static bool ComputeDouble(uint64_t mantissa, int exponent, bool is_negative, double &out_number);
+    static bool ParseDoubleWithStrtod(const char *begin, const char *end, double &out_number);
+    static void MultiplyFull(uint64_t a, uint64_t b, uint64_t &out_high, uint64_t &out_low);
+
+    // Data Members
+    static const double exact_powers_of_ten[23];
+
+    // The range of the decimal exponents with a 128-bit power of five (enough for the dataset values)
+    static const int smallest_power_of_five = -64;
+    static const int largest_power_of_five = 40;
+    static const uint64_t powers_of_five[2 * (largest_power_of_five - smallest_power_of_five + 1)];
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The powers of ten that are exact in a double
+const double NumberParser::exact_powers_of_ten[23] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+// The powers of five from 5^-64 to 5^40, normalized to 128 bits (the high and the low halves), as in the
+// tables of the Eisel-Lemire algorithm (the negative powers are rounded up)
+const uint64_t NumberParser::powers_of_five[2 * (largest_power_of_five - smallest_power_of_five + 1)] = {
+        0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL, 0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL,
+        0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL, 0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL,
+        0xcdb02555653131b6ULL, 0x3792f412cb06794dULL, 0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL,
+        0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL, 0xc8de047564d20a8bULL, 0xf245825a5a445275ULL,
+        0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL, 0x9ced737bb6c4183dULL, 0x55464dd69685606bULL,
+        0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL, 0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL,
+        0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL, 0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL,
+        0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL, 0x95a8637627989aadULL, 0xdde7001379a44aa8ULL,
+        0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL, 0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL,
+        0x9226712162ab070dULL, 0xcab3961304ca70e8ULL, 0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL,
+        0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL, 0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL,
+        0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL, 0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL,
+        0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL, 0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL,
+        0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL, 0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL,
+        0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL, 0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL,
+        0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL, 0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL,
+        0xcfb11ead453994baULL, 0x67de18eda5814af2ULL, 0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL,
+        0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL, 0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL,
+        0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL, 0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL,
+        0xc612062576589ddaULL, 0x95364afe032a819eULL, 0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL,
+        0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL, 0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL,
+        0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL, 0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL,
+        0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL, 0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL,
+        0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL, 0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL,
+        0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL, 0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL,
+        0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL, 0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL,
+        0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL, 0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL,
+        0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL, 0x89705f4136b4a597ULL, 0x31680a88f8953031ULL,
+        0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL, 0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL,
+        0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL, 0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL,
+        0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL, 0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL,
+        0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL, 0xccccccccccccccccULL, 0xcccccccccccccccdULL,
+        0x8000000000000000ULL, 0x0000000000000000ULL, 0xa000000000000000ULL, 0x0000000000000000ULL,
+        0xc800000000000000ULL, 0x0000000000000000ULL, 0xfa00000000000000ULL, 0x0000000000000000ULL,
+        0x9c40000000000000ULL, 0x0000000000000000ULL, 0xc350000000000000ULL, 0x0000000000000000ULL,
+        0xf424000000000000ULL, 0x0000000000000000ULL, 0x9896800000000000ULL, 0x0000000000000000ULL,
+        0xbebc200000000000ULL, 0x0000000000000000ULL, 0xee6b280000000000ULL, 0x0000000000000000ULL,
+        0x9502f90000000000ULL, 0x0000000000000000ULL, 0xba43b74000000000ULL, 0x0000000000000000ULL,
+        0xe8d4a51000000000ULL, 0x0000000000000000ULL, 0x9184e72a00000000ULL, 0x0000000000000000ULL,
+        0xb5e620f480000000ULL, 0x0000000000000000ULL, 0xe35fa931a0000000ULL, 0x0000000000000000ULL,
+        0x8e1bc9bf04000000ULL, 0x0000000000000000ULL, 0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL,
+        0xde0b6b3a76400000ULL, 0x0000000000000000ULL, 0x8ac7230489e80000ULL, 0x0000000000000000ULL,
+        0xad78ebc5ac620000ULL, 0x0000000000000000ULL, 0xd8d726b7177a8000ULL, 0x0000000000000000ULL,
+        0x878678326eac9000ULL, 0x0000000000000000ULL, 0xa968163f0a57b400ULL, 0x0000000000000000ULL,
+        0xd3c21bcecceda100ULL, 0x0000000000000000ULL, 0x84595161401484a0ULL, 0x0000000000000000ULL,
+        0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL, 0xcecb8f27f4200f3aULL, 0x0000000000000000ULL,
+        0x813f3978f8940984ULL, 0x4000000000000000ULL, 0xa18f07d736b90be5ULL, 0x5000000000000000ULL,
+        0xc9f2c9cd04674edeULL, 0xa400000000000000ULL, 0xfc6f7c4045812296ULL, 0x4d00000000000000ULL,
+        0x9dc5ada82b70b59dULL, 0xf020000000000000ULL, 0xc5371912364ce305ULL, 0x6c28000000000000ULL,
+        0xf684df56c3e01bc6ULL, 0xc732000000000000ULL, 0x9a130b963a6c115cULL, 0x3c7f400000000000ULL,
+        0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL, 0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL,
+        0x96769950b50d88f4ULL, 0x1314448000000000ULL, 0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL,
+        0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL
+};
+
+// Parse an integer with an optional sign. Returns false if the text is not exactly an integer or it does not
+// fit in 64 bits.
+bool NumberParser::ParseInt64(const char *begin, const char *end, long long &out_number)
+{
+    const char *p = begin;
+    bool is_negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        is_negative = (*p++ == '-');
+    if (p == end || end - p > 19) return false;
+
+    // Nineteen digits always fit in an unsigned 64-bit integer
+    uint64_t value = 0;
+    for (; p < end; ++p)
+    {
+        unsigned digit = (unsigned)(unsigned char)*p - '0';
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    }
+
+    const uint64_t max_value = (uint64_t)9223372036854775807LL;
+    if (value > max_value + (is_negative ? 1 : 0)) return false;
+    out_number = is_negative ? (long long)(0 - value) : (long long)value;
+    return true;
+}
+
+// Parse a real number in the decimal or the exponent format (or anything else accepted by strtod).
+// Returns false if the text is not exactly a number.
+bool NumberParser::ParseDouble(const char *begin, const char *end, double &out_number)
+{
+    const char *p = begin;
+    bool is_negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        is_negative = (*p++ == '-');
+
+    // Read the significant digits (ignoring the leading zeros) and the position of the decimal point
+    uint64_t mantissa = 0;
+    int n_significant = 0, exponent = 0;
+    bool has_digits = false;
+    for (; p < end && (unsigned)(unsigned char)*p - '0' <= 9; ++p)
+    {
+        has_digits = true;
+        if (n_significant == 19) return ParseDoubleWithStrtod(begin, end, out_number);
+        mantissa = mantissa * 10 + (*p - '0');
+        if (mantissa != 0) ++n_significant;
+    }
+    if (p < end && *p == '.')
+        for (++p; p < end && (unsigned)(unsigned char)*p - '0' <= 9; ++p)
+        {
+            has_digits = true;
+            if (n_significant == 19) return ParseDoubleWithStrtod(begin, end, out_number);
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) ++n_significant;
+            --exponent;
+        }
+    if (!has_digits) return ParseDoubleWithStrtod(begin, end, out_number);
+
+    // Read the exponent
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool is_exponent_negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            is_exponent_negative = (*p++ == '-');
+        if (p == end || end - p > 4) return ParseDoubleWithStrtod(begin, end, out_number);
+
+        int exponent_value = 0;
+        for (; p < end && (unsigned)(unsigned char)*p - '0' <= 9; ++p)
+            exponent_value = exponent_value * 10 + (*p - '0');
+        exponent += is_exponent_negative ? -exponent_value : exponent_value;
+    }
+    if (p != end) return ParseDoubleWithStrtod(begin, end, out_number);
+
+    if (ComputeDouble(mantissa, exponent, is_negative, out_number)) return true;
+    return ParseDoubleWithStrtod(begin, end, out_number);
+}
+
+// Parse an epoch timestamp in nanoseconds (up to 19 digits) to the seconds and the nanoseconds. Returns false
+// if the text is not only digits.
+bool NumberParser::ParseEpochNanoseconds(const char *begin, const char *end, long long &out_seconds, int &out_nanoseconds)
+{
+    if (begin == end || end - begin > 19) return false;
+
+    uint64_t value = 0;
+    for (const char *p = begin; p < end; ++p)
+    {
+        unsigned digit = (unsigned)(unsigned char)*p - '0';
+        if (digit > 9) return false;
+        value = value * 10 + digit;
+    }
+
+    out_seconds = (long long)(value / 1000000000ULL);
+    out_nanoseconds = (int)(value % 1000000000ULL);
+    return true;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Compute the double nearest to mantissa * 10^exponent. Returns false if the result cannot be computed here
+// (so strtod should be used).
+bool NumberParser::ComputeDouble(uint64_t mantissa, int exponent, bool is_negative, double &out_number)
+{
+    if (mantissa == 0)
+    {
+        out_number = is_negative ? -0.0 : 0.0;
+        return true;
+    }
+
+    // Both the mantissa and the power of ten are exact, so one operation rounds the result correctly
+    if (mantissa <= ((uint64_t)1 << 53) && exponent >= -22 && exponent <= 22)
+    {
+        double value = (double)mantissa;
+        if (exponent < 0) value /= exact_powers_of_ten[-exponent];
+        else value *= exact_powers_of_ten[exponent];
+        out_number = is_negative ? -value : value;
+        return true;
+    }
+    if (exponent < smallest_power_of_five || exponent > largest_power_of_five) return false;
+
+    // Multiply the normalized mantissa with the truncated power of five. The 55 high bits are enough unless
+    // the bits below them are all ones, when the low half of the power is added.
+    int leading_zeros = BitOps::CountLeadingZeros(mantissa);
+    mantissa <<= leading_zeros;
+    int index = 2 * (exponent - smallest_power_of_five);
+    uint64_t high, low;
+    MultiplyFull(mantissa, powers_of_five[index], high, low);
+    const uint64_t precision_mask = 0x1FF;
+    if ((high & precision_mask) == precision_mask)
+    {
+        uint64_t second_high, second_low;
+        MultiplyFull(mantissa, powers_of_five[index + 1], second_high, second_low);
+        low += second_high;
+        if (second_high > low) ++high;
+
+        // The product may still be too close to the middle of two doubles to round it correctly
+        if ((high & precision_mask) == precision_mask && low == ~(uint64_t)0) return false;
+    }
+
+    // Keep 54 bits (one more for rounding) and find the binary exponent
+    int upper_bit = (int)(high >> 63);
+    int shift = upper_bit + 9;
+    uint64_t bits = high >> shift;
+    int binary_exponent = (((152170 + 65536) * exponent) >> 16) + 63 + upper_bit - leading_zeros + 1023;
+    if (binary_exponent <= 0) return false;
+
+    // Round to even if the product is exactly halfway between two doubles (only possible for small exponents)
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (bits & 3) == 1 && (bits << shift) == high)
+        bits &= ~(uint64_t)1;
+    bits += bits & 1;
+    bits >>= 1;
+    if (bits >= ((uint64_t)2 << 52))
+    {
+        bits = (uint64_t)1 << 52;
+        ++binary_exponent;
+    }
+    if (binary_exponent >= 0x7FF) return false;
+
+    // Build the double from its bits
+    bits &= ~((uint64_t)1 << 52);
+    bits |= (uint64_t)binary_exponent << 52;
+    if (is_negative) bits |= (uint64_t)1 << 63;
+    std::memcpy(&out_number, &bits, sizeof(out_number));
+    return true;
+}
+
+// Parse a real number with strtod, which needs a null-terminated copy (on the stack for the normal lengths)
+bool NumberParser::ParseDoubleWithStrtod(const char *begin, const char *end, double &out_number)
+{
+    size_t length = end - begin;
+    if (length == 0) return false;
+
+    char stack_buffer[64];
+    std::string heap_buffer;
+    const char *text = stack_buffer;
+    if (length < sizeof(stack_buffer))
+    {
+        std::copy(begin, end, stack_buffer);
+        stack_buffer[length] = '\0';
+    }
+    else
+    {
+        heap_buffer.assign(begin, end);
+        text = heap_buffer.c_str();
+    }
+
+    char *text_end;
+    double value = std::strtod(text, &text_end);
+    if (text_end != text + length) return false;
+    out_number = value;
+    return true;
+}
+
+// Multiply two 64-bit integers to the high and the low halves of the 128-bit product
+void NumberParser::MultiplyFull(uint64_t a, uint64_t b, uint64_t &out_high, uint64_t &out_low)
+{
+#if defined _MSC_VER && defined _M_X64
+    out_low = _umul128(a, b, &out_high);
+#elif defined __SIZEOF_INT128__
+    unsigned __int128 product = (unsigned __int128)a * b;
+    out_high = (uint64_t)(product >> 64);
+    out_low = (uint64_t)product;
+#else
+    uint64_t a_low = (uint32_t)a, a_high = a >> 32, b_low = (uint32_t)b, b_high = b >> 32;
+    uint64_t low_low = a_low * b_low, high_low = a_high * b_low, low_high = a_low * b_high;
+    uint64_t middle = (low_low >> 32) + (uint32_t)high_low + (uint32_t)low_high;
+    out_high = a_high * b_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+    out_low = (middle << 32) | (uint32_t)low_low;
+#endif
+}
+
+}
+#endif
@@ -0,0 +1,296 @@
+/*  ***************************************************************************
+*   prefetch.h - Header for loading the next ALFA dataset sequences in the
+*   background while the current one is processed.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_PREFETCH_H
+#define ALFA_PREFETCH_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include "commons.h"
+#include "sequence.h"
+#include "loadspec.h"
+
+namespace alfa
+{
+
+// This class loads an ordered list of sequences in the background, so the loading of the next sequences
+// overlaps with the processing of the current one. The sequences are taken in order with Next (or processed
+// by a callback with Run). At most the prefetch depth of sequences are loaded (or being loaded) and not taken
+// yet, which bounds the memory to the depth plus the sequence being processed.
+class SequencePrefetcher
+{
+public:
+
+    // A callback processes a loaded sequence given its index in the list
+    typedef std::function<void(const Sequence &, int)> SequenceFunction;
+
+    // Constructors & Deconstructors
+    SequencePrefetcher(int prefetch_depth = 2);
+    ~SequencePrefetcher();
+
+    // Member Functions
+    int AddSequence(const std::string &sequence_dir, const std::string &sequence_name);
+    int AddSequenceFile(const std::string &bag_path);
+    void SetPrefetchDepth(int prefetch_depth);
+    void SetNumberOfLoaders(int n_loaders);
+    void SetLoadSpec(const LoadSpec &spec);
+    void SetSetupFunction(const std::function<void(Sequence &)> &setup);
+    void Start();
+    bool Next(Sequence &out_sequence, int &out_sequence_idx);
+    int Run(const SequenceFunction &process);
+    void Stop();
+    int GetNumberOfSequences() const;
+    double GetLoadTime() const;
+    double GetWaitTime() const;
+
+private:
+    // Local struct definitions
+    struct SequenceSlot                 // Structure for a sequence in the list
+    {
+        std::string DirectoryPath;
+        std::string Name;
+        std::unique_ptr<Sequence> Data; // Loaded sequence (until it is taken)
+        bool IsReady = false;           // Has the loading finished
+    };
+
+    // Member Functions
+    void RunLoader();
+
+    // The prefetcher cannot be copied while the loaders are running
+    SequencePrefetcher(const SequencePrefetcher &);
+    SequencePrefetcher &operator=(const SequencePrefetcher &);
+
+    // Data Members
+    int prefetch_depth;
+    int n_loaders = 1;
+    LoadSpec load_spec;
+    std::function<void(Sequence &)> setup_function;
+    std::vector<SequenceSlot> slots;
+    std::vector<std::thread> loaders;
+
+    // Index of the next sequence to load and to take (protected by state_mutex)
+    int next_to_load = 0, next_to_take = 0;
+    bool stop_requested = false;
+    double load_time = 0, wait_time = 0;
+    std::mutex state_mutex;
+    std::condition_variable slot_available, sequence_ready;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for SequencePrefetcher. Loads up to the given number of sequences ahead.
+SequencePrefetcher::SequencePrefetcher(int prefetch_depth)
+    : prefetch_depth(std::max(1, prefetch_depth))
+{
+}
+
+// Destructor function for SequencePrefetcher. Waits for the sequences being loaded.
+SequencePrefetcher::~SequencePrefetcher()
+{
+    Stop();
+}
+
+// Add a sequence to the end of the list. Returns the index of the sequence.
+int SequencePrefetcher::AddSequence(const std::string &sequence_dir, const std::string &sequence_name)
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+    SequenceSlot slot;
+    slot.DirectoryPath = sequence_dir;
+    slot.Name = sequence_name;
+    slots.push_back(std::move(slot));
+
+    // The waiting loaders can start on the new sequence
+    slot_available.notify_all();
+    return (int)slots.size() - 1;
+}
+
+// Add a sequence to the end of the list given the path to its bag file. Returns the index of the sequence,
+// or -1 if the path is not a bag file.
+int SequencePrefetcher::AddSequenceFile(const std::string &bag_path)
+{
+    std::string sequence_dir, sequence_name;
+    if (!Sequence::ParseBagPath(bag_path, sequence_dir, sequence_name))
+    {
+        std::cerr << "AddSequenceFile Error! '" << bag_path << "' is not a path to a bag file." << std::endl;
+        return -1;
+    }
+    return AddSequence(sequence_dir, sequence_name);
+}
+
+// Set the number of sequences that are loaded ahead of the one being processed (at least one)
+void SequencePrefetcher::SetPrefetchDepth(int prefetch_depth)
+{
+    std::lock_guard<std::mutex> lock(state_mutex);
+    this->prefetch_depth = std::max(1, prefetch_depth);
+    slot_available.notify_all();
+}
+
+// Set the number of sequences loaded at the same time (one by default, since the topic files of a sequence
+// are already parsed on several threads). Takes effect when the loading starts.
+void SequencePrefetcher::SetNumberOfLoaders(int n_loaders)
+{
+    this->n_loaders = std::max(1, n_loaders);
+}
+
+// Set the topics and the fields to load from each sequence (see Sequence::SetLoadSpec)
+void SequencePrefetcher::SetLoadSpec(const LoadSpec &spec)
+{
+    load_spec = spec;
+}
+
+// Set a function that configures each sequence before it is loaded (e.g., the ordering mode or the
+// zone map block size). It is called on the loader threads.
+void SequencePrefetcher::SetSetupFunction(const std::function<void(Sequence &)> &setup)
+{
+    setup_function = setup;
+}
+
+// Start loading the sequences in the background (called by Next if it is not called before)
+void SequencePrefetcher::Start()
+{
+    if (!loaders.empty()) return;
+    stop_requested = false;
+    for (int i = 0; i < n_loaders; ++i)
+        loaders.push_back(std::thread(&SequencePrefetcher::RunLoader, this));
+}
+
+// Take the next sequence of the list, waiting until it is loaded. Returns false after the last sequence
+// (or if the loading is stopped). The sequence is not initialized if it could not be loaded.
+bool SequencePrefetcher::Next(Sequence &out_sequence, int &out_sequence_idx)
+{
+    Start();
+
+    std::unique_lock<std::mutex> lock(state_mutex);
+    if (next_to_take >= (int)slots.size()) return false;
+
+    // Wait for the sequence and keep the time the caller was idle (the slots may move while waiting)
+    int sequence_idx = next_to_take;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sequence_ready.wait(lock, [this, sequence_idx]() { return slots[sequence_idx].IsReady || stop_requested; });
+    wait_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!slots[sequence_idx].IsReady) return false;
+
+    // Hand the sequence over and let the loaders start on the next one
+    out_sequence = std::move(*slots[sequence_idx].Data);
+    slots[sequence_idx].Data.reset();
+    out_sequence_idx = next_to_take++;
+    slot_available.notify_all();
+    return true;
+}
+
+// Process all the remaining sequences in order with a callback, while the next ones are loaded.
+// The sequences that could not be loaded are skipped. Returns the number of processed sequences.
+int SequencePrefetcher::Run(const SequenceFunction &process)
+{
+    int n_processed = 0, sequence_idx;
+    Sequence sequence;
+    while (Next(sequence, sequence_idx))
+    {
+        if (!sequence.IsInitialized()) continue;
+        process(sequence, sequence_idx);
+        ++n_processed;
+    }
+    return n_processed;
+}
+
+// Stop loading the sequences. The sequences being loaded are finished and the others are not loaded.
+void SequencePrefetcher::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stop_requested = true;
+    }
+    slot_available.notify_all();
+    sequence_ready.notify_all();
+    for (int i = 0; i < (int)loaders.size(); ++i)
+        loaders[i].join();
+    loaders.clear();
+}
+
+// Get the number of sequences in the list
+int SequencePrefetcher::GetNumberOfSequences() const
+{
+    return (int)slots.size();
+}
+
+// Get the total time spent loading the sequences in seconds (on all the loaders)
+double SequencePrefetcher::GetLoadTime() const
+{
+    return load_time;
+}
+
+// Get the total time Next waited for the sequences to be loaded in seconds (the loading that did not
+// overlap with the processing)
+double SequencePrefetcher::GetWaitTime() const
+{
+    return wait_time;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Load the next sequences of the list while there is room for them
+void SequencePrefetcher::RunLoader()
+{
+    std::unique_lock<std::mutex> lock(state_mutex);
+    while (true)
+    {
+        // Wait until there is a sequence to load and it fits in the prefetch depth
+        slot_available.wait(lock, [this]() { return stop_requested ||
+            (next_to_load < (int)slots.size() && next_to_load - next_to_take < prefetch_depth); });
+        if (stop_requested) return;
+        int sequence_idx = next_to_load++;
+        std::string sequence_dir = slots[sequence_idx].DirectoryPath, sequence_name = slots[sequence_idx].Name;
+
+        // Load the sequence without holding the lock
+        lock.unlock();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::unique_ptr<Sequence> sequence(new Sequence());
+        sequence->SetLoadSpec(load_spec);
+        if (setup_function) setup_function(*sequence);
+        sequence->LoadSequence(sequence_dir, sequence_name);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        lock.lock();
+
+        // The slots may have moved if sequences were added meanwhile
+        slots[sequence_idx].Data = std::move(sequence);
+        slots[sequence_idx].IsReady = true;
+        load_time += elapsed;
+        sequence_ready.notify_all();
+    }
+}
+
+}
+#endif
@@ -0,0 +1,414 @@
+/*  ***************************************************************************
+*   profile.h - Header for the statistics and data-quality profile of ALFA
+*   dataset sequences.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_PROFILE_H
+#define ALFA_PROFILE_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "commons.h"
+#include "topic.h"
+#include "sequence.h"
+#include "threadpool.h"
+
+namespace alfa
+{
+
+// This structure keeps the statistics of a field of a topic
+struct FieldProfile
+{
+    std::string Label;
+    size_t NumericCount = 0;            // Number of the values that are numbers (booleans are 1 and 0)
+    size_t NaNCount = 0;                // Number of the values that are not numbers (including "nan")
+    size_t EmptyCount = 0;              // Number of the empty values
+    double Min = 0, Max = 0;            // Statistics of the numbers (0 if there are none)
+    double Mean = 0, StdDev = 0;
+};
+
+// This structure keeps the timing statistics and the data-quality checks of a topic
+struct TopicProfile
+{
+    // Local struct definitions
+    struct Gap                          // Structure for a gap between two consecutive messages
+    {
+        double Start = 0;               // Time of the message before the gap (seconds since the sequence start)
+        double Length = 0;              // Length of the gap (seconds)
+    };
+
+    std::string Name;
+    bool IsFaultTopic = false;
+    size_t NumMessages = 0;
+    double Start = 0, Duration = 0;     // First message time (seconds since the sequence start) and time span
+    double Rate = 0;                    // Average message rate (Hz)
+
+    // Inter-arrival times of the consecutive messages (seconds)
+    double IntervalMean = 0, IntervalP50 = 0, IntervalP90 = 0, IntervalP99 = 0, IntervalMax = 0;
+    double Jitter = 0;                  // Standard deviation of the inter-arrival times (seconds)
+    std::vector<Gap> Gaps;              // Gaps longer than the gap threshold
+
+    // Recorded times (%time) that go back or repeat
+    size_t OutOfOrderTimes = 0, DuplicateTimes = 0;
+
+    // Header stamps that go back or repeat, and the delay of the recorded time after the stamp (seconds)
+    bool HasHeader = false;
+    size_t OutOfOrderStamps = 0, DuplicateStamps = 0;
+    double StampDelayMin = 0, StampDelayMax = 0, StampDelayMean = 0;
+
+    std::vector<FieldProfile> Fields;
+};
+
+// This structure keeps the profile of a sequence
+struct SequenceProfile
+{
+    std::string Name;
+    size_t NumMessages = 0;
+    double Duration = 0;                // Total duration of the sequence (seconds)
+    double GapThreshold = 0;            // Threshold used for reporting the gaps (seconds)
+    std::vector<TopicProfile> Topics;
+
+    // Member Functions
+    std::string ToJson() const;
+    bool SaveJson(const std::string &filename) const;
+    void Clear();
+};
+
+// This class computes the profile of a sequence: the statistics of every field and the timing and
+// ordering checks of every topic. Each topic is profiled in a single pass over its messages, and the
+// topics are profiled in parallel.
+class SequenceProfiler
+{
+public:
+
+    // Default shortest reported gap between two consecutive messages of a topic (seconds)
+    static const double DefaultGapThreshold;
+
+    // Member Functions
+    void SetGapThreshold(double gap_threshold);
+    void SetNumberOfThreads(int n_threads);
+    bool Profile(const Sequence &sequence, SequenceProfile &out_profile) const;
+    void ProfileTopic(const Topic &topic, long long sequence_start, TopicProfile &out_profile) const;
+
+private:
+    // Member Functions
+    static double FindPercentile(std::vector<double> &values, double percentile);
+
+    // Data Members
+    double gap_threshold = DefaultGapThreshold;
+    int n_threads = 0;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Convert the profile to a JSON document (the numbers that are not finite are written as null)
+std::string SequenceProfile::ToJson() const
+{
+    std::ostringstream json;
+    json << std::setprecision(10);
+
+    // Write a number, a string or a key
+    auto number = [&json](double value) -> std::ostringstream & {
+        if (std::isfinite(value)) json << value; else json << "null";
+        return json;
+    };
+    auto text = [&json](const std::string &value) -> std::ostringstream & {
+        json << '"';
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            unsigned char c = value[i];
+            if (c == '"' || c == '\\') json << '\\' << c;
+            else if (c < 0x20) json << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c << std::dec << std::setfill(' ');
+            else json << c;
+        }
+        json << '"';
+        return json;
+    };
+
+    json << "{\n";
+    json << "  \"name\": "; text(Name) << ",\n";
+    json << "  \"messages\": " << NumMessages << ",\n";
+    json << "  \"duration\": "; number(Duration) << ",\n";
+    json << "  \"gap_threshold\": "; number(GapThreshold) << ",\n";
+    json << "  \"topics\": [";
+    for (size_t t = 0; t < Topics.size(); ++t)
+    {
+        const TopicProfile &topic = Topics[t];
+        json << (t > 0 ? ",\n" : "\n") << "    {\n";
+        json << "      \"name\": "; text(topic.Name) << ",\n";
+        json << "      \"fault_topic\": " << (topic.IsFaultTopic ? "true" : "false") << ",\n";
+        json << "      \"messages\": " << topic.NumMessages << ",\n";
+        json << "      \"start\": "; number(topic.Start) << ",\n";
+        json << "      \"duration\": "; number(topic.Duration) << ",\n";
+        json << "      \"rate\": "; number(topic.Rate) << ",\n";
+        json << "      \"interval\": {\"mean\": "; number(topic.IntervalMean) << ", \"p50\": "; number(topic.IntervalP50)
+            << ", \"p90\": "; number(topic.IntervalP90) << ", \"p99\": "; number(topic.IntervalP99)
+            << ", \"max\": "; number(topic.IntervalMax) << ", \"jitter\": "; number(topic.Jitter) << "},\n";
+        json << "      \"gaps\": [";
+        for (size_t g = 0; g < topic.Gaps.size(); ++g)
+        {
+            json << (g > 0 ? ", " : "") << "{\"start\": "; number(topic.Gaps[g].Start) << ", \"length\": "; number(topic.Gaps[g].Length) << "}";
+        }
+        json << "],\n";
+        json << "      \"time_order\": {\"out_of_order\": " << topic.OutOfOrderTimes << ", \"duplicates\": " << topic.DuplicateTimes << "},\n";
+        if (topic.HasHeader)
+        {
+            json << "      \"stamp_order\": {\"out_of_order\": " << topic.OutOfOrderStamps << ", \"duplicates\": " << topic.DuplicateStamps << "},\n";
+            json << "      \"stamp_delay\": {\"min\": "; number(topic.StampDelayMin) << ", \"max\": "; number(topic.StampDelayMax)
+                << ", \"mean\": "; number(topic.StampDelayMean) << "},\n";
+        }
+        json << "      \"fields\": [";
+        for (size_t f = 0; f < topic.Fields.size(); ++f)
+        {
+            const FieldProfile &field = topic.Fields[f];
+            json << (f > 0 ? ",\n" : "\n") << "        {\"label\": "; text(field.Label) << ", \"numbers\": " << field.NumericCount
+                << ", \"nans\": " << field.NaNCount << ", \"empty\": " << field.EmptyCount << ", \"min\": "; number(field.Min)
+                << ", \"max\": "; number(field.Max) << ", \"mean\": "; number(field.Mean) << ", \"std\": "; number(field.StdDev) << "}";
+        }
+        json << (topic.Fields.empty() ? "]\n" : "\n      ]\n") << "    }";
+    }
+    json << (Topics.empty() ? "]\n" : "\n  ]\n") << "}\n";
+
+    return json.str();
+}
+
+// Write the profile to a JSON file
+bool SequenceProfile::SaveJson(const std::string &filename) const
+{
+    std::ofstream ofs(filename);
+    if (!ofs.is_open())
+    {
+        std::cerr << "Failed to open '" << filename << "' file for writing." << std::endl;
+        return false;
+    }
+    ofs << ToJson();
+    return ofs.good();
+}
+
+// Remove all the topics from the profile
+void SequenceProfile::Clear()
+{
+    Name = "";
+    NumMessages = 0;
+    Duration = 0;
+    GapThreshold = 0;
+    Topics.clear();
+}
+
+// Gaps of more than half a second are far longer than the normal periods of the topics
+const double SequenceProfiler::DefaultGapThreshold = 0.5;
+
+// Set the shortest reported gap between two consecutive messages of a topic (seconds)
+void SequenceProfiler::SetGapThreshold(double gap_threshold)
+{
+    this->gap_threshold = gap_threshold;
+}
+
+// Set the number of threads (0 for one thread per CPU core)
+void SequenceProfiler::SetNumberOfThreads(int n_threads)
+{
+    this->n_threads = std::max(n_threads, 0);
+}
+
+// Compute the profile of all the topics of a sequence
+bool SequenceProfiler::Profile(const Sequence &sequence, SequenceProfile &out_profile) const
+{
+    out_profile.Clear();
+    if (!sequence.IsInitialized())
+    {
+        std::cerr << "Profile Error! The sequence is not initialized." << std::endl;
+        return false;
+    }
+
+    out_profile.Name = sequence.Name;
+    out_profile.NumMessages = sequence.MessageIndexList.size();
+    out_profile.Duration = sequence.GetTotalDuration();
+    out_profile.GapThreshold = gap_threshold;
+    out_profile.Topics.resize(sequence.Topics.size());
+
+    // The times are reported relative to the first message of the sequence
+    long long sequence_start = sequence.MessageIndexList.empty() ? 0 : sequence.GetMessage(0).DateTime.ToNanoseconds();
+
+    // Each topic writes only its own profile, so the topics can be profiled in parallel
+    ThreadPool pool(n_threads);
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+        pool.Submit([this, &sequence, &out_profile, t, sequence_start]()
+            { ProfileTopic(sequence.Topics[t], sequence_start, out_profile.Topics[t]); });
+    pool.WaitAll();
+
+    return true;
+}
+
+// Compute the profile of a topic in a single pass over its messages. The times are reported relative
+// to the given start time (nanoseconds).
+void SequenceProfiler::ProfileTopic(const Topic &topic, long long sequence_start, TopicProfile &out_profile) const
+{
+    out_profile = TopicProfile();
+    out_profile.Name = topic.Name;
+    out_profile.IsFaultTopic = topic.IsFaultTopic();
+    out_profile.HasHeader = topic.HasHeaderField();
+    out_profile.NumMessages = topic.Messages.size();
+
+    int n_fields = (int)topic.FieldLabels.size();
+    out_profile.Fields.resize(n_fields);
+    for (int f = 0; f < n_fields; ++f)
+        out_profile.Fields[f].Label = topic.FieldLabels[f];
+
+    // Running sums of the numbers (Welford's method) and of the stamp delays
+    std::vector<double> means(n_fields, 0), squares(n_fields, 0);
+    std::vector<double> mins(n_fields, std::numeric_limits<double>::infinity());
+    std::vector<double> maxs(n_fields, -std::numeric_limits<double>::infinity());
+    std::vector<double> intervals;
+    intervals.reserve(topic.Messages.size());
+    double delay_sum = 0;
+    double delay_min = std::numeric_limits<double>::infinity(), delay_max = -std::numeric_limits<double>::infinity();
+    long long first_time = 0, last_time = 0, prev_time = 0, prev_stamp = 0;
+
+    for (size_t i = 0; i < topic.Messages.size(); ++i)
+    {
+        const Message &msg = topic.Messages[i];
+
+        // Check the recorded times
+        long long time = msg.DateTime.ToNanoseconds();
+        if (i == 0) first_time = last_time = time;
+        else
+        {
+            double interval = (time - prev_time) * 1e-9;
+            intervals.push_back(interval);
+            if (time < prev_time) out_profile.OutOfOrderTimes++;
+            else if (time == prev_time) out_profile.DuplicateTimes++;
+            if (interval > gap_threshold)
+            {
+                TopicProfile::Gap gap;
+                gap.Start = (prev_time - sequence_start) * 1e-9;
+                gap.Length = interval;
+                out_profile.Gaps.push_back(gap);
+            }
+        }
+        first_time = std::min(first_time, time);
+        last_time = std::max(last_time, time);
+        prev_time = time;
+
+        // Check the header stamps against the recorded times
+        if (out_profile.HasHeader)
+        {
+            long long stamp = msg.Header.Stamp;
+            if (i > 0 && stamp < prev_stamp) out_profile.OutOfOrderStamps++;
+            else if (i > 0 && stamp == prev_stamp) out_profile.DuplicateStamps++;
+            prev_stamp = stamp;
+
+            double delay = (msg.DateTime.ToEpochNanoseconds() - stamp) * 1e-9;
+            delay_sum += delay;
+            delay_min = std::min(delay_min, delay);
+            delay_max = std::max(delay_max, delay);
+        }
+
+        // Update the statistics of the fields
+        for (int f = 0; f < n_fields && f < (int)msg.Fields.size(); ++f)
+        {
+            FieldProfile &field = out_profile.Fields[f];
+            if (msg.Fields[f].empty())
+            {
+                field.EmptyCount++;
+                continue;
+            }
+
+            double value = Topic::FieldToDouble(msg.Fields[f]);
+            if (value != value)
+            {
+                field.NaNCount++;
+                continue;
+            }
+
+            field.NumericCount++;
+            double delta = value - means[f];
+            means[f] += delta / field.NumericCount;
+            squares[f] += delta * (value - means[f]);
+            mins[f] = std::min(mins[f], value);
+            maxs[f] = std::max(maxs[f], value);
+        }
+    }
+
+    // Finalize the statistics of the fields
+    for (int f = 0; f < n_fields; ++f)
+    {
+        FieldProfile &field = out_profile.Fields[f];
+        if (field.NumericCount == 0) continue;
+        field.Min = mins[f];
+        field.Max = maxs[f];
+        field.Mean = means[f];
+        field.StdDev = std::sqrt(squares[f] / field.NumericCount);
+    }
+
+    // Finalize the timing statistics
+    if (topic.Messages.empty()) return;
+    out_profile.Start = (first_time - sequence_start) * 1e-9;
+    out_profile.Duration = (last_time - first_time) * 1e-9;
+    if (out_profile.Duration > 0)
+        out_profile.Rate = (out_profile.NumMessages - 1) / out_profile.Duration;
+    if (out_profile.HasHeader)
+    {
+        out_profile.StampDelayMin = delay_min;
+        out_profile.StampDelayMax = delay_max;
+        out_profile.StampDelayMean = delay_sum / out_profile.NumMessages;
+    }
+    if (intervals.empty()) return;
+
+    double sum = 0, square_sum = 0;
+    for (size_t i = 0; i < intervals.size(); ++i)
+    {
+        sum += intervals[i];
+        square_sum += intervals[i] * intervals[i];
+    }
+    out_profile.IntervalMean = sum / intervals.size();
+    out_profile.Jitter = std::sqrt(std::max(0.0, square_sum / intervals.size() - out_profile.IntervalMean * out_profile.IntervalMean));
+    out_profile.IntervalMax = *std::max_element(intervals.begin(), intervals.end());
+    out_profile.IntervalP50 = FindPercentile(intervals, 50);
+    out_profile.IntervalP90 = FindPercentile(intervals, 90);
+    out_profile.IntervalP99 = FindPercentile(intervals, 99);
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Find a percentile (nearest rank) of the values. The values are partially reordered.
+double SequenceProfiler::FindPercentile(std::vector<double> &values, double percentile)
+{
+    size_t rank = (size_t)std::ceil(percentile / 100 * values.size());
+    rank = std::min(std::max(rank, (size_t)1), values.size()) - 1;
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+}
+#endif
@@ -0,0 +1,1019 @@
+/*  ***************************************************************************
+*   query.h - Header for the predicate and expression engine over the fields
+*   of ALFA dataset topics (e.g., triage queries on the sequences).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_QUERY_H
+#define ALFA_QUERY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include "commons.h"
+#include "bitops.h"
+#include "topic.h"
+#include "sequence.h"
+
+namespace alfa
+{
+
+// This class keeps an expression over the fields of the topics of a sequence, for example:
+//     Expression::Abs(Expression::Field("mavros-nav_info-roll", "commanded")
+//         - Expression::Field("mavros-nav_info-roll", "measured")) > 5
+//     && Expression::Field("mavros-nav_info-airspeed", "measured") < 12
+// Comparisons and logical operators give 1 for true and 0 for false. Expressions are immutable and
+// cheap to copy, so they can be built once and evaluated on many sequences (see QueryEngine).
+class Expression
+{
+public:
+
+    // Local enum definitions
+    enum Operator                       // Type of the expression nodes
+    {
+        Constant, FieldValue, ElapsedTime,
+        Add, Subtract, Multiply, Divide, Negate, AbsoluteValue,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+        LogicalAnd, LogicalOr, LogicalNot
+    };
+
+    // Constructors & Deconstructors
+    Expression(double value = 0);
+
+    // Member Functions
+    static Expression Value(double value);
+    static Expression Field(const std::string &topic_name, const std::string &field_label);
+    static Expression Time();
+    static Expression Abs(const Expression &expr);
+    static Expression And(const Expression &expr1, const Expression &expr2);
+    static Expression Or(const Expression &expr1, const Expression &expr2);
+    static Expression Not(const Expression &expr);
+    static Expression Binary(Operator op, const Expression &expr1, const Expression &expr2);
+    static Expression Unary(Operator op, const Expression &expr);
+
+    Operator GetOperator() const;
+    std::string ToString() const;
+
+private:
+    // Query engines compile the expression nodes
+    friend class QueryEngine;
+
+    // Local struct definitions
+    struct Node                         // Structure for an expression node
+    {
+        Operator Op = Constant;
+        double Value = 0;               // Value of the constants
+        std::string TopicName;          // Topic name and field label of the field values
+        std::string FieldLabel;
+        std::shared_ptr<const Node> Left, Right;
+    };
+
+    // Member Functions
+    static std::string NodeToString(const Node &node);
+
+    // Data Members
+    std::shared_ptr<const Node> root;
+};
+
+// Operators for building the expressions
+Expression operator+ (const Expression &expr1, const Expression &expr2);
+Expression operator- (const Expression &expr1, const Expression &expr2);
+Expression operator* (const Expression &expr1, const Expression &expr2);
+Expression operator/ (const Expression &expr1, const Expression &expr2);
+Expression operator- (const Expression &expr);
+Expression operator< (const Expression &expr1, const Expression &expr2);
+Expression operator<= (const Expression &expr1, const Expression &expr2);
+Expression operator> (const Expression &expr1, const Expression &expr2);
+Expression operator>= (const Expression &expr1, const Expression &expr2);
+Expression operator== (const Expression &expr1, const Expression &expr2);
+Expression operator!= (const Expression &expr1, const Expression &expr2);
+Expression operator&& (const Expression &expr1, const Expression &expr2);
+Expression operator|| (const Expression &expr1, const Expression &expr2);
+Expression operator! (const Expression &expr);
+
+// This class keeps the messages of a topic selected by a query as a bitmap (bit i is set if the
+// message i of the topic is selected)
+class Selection
+{
+public:
+
+    // Class Data Members
+    int TopicIdx = -1;                  // Index of the topic in the sequence
+    size_t Size = 0;                    // Number of the messages of the topic
+    std::vector<unsigned long long> Bits;
+
+    // Member Functions
+    bool IsSelected(size_t msg_idx) const;
+    size_t Count() const;
+    std::vector<int> GetIndices() const;
+    Selection Intersect(const Selection &selection) const;
+    Selection Unite(const Selection &selection) const;
+    void Clear();
+};
+
+// This class evaluates expressions on the messages of a sequence. An expression is evaluated for each
+// message of a driver topic (by default, the topic of its first field). The fields of the other topics
+// are aligned to the times of the driver messages by holding their last received value; before their
+// first message they are NaN, so the comparisons on them are false. Evaluation is done in batches of
+// messages with simple loops over contiguous buffers that the compiler can vectorize. If the driver topic
+// has zone maps (see Topic::BuildZoneMaps), the batches that cannot change the result are skipped. The
+// parsed fields are cached, so the later queries on the same fields skip the parsing. The engine is not
+// thread-safe.
+class QueryEngine
+{
+public:
+
+    // Number of the messages evaluated in each batch (a multiple of 64)
+    static const int BatchSize;
+
+    // Constructors & Deconstructors
+    QueryEngine(const Sequence &sequence);
+
+    // Member Functions
+    Selection Filter(const Expression &predicate, const std::string &driver_topic = "");
+    std::vector<double> Evaluate(const Expression &expression, const std::string &driver_topic = "");
+    Selection Align(const Selection &selection, const std::string &topic_name);
+    std::vector<int> ToMessageList(const Selection &selection) const;
+    size_t GetNumberOfSkippedMessages() const;
+    void ClearCache();
+
+private:
+    // Local struct definitions
+    struct CompiledNode                 // Structure for a node of a compiled expression
+    {
+        Expression::Operator Op = Expression::Constant;
+        double Value = 0;
+        int Left = -1, Right = -1;      // Indices of the operand nodes
+        int TopicIdx = -1;              // Topic and index of the field values
+        int FieldIdx = -1;
+        const std::vector<double> *Column = NULL;   // Parsed values of the field
+        const std::vector<int> *Rows = NULL;        // Held message of the topic for each driver message
+    };
+
+    struct Program                      // Structure for a compiled expression
+    {
+        std::vector<CompiledNode> Nodes;
+        std::vector<std::vector<double> > Buffers;  // Output of each node for the current batch
+        int DriverIdx = -1;
+        const std::vector<long long> *DriverTimes = NULL;
+        std::map<int, std::vector<int> > HeldRows;  // Held message of each other topic
+    };
+
+    struct Bounds                       // Structure for the range of the values of a node in a batch
+    {
+        double Min, Max;                // Min > Max if all the values are NaN
+        bool MayBeNaN;
+    };
+
+    // Member Functions
+    bool Compile(const Expression &expression, const std::string &driver_topic, const std::string &caller, Program &out_program);
+    int CompileNode(const Expression::Node &node, const std::string &caller, Program &program);
+    bool FindDriverTopic(const Expression::Node &node, std::string &out_topic_name) const;
+    void EvaluateNode(Program &program, int node_idx, int start, int n);
+    Bounds FindBounds(const Program &program, int node_idx, int start, int n) const;
+    static Bounds MakeBounds(double min_value, double max_value, bool may_be_nan);
+    static bool IsAlwaysTrue(const Bounds &bounds);
+    static bool IsAlwaysFalse(const Bounds &bounds);
+    const std::vector<double> &GetColumn(int topic_idx, int field_idx);
+    const std::vector<long long> &GetTimes(int topic_idx);
+    void FindHeldRows(const std::vector<long long> &times, const std::vector<long long> &target_times, std::vector<int> &out_rows) const;
+
+    // Data Members
+    const Sequence &sequence;
+    long long start_time = 0;           // Time of the first message of the sequence
+    size_t skipped_messages = 0;        // Messages skipped by the last filter using the zone maps
+    std::map<std::pair<int, int>, std::vector<double> > columns;
+    std::map<int, std::vector<long long> > times;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Constructor function for Expression. Creates a constant expression.
+Expression::Expression(double value)
+{
+    std::shared_ptr<Node> node(new Node);
+    node->Op = Constant;
+    node->Value = value;
+    root = node;
+}
+
+// Create a constant expression
+Expression Expression::Value(double value)
+{
+    return Expression(value);
+}
+
+// Create an expression for the values of a field of a topic
+Expression Expression::Field(const std::string &topic_name, const std::string &field_label)
+{
+    std::shared_ptr<Node> node(new Node);
+    node->Op = FieldValue;
+    node->TopicName = topic_name;
+    node->FieldLabel = field_label;
+
+    Expression expr;
+    expr.root = node;
+    return expr;
+}
+
+// Create an expression for the time of the messages (seconds since the start of the sequence)
+Expression Expression::Time()
+{
+    std::shared_ptr<Node> node(new Node);
+    node->Op = ElapsedTime;
+
+    Expression expr;
+    expr.root = node;
+    return expr;
+}
+
+// Create an expression for the absolute value of an expression
+Expression Expression::Abs(const Expression &expr)
+{
+    return Unary(AbsoluteValue, expr);
+}
+
+// Create an expression that is true if both expressions are true (non-zero)
+Expression Expression::And(const Expression &expr1, const Expression &expr2)
+{
+    return Binary(LogicalAnd, expr1, expr2);
+}
+
+// Create an expression that is true if any of the expressions is true (non-zero)
+Expression Expression::Or(const Expression &expr1, const Expression &expr2)
+{
+    return Binary(LogicalOr, expr1, expr2);
+}
+
+// Create an expression that is true if the expression is false (zero)
+Expression Expression::Not(const Expression &expr)
+{
+    return Unary(LogicalNot, expr);
+}
+
+// Create an expression that applies a binary operator to two expressions
+Expression Expression::Binary(Operator op, const Expression &expr1, const Expression &expr2)
+{
+    std::shared_ptr<Node> node(new Node);
+    node->Op = op;
+    node->Left = expr1.root;
+    node->Right = expr2.root;
+
+    Expression expr;
+    expr.root = node;
+    return expr;
+}
+
+// Create an expression that applies a unary operator to an expression
+Expression Expression::Unary(Operator op, const Expression &expr)
+{
+    std::shared_ptr<Node> node(new Node);
+    node->Op = op;
+    node->Left = expr.root;
+
+    Expression out_expr;
+    out_expr.root = node;
+    return out_expr;
+}
+
+// Get the operator of the top node of the expression
+Expression::Operator Expression::GetOperator() const
+{
+    return root->Op;
+}
+
+// Convert the expression to a readable string
+std::string Expression::ToString() const
+{
+    return NodeToString(*root);
+}
+
+// Operators for building the expressions
+Expression operator+ (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Add, expr1, expr2); }
+Expression operator- (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Subtract, expr1, expr2); }
+Expression operator* (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Multiply, expr1, expr2); }
+Expression operator/ (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Divide, expr1, expr2); }
+Expression operator- (const Expression &expr) { return Expression::Unary(Expression::Negate, expr); }
+Expression operator< (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Less, expr1, expr2); }
+Expression operator<= (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::LessEqual, expr1, expr2); }
+Expression operator> (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Greater, expr1, expr2); }
+Expression operator>= (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::GreaterEqual, expr1, expr2); }
+Expression operator== (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::Equal, expr1, expr2); }
+Expression operator!= (const Expression &expr1, const Expression &expr2) { return Expression::Binary(Expression::NotEqual, expr1, expr2); }
+Expression operator&& (const Expression &expr1, const Expression &expr2) { return Expression::And(expr1, expr2); }
+Expression operator|| (const Expression &expr1, const Expression &expr2) { return Expression::Or(expr1, expr2); }
+Expression operator! (const Expression &expr) { return Expression::Not(expr); }
+
+// Returns true if a message is selected
+bool Selection::IsSelected(size_t msg_idx) const
+{
+    if (msg_idx >= Size) return false;
+    return (Bits[msg_idx >> 6] >> (msg_idx & 63)) & 1ULL;
+}
+
+// Get the number of the selected messages
+size_t Selection::Count() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < Bits.size(); ++i)
+        count += BitOps::PopCount(Bits[i]);
+    return count;
+}
+
+// Get the indices of the selected messages in the topic
+std::vector<int> Selection::GetIndices() const
+{
+    std::vector<int> indices;
+    indices.reserve(Count());
+    for (size_t w = 0; w < Bits.size(); ++w)
+    {
+        // Go through the set bits of the word
+        unsigned long long word = Bits[w];
+        while (word != 0)
+        {
+            indices.push_back((int)(w * 64 + BitOps::CountTrailingZeros(word)));
+            word &= word - 1;
+        }
+    }
+    return indices;
+}
+
+// Get the messages selected in both selections (of the same topic)
+Selection Selection::Intersect(const Selection &selection) const
+{
+    Selection result;
+    if (selection.TopicIdx != TopicIdx || selection.Size != Size)
+    {
+        std::cerr << "Intersect Error! The selections are not on the same topic." << std::endl;
+        return result;
+    }
+
+    result = *this;
+    for (size_t i = 0; i < Bits.size(); ++i)
+        result.Bits[i] &= selection.Bits[i];
+    return result;
+}
+
+// Get the messages selected in any of the selections (of the same topic)
+Selection Selection::Unite(const Selection &selection) const
+{
+    Selection result;
+    if (selection.TopicIdx != TopicIdx || selection.Size != Size)
+    {
+        std::cerr << "Unite Error! The selections are not on the same topic." << std::endl;
+        return result;
+    }
+
+    result = *this;
+    for (size_t i = 0; i < Bits.size(); ++i)
+        result.Bits[i] |= selection.Bits[i];
+    return result;
+}
+
+// Remove all the messages and the topic from the selection
+void Selection::Clear()
+{
+    TopicIdx = -1;
+    Size = 0;
+    Bits.clear();
+}
+
+// Batches of 1024 messages keep the buffers of a typical expression in the L1 cache
+const int QueryEngine::BatchSize = 1024;
+
+// Constructor function for QueryEngine. The sequence should stay loaded while the engine is used.
+QueryEngine::QueryEngine(const Sequence &sequence) : sequence(sequence)
+{
+    if (!sequence.MessageIndexList.empty())
+        start_time = sequence.GetMessage(0).DateTime.ToNanoseconds();
+}
+
+// Select the messages of the driver topic for which the predicate is true (non-zero)
+Selection QueryEngine::Filter(const Expression &predicate, const std::string &driver_topic)
+{
+    Selection selection;
+    skipped_messages = 0;
+
+    Program program;
+    if (!Compile(predicate, driver_topic, "Filter", program)) return selection;
+
+    int n_messages = (int)sequence.Topics[program.DriverIdx].Messages.size();
+    selection.TopicIdx = program.DriverIdx;
+    selection.Size = n_messages;
+    selection.Bits.assign((n_messages + 63) / 64, 0);
+
+    bool has_zone_maps = sequence.Topics[program.DriverIdx].HasZoneMaps();
+    for (int start = 0; start < n_messages; start += BatchSize)
+    {
+        int n = std::min(BatchSize, n_messages - start);
+
+        // Skip the batch if the zone maps decide the predicate for all of its messages
+        if (has_zone_maps)
+        {
+            Bounds bounds = FindBounds(program, 0, start, n);
+            if (IsAlwaysFalse(bounds) || IsAlwaysTrue(bounds))
+            {
+                if (IsAlwaysTrue(bounds))
+                    for (int w = 0; w * 64 < n; ++w)
+                        selection.Bits[start / 64 + w] = (n - w * 64 >= 64) ? ~0ULL : (1ULL << (n - w * 64)) - 1;
+                skipped_messages += n;
+                continue;
+            }
+        }
+
+        EvaluateNode(program, 0, start, n);
+
+        // Pack the results of the batch into the bitmap
+        const double *values = program.Buffers[0].data();
+        unsigned long long *words = &selection.Bits[start / 64];
+        for (int w = 0; w * 64 < n; ++w)
+        {
+            unsigned long long word = 0;
+            int n_bits = std::min(64, n - w * 64);
+            for (int b = 0; b < n_bits; ++b)
+                word |= (unsigned long long)(values[w * 64 + b] != 0) << b;
+            words[w] = word;
+        }
+    }
+
+    return selection;
+}
+
+// Evaluate an expression for all the messages of the driver topic
+std::vector<double> QueryEngine::Evaluate(const Expression &expression, const std::string &driver_topic)
+{
+    std::vector<double> values;
+
+    Program program;
+    if (!Compile(expression, driver_topic, "Evaluate", program)) return values;
+
+    int n_messages = (int)sequence.Topics[program.DriverIdx].Messages.size();
+    values.resize(n_messages);
+    for (int start = 0; start < n_messages; start += BatchSize)
+    {
+        int n = std::min(BatchSize, n_messages - start);
+        EvaluateNode(program, 0, start, n);
+        std::copy(program.Buffers[0].begin(), program.Buffers[0].begin() + n, values.begin() + start);
+    }
+
+    return values;
+}
+
+// Move a selection to another topic by time: a message of the topic is selected if the last message
+// of the selection topic received at or before it is selected. This allows combining the selections
+// of different topics (e.g., with Intersect).
+Selection QueryEngine::Align(const Selection &selection, const std::string &topic_name)
+{
+    Selection result;
+
+    int topic_idx = sequence.FindTopicIndex(topic_name);
+    if (topic_idx < 0)
+    {
+        std::cerr << "Align Error! '" << topic_name << "' topic not found." << std::endl;
+        return result;
+    }
+    if (selection.TopicIdx < 0 || selection.TopicIdx >= (int)sequence.Topics.size())
+    {
+        std::cerr << "Align Error! The selection is empty." << std::endl;
+        return result;
+    }
+
+    int n_messages = (int)sequence.Topics[topic_idx].Messages.size();
+    result.TopicIdx = topic_idx;
+    result.Size = n_messages;
+    result.Bits.assign((n_messages + 63) / 64, 0);
+
+    // Same topic, nothing to align
+    if (topic_idx == selection.TopicIdx)
+    {
+        result.Bits = selection.Bits;
+        return result;
+    }
+
+    std::vector<int> rows;
+    FindHeldRows(GetTimes(selection.TopicIdx), GetTimes(topic_idx), rows);
+    for (int i = 0; i < n_messages; ++i)
+        if (rows[i] >= 0 && selection.IsSelected(rows[i]))
+            result.Bits[i >> 6] |= 1ULL << (i & 63);
+
+    return result;
+}
+
+// Get the indices of the selected messages in the message list of the sequence (in the sequence order)
+std::vector<int> QueryEngine::ToMessageList(const Selection &selection) const
+{
+    std::vector<int> indices;
+    for (int i = 0; i < (int)sequence.MessageIndexList.size(); ++i)
+        if (sequence.MessageIndexList[i].TopicIdx == selection.TopicIdx
+            && selection.IsSelected(sequence.MessageIndexList[i].MessageIdx))
+            indices.push_back(i);
+    return indices;
+}
+
+// Get the number of the messages that the last filter did not evaluate because of the zone maps
+size_t QueryEngine::GetNumberOfSkippedMessages() const
+{
+    return skipped_messages;
+}
+
+// Remove the cached fields and times (e.g., after the sequence is refreshed)
+void QueryEngine::ClearCache()
+{
+    columns.clear();
+    times.clear();
+    start_time = sequence.MessageIndexList.empty() ? 0 : sequence.GetMessage(0).DateTime.ToNanoseconds();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Convert an expression node to a readable string
+std::string Expression::NodeToString(const Node &node)
+{
+    static const char *symbols[] = {"", "", "", "+", "-", "*", "/", "-", "abs",
+        "<", "<=", ">", ">=", "==", "!=", "&&", "||", "!"};
+
+    std::ostringstream output;
+    switch (node.Op)
+    {
+    case Constant:
+        output << node.Value;
+        break;
+    case FieldValue:
+        output << node.TopicName << "/" << node.FieldLabel;
+        break;
+    case ElapsedTime:
+        output << "time";
+        break;
+    case AbsoluteValue:
+        output << "abs(" << NodeToString(*node.Left) << ")";
+        break;
+    case Negate:
+    case LogicalNot:
+        output << symbols[node.Op] << "(" << NodeToString(*node.Left) << ")";
+        break;
+    default:
+        output << "(" << NodeToString(*node.Left) << " " << symbols[node.Op] << " " << NodeToString(*node.Right) << ")";
+    }
+    return output.str();
+}
+
+// Compile an expression for the evaluation on the driver topic. The caller name is used in the errors.
+bool QueryEngine::Compile(const Expression &expression, const std::string &driver_topic, const std::string &caller, Program &out_program)
+{
+    // Use the topic of the first field if the driver topic is not given
+    std::string driver_name = driver_topic;
+    if (driver_name.empty() && !FindDriverTopic(*expression.root, driver_name))
+    {
+        std::cerr << caller << " Error! The expression has no fields, please provide the driver topic." << std::endl;
+        return false;
+    }
+
+    out_program.DriverIdx = sequence.FindTopicIndex(driver_name);
+    if (out_program.DriverIdx < 0)
+    {
+        std::cerr << caller << " Error! '" << driver_name << "' topic not found." << std::endl;
+        return false;
+    }
+    out_program.DriverTimes = &GetTimes(out_program.DriverIdx);
+
+    // Compile the nodes (the root is the first node)
+    out_program.Nodes.clear();
+    if (CompileNode(*expression.root, caller, out_program) < 0) return false;
+
+    // Allocate the batch buffers and fill the constants once
+    out_program.Buffers.assign(out_program.Nodes.size(), std::vector<double>(BatchSize));
+    for (int i = 0; i < (int)out_program.Nodes.size(); ++i)
+        if (out_program.Nodes[i].Op == Expression::Constant)
+            std::fill(out_program.Buffers[i].begin(), out_program.Buffers[i].end(), out_program.Nodes[i].Value);
+
+    return true;
+}
+
+// Compile an expression node and its operands. Returns the index of the node or -1 on errors.
+int QueryEngine::CompileNode(const Expression::Node &node, const std::string &caller, Program &program)
+{
+    int node_idx = (int)program.Nodes.size();
+    program.Nodes.push_back(CompiledNode());
+    program.Nodes[node_idx].Op = node.Op;
+    program.Nodes[node_idx].Value = node.Value;
+
+    if (node.Op == Expression::FieldValue)
+    {
+        // Find the topic and the field
+        int topic_idx = sequence.FindTopicIndex(node.TopicName);
+        if (topic_idx < 0)
+        {
+            std::cerr << caller << " Error! '" << node.TopicName << "' topic not found." << std::endl;
+            return -1;
+        }
+        int field_idx = sequence.Topics[topic_idx].FindLabelIndex(node.FieldLabel);
+        if (field_idx < 0)
+        {
+            std::cerr << caller << " Error! '" << node.FieldLabel << "' field not found in '" << node.TopicName << "' topic." << std::endl;
+            return -1;
+        }
+
+        program.Nodes[node_idx].TopicIdx = topic_idx;
+        program.Nodes[node_idx].FieldIdx = field_idx;
+        program.Nodes[node_idx].Column = &GetColumn(topic_idx, field_idx);
+
+        // Align the fields of the other topics to the driver messages
+        if (topic_idx != program.DriverIdx)
+        {
+            std::map<int, std::vector<int> >::iterator it = program.HeldRows.find(topic_idx);
+            if (it == program.HeldRows.end())
+            {
+                it = program.HeldRows.insert(std::make_pair(topic_idx, std::vector<int>())).first;
+                FindHeldRows(GetTimes(topic_idx), *program.DriverTimes, it->second);
+            }
+            program.Nodes[node_idx].Rows = &it->second;
+        }
+    }
+
+    // Compile the operands
+    if (node.Left)
+    {
+        int left = CompileNode(*node.Left, caller, program);
+        if (left < 0) return -1;
+        program.Nodes[node_idx].Left = left;
+    }
+    if (node.Right)
+    {
+        int right = CompileNode(*node.Right, caller, program);
+        if (right < 0) return -1;
+        program.Nodes[node_idx].Right = right;
+    }
+
+    return node_idx;
+}
+
+// Find the topic of the first field of an expression. Returns false if there are no fields.
+bool QueryEngine::FindDriverTopic(const Expression::Node &node, std::string &out_topic_name) const
+{
+    if (node.Op == Expression::FieldValue)
+    {
+        out_topic_name = node.TopicName;
+        return true;
+    }
+    if (node.Left && FindDriverTopic(*node.Left, out_topic_name)) return true;
+    if (node.Right && FindDriverTopic(*node.Right, out_topic_name)) return true;
+    return false;
+}
+
+// Evaluate a compiled node for a batch of n driver messages starting from the given message
+void QueryEngine::EvaluateNode(Program &program, int node_idx, int start, int n)
+{
+    const CompiledNode &node = program.Nodes[node_idx];
+    double *out = program.Buffers[node_idx].data();
+
+    switch (node.Op)
+    {
+    case Expression::Constant:
+        return;
+
+    case Expression::FieldValue:
+    {
+        const double *column = node.Column->data();
+        if (node.Rows == NULL)
+            std::copy(column + start, column + start + n, out);
+        else
+        {
+            // Gather the held values of the other topic
+            const int *rows = node.Rows->data() + start;
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            for (int i = 0; i < n; ++i)
+                out[i] = rows[i] >= 0 ? column[rows[i]] : nan;
+        }
+        return;
+    }
+
+    case Expression::ElapsedTime:
+    {
+        const long long *driver_times = program.DriverTimes->data() + start;
+        for (int i = 0; i < n; ++i)
+            out[i] = (driver_times[i] - start_time) * 1e-9;
+        return;
+    }
+
+    case Expression::LogicalAnd:
+    case Expression::LogicalOr:
+    {
+        // Skip the second operand if the first one decides the whole batch
+        EvaluateNode(program, node.Left, start, n);
+        const double *a = program.Buffers[node.Left].data();
+        int n_true = 0;
+        for (int i = 0; i < n; ++i)
+            n_true += (a[i] != 0);
+
+        if (node.Op == Expression::LogicalAnd && n_true == 0)
+        {
+            std::fill(out, out + n, 0.0);
+            return;
+        }
+        if (node.Op == Expression::LogicalOr && n_true == n)
+        {
+            std::fill(out, out + n, 1.0);
+            return;
+        }
+
+        EvaluateNode(program, node.Right, start, n);
+        const double *b = program.Buffers[node.Right].data();
+        if (node.Op == Expression::LogicalAnd)
+            for (int i = 0; i < n; ++i) out[i] = (double)((a[i] != 0) & (b[i] != 0));
+        else
+            for (int i = 0; i < n; ++i) out[i] = (double)((a[i] != 0) | (b[i] != 0));
+        return;
+    }
+
+    default:
+        break;
+    }
+
+    // Unary operators
+    EvaluateNode(program, node.Left, start, n);
+    const double *a = program.Buffers[node.Left].data();
+    switch (node.Op)
+    {
+    case Expression::Negate:
+        for (int i = 0; i < n; ++i) out[i] = -a[i];
+        return;
+    case Expression::AbsoluteValue:
+        for (int i = 0; i < n; ++i) out[i] = std::fabs(a[i]);
+        return;
+    case Expression::LogicalNot:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] == 0);
+        return;
+    default:
+        break;
+    }
+
+    // Binary operators
+    EvaluateNode(program, node.Right, start, n);
+    const double *b = program.Buffers[node.Right].data();
+    switch (node.Op)
+    {
+    case Expression::Add:
+        for (int i = 0; i < n; ++i) out[i] = a[i] + b[i];
+        break;
+    case Expression::Subtract:
+        for (int i = 0; i < n; ++i) out[i] = a[i] - b[i];
+        break;
+    case Expression::Multiply:
+        for (int i = 0; i < n; ++i) out[i] = a[i] * b[i];
+        break;
+    case Expression::Divide:
+        for (int i = 0; i < n; ++i) out[i] = a[i] / b[i];
+        break;
+    case Expression::Less:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] < b[i]);
+        break;
+    case Expression::LessEqual:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] <= b[i]);
+        break;
+    case Expression::Greater:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] > b[i]);
+        break;
+    case Expression::GreaterEqual:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] >= b[i]);
+        break;
+    case Expression::Equal:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] == b[i]);
+        break;
+    case Expression::NotEqual:
+        for (int i = 0; i < n; ++i) out[i] = (double)(a[i] != b[i]);
+        break;
+    default:
+        break;
+    }
+}
+
+// Find the range of the values of a compiled node for a batch of n driver messages from the zone maps of
+// the driver topic. The range is conservative: all the values are in it, but it may be wider.
+QueryEngine::Bounds QueryEngine::FindBounds(const Program &program, int node_idx, int start, int n) const
+{
+    const CompiledNode &node = program.Nodes[node_idx];
+    const double inf = std::numeric_limits<double>::infinity();
+    const Bounds unknown = MakeBounds(-inf, inf, true), empty = MakeBounds(inf, -inf, true);
+    const Bounds always_false = MakeBounds(0, 0, false), always_true = MakeBounds(1, 1, false);
+    const Bounds unknown_bool = MakeBounds(0, 1, false);
+
+    switch (node.Op)
+    {
+    case Expression::Constant:
+        return MakeBounds(node.Value, node.Value, node.Value != node.Value);
+
+    case Expression::FieldValue:
+    case Expression::ElapsedTime:
+    {
+        // Only the driver fields and times are summarized per message block
+        if (node.Op == Expression::FieldValue && node.Rows != NULL) return unknown;
+        const Topic::ZoneMap &zones = sequence.Topics[program.DriverIdx].GetZoneMaps();
+        int first_block = start / zones.BlockSize, last_block = (start + n - 1) / zones.BlockSize;
+        if (last_block >= (int)zones.MinTimes.size()) return unknown;
+        if (node.Op == Expression::FieldValue && node.FieldIdx >= (int)zones.Counts.size()) return unknown;
+
+        Bounds bounds = empty;
+        bounds.MayBeNaN = false;
+        for (int b = first_block; b <= last_block; ++b)
+        {
+            if (node.Op == Expression::ElapsedTime)
+            {
+                bounds.Min = std::min(bounds.Min, (zones.MinTimes[b] - start_time) * 1e-9);
+                bounds.Max = std::max(bounds.Max, (zones.MaxTimes[b] - start_time) * 1e-9);
+                continue;
+            }
+            int block_length = std::min(zones.BlockSize, (int)sequence.Topics[program.DriverIdx].Messages.size() - b * zones.BlockSize);
+            bounds.Min = std::min(bounds.Min, zones.MinValues[node.FieldIdx][b]);
+            bounds.Max = std::max(bounds.Max, zones.MaxValues[node.FieldIdx][b]);
+            bounds.MayBeNaN |= zones.Counts[node.FieldIdx][b] < block_length;
+        }
+        return bounds;
+    }
+
+    default:
+        break;
+    }
+
+    Bounds a = FindBounds(program, node.Left, start, n);
+    Bounds b = node.Right >= 0 ? FindBounds(program, node.Right, start, n) : a;
+    bool a_is_nan = a.Min > a.Max, b_is_nan = b.Min > b.Max;
+    bool has_infinity = std::isinf(a.Min) || std::isinf(a.Max) || std::isinf(b.Min) || std::isinf(b.Max);
+    bool may_be_nan = a.MayBeNaN || b.MayBeNaN || has_infinity;
+
+    switch (node.Op)
+    {
+    // Arithmetic operators (NaN in, NaN out)
+    case Expression::Add:
+    case Expression::Subtract:
+    case Expression::Multiply:
+    case Expression::Divide:
+    {
+        if (a_is_nan || b_is_nan) return empty;
+        if (node.Op == Expression::Add) return MakeBounds(a.Min + b.Min, a.Max + b.Max, may_be_nan);
+        if (node.Op == Expression::Subtract) return MakeBounds(a.Min - b.Max, a.Max - b.Min, may_be_nan);
+        if (node.Op == Expression::Divide && b.Min <= 0 && b.Max >= 0) return unknown;
+
+        double values[4];
+        values[0] = node.Op == Expression::Multiply ? a.Min * b.Min : a.Min / b.Min;
+        values[1] = node.Op == Expression::Multiply ? a.Min * b.Max : a.Min / b.Max;
+        values[2] = node.Op == Expression::Multiply ? a.Max * b.Min : a.Max / b.Min;
+        values[3] = node.Op == Expression::Multiply ? a.Max * b.Max : a.Max / b.Max;
+        for (int i = 0; i < 4; ++i)
+            if (values[i] != values[i]) return unknown;
+        return MakeBounds(*std::min_element(values, values + 4), *std::max_element(values, values + 4), may_be_nan);
+    }
+    case Expression::Negate:
+        return a_is_nan ? empty : MakeBounds(-a.Max, -a.Min, a.MayBeNaN);
+    case Expression::AbsoluteValue:
+        if (a_is_nan) return empty;
+        if (a.Min >= 0) return a;
+        if (a.Max <= 0) return MakeBounds(-a.Max, -a.Min, a.MayBeNaN);
+        return MakeBounds(0, std::max(-a.Min, a.Max), a.MayBeNaN);
+
+    // Comparisons (false for NaN, except for not-equal)
+    case Expression::Less:
+        if (a_is_nan || b_is_nan || a.Min >= b.Max) return always_false;
+        return (!may_be_nan && a.Max < b.Min) ? always_true : unknown_bool;
+    case Expression::LessEqual:
+        if (a_is_nan || b_is_nan || a.Min > b.Max) return always_false;
+        return (!may_be_nan && a.Max <= b.Min) ? always_true : unknown_bool;
+    case Expression::Greater:
+        if (a_is_nan || b_is_nan || a.Max <= b.Min) return always_false;
+        return (!may_be_nan && a.Min > b.Max) ? always_true : unknown_bool;
+    case Expression::GreaterEqual:
+        if (a_is_nan || b_is_nan || a.Max < b.Min) return always_false;
+        return (!may_be_nan && a.Min >= b.Max) ? always_true : unknown_bool;
+    case Expression::Equal:
+        if (a_is_nan || b_is_nan || a.Max < b.Min || b.Max < a.Min) return always_false;
+        return (!may_be_nan && a.Min == a.Max && b.Min == b.Max && a.Min == b.Min) ? always_true : unknown_bool;
+    case Expression::NotEqual:
+        if (a_is_nan || b_is_nan || a.Max < b.Min || b.Max < a.Min) return always_true;
+        return (!may_be_nan && a.Min == a.Max && b.Min == b.Max && a.Min == b.Min) ? always_false : unknown_bool;
+
+    // Logical operators (NaN is true)
+    case Expression::LogicalAnd:
+        if (IsAlwaysFalse(a) || IsAlwaysFalse(b)) return always_false;
+        return (IsAlwaysTrue(a) && IsAlwaysTrue(b)) ? always_true : unknown_bool;
+    case Expression::LogicalOr:
+        if (IsAlwaysTrue(a) || IsAlwaysTrue(b)) return always_true;
+        return (IsAlwaysFalse(a) && IsAlwaysFalse(b)) ? always_false : unknown_bool;
+    case Expression::LogicalNot:
+        if (IsAlwaysTrue(a)) return always_false;
+        return IsAlwaysFalse(a) ? always_true : unknown_bool;
+
+    default:
+        return unknown;
+    }
+}
+
+// Create the range of the values of a node
+QueryEngine::Bounds QueryEngine::MakeBounds(double min_value, double max_value, bool may_be_nan)
+{
+    Bounds bounds;
+    bounds.Min = min_value;
+    bounds.Max = max_value;
+    bounds.MayBeNaN = may_be_nan;
+    return bounds;
+}
+
+// Returns true if all the values in the range are true (non-zero; NaN is also true)
+bool QueryEngine::IsAlwaysTrue(const Bounds &bounds)
+{
+    return bounds.Min > 0 || bounds.Max < 0;
+}
+
+// Returns true if all the values in the range are false (zero)
+bool QueryEngine::IsAlwaysFalse(const Bounds &bounds)
+{
+    return !bounds.MayBeNaN && bounds.Min == 0 && bounds.Max == 0;
+}
+
+// Get the parsed values of a field (NaN for the values that are not numbers). Parses the field on first use.
+const std::vector<double> &QueryEngine::GetColumn(int topic_idx, int field_idx)
+{
+    std::pair<int, int> key(topic_idx, field_idx);
+    std::map<std::pair<int, int>, std::vector<double> >::iterator it = columns.find(key);
+    if (it != columns.end()) return it->second;
+
+    const Topic &topic = sequence.Topics[topic_idx];
+    std::vector<double> &column = columns[key];
+    column.resize(topic.Messages.size());
+    Topic::FieldType type = topic.GetFieldType(field_idx);
+
+    // Copy the numeric fields from their stored values and parse the text fields
+    if (type == Topic::Float64)
+        std::copy(topic.GetColumn(field_idx).Numbers.begin(), topic.GetColumn(field_idx).Numbers.end(), column.begin());
+    else if (type == Topic::Bool || type == Topic::Int64)
+    {
+        const Topic::Column &stored = topic.GetColumn(field_idx);
+        std::copy(stored.Integers.begin(), stored.Integers.end(), column.begin());
+        for (size_t i = 0; i < stored.Missing.size(); ++i)
+            column[stored.Missing[i]] = std::numeric_limits<double>::quiet_NaN();
+    }
+    else
+        for (size_t i = 0; i < topic.Messages.size(); ++i)
+            column[i] = Topic::FieldToDouble(topic.Messages[i].Fields[field_idx]);
+    return column;
+}
+
+// Get the times of the messages of a topic (nanoseconds). Converts the times on first use.
+const std::vector<long long> &QueryEngine::GetTimes(int topic_idx)
+{
+    std::map<int, std::vector<long long> >::iterator it = times.find(topic_idx);
+    if (it != times.end()) return it->second;
+
+    return times[topic_idx] = sequence.Topics[topic_idx].GetTimesInNanoseconds();
+}
+
+// Find the last message (with the given times) received at or before each of the target times.
+// The index is -1 for the target times before the first message. Sorted times take a single pass.
+void QueryEngine::FindHeldRows(const std::vector<long long> &times, const std::vector<long long> &target_times, std::vector<int> &out_rows) const
+{
+    out_rows.resize(target_times.size());
+    int curr = 0, n_times = (int)times.size();
+    long long prev_time = target_times.empty() ? 0 : target_times[0];
+    for (size_t i = 0; i < target_times.size(); ++i)
+    {
+        long long time = target_times[i];
+
+        // Go back to the right message if the target times are not sorted
+        if (time < prev_time)
+            curr = (int)(std::upper_bound(times.begin(), times.end(), time) - times.begin());
+        prev_time = time;
+
+        while (curr < n_times && times[curr] <= time) ++curr;
+        out_rows[i] = curr - 1;
+    }
+}
+
+}
+#endif
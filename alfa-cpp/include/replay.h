@@ -0,0 +1,382 @@
+/*  ***************************************************************************
+*   replay.h - Header for replaying ALFA dataset sequences in real time.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_REPLAY_H
+#define ALFA_REPLAY_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "commons.h"
+#include "message.h"
+#include "sequence.h"
+#include "ringbuffer.h"
+
+namespace alfa
+{
+
+// This class replays the messages of a sequence in the order of their recording time and delivers
+// them to the registered consumers. Each consumer runs in its own thread and receives the messages
+// through a lock-free ring buffer, so a slow consumer loses messages instead of delaying the others.
+// The topics are read through Sequence::GetTopic, so a sequence in a memory budget loads its unloaded
+// topics again; its messages are copied into the events, since the budget may unload them at any time.
+class Replayer
+{
+public:
+
+    // Local struct definitions
+    struct Event                        // Structure for a replayed message
+    {
+        size_t MessageIdx = 0;          // Index in the sequence message list
+        int TopicIdx = -1;              // Index of the topic in the sequence
+        int TopicMessageIdx = -1;       // Index of the message in the topic
+        const Message *Msg = NULL;      // The message (owned by the sequence or by MessageCopy)
+        std::shared_ptr<const Message> MessageCopy; // Copy of the message if the sequence has a topic tracker
+        long long RecordedTime = 0;     // Recording time relative to the first message (nanoseconds)
+        long long ScheduledTime = 0;    // Planned delivery time relative to the replay start (nanoseconds)
+        long long DispatchTime = 0;     // Actual delivery time relative to the replay start (nanoseconds)
+    };
+
+    struct TimingStats                  // Structure for the timing statistics (microseconds)
+    {
+        size_t Count = 0;
+        double Mean = 0, Median = 0, Percentile99 = 0, Max = 0;
+    };
+
+    struct ConsumerStats                // Structure for the statistics of a consumer
+    {
+        size_t Delivered = 0;           // Number of messages processed by the consumer
+        size_t Dropped = 0;             // Number of messages lost because the consumer buffer was full
+        TimingStats Latency;            // Time from the dispatch until the consumer received the message
+    };
+
+    typedef std::function<void(const Event &)> ConsumerCallback;
+
+    // Constructors & Deconstructors
+    Replayer(const Sequence &sequence);
+    ~Replayer();
+
+    // Member Functions
+    int AddConsumer(const ConsumerCallback &callback, size_t buffer_size = 4096, const std::vector<int> &topics = std::vector<int>());
+    void SetSpeed(double speed);
+    double GetSpeed() const;
+    bool Start();
+    void Wait();
+    void Stop();
+    bool IsRunning() const;
+    TimingStats GetPacingStats() const;
+    ConsumerStats GetConsumerStats(int consumer_idx) const;
+    int GetNumberOfConsumers() const;
+
+private:
+    // Local struct definitions
+    struct Consumer                     // Structure for a registered consumer
+    {
+        ConsumerCallback Callback;
+        std::vector<bool> Topics;       // Topics delivered to the consumer (empty for all)
+        std::unique_ptr<SPSCRingBuffer<Event> > Buffer;
+        std::thread Thread;
+        std::atomic<size_t> Dropped;
+        std::vector<long long> Latencies;
+        size_t Delivered = 0;
+    };
+
+    // Member Functions
+    void RunProducer();
+    void RunConsumer(Consumer &consumer);
+    long long GetElapsedTime() const;
+    static TimingStats ComputeStats(std::vector<long long> samples);
+
+    // Data Members
+    const Sequence &sequence;
+    std::vector<std::unique_ptr<Consumer> > consumers;
+    double speed = 1.0;
+    std::thread producer;
+    std::atomic<bool> is_running, is_producer_done, stop_requested;
+    std::atomic<int> n_running_threads; // The last thread to finish clears is_running
+    std::chrono::steady_clock::time_point start_time;
+    std::vector<long long> jitters;
+
+    // Sleeping is not precise, so the last part of the wait is spent spinning (nanoseconds)
+    static const long long SpinTime;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// The time spent spinning before each scheduled delivery instead of sleeping
+const long long Replayer::SpinTime = 200000;
+
+// Constructor function for Replayer. The sequence should stay valid while replaying.
+Replayer::Replayer(const Sequence &sequence)
+    : sequence(sequence), is_running(false), is_producer_done(false), stop_requested(false), n_running_threads(0)
+{
+}
+
+// Destructor function for Replayer. Stops the replay if it is running.
+Replayer::~Replayer()
+{
+    Stop();
+}
+
+// Register a consumer for the messages of the given topics (or all the topics if empty).
+// Returns the index of the consumer, or -1 if the replay is already running.
+int Replayer::AddConsumer(const ConsumerCallback &callback, size_t buffer_size, const std::vector<int> &topics)
+{
+    if (IsRunning())
+    {
+        std::cerr << "AddConsumer Error! Cannot add consumers while replaying." << std::endl;
+        return -1;
+    }
+
+    std::unique_ptr<Consumer> consumer(new Consumer());
+    consumer->Callback = callback;
+    consumer->Buffer.reset(new SPSCRingBuffer<Event>(buffer_size));
+    consumer->Dropped = 0;
+
+    // Mark the desired topics
+    if (!topics.empty())
+    {
+        consumer->Topics.assign(sequence.Topics.size(), false);
+        for (int i = 0; i < (int)topics.size(); ++i)
+            if (topics[i] >= 0 && topics[i] < (int)sequence.Topics.size())
+                consumer->Topics[topics[i]] = true;
+    }
+
+    consumers.push_back(std::move(consumer));
+    return (int)consumers.size() - 1;
+}
+
+// Set the replay speed: 1 for real time, N for N times faster and 0 for as fast as possible
+void Replayer::SetSpeed(double speed)
+{
+    this->speed = std::max(speed, 0.0);
+}
+
+// Get the replay speed
+double Replayer::GetSpeed() const
+{
+    return speed;
+}
+
+// Start replaying the sequence in the background. Returns false if it cannot be started.
+bool Replayer::Start()
+{
+    if (IsRunning())
+    {
+        std::cerr << "Start Error! The replay is already running." << std::endl;
+        return false;
+    }
+
+    // Wait for the previous replay to finish
+    Wait();
+
+    // Reset the statistics
+    jitters.clear();
+    jitters.reserve(sequence.MessageIndexList.size());
+    for (int i = 0; i < (int)consumers.size(); ++i)
+    {
+        consumers[i]->Dropped = 0;
+        consumers[i]->Delivered = 0;
+        consumers[i]->Latencies.clear();
+    }
+
+    // Start the consumer threads and then the producer thread
+    is_running = true;
+    n_running_threads = (int)consumers.size() + 1;
+    is_producer_done = false;
+    stop_requested = false;
+    start_time = std::chrono::steady_clock::now();
+    for (int i = 0; i < (int)consumers.size(); ++i)
+        consumers[i]->Thread = std::thread(&Replayer::RunConsumer, this, std::ref(*consumers[i]));
+    producer = std::thread(&Replayer::RunProducer, this);
+
+    return true;
+}
+
+// Wait until all the messages are replayed and processed by the consumers
+void Replayer::Wait()
+{
+    if (producer.joinable()) producer.join();
+    for (int i = 0; i < (int)consumers.size(); ++i)
+        if (consumers[i]->Thread.joinable()) consumers[i]->Thread.join();
+    is_running = false;
+}
+
+// Stop the replay without delivering the remaining messages
+void Replayer::Stop()
+{
+    stop_requested = true;
+    Wait();
+}
+
+// Returns true if the replay is running (false once all the messages are replayed and processed)
+bool Replayer::IsRunning() const
+{
+    return is_running;
+}
+
+// Get the difference between the scheduled and the actual delivery times of the messages.
+// Should be called after the replay is finished.
+Replayer::TimingStats Replayer::GetPacingStats() const
+{
+    return ComputeStats(jitters);
+}
+
+// Get the statistics of a consumer. Should be called after the replay is finished.
+Replayer::ConsumerStats Replayer::GetConsumerStats(int consumer_idx) const
+{
+    ConsumerStats stats;
+    if (consumer_idx < 0 || consumer_idx >= (int)consumers.size()) return stats;
+
+    stats.Delivered = consumers[consumer_idx]->Delivered;
+    stats.Dropped = consumers[consumer_idx]->Dropped;
+    stats.Latency = ComputeStats(consumers[consumer_idx]->Latencies);
+    return stats;
+}
+
+// Get the number of registered consumers
+int Replayer::GetNumberOfConsumers() const
+{
+    return (int)consumers.size();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Walk through the message list and hand the messages to the consumers at their scheduled times
+void Replayer::RunProducer()
+{
+    const std::vector<Sequence::MessageIndex> &index_list = sequence.MessageIndexList;
+    bool has_tracker = sequence.GetTopicTracker() != NULL;
+    long long first_time = index_list.empty() ? 0 : sequence.GetMessage(0).DateTime.ToNanoseconds();
+
+    for (size_t i = 0; i < index_list.size() && !stop_requested; ++i)
+    {
+        // Prepare the event for the message (skip it if its topic could not be loaded again)
+        Event event;
+        event.MessageIdx = i;
+        event.TopicIdx = index_list[i].TopicIdx;
+        event.TopicMessageIdx = index_list[i].MessageIdx;
+        const Topic &topic = sequence.GetTopic(event.TopicIdx);
+        if (event.TopicMessageIdx >= (int)topic.Messages.size()) continue;
+        if (has_tracker)
+            event.MessageCopy = std::make_shared<const Message>(topic.Messages[event.TopicMessageIdx]);
+        event.Msg = has_tracker ? event.MessageCopy.get() : &topic.Messages[event.TopicMessageIdx];
+
+        long long recorded_time = event.Msg->DateTime.ToNanoseconds();
+        event.RecordedTime = recorded_time - first_time;
+
+        // Wait until the scheduled time: sleep first and spin at the end for precision
+        if (speed > 0)
+        {
+            event.ScheduledTime = (long long)(event.RecordedTime / speed);
+            long long remaining = event.ScheduledTime - GetElapsedTime();
+            if (remaining > SpinTime)
+                std::this_thread::sleep_for(std::chrono::nanoseconds(remaining - SpinTime));
+            while (GetElapsedTime() < event.ScheduledTime && !stop_requested) {}
+        }
+        else
+            event.ScheduledTime = GetElapsedTime();
+
+        // Hand the message to the consumers without waiting for them
+        event.DispatchTime = GetElapsedTime();
+        jitters.push_back(event.DispatchTime - event.ScheduledTime);
+        for (int c = 0; c < (int)consumers.size(); ++c)
+        {
+            Consumer &consumer = *consumers[c];
+            if (!consumer.Topics.empty() && !consumer.Topics[event.TopicIdx]) continue;
+            if (!consumer.Buffer->TryPush(event))
+                consumer.Dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    is_producer_done = true;
+    if (--n_running_threads == 0) is_running = false;
+}
+
+// Receive the messages from the buffer of a consumer and pass them to its callback
+void Replayer::RunConsumer(Consumer &consumer)
+{
+    Event event;
+    int idle_count = 0;
+    while (!stop_requested)
+    {
+        if (consumer.Buffer->TryPop(event))
+        {
+            consumer.Latencies.push_back(GetElapsedTime() - event.DispatchTime);
+            consumer.Callback(event);
+            consumer.Delivered++;
+            idle_count = 0;
+            continue;
+        }
+
+        // Finish when the producer is done and the buffer is empty
+        if (is_producer_done && consumer.Buffer->IsEmpty()) break;
+
+        // Spin for a while before sleeping to keep the latency low
+        if (++idle_count < 100)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    if (--n_running_threads == 0) is_running = false;
+}
+
+// Get the time since the start of the replay in nanoseconds
+long long Replayer::GetElapsedTime() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+// Compute the statistics of the time samples (given in nanoseconds) in microseconds
+Replayer::TimingStats Replayer::ComputeStats(std::vector<long long> samples)
+{
+    TimingStats stats;
+    stats.Count = samples.size();
+    if (samples.empty()) return stats;
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+        sum += samples[i];
+
+    stats.Mean = sum / samples.size() / 1e3;
+    stats.Median = samples[samples.size() / 2] / 1e3;
+    stats.Percentile99 = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)] / 1e3;
+    stats.Max = samples.back() / 1e3;
+    return stats;
+}
+
+}
+#endif
@@ -0,0 +1,279 @@
+/*  ***************************************************************************
+*   ringbuffer.h - Header for the lock-free queues used to pass ALFA messages
+*   between threads.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_RINGBUFFER_H
+#define ALFA_RINGBUFFER_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace alfa
+{
+
+// This class is a bounded lock-free queue for one producer thread and one consumer thread.
+// The producer never waits for the consumer: pushing to a full buffer fails immediately.
+template <typename T>
+class SPSCRingBuffer
+{
+public:
+
+    // Constructors & Deconstructors
+    explicit SPSCRingBuffer(size_t capacity = 1024);
+
+    // Member Functions
+    bool TryPush(const T &item);
+    bool TryPop(T &out_item);
+    size_t Size() const;
+    size_t Capacity() const;
+    bool IsEmpty() const;
+
+private:
+    // The buffer cannot be copied while the threads are using it
+    SPSCRingBuffer(const SPSCRingBuffer &);
+    SPSCRingBuffer &operator=(const SPSCRingBuffer &);
+
+    // Data Members
+    std::vector<T> buffer;
+    size_t mask;
+
+    // The read and write positions are kept on separate cache lines by padding them (alignas would need an
+    // aligned new, which C++11 does not have for the buffers created with new)
+    static const size_t CacheLineSize = 64;
+    char padding_before_head[CacheLineSize];
+    std::atomic<size_t> head;               // Next position to read (owned by the consumer)
+    char padding_before_tail[CacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> tail;               // Next position to write (owned by the producer)
+    char padding_after_tail[CacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+// This class is a bounded lock-free queue for any number of producer and consumer threads.
+// Each slot has a sequence number that tells the threads whether it is ready to be written or read.
+template <typename T>
+class MPMCRingBuffer
+{
+public:
+
+    // Constructors & Deconstructors
+    explicit MPMCRingBuffer(size_t capacity = 1024);
+
+    // Member Functions
+    bool TryPush(const T &item);
+    bool TryPop(T &out_item);
+    size_t Size() const;
+    size_t Capacity() const;
+    bool IsEmpty() const;
+
+private:
+    // Local struct definitions
+    struct Cell
+    {
+        std::atomic<size_t> Sequence;
+        T Data;
+    };
+
+    // The buffer cannot be copied while the threads are using it
+    MPMCRingBuffer(const MPMCRingBuffer &);
+    MPMCRingBuffer &operator=(const MPMCRingBuffer &);
+
+    // Data Members
+    std::unique_ptr<Cell[]> buffer;
+    size_t mask;
+
+    // The read and write positions are kept on separate cache lines by padding them (see SPSCRingBuffer)
+    static const size_t CacheLineSize = 64;
+    char padding_before_head[CacheLineSize];
+    std::atomic<size_t> head;               // Next position to read
+    char padding_before_tail[CacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> tail;               // Next position to write
+    char padding_after_tail[CacheLineSize - sizeof(std::atomic<size_t>)];
+};
+
+/******************************************************************************/
+/******************* SPSCRingBuffer Function Definitions **********************/
+/******************************************************************************/
+
+// Constructor function for SPSCRingBuffer. The capacity is rounded up to a power of two.
+template <typename T>
+SPSCRingBuffer<T>::SPSCRingBuffer(size_t capacity)
+    : head(0), tail(0)
+{
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    buffer.resize(size);
+    mask = size - 1;
+}
+
+// Add an item to the buffer. Returns false if the buffer is full. Only called by the producer.
+template <typename T>
+bool SPSCRingBuffer<T>::TryPush(const T &item)
+{
+    size_t curr_tail = tail.load(std::memory_order_relaxed);
+    if (curr_tail - head.load(std::memory_order_acquire) > mask)
+        return false;
+
+    buffer[curr_tail & mask] = item;
+    tail.store(curr_tail + 1, std::memory_order_release);
+    return true;
+}
+
+// Remove the oldest item from the buffer. Returns false if the buffer is empty. Only called by the consumer.
+template <typename T>
+bool SPSCRingBuffer<T>::TryPop(T &out_item)
+{
+    size_t curr_head = head.load(std::memory_order_relaxed);
+    if (curr_head == tail.load(std::memory_order_acquire))
+        return false;
+
+    out_item = std::move(buffer[curr_head & mask]);
+    head.store(curr_head + 1, std::memory_order_release);
+    return true;
+}
+
+// Get the number of items in the buffer (may be outdated when the other thread is running)
+template <typename T>
+size_t SPSCRingBuffer<T>::Size() const
+{
+    return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+}
+
+// Get the maximum number of items in the buffer
+template <typename T>
+size_t SPSCRingBuffer<T>::Capacity() const
+{
+    return buffer.size();
+}
+
+// Returns true if the buffer is empty (may be outdated when the other thread is running)
+template <typename T>
+bool SPSCRingBuffer<T>::IsEmpty() const
+{
+    return Size() == 0;
+}
+
+/******************************************************************************/
+/******************* MPMCRingBuffer Function Definitions **********************/
+/******************************************************************************/
+
+// Constructor function for MPMCRingBuffer. The capacity is rounded up to a power of two.
+template <typename T>
+MPMCRingBuffer<T>::MPMCRingBuffer(size_t capacity)
+    : head(0), tail(0)
+{
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    buffer.reset(new Cell[size]);
+    mask = size - 1;
+
+    // Each slot is ready to be written in its first round
+    for (size_t i = 0; i < size; ++i)
+        buffer[i].Sequence.store(i, std::memory_order_relaxed);
+}
+
+// Add an item to the buffer. Returns false if the buffer is full.
+template <typename T>
+bool MPMCRingBuffer<T>::TryPush(const T &item)
+{
+    Cell *cell;
+    size_t pos = tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &buffer[pos & mask];
+        size_t seq = cell->Sequence.load(std::memory_order_acquire);
+        long long diff = (long long)seq - (long long)pos;
+
+        // Claim the slot if it is free in this round, otherwise check if the buffer is full
+        if (diff == 0)
+        {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = tail.load(std::memory_order_relaxed);
+    }
+
+    cell->Data = item;
+    cell->Sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Remove the oldest item from the buffer. Returns false if the buffer is empty.
+template <typename T>
+bool MPMCRingBuffer<T>::TryPop(T &out_item)
+{
+    Cell *cell;
+    size_t pos = head.load(std::memory_order_relaxed);
+    while (true)
+    {
+        cell = &buffer[pos & mask];
+        size_t seq = cell->Sequence.load(std::memory_order_acquire);
+        long long diff = (long long)seq - (long long)(pos + 1);
+
+        // Claim the slot if it is written in this round, otherwise check if the buffer is empty
+        if (diff == 0)
+        {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false;
+        else
+            pos = head.load(std::memory_order_relaxed);
+    }
+
+    out_item = std::move(cell->Data);
+    cell->Sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+// Get the number of items in the buffer (may be outdated when the other threads are running)
+template <typename T>
+size_t MPMCRingBuffer<T>::Size() const
+{
+    size_t curr_tail = tail.load(std::memory_order_acquire);
+    size_t curr_head = head.load(std::memory_order_acquire);
+    return curr_tail > curr_head ? curr_tail - curr_head : 0;
+}
+
+// Get the maximum number of items in the buffer
+template <typename T>
+size_t MPMCRingBuffer<T>::Capacity() const
+{
+    return mask + 1;
+}
+
+// Returns true if the buffer is empty (may be outdated when the other threads are running)
+template <typename T>
+bool MPMCRingBuffer<T>::IsEmpty() const
+{
+    return Size() == 0;
+}
+
+}
+#endif
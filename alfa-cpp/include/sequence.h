@@ -33,12 +33,29 @@
 #include <queue>
 #include <functional>
 #include <map>
+#include <iterator>
+#include <mutex>
 #include "commons.h"
 #include "topic.h"
+#include "faults.h"
+#include "loadspec.h"
+#include "ingest.h"
 
 namespace alfa
 {
 
+class Sequence;
+
+// Interface for the objects that keep track of the use of the topics of the sequences (e.g., MemoryBudget).
+// The tracker is told before a topic is accessed through Sequence::GetTopic, so it can load the topic if needed.
+class TopicTracker
+{
+public:
+    virtual ~TopicTracker() {}
+    virtual void OnTopicAccess(const Sequence &sequence, int topic_idx) = 0;
+    virtual void OnSequenceCleared(const Sequence &sequence) = 0;
+};
+
 // This class keeps the information of a dataset sequence
 class Sequence
 {
@@ -53,6 +70,13 @@ public:
             : TopicIdx(topic_idx), MessageIdx(message_idx) {}
     };
 
+    // Local enum definitions
+    enum OrderingMode                   // How the messages of the topics are ordered in the message list
+    {
+        FullMessage,                    // By time, then sequence id, header stamp and fields (Message::operator<)
+        TimeOnly                        // By time, then topic index and message index (linear-time radix sort)
+    };
+
     // Class Data Members
     std::string Name = "N/A";
     std::string DirectoryPath;
@@ -61,29 +85,94 @@ public:
 
     // Constructors & Deconstructors
     Sequence(const std::string &sequence_dir = "", const std::string &sequence_name = "N/A");
+    Sequence(const Sequence &sequence) = default;
+    Sequence(Sequence &&sequence) = default;
+    Sequence &operator= (const Sequence &sequence) = default;
+    Sequence &operator= (Sequence &&sequence) = default;
+    ~Sequence();
 
     // Member Functions
     bool LoadSequence(const std::string &sequence_dir, const std::string &sequence_name);
+    bool FollowSequence(const std::string &sequence_dir, const std::string &sequence_name);
+    int Refresh();
     bool IsInitialized() const;
     void Clear();
-    Message GetMessage(size_t msg_idx);
-    void PrintBriefInfo();
-    std::vector<int> GetFaultTopics();
-    double GetTotalDuration();
-    double GetNormalFlightDuration();
-    int FindFirstFaultMessage();
-    int FindTopicIndex(const std::string &topic_name);
+    void SetOrderingMode(OrderingMode mode);
+    OrderingMode GetOrderingMode() const;
+    void SetZoneMapBlockSize(int block_size);
+    void SetLoadSpec(const LoadSpec &spec);
+    void SetNumberOfThreads(int n_threads);
+    void SetBatchedReading(bool batched);
+    const LoadSpec &GetLoadSpec() const;
+    Message GetMessage(size_t msg_idx) const;
+    const Topic &GetTopic(int topic_idx) const;
+    void SetTopicTracker(TopicTracker *tracker);
+    TopicTracker *GetTopicTracker() const;
+    size_t GetMemoryFootprint() const;
+    void PrintBriefInfo() const;
+    std::vector<int> GetFaultTopics() const;
+    double GetTotalDuration() const;
+    double GetNormalFlightDuration() const;
+    int FindFirstFaultMessage() const;
+    const FaultTimeline &GetFaultTimeline() const;
+    void SetFaultGapThreshold(double gap_threshold);
+    int FindTopicIndex(const std::string &topic_name) const;
+    static bool ParseBagPath(const std::string &bag_path, std::string &out_sequence_dir, std::string &out_sequence_name);
+    static int LoadSequences(std::vector<Sequence> &sequences, const VecString &sequence_dirs, const VecString &sequence_names);
 
 private:
+    // Compressed sequences restore the private members on decompression, and shared sequences on copying
+    friend class CompressedSequence;
+    friend class SharedSequence;
+
     // Data Members
     bool is_initialized = false;
+    bool follow_mode = false;
+    OrderingMode ordering_mode = FullMessage;
+    int zone_map_block_size = 0;
+    LoadSpec load_spec;
+    int n_threads = 0;
+    bool batched_reading = false;
+
+    // The tracker keeps track of this object, so it is not copied or moved with the sequence
+    struct TrackerPointer
+    {
+        TopicTracker *Tracker = NULL;
+        TrackerPointer() {}
+        TrackerPointer(const TrackerPointer &) {}
+        TrackerPointer &operator= (const TrackerPointer &) { return *this; }
+    } topic_tracker;
+
+    // The lock for loading the unloaded topics again without a tracker (a copy has its own lock)
+    struct ReloadLock
+    {
+        std::mutex Mutex;
+        ReloadLock() {}
+        ReloadLock(const ReloadLock &) {}
+        ReloadLock &operator= (const ReloadLock &) { return *this; }
+    };
+    mutable ReloadLock reload_lock;
+
     std::map<std::string, int> topic_map;
 
+    // Fault ground truth index, updated whenever the messages change
+    FaultTimeline fault_timeline;
+    double fault_gap_threshold = FaultTimeline::DefaultGapThreshold;
+    int first_fault_message = -1;
+
     // Member Functions
     std::string ExtractTopicName(const std::string &topic_filename);
     bool ExtractTopicNames(VecString &out_topic_files, VecString &out_topic_names);
+    void AddTopic(const std::string &topic_filename, const std::string &topic_name);
+    Topic &CreateTopic(const std::string &topic_name);
+    void IndexTopic(int topic_idx);
+    std::string GetTopicPath(const std::string &topic_filename) const;
+    static int LoadTopicsInBatch(const std::vector<Sequence *> &sequences);
     void CreateMessageList();
-    bool CompareMessageIndices(MessageIndex msg1, MessageIndex msg2);
+    void MergeTopicMessages(const std::vector<int> &start_indices, std::vector<MessageIndex> &out_list);
+    void SortTopicMessagesByTime(const std::vector<int> &start_indices, std::vector<MessageIndex> &out_list) const;
+    bool CompareMessageIndices(MessageIndex msg1, MessageIndex msg2) const;
+    void BuildFaultIndex();
 };
 
 /******************************************************************************/
@@ -98,6 +187,13 @@ Sequence::Sequence(const std::string &sequence_dir, const std::string &sequence_
         LoadSequence(sequence_dir, sequence_name);
 }
 
+// Destructor function for Sequence. Tells the topic tracker that the topics are gone.
+Sequence::~Sequence()
+{
+    if (topic_tracker.Tracker != NULL)
+        topic_tracker.Tracker->OnSequenceCleared(*this);
+}
+
 // Load all the topic files in a sequence
 bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &sequence_name)
 {
@@ -105,6 +201,10 @@ bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &
     DirectoryPath = sequence_dir;
     Name = sequence_name;
 
+    // Read all the topic files at once if it is asked
+    if (batched_reading)
+        return LoadTopicsInBatch(std::vector<Sequence *>(1, this)) == 1;
+
     // Extract the list of all the topic names and topic filenames
     VecString topic_list, topic_file_list;
     if (ExtractTopicNames(topic_file_list, topic_list) == false)
@@ -116,17 +216,11 @@ bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &
 
     // Load all the topics
     for (int i = 0; i < (int)topic_list.size(); ++i)
-    {
-        std::string topic_full_filename = sequence_dir + topic_file_list[i] + "." + Commons::CSVFileExtension;
-        Topics.push_back(Topic(topic_full_filename, topic_list[i]));
-    }
+        AddTopic(topic_file_list[i], topic_list[i]);
 
-    // Create the sorted message list of all the topics
+    // Create the sorted message list of all the topics and index the faults
     CreateMessageList();
-
-    // Create the table of the topic names vs. their indices
-    for (int i = 0; i < (int)Topics.size(); ++i)
-        this->topic_map.insert(std::make_pair(Topics[i].Name, i));
+    BuildFaultIndex();
 
     // Initialization done
     is_initialized = true;
@@ -134,6 +228,76 @@ bool Sequence::LoadSequence(const std::string &sequence_dir, const std::string &
     return IsInitialized();
 }
 
+// Load all the topic files in a sequence that is still being recorded. The directory may not have
+// any topic files yet. Use Refresh to read the new messages.
+bool Sequence::FollowSequence(const std::string &sequence_dir, const std::string &sequence_name)
+{
+    // Save the given directory and sequence name
+    DirectoryPath = sequence_dir;
+    Name = sequence_name;
+
+    // Initialization done, the existing topic files are read as new data
+    follow_mode = true;
+    is_initialized = true;
+    Refresh();
+
+    return IsInitialized();
+}
+
+// Read the messages added to the topic files (and the new topic files) since the last refresh and merge
+// them into the message list. The cost depends on the size of the new data, not the whole sequence.
+// Returns the number of new messages, or -1 if the sequence is not followed.
+int Sequence::Refresh()
+{
+    // Only the followed sequences can be refreshed
+    if (!IsInitialized() || !follow_mode)
+    {
+        std::cerr << "Refresh Error! The sequence is not loaded in the follow mode." << std::endl;
+        return -1;
+    }
+
+    // Read the new lines of the topic files
+    std::vector<int> start_indices(Topics.size());
+    for (int i = 0; i < (int)Topics.size(); ++i)
+    {
+        start_indices[i] = Topics[i].Messages.size();
+        Topics[i].ReadAppendedData();
+    }
+
+    // Add the topic files created after the last refresh
+    VecString topic_list, topic_file_list;
+    if (ExtractTopicNames(topic_file_list, topic_list))
+        for (int i = 0; i < (int)topic_list.size(); ++i)
+            if (FindTopicIndex(topic_list[i]) < 0)
+            {
+                AddTopic(topic_file_list[i], topic_list[i]);
+                start_indices.push_back(0);
+            }
+
+    // Merge the new messages of all the topics
+    std::vector<MessageIndex> new_list;
+    if (ordering_mode == TimeOnly)
+        SortTopicMessagesByTime(start_indices, new_list);
+    else
+        MergeTopicMessages(start_indices, new_list);
+    if (new_list.empty()) return 0;
+
+    // Find the position of the first new message. Normally it is after all the existing messages.
+    std::vector<MessageIndex>::iterator it = std::upper_bound(MessageIndexList.begin(), MessageIndexList.end(), new_list[0],
+        [this](const MessageIndex &msg1, const MessageIndex &msg2) { return CompareMessageIndices(msg1, msg2); });
+
+    // Merge the new messages with the existing messages after that position
+    std::vector<MessageIndex> old_tail(it, MessageIndexList.end());
+    MessageIndexList.erase(it, MessageIndexList.end());
+    std::merge(old_tail.begin(), old_tail.end(), new_list.begin(), new_list.end(), std::back_inserter(MessageIndexList),
+        [this](const MessageIndex &msg1, const MessageIndex &msg2) { return CompareMessageIndices(msg1, msg2); });
+
+    // The new messages may include new faults
+    BuildFaultIndex();
+
+    return (int)new_list.size();
+}
+
 // Returns the initialization status
 bool Sequence::IsInitialized() const
 {
@@ -143,26 +307,138 @@ bool Sequence::IsInitialized() const
 // Clear the entire sequence object
 void Sequence::Clear()
 {
+    // Detach from the topic tracker
+    if (topic_tracker.Tracker != NULL)
+        topic_tracker.Tracker->OnSequenceCleared(*this);
+    topic_tracker.Tracker = NULL;
+
     Name = "N/A";
     DirectoryPath = "";
     Topics.clear();
     MessageIndexList.clear();
     is_initialized = false;
+    follow_mode = false;
     topic_map.clear();
+    fault_timeline.Clear();
+    first_fault_message = -1;
+}
+
+// Set how the messages with equal recording times are ordered. Should be called before loading the sequence;
+// the message list of a loaded sequence is sorted again.
+void Sequence::SetOrderingMode(OrderingMode mode)
+{
+    ordering_mode = mode;
+
+    if (IsInitialized())
+    {
+        MessageIndexList.clear();
+        CreateMessageList();
+        BuildFaultIndex();
+    }
+}
+
+// Get the ordering mode of the message list
+Sequence::OrderingMode Sequence::GetOrderingMode() const
+{
+    return ordering_mode;
+}
+
+// Set the topics and the fields to load (see LoadSpec). Should be called before loading the sequence;
+// the topics that are already loaded are not changed.
+void Sequence::SetLoadSpec(const LoadSpec &spec)
+{
+    load_spec = spec;
+}
+
+// Set the number of threads for parsing each large topic file (0 for one per core, the default; see
+// Topic::SetNumberOfThreads)
+void Sequence::SetNumberOfThreads(int n_threads)
+{
+    this->n_threads = n_threads;
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        Topics[i].SetNumberOfThreads(n_threads);
+}
+
+// Set if the topic files are read at once with batched I/O (see FileIngestor) instead of one by one.
+// The files are then parsed on several threads, one file per thread. Does not apply to the follow mode.
+void Sequence::SetBatchedReading(bool batched)
+{
+    batched_reading = batched;
+}
+
+// Get the topics and the fields selected to be loaded
+const LoadSpec &Sequence::GetLoadSpec() const
+{
+    return load_spec;
+}
+
+// Set the block size of the topic zone maps (see Topic::BuildZoneMaps), or 0 to not build them (the default).
+// The zone maps are built when the topics are loaded; the topics of a loaded sequence are updated now.
+void Sequence::SetZoneMapBlockSize(int block_size)
+{
+    zone_map_block_size = std::max(block_size, 0);
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        Topics[i].BuildZoneMaps(zone_map_block_size);
 }
 
 // Get messages by index from the message collection sorted by the recording time
-Message Sequence::GetMessage(size_t msg_idx)
+Message Sequence::GetMessage(size_t msg_idx) const
 {
     // Check if the index is in range
     if (msg_idx >= MessageIndexList.size())
         return Message();
     
-    return Topics[MessageIndexList[msg_idx].TopicIdx].Messages[MessageIndexList[msg_idx].MessageIdx];
+    // The topic has no messages if it could not be loaded again
+    const Topic &topic = GetTopic(MessageIndexList[msg_idx].TopicIdx);
+    if ((size_t)MessageIndexList[msg_idx].MessageIdx >= topic.Messages.size())
+        return Message();
+
+    return topic.Messages[MessageIndexList[msg_idx].MessageIdx];
+}
+
+// Get a topic by index. If a topic tracker is set (e.g., a MemoryBudget), it is told about the access
+// first, so the topic is loaded again if it was unloaded. Without a tracker (e.g., in a copy of a sequence
+// with a tracker), an unloaded topic is read from its file again. Use this function instead of Topics for
+// the sequences with unloaded topics. If the topic cannot be loaded again, it is returned without its messages.
+const Topic &Sequence::GetTopic(int topic_idx) const
+{
+    if (topic_tracker.Tracker != NULL)
+        topic_tracker.Tracker->OnTopicAccess(*this, topic_idx);
+    else if (!Topics[topic_idx].IsLoaded())
+    {
+        std::lock_guard<std::mutex> lock(reload_lock.Mutex);
+        if (!Topics[topic_idx].IsLoaded())
+            const_cast<Topic &>(Topics[topic_idx]).Reload();
+    }
+
+    if (!Topics[topic_idx].IsLoaded())
+        std::cerr << "GetTopic Error! The messages of '" << Topics[topic_idx].Name << "' topic could not be loaded again." << std::endl;
+    return Topics[topic_idx];
+}
+
+// Set the object that keeps track of the use of the topics (NULL to remove it)
+void Sequence::SetTopicTracker(TopicTracker *tracker)
+{
+    topic_tracker.Tracker = tracker;
+}
+
+// Get the object that keeps track of the use of the topics (NULL if there is none)
+TopicTracker *Sequence::GetTopicTracker() const
+{
+    return topic_tracker.Tracker;
+}
+
+// Estimate the number of bytes used by the sequence in memory (the topics and the message list)
+size_t Sequence::GetMemoryFootprint() const
+{
+    size_t total = sizeof(Sequence) + MessageIndexList.capacity() * sizeof(MessageIndex);
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        total += Topics[i].GetMemoryFootprint();
+    return total;
 }
 
 // Print some brief information like the number and names of topics, total messages, time, etc.
-void Sequence::PrintBriefInfo()
+void Sequence::PrintBriefInfo() const
 {
     // Cancel if the sequence is not initialized
     if (!IsInitialized())
@@ -199,7 +475,7 @@ void Sequence::PrintBriefInfo()
 }
 
 // Get the list of indices of the fault topics
-std::vector<int> Sequence::GetFaultTopics()
+std::vector<int> Sequence::GetFaultTopics() const
 {
     std::vector<int> fault_topics;
     for (int i = 0; i < (int)Topics.size(); ++i)
@@ -210,13 +486,13 @@ std::vector<int> Sequence::GetFaultTopics()
 }
 
 // Get the total flight duration in seconds
-double Sequence::GetTotalDuration()
+double Sequence::GetTotalDuration() const
 {
     return GetMessage(MessageIndexList.size() - 1).DateTime - GetMessage(0).DateTime;
 }
 
 // Get the normal flight (pre-failure flight) duration in seconds
-double Sequence::GetNormalFlightDuration()
+double Sequence::GetNormalFlightDuration() const
 {
     // Find the first fault
     int msg_ind = FindFirstFaultMessage();
@@ -228,22 +504,30 @@ double Sequence::GetNormalFlightDuration()
     return GetMessage(msg_ind - 1).DateTime - GetMessage(0).DateTime;
 }
 
-// Find the index of the first fault message in the sequence message list
-int Sequence::FindFirstFaultMessage()
+// Find the index of the first fault message in the sequence message list (-1 if there are no faults)
+int Sequence::FindFirstFaultMessage() const
 {
-    // Iterate through all the messages to find the first fault
-    for (int i = 0; i < (int)MessageIndexList.size(); ++i)
-        if (Topics[MessageIndexList[i].TopicIdx].IsFaultTopic())
-            return i;
+    // The index is found when the messages are loaded
+    return first_fault_message;
+}
 
-    // If no fault topics found, return -1
-    return -1;
+// Get the fault intervals of all the fault topics
+const FaultTimeline &Sequence::GetFaultTimeline() const
+{
+    return fault_timeline;
+}
+
+// Set the largest gap between the fault messages of the same fault interval (seconds) and rebuild the intervals
+void Sequence::SetFaultGapThreshold(double gap_threshold)
+{
+    fault_gap_threshold = gap_threshold;
+    fault_timeline.Build(Topics, fault_gap_threshold);
 }
 
 // Find the index of a given topic (case sensitive)
-int Sequence::FindTopicIndex(const std::string &topic_name)
+int Sequence::FindTopicIndex(const std::string &topic_name) const
 {
-    std::map<std::string, int>::iterator it = topic_map.find(topic_name);
+    std::map<std::string, int>::const_iterator it = topic_map.find(topic_name);
 
     // Return -1 if not found
     if (it == topic_map.end()) return -1;
@@ -251,6 +535,47 @@ int Sequence::FindTopicIndex(const std::string &topic_name)
     return it->second;        
 }
 
+// Extract the sequence directory and name from the path to the sequence bag file.
+// The topic files of the sequence are expected next to the bag file.
+bool Sequence::ParseBagPath(const std::string &bag_path, std::string &out_sequence_dir, std::string &out_sequence_name)
+{
+    // Extract the path and the sequence name
+    std::string extension;
+    bool extracted = Commons::ExtractFilenameAndExtension(bag_path, out_sequence_name, extension, out_sequence_dir);
+
+    // Check that the extension is correct
+    if (!extracted || (extension != "bag"))
+        return false;
+
+    // Add the path separator to the path
+    if (out_sequence_dir.empty() || out_sequence_dir[out_sequence_dir.length() - 1] != Commons::FilePathSeparator) 
+        out_sequence_dir += Commons::FilePathSeparator;
+
+    return true;
+}
+
+// Load several sequences given their directories and names, reading the topic files of all of them in one
+// batch (see SetBatchedReading). The vector is resized to the number of sequences; the sequences already in
+// it keep their settings (e.g., the load spec). Returns the number of loaded sequences.
+int Sequence::LoadSequences(std::vector<Sequence> &sequences, const VecString &sequence_dirs, const VecString &sequence_names)
+{
+    if (sequence_dirs.size() != sequence_names.size())
+    {
+        std::cerr << "LoadSequences Error! The number of directories and names do not match." << std::endl;
+        return 0;
+    }
+
+    sequences.resize(sequence_dirs.size());
+    std::vector<Sequence *> targets;
+    for (int i = 0; i < (int)sequences.size(); ++i)
+    {
+        sequences[i].DirectoryPath = sequence_dirs[i];
+        sequences[i].Name = sequence_names[i];
+        targets.push_back(&sequences[i]);
+    }
+    return LoadTopicsInBatch(targets);
+}
+
 /******************************************************************************/
 /*********************** Local Function Definitions ***************************/
 /******************************************************************************/
@@ -290,11 +615,11 @@ bool Sequence::ExtractTopicNames(VecString &out_topic_files, VecString &out_topi
     // Sort the file list alphabetically
     std::sort(dir_file_list.begin(), dir_file_list.end());
 
-    // Extract the topic names from their file names
+    // Extract the topic names from their file names (only the topics selected to be loaded)
     for (int i = 0; i < (int)dir_file_list.size(); ++i)
     {
         std::string topic_name = ExtractTopicName(dir_file_list[i]);
-        if (!topic_name.empty())
+        if (!topic_name.empty() && load_spec.IsTopicSelected(topic_name))
         {
             out_topic_files.push_back(dir_file_list[i]);
             out_topic_names.push_back(topic_name);
@@ -307,27 +632,119 @@ bool Sequence::ExtractTopicNames(VecString &out_topic_files, VecString &out_topi
     return true;
 }
 
+// Add a topic to the sequence and load its file
+void Sequence::AddTopic(const std::string &topic_filename, const std::string &topic_name)
+{
+    CreateTopic(topic_name).ReadFromFile(GetTopicPath(topic_filename));
+    IndexTopic((int)Topics.size() - 1);
+}
+
+// Add an empty topic to the sequence in the same reading mode as the sequence, with the selected fields
+Topic &Sequence::CreateTopic(const std::string &topic_name)
+{
+    Topics.push_back(Topic("", topic_name));
+    Topics.back().SetFollowMode(follow_mode);
+    Topics.back().SetColumnSelection(load_spec.GetFieldPatterns(topic_name));
+    Topics.back().SetNumberOfThreads(n_threads);
+    return Topics.back();
+}
+
+// Build the zone maps of a loaded topic and add it to the table of the topic names vs. their indices
+void Sequence::IndexTopic(int topic_idx)
+{
+    if (zone_map_block_size > 0)
+        Topics[topic_idx].BuildZoneMaps(zone_map_block_size);
+    this->topic_map.insert(std::make_pair(Topics[topic_idx].Name, topic_idx));
+}
+
+// Get the full path of a topic file given its filename without the extension
+std::string Sequence::GetTopicPath(const std::string &topic_filename) const
+{
+    return DirectoryPath + topic_filename + "." + Commons::CSVFileExtension;
+}
+
+// Load the topics of the sequences (with their directories and names set) reading all their files in one
+// batch, so the files are read ahead while the previous ones are parsed. Returns the number of loaded sequences.
+int Sequence::LoadTopicsInBatch(const std::vector<Sequence *> &sequences)
+{
+    // Create the topics of all the sequences first, so they do not move while the files are parsed
+    FileIngestor ingestor;
+    std::vector<Topic *> file_topics;
+    std::vector<int> first_topics(sequences.size(), -1);
+    for (int s = 0; s < (int)sequences.size(); ++s)
+    {
+        Sequence &sequence = *sequences[s];
+        VecString topic_list, topic_file_list;
+        if (sequence.ExtractTopicNames(topic_file_list, topic_list) == false)
+        {
+            // Output error if no topics are found
+            std::cerr << "No topic files found at '" << sequence.DirectoryPath << "' directory." << std::endl;
+            continue;
+        }
+        int first_topic = first_topics[s] = (int)sequence.Topics.size();
+        sequence.Topics.reserve(first_topic + topic_list.size());
+        for (int i = 0; i < (int)topic_list.size(); ++i)
+        {
+            Topic &topic = sequence.CreateTopic(topic_list[i]);
+            topic.FileName = sequence.GetTopicPath(topic_file_list[i]);
+            ingestor.AddFile(topic.FileName);
+        }
+        for (int i = first_topic; i < (int)sequence.Topics.size(); ++i)
+            file_topics.push_back(&sequence.Topics[i]);
+    }
+
+    // Parse each file as soon as it is read (the files that cannot be read leave their topics uninitialized)
+    if (!file_topics.empty())
+        ingestor.ReadAll([&file_topics, &ingestor](int file_idx, std::string &data)
+            { file_topics[file_idx]->ReadFromData(ingestor.GetFilePath(file_idx), data); });
+
+    // Index the topics, then create the sorted message lists and index the faults
+    int n_loaded = 0;
+    for (int s = 0; s < (int)sequences.size(); ++s)
+    {
+        if (first_topics[s] < 0) continue;
+        Sequence &sequence = *sequences[s];
+        for (int i = first_topics[s]; i < (int)sequence.Topics.size(); ++i)
+            sequence.IndexTopic(i);
+        sequence.CreateMessageList();
+        sequence.BuildFaultIndex();
+        sequence.is_initialized = true;
+        ++n_loaded;
+    }
+
+    return n_loaded;
+}
+
 // Merge all the messages in all the topics into MessageIndexList sorted by their recorded time
 void Sequence::CreateMessageList()
+{
+    if (ordering_mode == TimeOnly)
+        SortTopicMessagesByTime(std::vector<int>(Topics.size(), 0), MessageIndexList);
+    else
+        MergeTopicMessages(std::vector<int>(Topics.size(), 0), MessageIndexList);
+}
+
+// Merge the messages of all the topics starting from the given indices, sorted by their recorded time
+void Sequence::MergeTopicMessages(const std::vector<int> &start_indices, std::vector<MessageIndex> &out_list)
 {
     // Define a typedef for simplicity
     typedef std::pair<Message, int> KeyValuePair;
 
     // Initialize the list of the indices of current messages in the topic
-    std::vector<int> curr_index(Topics.size(), 0);
+    std::vector<int> curr_index(start_indices);
 
     // Initialize the min heap using the first message of the topics
     std::priority_queue<KeyValuePair, std::vector<KeyValuePair>, std::greater<KeyValuePair> > min_heap;
     for (int i = 0; i < (int)Topics.size(); ++i)
-        if (!Topics[i].Messages.empty())
-            min_heap.push(KeyValuePair(Topics[i].Messages[0], i));
+        if (curr_index[i] < (int)Topics[i].Messages.size())
+            min_heap.push(KeyValuePair(Topics[i].Messages[curr_index[i]], i));
 
     // Perform a process similar to merge sort of already sorted lists
     while (!min_heap.empty())
     {
         // Add the smallest message to the list
         int t_idx = min_heap.top().second;
-        MessageIndexList.push_back(MessageIndex(t_idx, curr_index[t_idx]));
+        out_list.push_back(MessageIndex(t_idx, curr_index[t_idx]));
         
         // Remove the message from the heap
         min_heap.pop();
@@ -339,11 +756,97 @@ void Sequence::CreateMessageList()
     }
 }
 
-// Compare two message indices based on their actual message times, etc.
-bool Sequence::CompareMessageIndices(MessageIndex msg1, MessageIndex msg2)
+// Sort the messages of all the topics starting from the given indices by their recorded time, then by their
+// topic index and message index. Uses an LSD radix sort on the times, which is stable, so the messages
+// with equal times keep the topic and message order in which they are collected.
+void Sequence::SortTopicMessagesByTime(const std::vector<int> &start_indices, std::vector<MessageIndex> &out_list) const
 {
+    // Collect the messages in the order of their topic and message indices
+    std::vector<MessageIndex> indices;
+    std::vector<unsigned long long> keys;
+    long long min_time = 0;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+        for (int i = start_indices[t]; i < (int)Topics[t].Messages.size(); ++i)
+        {
+            long long time = Topics[t].Messages[i].DateTime.ToNanoseconds();
+            if (indices.empty() || time < min_time) min_time = time;
+            indices.push_back(MessageIndex(t, i));
+            keys.push_back((unsigned long long)time);
+        }
+
+    // Use the times relative to the earliest message, so only the significant digits are sorted
+    unsigned long long max_key = 0;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        keys[i] -= (unsigned long long)min_time;
+        max_key = std::max(max_key, keys[i]);
+    }
+
+    // Sort by 11-bit digits, starting from the least significant one
+    const int digit_bits = 11, n_buckets = 1 << digit_bits;
+    std::vector<unsigned long long> temp_keys(keys.size());
+    std::vector<MessageIndex> temp_indices(indices.size());
+    std::vector<size_t> counts(n_buckets + 1);
+    for (int shift = 0; shift < 64 && (max_key >> shift) != 0; shift += digit_bits)
+    {
+        // Count the keys for each digit value and find the start position of each digit value
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t i = 0; i < keys.size(); ++i)
+            counts[((keys[i] >> shift) & (n_buckets - 1)) + 1]++;
+        for (int d = 0; d < n_buckets; ++d)
+            counts[d + 1] += counts[d];
+
+        // Move the keys to their positions, keeping the order of the keys with the same digit
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            size_t pos = counts[(keys[i] >> shift) & (n_buckets - 1)]++;
+            temp_keys[pos] = keys[i];
+            temp_indices[pos] = indices[i];
+        }
+        keys.swap(temp_keys);
+        indices.swap(temp_indices);
+    }
+
+    out_list.insert(out_list.end(), indices.begin(), indices.end());
+}
+
+// Compare two message indices based on their actual message times, etc. (according to the ordering mode)
+bool Sequence::CompareMessageIndices(MessageIndex msg1, MessageIndex msg2) const
+{
+    if (ordering_mode == TimeOnly)
+    {
+        long long time1 = Topics[msg1.TopicIdx].Messages[msg1.MessageIdx].DateTime.ToNanoseconds();
+        long long time2 = Topics[msg2.TopicIdx].Messages[msg2.MessageIdx].DateTime.ToNanoseconds();
+        if (time1 != time2) return time1 < time2;
+        if (msg1.TopicIdx != msg2.TopicIdx) return msg1.TopicIdx < msg2.TopicIdx;
+        return msg1.MessageIdx < msg2.MessageIdx;
+    }
+
     return (Topics[msg1.TopicIdx].Messages[msg1.MessageIdx] < Topics[msg2.TopicIdx].Messages[msg2.MessageIdx]);
 } 
 
+// Build the fault intervals and find the first fault message in the message list
+void Sequence::BuildFaultIndex()
+{
+    fault_timeline.Build(Topics, fault_gap_threshold);
+
+    // The first message of each fault topic is found by a binary search in the sorted list
+    first_fault_message = -1;
+    for (int t = 0; t < (int)Topics.size(); ++t)
+    {
+        if (!Topics[t].IsFaultTopic() || Topics[t].Messages.empty()) continue;
+
+        std::vector<MessageIndex>::const_iterator it = std::lower_bound(MessageIndexList.begin(), MessageIndexList.end(), MessageIndex(t, 0),
+            [this](const MessageIndex &msg1, const MessageIndex &msg2) { return CompareMessageIndices(msg1, msg2); });
+
+        // Skip the messages of other topics that are equal to the fault message
+        while (it != MessageIndexList.end() && !Topics[it->TopicIdx].IsFaultTopic()) ++it;
+
+        int msg_idx = (int)(it - MessageIndexList.begin());
+        if (it != MessageIndexList.end() && (first_fault_message < 0 || msg_idx < first_fault_message))
+            first_fault_message = msg_idx;
+    }
+}
+
 }
 #endif
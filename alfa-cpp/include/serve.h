@@ -0,0 +1,1208 @@
+/*  ***************************************************************************
+*   serve.h - Header for serving the loaded ALFA dataset sequences to other
+*   local processes over a Unix domain socket.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_SERVE_H
+#define ALFA_SERVE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cerrno>
+#include <stdint.h>
+#include "commons.h"
+#include "sequence.h"
+#include "threadpool.h"
+
+#if defined __linux__
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace alfa
+{
+
+// This structure is the header of the frames exchanged by the dataset server and its clients. Each frame
+// is the header followed by a payload of PayloadSize bytes (see ServePayload). The requests and their
+// responses are (the times are in nanoseconds, see DateTime::ToNanoseconds, and the ranges include both ends):
+//   ListSequences ()                          -> count, (name, topics, messages, start time, end time) of each sequence
+//   ListTopics (sequence)                     -> count, (name, messages, start time, end time, count, (label, type)
+//                                                of each field) of each topic
+//   GetFieldSlice (sequence, topic, field,    -> times array, values array of the messages in the range
+//                  start time, end time)
+//   GetAlignedMatrix (sequence, start time,   -> number of columns, times array (the grid), values array (row-major,
+//                     end time, period, count,   holding the last received value of each field at each grid time)
+//                     (topic, field) of each column)
+// A failed request gets a Failure frame with the error text.
+struct ServeFrame
+{
+    // Local enum definitions
+    enum FrameType                      // Types of the frames
+    {
+        ListSequences = 1,
+        ListTopics = 2,
+        GetFieldSlice = 3,
+        GetAlignedMatrix = 4,
+        Success = 100,                  // The response of a request
+        Failure = 101                   // The response of a failed request
+    };
+
+    // Marks the start of every frame ("ALFA")
+    static const uint32_t FrameMagic;
+
+    uint32_t Magic = 0;
+    uint32_t Type = 0;
+    uint64_t PayloadSize = 0;
+};
+
+// This class writes and reads the payload of a frame. The payload is a series of items that each start at
+// a multiple of 8 bytes: integers (int64), numbers (double), texts (an int64 length and the characters)
+// and arrays (an int64 count and the int64 or double values). The byte order is the one of the machine,
+// since the server and the clients are on the same machine. The arrays are used in place from the received
+// payload without copying (e.g., with numpy.frombuffer in Python).
+class ServePayload
+{
+public:
+
+    // Member Functions
+    void Clear();
+    char *GetData();
+    const char *GetData() const;
+    size_t GetSize() const;
+    bool Resize(size_t n_bytes);
+
+    void PutInteger(long long value);
+    void PutNumber(double value);
+    void PutText(const std::string &text);
+    long long *AddIntegers(size_t n_values);
+    double *AddNumbers(size_t n_values);
+
+    bool GetInteger(long long &out_value);
+    bool GetNumber(double &out_value);
+    bool GetText(std::string &out_text);
+    bool GetIntegers(const long long *&out_values, size_t &out_n_values);
+    bool GetNumbers(const double *&out_values, size_t &out_n_values);
+    static bool WriteFrame(int socket_fd, uint32_t type, const ServePayload &payload);
+    static bool ReadFrame(int socket_fd, ServeFrame &out_frame, ServePayload &out_payload, size_t max_payload_size);
+
+private:
+    // Member Functions
+    const uint64_t *TakeWords(size_t n_bytes);
+    static bool ReadSocket(int socket_fd, void *data, size_t n_bytes);
+
+    // Data Members
+    std::vector<uint64_t> words;        // The payload (kept in words for the alignment of the items)
+    size_t read_pos = 0;                // Next word to read
+};
+
+// This class serves a set of loaded sequences to other local processes (e.g., notebooks, plotting tools and
+// detectors) over a Unix domain socket, so they do not load the dataset themselves. The clients list the
+// sequences and their topics and request the values of a field in a time range or the values of several
+// fields aligned on a time grid (see ServeFrame). An event thread waits for the requests of all the
+// clients, and the requests are served by a pool of workers; each client is served by one worker at a time.
+class DatasetServer
+{
+public:
+
+    // The largest request payload and aligned matrix (number of values) served
+    static const size_t MaxRequestSize;
+    static const size_t MaxMatrixSize;
+
+    // Constructors & Deconstructors
+    DatasetServer(int n_threads = 0);
+    ~DatasetServer();
+
+    // Member Functions
+    int AddSequence(const Sequence &sequence);
+    int LoadSequences(const VecString &sequence_dirs, const VecString &sequence_names);
+    bool Start(const std::string &socket_path);
+    void Stop();
+    bool IsRunning() const;
+    size_t GetNumberOfSequences() const;
+    size_t GetNumberOfRequests() const;
+    size_t GetNumberOfConnections() const;
+
+private:
+    // Local struct definitions
+    struct Connection                   // Structure for a connected client
+    {
+        int Socket = -1;
+        ServePayload Request, Response; // Reused for all the requests of the client
+    };
+
+    // Member Functions
+    void RunEvents();
+    void ServeNextConnection();
+    void ServeConnection(Connection *connection);
+    void CloseConnection(Connection *connection);
+    bool HandleRequest(uint32_t type, ServePayload &request, ServePayload &response, std::string &error) const;
+    bool ListSequencesRequest(ServePayload &response) const;
+    bool ListTopicsRequest(ServePayload &request, ServePayload &response, std::string &error) const;
+    bool GetFieldSliceRequest(ServePayload &request, ServePayload &response, std::string &error) const;
+    bool GetAlignedMatrixRequest(ServePayload &request, ServePayload &response, std::string &error) const;
+    const Sequence *FindSequence(const std::string &sequence_name, std::string &error) const;
+    const Topic *FindNumericField(const Sequence &sequence, const std::string &topic_name, const std::string &field_label,
+        int &out_field_index, std::string &error) const;
+
+    // The server cannot be copied while the threads are running
+    DatasetServer(const DatasetServer &);
+    DatasetServer &operator=(const DatasetServer &);
+
+    // Data Members
+    int n_threads;
+    std::vector<const Sequence *> sequences;
+    std::vector<std::unique_ptr<Sequence> > owned_sequences;
+    std::map<std::string, int> sequence_map;
+    std::string socket_path;
+    int listen_fd = -1, epoll_fd = -1, wake_fd = -1;
+    std::thread event_thread;
+    std::unique_ptr<ThreadPool> pool;
+    std::atomic<bool> is_running;
+    std::atomic<size_t> n_requests, n_connections;
+
+    // The connected clients and the ones with a request waiting, in arrival order (protected by connection_mutex)
+    std::map<int, std::unique_ptr<Connection> > connections;
+    std::deque<Connection *> ready_connections;
+    std::mutex connection_mutex;
+};
+
+// This class is a client of the dataset server. The arrays of the slices and the matrices point into the
+// received payload, so they are valid until the next request of the client.
+class DatasetClient
+{
+public:
+
+    // Local struct definitions
+    struct SequenceInfo                 // Structure for a served sequence
+    {
+        std::string Name;
+        int NumberOfTopics = 0;
+        long long NumberOfMessages = 0;
+        long long StartTime = 0, EndTime = 0;
+    };
+
+    struct TopicInfo                    // Structure for a topic of a served sequence
+    {
+        std::string Name;
+        long long NumberOfMessages = 0;
+        long long StartTime = 0, EndTime = 0;
+        VecString FieldLabels;
+        std::vector<Topic::FieldType> FieldTypes;
+    };
+
+    struct FieldSlice                   // Structure for the values of a field in a time range
+    {
+        size_t Size = 0;
+        const long long *Times = NULL;
+        const double *Values = NULL;
+    };
+
+    struct AlignedMatrix                // Structure for the values of several fields on a time grid
+    {
+        size_t NumberOfRows = 0, NumberOfColumns = 0;
+        const long long *Times = NULL;  // Time of each row
+        const double *Values = NULL;    // Values of the fields, shape (NumberOfRows, NumberOfColumns)
+    };
+
+    // Constructors & Deconstructors
+    DatasetClient();
+    ~DatasetClient();
+
+    // Member Functions
+    bool Connect(const std::string &socket_path);
+    void Disconnect();
+    bool IsConnected() const;
+    bool ListSequences(std::vector<SequenceInfo> &out_sequences);
+    bool ListTopics(const std::string &sequence_name, std::vector<TopicInfo> &out_topics);
+    bool GetFieldSlice(const std::string &sequence_name, const std::string &topic_name, const std::string &field_label,
+        FieldSlice &out_slice, long long start_time = std::numeric_limits<long long>::min(),
+        long long end_time = std::numeric_limits<long long>::max());
+    bool GetAlignedMatrix(const std::string &sequence_name, const VecString &topic_names, const VecString &field_labels,
+        long long period, AlignedMatrix &out_matrix, long long start_time = std::numeric_limits<long long>::min(),
+        long long end_time = std::numeric_limits<long long>::max());
+    size_t GetLastResponseSize() const;
+
+private:
+    // Member Functions
+    bool SendRequest(uint32_t type, const std::string &function_name);
+
+    // The client cannot be copied while it is connected
+    DatasetClient(const DatasetClient &);
+    DatasetClient &operator=(const DatasetClient &);
+
+    // Data Members
+    int socket_fd = -1;
+    ServePayload request, response;
+};
+
+/******************************************************************************/
+/********************** ServePayload Function Definitions *********************/
+/******************************************************************************/
+
+const uint32_t ServeFrame::FrameMagic = 0x41464C41;
+
+// Remove all the items of the payload
+void ServePayload::Clear()
+{
+    words.clear();
+    read_pos = 0;
+}
+
+// Get the bytes of the payload
+char *ServePayload::GetData()
+{
+    return (char *)words.data();
+}
+
+// Get the bytes of the payload
+const char *ServePayload::GetData() const
+{
+    return (const char *)words.data();
+}
+
+// Get the size of the payload in bytes
+size_t ServePayload::GetSize() const
+{
+    return words.size() * sizeof(uint64_t);
+}
+
+// Resize the payload for receiving it (and read it from the start). Returns false if the size is not
+// a multiple of 8 bytes.
+bool ServePayload::Resize(size_t n_bytes)
+{
+    if (n_bytes % sizeof(uint64_t) != 0) return false;
+    words.resize(n_bytes / sizeof(uint64_t));
+    read_pos = 0;
+    return true;
+}
+
+// Add an integer to the payload
+void ServePayload::PutInteger(long long value)
+{
+    words.push_back((uint64_t)value);
+}
+
+// Add a number to the payload
+void ServePayload::PutNumber(double value)
+{
+    uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    words.push_back(word);
+}
+
+// Add a text to the payload
+void ServePayload::PutText(const std::string &text)
+{
+    PutInteger((long long)text.size());
+    size_t pos = words.size();
+    words.resize(pos + (text.size() + 7) / 8, 0);
+    if (!text.empty()) std::memcpy(&words[pos], text.data(), text.size());
+}
+
+// Add an array of integers to the payload. Returns the values to fill (valid until the next item is added).
+long long *ServePayload::AddIntegers(size_t n_values)
+{
+    PutInteger((long long)n_values);
+    words.resize(words.size() + n_values);
+    return (long long *)(words.data() + words.size() - n_values);
+}
+
+// Add an array of numbers to the payload. Returns the values to fill (valid until the next item is added).
+double *ServePayload::AddNumbers(size_t n_values)
+{
+    PutInteger((long long)n_values);
+    words.resize(words.size() + n_values);
+    return (double *)(words.data() + words.size() - n_values);
+}
+
+// Read the next integer of the payload. Returns false if the payload ends.
+bool ServePayload::GetInteger(long long &out_value)
+{
+    const uint64_t *word = TakeWords(sizeof(uint64_t));
+    if (word == NULL) return false;
+    out_value = (long long)*word;
+    return true;
+}
+
+// Read the next number of the payload. Returns false if the payload ends.
+bool ServePayload::GetNumber(double &out_value)
+{
+    const uint64_t *word = TakeWords(sizeof(uint64_t));
+    if (word == NULL) return false;
+    std::memcpy(&out_value, word, sizeof(out_value));
+    return true;
+}
+
+// Read the next text of the payload. Returns false if the payload ends.
+bool ServePayload::GetText(std::string &out_text)
+{
+    long long length;
+    if (!GetInteger(length) || length < 0) return false;
+    const uint64_t *data = TakeWords((size_t)length);
+    if (data == NULL) return false;
+    out_text.assign((const char *)data, (size_t)length);
+    return true;
+}
+
+// Read the next array of integers of the payload in place. Returns false if the payload ends.
+bool ServePayload::GetIntegers(const long long *&out_values, size_t &out_n_values)
+{
+    long long n_values;
+    if (!GetInteger(n_values) || n_values < 0 || (size_t)n_values > words.size()) return false;
+    const uint64_t *data = TakeWords((size_t)n_values * sizeof(uint64_t));
+    if (data == NULL) return false;
+    out_values = (const long long *)data;
+    out_n_values = (size_t)n_values;
+    return true;
+}
+
+// Read the next array of numbers of the payload in place. Returns false if the payload ends.
+bool ServePayload::GetNumbers(const double *&out_values, size_t &out_n_values)
+{
+    long long n_values;
+    if (!GetInteger(n_values) || n_values < 0 || (size_t)n_values > words.size()) return false;
+    const uint64_t *data = TakeWords((size_t)n_values * sizeof(uint64_t));
+    if (data == NULL) return false;
+    out_values = (const double *)data;
+    out_n_values = (size_t)n_values;
+    return true;
+}
+
+// Write a frame with the given type and payload to a socket (in one call if possible)
+bool ServePayload::WriteFrame(int socket_fd, uint32_t type, const ServePayload &payload)
+{
+#if defined __linux__
+    ServeFrame frame;
+    frame.Magic = ServeFrame::FrameMagic;
+    frame.Type = type;
+    frame.PayloadSize = payload.GetSize();
+
+    iovec parts[2];
+    parts[0].iov_base = &frame;
+    parts[0].iov_len = sizeof(frame);
+    parts[1].iov_base = (void *)payload.GetData();
+    parts[1].iov_len = payload.GetSize();
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+
+    // Continue after the partial writes (the clients may be gone, so SIGPIPE is not raised)
+    while (message.msg_iovlen > 0)
+    {
+        ssize_t n_written = sendmsg(socket_fd, &message, MSG_NOSIGNAL);
+        if (n_written < 0 && errno == EINTR) continue;
+        if (n_written <= 0) return false;
+        while (message.msg_iovlen > 0 && (size_t)n_written >= message.msg_iov->iov_len)
+        {
+            n_written -= message.msg_iov->iov_len;
+            ++message.msg_iov;
+            --message.msg_iovlen;
+        }
+        if (message.msg_iovlen > 0)
+        {
+            message.msg_iov->iov_base = (char *)message.msg_iov->iov_base + n_written;
+            message.msg_iov->iov_len -= n_written;
+        }
+    }
+    return true;
+#else
+    (void)socket_fd; (void)type; (void)payload;
+    return false;
+#endif
+}
+
+// Read a frame from a socket. Returns false if the socket is closed or the frame is invalid.
+bool ServePayload::ReadFrame(int socket_fd, ServeFrame &out_frame, ServePayload &out_payload, size_t max_payload_size)
+{
+    if (!ReadSocket(socket_fd, &out_frame, sizeof(out_frame)) || out_frame.Magic != ServeFrame::FrameMagic ||
+        out_frame.PayloadSize > max_payload_size || !out_payload.Resize((size_t)out_frame.PayloadSize))
+        return false;
+    return ReadSocket(socket_fd, out_payload.GetData(), out_payload.GetSize());
+}
+
+/******************************************************************************/
+/******************* ServePayload Local Function Definitions ******************/
+/******************************************************************************/
+
+// Take the words of the next item (rounded up to the words). Returns NULL if the payload ends.
+const uint64_t *ServePayload::TakeWords(size_t n_bytes)
+{
+    size_t n_words = (n_bytes + 7) / 8;
+    if (n_words > words.size() - read_pos) return NULL;
+    const uint64_t *data = words.data() + read_pos;
+    read_pos += n_words;
+    return data;
+}
+
+// Read the given number of bytes from a socket. Returns false if the socket is closed or fails.
+bool ServePayload::ReadSocket(int socket_fd, void *data, size_t n_bytes)
+{
+#if defined __linux__
+    char *pos = (char *)data;
+    while (n_bytes > 0)
+    {
+        ssize_t n_read = recv(socket_fd, pos, n_bytes, 0);
+        if (n_read < 0 && errno == EINTR) continue;
+        if (n_read <= 0) return false;
+        pos += n_read;
+        n_bytes -= (size_t)n_read;
+    }
+    return true;
+#else
+    (void)socket_fd; (void)data;
+    return n_bytes == 0;
+#endif
+}
+
+/******************************************************************************/
+/********************* DatasetServer Function Definitions *********************/
+/******************************************************************************/
+
+const size_t DatasetServer::MaxRequestSize = 1 << 20;
+const size_t DatasetServer::MaxMatrixSize = (size_t)1 << 26;
+
+// Constructor function for DatasetServer. Serves the requests on the given number of workers (one per
+// core if not given).
+DatasetServer::DatasetServer(int n_threads)
+    : n_threads(n_threads), is_running(false), n_requests(0), n_connections(0)
+{
+}
+
+// Destructor function for DatasetServer. Stops the server.
+DatasetServer::~DatasetServer()
+{
+    Stop();
+}
+
+// Add a loaded sequence to serve. The sequence is not copied, so it must stay alive (and unchanged) while
+// the server is running. Returns the index of the sequence, or -1 if it cannot be added.
+int DatasetServer::AddSequence(const Sequence &sequence)
+{
+    if (IsRunning())
+    {
+        std::cerr << "AddSequence Error! The sequences cannot be added while the server is running." << std::endl;
+        return -1;
+    }
+    if (!sequence.IsInitialized() || sequence_map.count(sequence.Name) > 0)
+    {
+        std::cerr << "AddSequence Error! Sequence '" << sequence.Name << "' is not loaded or is already added." << std::endl;
+        return -1;
+    }
+
+    sequence_map[sequence.Name] = (int)sequences.size();
+    sequences.push_back(&sequence);
+    return (int)sequences.size() - 1;
+}
+
+// Load the sequences to serve (all their topic files are read in one batch, see Sequence::LoadSequences).
+// Returns the number of the sequences added.
+int DatasetServer::LoadSequences(const VecString &sequence_dirs, const VecString &sequence_names)
+{
+    std::vector<Sequence> loaded;
+    Sequence::LoadSequences(loaded, sequence_dirs, sequence_names);
+
+    int n_added = 0;
+    for (int i = 0; i < (int)loaded.size(); ++i)
+    {
+        if (!loaded[i].IsInitialized()) continue;
+        owned_sequences.push_back(std::unique_ptr<Sequence>(new Sequence(std::move(loaded[i]))));
+        if (AddSequence(*owned_sequences.back()) < 0)
+            owned_sequences.pop_back();
+        else
+            ++n_added;
+    }
+    return n_added;
+}
+
+// Start serving the sequences on a Unix domain socket at the given path (a stale socket file at the
+// path is replaced). Returns false if the socket cannot be created.
+bool DatasetServer::Start(const std::string &socket_path)
+{
+#if !defined __linux__
+    std::cerr << "Start Error! The dataset server is only supported on Linux." << std::endl;
+    (void)socket_path;
+    return false;
+#else
+    if (IsRunning()) return false;
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Start Error! Invalid socket path '" << socket_path << "'." << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size());
+
+    // Create the listening socket and the event queue
+    unlink(socket_path.c_str());
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (listen_fd < 0 || epoll_fd < 0 || wake_fd < 0 || bind(listen_fd, (sockaddr *)&address, sizeof(address)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0)
+    {
+        std::cerr << "Start Error! Failed to listen on '" << socket_path << "' (" << std::strerror(errno) << ")." << std::endl;
+        if (listen_fd >= 0) close(listen_fd);
+        if (epoll_fd >= 0) close(epoll_fd);
+        if (wake_fd >= 0) close(wake_fd);
+        listen_fd = epoll_fd = wake_fd = -1;
+        return false;
+    }
+    this->socket_path = socket_path;
+
+    // The listening socket and the wake-up event are identified by a NULL connection
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event);
+
+    pool.reset(new ThreadPool(n_threads));
+    is_running = true;
+    event_thread = std::thread(&DatasetServer::RunEvents, this);
+    return true;
+#endif
+}
+
+// Stop the server. The requests being served are finished and the clients are disconnected.
+void DatasetServer::Stop()
+{
+#if defined __linux__
+    if (!event_thread.joinable()) return;
+
+    // Stop the event thread, then wake up the workers waiting on the clients
+    is_running = false;
+    uint64_t wake = 1;
+    if (write(wake_fd, &wake, sizeof(wake)) < 0) {}
+    event_thread.join();
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex);
+        for (std::map<int, std::unique_ptr<Connection> >::iterator it = connections.begin(); it != connections.end(); ++it)
+            shutdown(it->first, SHUT_RDWR);
+    }
+    pool.reset();
+
+    for (std::map<int, std::unique_ptr<Connection> >::iterator it = connections.begin(); it != connections.end(); ++it)
+        close(it->first);
+    connections.clear();
+    close(listen_fd);
+    close(epoll_fd);
+    close(wake_fd);
+    listen_fd = epoll_fd = wake_fd = -1;
+    unlink(socket_path.c_str());
+    socket_path.clear();
+#endif
+}
+
+// Returns true if the server is running
+bool DatasetServer::IsRunning() const
+{
+    return is_running;
+}
+
+// Get the number of the served sequences
+size_t DatasetServer::GetNumberOfSequences() const
+{
+    return sequences.size();
+}
+
+// Get the number of the requests served since the server started
+size_t DatasetServer::GetNumberOfRequests() const
+{
+    return n_requests;
+}
+
+// Get the number of the clients connected since the server started
+size_t DatasetServer::GetNumberOfConnections() const
+{
+    return n_connections;
+}
+
+/******************************************************************************/
+/****************** DatasetServer Local Function Definitions ******************/
+/******************************************************************************/
+
+// Accept the clients and hand their requests to the workers until the server stops. Each client is
+// waited for once (EPOLLONESHOT), so only one worker serves it at a time, and the worker waits for it
+// again after serving the request.
+void DatasetServer::RunEvents()
+{
+#if defined __linux__
+    const int max_events = 64;
+    epoll_event events[max_events];
+    while (is_running)
+    {
+        int n_events = epoll_wait(epoll_fd, events, max_events, -1);
+        for (int i = 0; i < n_events && is_running; ++i)
+        {
+            // The pool takes its newest tasks first, so the tasks serve the clients in the order of their requests
+            Connection *connection = (Connection *)events[i].data.ptr;
+            if (connection != NULL)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(connection_mutex);
+                    ready_connections.push_back(connection);
+                }
+                pool->Submit([this]() { ServeNextConnection(); });
+                continue;
+            }
+
+            // Accept a new client (the wake-up event only interrupts the wait)
+            int client_fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+            if (client_fd < 0) continue;
+
+            // The workers read and write the clients in blocking mode, but do not wait forever for a client
+            timeval timeout;
+            timeout.tv_sec = 10;
+            timeout.tv_usec = 0;
+            setsockopt(client_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+            std::unique_ptr<Connection> new_connection(new Connection());
+            new_connection->Socket = client_fd;
+            epoll_event event;
+            event.events = EPOLLIN | EPOLLONESHOT;
+            event.data.ptr = new_connection.get();
+            {
+                std::lock_guard<std::mutex> lock(connection_mutex);
+                connections[client_fd] = std::move(new_connection);
+            }
+            epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_fd, &event);
+            ++n_connections;
+        }
+    }
+#endif
+}
+
+// Serve the client that has waited the longest for its request
+void DatasetServer::ServeNextConnection()
+{
+    Connection *connection;
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex);
+        connection = ready_connections.front();
+        ready_connections.pop_front();
+    }
+    ServeConnection(connection);
+}
+
+// Serve a request of a client and wait for its next request (or close the connection if the client
+// disconnected or sent an invalid frame)
+void DatasetServer::ServeConnection(Connection *connection)
+{
+#if defined __linux__
+    ServeFrame frame;
+    if (!ServePayload::ReadFrame(connection->Socket, frame, connection->Request, MaxRequestSize))
+    {
+        CloseConnection(connection);
+        return;
+    }
+
+    std::string error;
+    connection->Response.Clear();
+    bool is_served = HandleRequest(frame.Type, connection->Request, connection->Response, error);
+    if (!is_served)
+    {
+        connection->Response.Clear();
+        connection->Response.PutText(error);
+    }
+    ++n_requests;
+    if (!ServePayload::WriteFrame(connection->Socket, is_served ? ServeFrame::Success : ServeFrame::Failure, connection->Response) ||
+        !is_running)
+    {
+        CloseConnection(connection);
+        return;
+    }
+
+    // Keep the memory of the small responses for the next requests
+    if (connection->Response.GetSize() > MaxRequestSize) connection->Response = ServePayload();
+
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.ptr = connection;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection->Socket, &event) != 0)
+        CloseConnection(connection);
+#else
+    (void)connection;
+#endif
+}
+
+// Disconnect a client
+void DatasetServer::CloseConnection(Connection *connection)
+{
+#if defined __linux__
+    std::lock_guard<std::mutex> lock(connection_mutex);
+    int client_fd = connection->Socket;
+    close(client_fd);
+    connections.erase(client_fd);
+#else
+    (void)connection;
+#endif
+}
+
+// Serve a request. Returns false and the error text if the request fails.
+bool DatasetServer::HandleRequest(uint32_t type, ServePayload &request, ServePayload &response, std::string &error) const
+{
+    switch (type)
+    {
+    case ServeFrame::ListSequences:
+        return ListSequencesRequest(response);
+    case ServeFrame::ListTopics:
+        return ListTopicsRequest(request, response, error);
+    case ServeFrame::GetFieldSlice:
+        return GetFieldSliceRequest(request, response, error);
+    case ServeFrame::GetAlignedMatrix:
+        return GetAlignedMatrixRequest(request, response, error);
+    default:
+        error = "Unknown request type " + std::to_string((long long)type) + ".";
+        return false;
+    }
+}
+
+// List the served sequences
+bool DatasetServer::ListSequencesRequest(ServePayload &response) const
+{
+    response.PutInteger((long long)sequences.size());
+    for (int i = 0; i < (int)sequences.size(); ++i)
+    {
+        const Sequence &sequence = *sequences[i];
+        long long start_time = 0, end_time = 0;
+        if (!sequence.MessageIndexList.empty())
+        {
+            const Sequence::MessageIndex &first = sequence.MessageIndexList.front(), &last = sequence.MessageIndexList.back();
+            start_time = sequence.Topics[first.TopicIdx].Messages[first.MessageIdx].DateTime.ToNanoseconds();
+            end_time = sequence.Topics[last.TopicIdx].Messages[last.MessageIdx].DateTime.ToNanoseconds();
+        }
+
+        response.PutText(sequence.Name);
+        response.PutInteger((long long)sequence.Topics.size());
+        response.PutInteger((long long)sequence.MessageIndexList.size());
+        response.PutInteger(start_time);
+        response.PutInteger(end_time);
+    }
+    return true;
+}
+
+// List the topics of a sequence and their fields
+bool DatasetServer::ListTopicsRequest(ServePayload &request, ServePayload &response, std::string &error) const
+{
+    std::string sequence_name;
+    if (!request.GetText(sequence_name))
+    {
+        error = "Invalid ListTopics request.";
+        return false;
+    }
+    const Sequence *sequence = FindSequence(sequence_name, error);
+    if (sequence == NULL) return false;
+
+    response.PutInteger((long long)sequence->Topics.size());
+    for (int i = 0; i < (int)sequence->Topics.size(); ++i)
+    {
+        const Topic &topic = sequence->Topics[i];
+        response.PutText(topic.Name);
+        response.PutInteger((long long)topic.Messages.size());
+        response.PutInteger(topic.Messages.empty() ? 0 : topic.Messages.front().DateTime.ToNanoseconds());
+        response.PutInteger(topic.Messages.empty() ? 0 : topic.Messages.back().DateTime.ToNanoseconds());
+        response.PutInteger((long long)topic.FieldLabels.size());
+        for (int f = 0; f < (int)topic.FieldLabels.size(); ++f)
+        {
+            response.PutText(topic.FieldLabels[f]);
+            response.PutInteger((long long)topic.GetFieldType(f));
+        }
+    }
+    return true;
+}
+
+// Get the times and the values of a numeric field in a time range
+bool DatasetServer::GetFieldSliceRequest(ServePayload &request, ServePayload &response, std::string &error) const
+{
+    std::string sequence_name, topic_name, field_label;
+    long long start_time, end_time;
+    if (!request.GetText(sequence_name) || !request.GetText(topic_name) || !request.GetText(field_label) ||
+        !request.GetInteger(start_time) || !request.GetInteger(end_time))
+    {
+        error = "Invalid GetFieldSlice request.";
+        return false;
+    }
+    const Sequence *sequence = FindSequence(sequence_name, error);
+    int field_index;
+    const Topic *topic = (sequence == NULL) ? NULL : FindNumericField(*sequence, topic_name, field_label, field_index, error);
+    if (topic == NULL) return false;
+
+    // Write the times first, since adding the values moves the payload
+    std::vector<int> indices = topic->FindMessagesInTimeRange(start_time, end_time);
+    long long *times = response.AddIntegers(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        times[i] = topic->Messages[indices[i]].DateTime.ToNanoseconds();
+
+    const Topic::Column &column = topic->GetColumn(field_index);
+    double *values = response.AddNumbers(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        values[i] = column.ToDouble(indices[i]);
+    return true;
+}
+
+// Sample several numeric fields on a regular time grid, holding the last received value of each field.
+// The grid covers the part of the time range in which all the fields have data.
+bool DatasetServer::GetAlignedMatrixRequest(ServePayload &request, ServePayload &response, std::string &error) const
+{
+    std::string sequence_name;
+    long long start_time, end_time, period, n_columns;
+    if (!request.GetText(sequence_name) || !request.GetInteger(start_time) || !request.GetInteger(end_time) ||
+        !request.GetInteger(period) || !request.GetInteger(n_columns) || n_columns <= 0 || n_columns > 4096)
+    {
+        error = "Invalid GetAlignedMatrix request.";
+        return false;
+    }
+    if (period <= 0)
+    {
+        error = "The period of the grid should be positive.";
+        return false;
+    }
+    const Sequence *sequence = FindSequence(sequence_name, error);
+    if (sequence == NULL) return false;
+
+    // Find the fields and the time span in which all of them have data
+    std::vector<const Topic *> topics((size_t)n_columns);
+    std::vector<int> field_indices((size_t)n_columns);
+    for (int c = 0; c < (int)n_columns; ++c)
+    {
+        std::string topic_name, field_label;
+        if (!request.GetText(topic_name) || !request.GetText(field_label))
+        {
+            error = "Invalid GetAlignedMatrix request.";
+            return false;
+        }
+        topics[c] = FindNumericField(*sequence, topic_name, field_label, field_indices[c], error);
+        if (topics[c] == NULL) return false;
+        if (topics[c]->Messages.empty())
+        {
+            error = "'" + topic_name + "' topic has no messages.";
+            return false;
+        }
+        start_time = std::max(start_time, topics[c]->Messages.front().DateTime.ToNanoseconds());
+        end_time = std::min(end_time, topics[c]->Messages.back().DateTime.ToNanoseconds());
+    }
+    size_t n_rows = (end_time < start_time) ? 0 : (size_t)((end_time - start_time) / period) + 1;
+    if (n_rows > MaxMatrixSize / (size_t)n_columns)
+    {
+        error = "The matrix has too many values (" + std::to_string((unsigned long long)n_rows) + " rows). "
+            "Use a shorter time range or a longer period.";
+        return false;
+    }
+
+    // Write the grid times
+    response.PutInteger(n_columns);
+    long long *times = response.AddIntegers(n_rows);
+    for (size_t r = 0; r < n_rows; ++r)
+        times[r] = start_time + (long long)r * period;
+
+    // Hold the last value of each field at each grid time (starting from the last message before the grid)
+    double *values = response.AddNumbers(n_rows * (size_t)n_columns);
+    for (int c = 0; c < (int)n_columns; ++c)
+    {
+        const std::vector<Message> &messages = topics[c]->Messages;
+        const Topic::Column &column = topics[c]->GetColumn(field_indices[c]);
+        size_t curr = std::upper_bound(messages.begin(), messages.end(), start_time,
+            [](long long time, const Message &message) { return time < message.DateTime.ToNanoseconds(); }) - messages.begin();
+        curr = (curr > 0) ? curr - 1 : 0;
+        for (size_t r = 0; r < n_rows; ++r)
+        {
+            long long grid_time = start_time + (long long)r * period;
+            while (curr + 1 < messages.size() && messages[curr + 1].DateTime.ToNanoseconds() <= grid_time) ++curr;
+            values[r * n_columns + c] = column.ToDouble((int)curr);
+        }
+    }
+    return true;
+}
+
+// Find a served sequence by name
+const Sequence *DatasetServer::FindSequence(const std::string &sequence_name, std::string &error) const
+{
+    std::map<std::string, int>::const_iterator it = sequence_map.find(sequence_name);
+    if (it == sequence_map.end())
+    {
+        error = "'" + sequence_name + "' sequence not found.";
+        return NULL;
+    }
+    return sequences[it->second];
+}
+
+// Find a topic and the index of its numeric field. Returns NULL and the error text if the field is not
+// found or does not keep numbers.
+const Topic *DatasetServer::FindNumericField(const Sequence &sequence, const std::string &topic_name,
+    const std::string &field_label, int &out_field_index, std::string &error) const
+{
+    int topic_idx = sequence.FindTopicIndex(topic_name);
+    if (topic_idx < 0)
+    {
+        error = "'" + topic_name + "' topic not found.";
+        return NULL;
+    }
+    const Topic &topic = sequence.Topics[topic_idx];
+    out_field_index = topic.FindLabelIndex(field_label);
+    if (out_field_index < 0)
+    {
+        error = "'" + field_label + "' field not found.";
+        return NULL;
+    }
+
+    // The unloaded topics have no stored values
+    Topic::FieldType type = topic.GetFieldType(out_field_index);
+    if (!topic.IsLoaded() || (type != Topic::Bool && type != Topic::Int64 && type != Topic::Float64))
+    {
+        error = "'" + field_label + "' field is " + Topic::FieldTypeToString(type) + ", not numeric.";
+        return NULL;
+    }
+    return &topic;
+}
+
+/******************************************************************************/
+/********************* DatasetClient Function Definitions *********************/
+/******************************************************************************/
+
+// Default constructor for DatasetClient
+DatasetClient::DatasetClient()
+{
+}
+
+// Destructor function for DatasetClient. Disconnects from the server.
+DatasetClient::~DatasetClient()
+{
+    Disconnect();
+}
+
+// Connect to a dataset server listening on the given socket path
+bool DatasetClient::Connect(const std::string &socket_path)
+{
+#if !defined __linux__
+    std::cerr << "Connect Error! The dataset server is only supported on Linux." << std::endl;
+    (void)socket_path;
+    return false;
+#else
+    Disconnect();
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Connect Error! Invalid socket path '" << socket_path << "'." << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size());
+
+    socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (socket_fd < 0 || connect(socket_fd, (sockaddr *)&address, sizeof(address)) != 0)
+    {
+        std::cerr << "Connect Error! Failed to connect to '" << socket_path << "' (" << std::strerror(errno) << ")." << std::endl;
+        Disconnect();
+        return false;
+    }
+    return true;
+#endif
+}
+
+// Disconnect from the server
+void DatasetClient::Disconnect()
+{
+#if defined __linux__
+    if (socket_fd >= 0) close(socket_fd);
+#endif
+    socket_fd = -1;
+}
+
+// Returns true if the client is connected
+bool DatasetClient::IsConnected() const
+{
+    return socket_fd >= 0;
+}
+
+// Get the served sequences
+bool DatasetClient::ListSequences(std::vector<SequenceInfo> &out_sequences)
+{
+    out_sequences.clear();
+    request.Clear();
+    if (!SendRequest(ServeFrame::ListSequences, "ListSequences")) return false;
+
+    long long n_sequences, n_topics = 0;
+    bool is_valid = response.GetInteger(n_sequences);
+    for (long long i = 0; is_valid && i < n_sequences; ++i)
+    {
+        SequenceInfo info;
+        is_valid = response.GetText(info.Name) && response.GetInteger(n_topics) && response.GetInteger(info.NumberOfMessages) &&
+            response.GetInteger(info.StartTime) && response.GetInteger(info.EndTime);
+        info.NumberOfTopics = (int)n_topics;
+        out_sequences.push_back(info);
+    }
+    if (!is_valid) std::cerr << "ListSequences Error! Invalid response from the server." << std::endl;
+    return is_valid;
+}
+
+// Get the topics of a served sequence and their fields
+bool DatasetClient::ListTopics(const std::string &sequence_name, std::vector<TopicInfo> &out_topics)
+{
+    out_topics.clear();
+    request.Clear();
+    request.PutText(sequence_name);
+    if (!SendRequest(ServeFrame::ListTopics, "ListTopics")) return false;
+
+    long long n_topics, n_fields, type = 0;
+    bool is_valid = response.GetInteger(n_topics);
+    for (long long i = 0; is_valid && i < n_topics; ++i)
+    {
+        TopicInfo info;
+        is_valid = response.GetText(info.Name) && response.GetInteger(info.NumberOfMessages) &&
+            response.GetInteger(info.StartTime) && response.GetInteger(info.EndTime) && response.GetInteger(n_fields);
+        for (long long f = 0; is_valid && f < n_fields; ++f)
+        {
+            std::string label;
+            is_valid = response.GetText(label) && response.GetInteger(type);
+            info.FieldLabels.push_back(label);
+            info.FieldTypes.push_back((Topic::FieldType)type);
+        }
+        out_topics.push_back(info);
+    }
+    if (!is_valid) std::cerr << "ListTopics Error! Invalid response from the server." << std::endl;
+    return is_valid;
+}
+
+// Get the times and the values of a numeric field of a served sequence in a time range (nanoseconds,
+// both ends included)
+bool DatasetClient::GetFieldSlice(const std::string &sequence_name, const std::string &topic_name,
+    const std::string &field_label, FieldSlice &out_slice, long long start_time, long long end_time)
+{
+    out_slice = FieldSlice();
+    request.Clear();
+    request.PutText(sequence_name);
+    request.PutText(topic_name);
+    request.PutText(field_label);
+    request.PutInteger(start_time);
+    request.PutInteger(end_time);
+    if (!SendRequest(ServeFrame::GetFieldSlice, "GetFieldSlice")) return false;
+
+    size_t n_values;
+    if (!response.GetIntegers(out_slice.Times, out_slice.Size) || !response.GetNumbers(out_slice.Values, n_values) ||
+        n_values != out_slice.Size)
+    {
+        std::cerr << "GetFieldSlice Error! Invalid response from the server." << std::endl;
+        out_slice = FieldSlice();
+        return false;
+    }
+    return true;
+}
+
+// Get the values of several numeric fields of a served sequence on a time grid with the given period
+// (nanoseconds). The grid covers the part of the time range in which all the fields have data.
+bool DatasetClient::GetAlignedMatrix(const std::string &sequence_name, const VecString &topic_names,
+    const VecString &field_labels, long long period, AlignedMatrix &out_matrix, long long start_time, long long end_time)
+{
+    out_matrix = AlignedMatrix();
+    if (topic_names.size() != field_labels.size() || topic_names.empty())
+    {
+        std::cerr << "GetAlignedMatrix Error! Give one topic name for each field label." << std::endl;
+        return false;
+    }
+    request.Clear();
+    request.PutText(sequence_name);
+    request.PutInteger(start_time);
+    request.PutInteger(end_time);
+    request.PutInteger(period);
+    request.PutInteger((long long)topic_names.size());
+    for (size_t i = 0; i < topic_names.size(); ++i)
+    {
+        request.PutText(topic_names[i]);
+        request.PutText(field_labels[i]);
+    }
+    if (!SendRequest(ServeFrame::GetAlignedMatrix, "GetAlignedMatrix")) return false;
+
+    long long n_columns;
+    size_t n_values;
+    if (!response.GetInteger(n_columns) || n_columns <= 0 || !response.GetIntegers(out_matrix.Times, out_matrix.NumberOfRows) ||
+        !response.GetNumbers(out_matrix.Values, n_values) || n_values != out_matrix.NumberOfRows * (size_t)n_columns)
+    {
+        std::cerr << "GetAlignedMatrix Error! Invalid response from the server." << std::endl;
+        out_matrix = AlignedMatrix();
+        return false;
+    }
+    out_matrix.NumberOfColumns = (size_t)n_columns;
+    return true;
+}
+
+// Get the size of the last response payload in bytes
+size_t DatasetClient::GetLastResponseSize() const
+{
+    return response.GetSize();
+}
+
+/******************************************************************************/
+/****************** DatasetClient Local Function Definitions ******************/
+/******************************************************************************/
+
+// Send the request payload and receive the response payload. Prints the error of a failed request.
+bool DatasetClient::SendRequest(uint32_t type, const std::string &function_name)
+{
+    if (!IsConnected())
+    {
+        std::cerr << function_name << " Error! The client is not connected." << std::endl;
+        return false;
+    }
+
+    ServeFrame frame;
+    if (!ServePayload::WriteFrame(socket_fd, type, request) ||
+        !ServePayload::ReadFrame(socket_fd, frame, response, std::numeric_limits<size_t>::max()))
+    {
+        std::cerr << function_name << " Error! The connection to the server is lost." << std::endl;
+        Disconnect();
+        return false;
+    }
+    if (frame.Type != ServeFrame::Success)
+    {
+        std::string error;
+        response.GetText(error);
+        std::cerr << function_name << " Error! " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+#endif
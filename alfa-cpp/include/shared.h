@@ -0,0 +1,1215 @@
+/*  ***************************************************************************
+*   shared.h - Header for publishing the loaded ALFA dataset sequences to
+*   shared memory, so several processes can use them without loading them.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_SHARED_H
+#define ALFA_SHARED_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <stdint.h>
+#include "commons.h"
+#include "message.h"
+#include "topic.h"
+#include "sequence.h"
+
+#if !defined _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#endif
+
+namespace alfa
+{
+
+// This class is a read-only view of a topic in a shared memory segment (see SharedSequence). The recording
+// times, the headers, the field texts and the typed values of the fields are used in place, without copying
+// or parsing them. The view is valid while its sequence is attached. It has the reading functions of Topic,
+// but it is not a Topic: the functions that take a Topic need the copy made by ToTopic.
+class SharedTopic
+{
+public:
+
+    // Local struct definitions
+    struct TextTable                    // Structure for a list of texts in the segment
+    {
+        uint64_t Count = 0;             // Number of texts
+        uint64_t Offsets = 0;           // Offset of the text boundaries (Count + 1 uint32 values)
+        uint64_t Data = 0;              // Offset of the characters of all the texts
+    };
+
+    struct ColumnRecord                 // Structure for a field of the topic in the segment
+    {
+        int32_t Type = Topic::String;   // Inferred type of the field (Topic::FieldType)
+        int32_t HasValues = 0;          // Are the typed values stored
+        uint64_t Values = 0;            // Offset of the int64 (Bool, Int64), double (Float64) or int32 (Category) values
+        TextTable Dictionary;           // Distinct values of a Category field
+        TextTable Texts;                // Texts of the field in all the messages
+    };
+
+    struct TopicRecord                  // Structure for a topic in the segment
+    {
+        uint64_t NumberOfMessages = 0;
+        int32_t NumberOfFields = 0, NumberOfColumns = 0;
+        int32_t IsInitialized = 0, IsFaultTopic = 0, HasHeader = 0, ZoneMapBlockSize = 0;
+        int32_t LenSeqID = 0, LenStamp = 0, LenFrameID = 0, NumberOfLenFields = 0;
+        TextTable Names;                // Topic name and file name
+        TextTable FieldLabels, OriginalLabels, LabelKeys;
+        uint64_t LabelValues = 0;       // Offset of the field indices of the label keys (int32)
+        uint64_t LenFields = 0;         // Offset of the printing lengths of the fields (int32)
+        uint64_t Times = 0;             // Offset of the recording times (int64, see DateTime::ToNanoseconds)
+        uint64_t SequenceIDs = 0;       // Offset of the header sequence ids (int32)
+        uint64_t Stamps = 0;            // Offset of the header stamps (int64)
+        TextTable FrameIDs;             // Header frame ids
+        uint64_t Columns = 0;           // Offset of the column records (NumberOfColumns)
+    };
+
+    // Class Data Members
+    std::string Name = "N/A";
+    std::string FileName;
+    VecString FieldLabels;
+
+    // Member Functions
+    bool IsInitialized() const;
+    bool IsFaultTopic() const;
+    bool HasHeaderField() const;
+    size_t Size() const;
+    int FindLabelIndex(const std::string &label) const;
+    Topic::FieldType GetFieldType(int field_index) const;
+    Message GetMessage(int msg_index) const;
+    std::string GetFieldText(int field_index, int msg_index) const;
+    Topic ToTopic() const;
+
+    std::vector<DateTime> GetTimes(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<long long> GetTimesInNanoseconds(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<Message::HeaderType> GetHeaders(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<std::string> GetFieldsAsString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<std::string> GetFieldsAsString(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<long long> GetFieldsAsLongLong(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<long long> GetFieldsAsLongLong(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<double> GetFieldsAsDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<double> GetFieldsAsDouble(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    // Direct access to the values in the segment (NULL if the field does not keep the values of the type)
+    const long long *GetTimeData() const;
+    const long long *GetIntegerData(int field_index) const;
+    const double *GetNumberData(int field_index) const;
+    const int *GetCodeData(int field_index) const;
+
+    // These functions are for the alfa-python use and are duplicates of the ones above
+    std::vector<std::string> GetFieldsAsStringByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsString(field_label, start_msg_index, n_messages); }
+    std::vector<std::string> GetFieldsAsStringByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsString(field_index, start_msg_index, n_messages); }
+
+    std::vector<long long> GetFieldsAsLongLongByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsLongLong(field_label, start_msg_index, n_messages); }
+    std::vector<long long> GetFieldsAsLongLongByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsLongLong(field_index, start_msg_index, n_messages); }
+
+    std::vector<double> GetFieldsAsDoubleByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsDouble(field_label, start_msg_index, n_messages); }
+    std::vector<double> GetFieldsAsDoubleByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsDouble(field_index, start_msg_index, n_messages); }
+
+private:
+    // The shared sequences create the views of their topics
+    friend class SharedSequence;
+
+    // Member Functions
+    void Attach(const char *segment, const TopicRecord *topic_record);
+    const ColumnRecord *GetColumnRecord(int field_index) const;
+    std::string GetText(const TextTable &table, size_t text_index) const;
+    VecString GetTexts(const TextTable &table) const;
+    bool ClampRange(int &start_msg_index, int &n_messages) const;
+    int FindFieldIndex(const std::string &field_label, const std::string &function_name) const;
+    const ColumnRecord *CheckNumericField(int field_index, bool integer_only, const std::string &function_name) const;
+
+    // Data Members
+    const char *segment = NULL;
+    const TopicRecord *record = NULL;
+    std::map<std::string, int> labels_map;
+};
+
+// This class publishes a loaded sequence to a named shared memory segment (a file in /dev/shm), or attaches
+// to a published one. The segment keeps the topics in a flat read-only layout, so the other processes map
+// it and query the sequence with no copy and no parsing (ToSequence makes a regular copy if needed).
+// The views are not Sequence and Topic objects, so the classes built on them (e.g., QueryEngine, WindowBuilder,
+// Replayer and TopicBus) run on a copy made by ToSequence; giving it the needed topics copies only those.
+// Each attached process holds a shared lock on the segment and is counted in it. A segment published with
+// remove_when_unused is removed by the last process that detaches from it; RemoveIfUnused also cleans up
+// the segments that were published without it.
+class SharedSequence
+{
+public:
+
+    // Local struct definitions
+    struct SegmentHeader                // Structure at the start of a segment
+    {
+        char Magic[8];                  // Identifies the ALFA segments
+        uint32_t Version = 0;
+        int32_t NumberOfAttachments = 0;    // Processes attached to the segment (updated atomically)
+        uint64_t TotalSize = 0;
+        int32_t RemoveWhenUnused = 0;
+        int32_t IsInitialized = 0;
+        int32_t OrderingMode = 0;
+        int32_t Reserved = 0;
+        SharedTopic::TextTable Names;   // Sequence name and directory path
+        uint64_t NumberOfTopics = 0;
+        uint64_t Topics = 0;            // Offset of the topic records
+        uint64_t NumberOfMessages = 0;
+        uint64_t MessageIndices = 0;    // Offset of the message index list (pairs of int32)
+    };
+
+    // Directory of the segments given by name
+    static const std::string SegmentDirectory;
+
+    // Version of the segment layout
+    static const uint32_t SegmentVersion;
+
+    // Class Data Members
+    std::string Name = "N/A";
+    std::string DirectoryPath;
+    std::vector<SharedTopic> Topics;
+
+    // Constructors & Deconstructors
+    SharedSequence();
+    ~SharedSequence();
+
+    // Member Functions
+    bool Publish(const Sequence &sequence, const std::string &segment_name, bool remove_when_unused = true);
+    bool Attach(const std::string &segment_name);
+    void Detach();
+    bool IsAttached() const;
+    bool IsInitialized() const;
+    size_t GetNumberOfMessages() const;
+    Sequence::MessageIndex GetMessageIndex(size_t msg_idx) const;
+    const Sequence::MessageIndex *GetMessageIndexList() const;
+    Message GetMessage(size_t msg_idx) const;
+    const SharedTopic &GetTopic(int topic_idx) const;
+    int FindTopicIndex(const std::string &topic_name) const;
+    Sequence ToSequence() const;
+    Sequence ToSequence(const VecString &topic_names) const;
+    const std::string &GetSegmentPath() const;
+    size_t GetSegmentSize() const;
+    int GetNumberOfAttachments() const;
+    static std::string SegmentNameToPath(const std::string &segment_name);
+    static bool Remove(const std::string &segment_name);
+    static bool RemoveIfUnused(const std::string &segment_name);
+
+private:
+    // Local struct definitions
+    struct SegmentWriter                // Structure for laying out a segment (only measures it if Base is NULL)
+    {
+        char *Base = NULL;
+        size_t Size = 0;
+        size_t Reserve(size_t n_bytes);
+        size_t Append(const void *data, size_t n_bytes);
+        void Write(size_t offset, const void *data, size_t n_bytes);
+    };
+
+    // Member Functions
+    static bool WriteSegment(const Sequence &sequence, bool remove_when_unused, SegmentWriter &writer);
+    static bool WriteTopic(const Topic &topic, SegmentWriter &writer, SharedTopic::TopicRecord &out_record);
+    template <typename TextFunction>
+    static bool WriteTexts(size_t n_texts, TextFunction text, SegmentWriter &writer, SharedTopic::TextTable &out_table);
+    bool CheckSegment() const;
+    bool CheckTopicRecord(const SharedTopic::TopicRecord &record) const;
+    bool CheckTextTable(const SharedTopic::TextTable &table) const;
+    bool CheckArray(uint64_t offset, uint64_t count, size_t item_size) const;
+
+    // The segment cannot be copied while it is mapped
+    SharedSequence(const SharedSequence &);
+    SharedSequence &operator=(const SharedSequence &);
+
+    // Data Members
+    std::string segment_path;
+    int segment_fd = -1;
+    const char *segment = NULL;         // Read-only mapping of the whole segment
+    SegmentHeader *header = NULL;       // Writable mapping of the header (for counting the attachments)
+    size_t segment_size = 0;
+    std::map<std::string, int> topic_map;
+};
+
+/******************************************************************************/
+/********************* SharedTopic Function Definitions ***********************/
+/******************************************************************************/
+
+// Returns the initialization status
+bool SharedTopic::IsInitialized() const
+{
+    return record != NULL && record->IsInitialized != 0;
+}
+
+// Returns true if this is a fault topic
+bool SharedTopic::IsFaultTopic() const
+{
+    return record != NULL && record->IsFaultTopic != 0;
+}
+
+// Returns true if the topic has the header fields
+bool SharedTopic::HasHeaderField() const
+{
+    return record != NULL && record->HasHeader != 0;
+}
+
+// Get the number of messages in the topic
+size_t SharedTopic::Size() const
+{
+    return (record == NULL) ? 0 : (size_t)record->NumberOfMessages;
+}
+
+// Find the index of a field label. Returns -1 if the field is not found.
+int SharedTopic::FindLabelIndex(const std::string &label) const
+{
+    std::map<std::string, int>::const_iterator it = labels_map.find(label);
+
+    // Return -1 if not found
+    if (it == labels_map.end()) return -1;
+
+    return it->second;
+}
+
+// Get the inferred type of a field (see Topic::GetFieldType)
+Topic::FieldType SharedTopic::GetFieldType(int field_index) const
+{
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    return (column == NULL) ? Topic::String : (Topic::FieldType)column->Type;
+}
+
+// Get a message by index. Returns an empty message if the index is out of range.
+Message SharedTopic::GetMessage(int msg_index) const
+{
+    Message message;
+    if (msg_index < 0 || msg_index >= (int)Size()) return message;
+
+    message.DateTime = DateTime::NanosecondsToTime(GetTimeData()[msg_index]);
+    if (HasHeaderField())
+    {
+        message.Header.SequenceID = ((const int32_t *)(segment + record->SequenceIDs))[msg_index];
+        message.Header.Stamp = ((const int64_t *)(segment + record->Stamps))[msg_index];
+        message.Header.FrameID = GetText(record->FrameIDs, msg_index);
+    }
+    message.Fields.resize(record->NumberOfFields);
+    for (int f = 0; f < record->NumberOfFields; ++f)
+        message.Fields[f] = GetFieldText(f, msg_index);
+
+    return message;
+}
+
+// Get the text of a field in a message (empty if the indices are out of range)
+std::string SharedTopic::GetFieldText(int field_index, int msg_index) const
+{
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    if (column == NULL || msg_index < 0 || msg_index >= (int)Size()) return "";
+    return GetText(column->Texts, msg_index);
+}
+
+// Copy the topic to a regular topic. The typed values are copied as they are, so nothing is parsed again.
+Topic SharedTopic::ToTopic() const
+{
+    Topic topic;
+    if (record == NULL) return topic;
+
+    // Restore the topic information
+    topic.Name = Name;
+    topic.FileName = FileName;
+    topic.FieldLabels = FieldLabels;
+    topic.labels_map = labels_map;
+    topic.orig_field_labels = GetTexts(record->OriginalLabels);
+    topic.is_fault_topic = IsFaultTopic();
+    topic.has_header = HasHeaderField();
+    topic.len_seqid = record->LenSeqID;
+    topic.len_stamp = record->LenStamp;
+    topic.len_frameid = record->LenFrameID;
+    const int32_t *len_fields = (const int32_t *)(segment + record->LenFields);
+    topic.len_fields.assign(len_fields, len_fields + record->NumberOfLenFields);
+
+    // Restore the messages
+    topic.Messages.resize(Size());
+    for (int i = 0; i < (int)Size(); ++i)
+        topic.Messages[i] = GetMessage(i);
+
+    // Restore the values of the fields in their types
+    topic.columns.resize(record->NumberOfColumns);
+    topic.is_column_stored.assign(record->NumberOfColumns, 0);
+    for (int f = 0; f < record->NumberOfColumns; ++f)
+    {
+        const ColumnRecord &column = ((const ColumnRecord *)(segment + record->Columns))[f];
+        Topic::Column &out_column = topic.columns[f];
+        out_column.Type = (Topic::FieldType)column.Type;
+        if (GetIntegerData(f) != NULL)
+        {
+            // The empty values are found from the texts
+            out_column.Integers.assign(GetIntegerData(f), GetIntegerData(f) + Size());
+            for (int i = 0; i < (int)Size(); ++i)
+                if (topic.Messages[i].Fields[f].empty()) out_column.Missing.push_back(i);
+        }
+        else if (GetNumberData(f) != NULL)
+            out_column.Numbers.assign(GetNumberData(f), GetNumberData(f) + Size());
+        else if (GetCodeData(f) != NULL)
+            out_column.Codes.assign(GetCodeData(f), GetCodeData(f) + Size());
+        topic.is_column_stored[f] = column.HasValues ? 1 : 0;
+        out_column.Dictionary = GetTexts(column.Dictionary);
+        topic.FieldTypes.push_back(out_column.Type);
+    }
+
+    // The zone maps are summaries of the values, so they are built again
+    if (record->ZoneMapBlockSize > 0)
+        topic.BuildZoneMaps(record->ZoneMapBlockSize);
+
+    topic.is_initialized = IsInitialized();
+    return topic;
+}
+
+// Retrieve the DateTime of a desired number of messages starting from the desired index
+std::vector<DateTime> SharedTopic::GetTimes(int start_msg_index, int n_messages) const
+{
+    std::vector<DateTime> vec_output;
+    if (!ClampRange(start_msg_index, n_messages)) return vec_output;
+
+    vec_output.reserve(n_messages);
+    for (int i = start_msg_index; i < start_msg_index + n_messages; ++i)
+        vec_output.push_back(DateTime::NanosecondsToTime(GetTimeData()[i]));
+    return vec_output;
+}
+
+// Retrieve the recording times in nanoseconds of a desired number of messages starting from the desired index
+std::vector<long long> SharedTopic::GetTimesInNanoseconds(int start_msg_index, int n_messages) const
+{
+    if (!ClampRange(start_msg_index, n_messages)) return std::vector<long long>();
+    return std::vector<long long>(GetTimeData() + start_msg_index, GetTimeData() + start_msg_index + n_messages);
+}
+
+// Retrieve the Header of a desired number of messages starting from the desired index
+std::vector<Message::HeaderType> SharedTopic::GetHeaders(int start_msg_index, int n_messages) const
+{
+    std::vector<Message::HeaderType> vec_output;
+    if (!HasHeaderField() || !ClampRange(start_msg_index, n_messages)) return vec_output;
+
+    vec_output.resize(n_messages);
+    for (int i = 0; i < n_messages; ++i)
+    {
+        vec_output[i].SequenceID = ((const int32_t *)(segment + record->SequenceIDs))[start_msg_index + i];
+        vec_output[i].Stamp = ((const int64_t *)(segment + record->Stamps))[start_msg_index + i];
+        vec_output[i].FrameID = GetText(record->FrameIDs, start_msg_index + i);
+    }
+    return vec_output;
+}
+
+// Retrieve the field texts of a desired number of messages starting from the desired index
+std::vector<std::string> SharedTopic::GetFieldsAsString(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<std::string> vec_output;
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    if (column == NULL)
+    {
+        std::cerr << "GetFieldsAsString Error! Field index is out of range." << std::endl;
+        return vec_output;
+    }
+    if (!ClampRange(start_msg_index, n_messages)) return vec_output;
+
+    vec_output.reserve(n_messages);
+    for (int i = start_msg_index; i < start_msg_index + n_messages; ++i)
+        vec_output.push_back(GetText(column->Texts, i));
+    return vec_output;
+}
+
+// Retrieve the field texts of a desired number of messages starting from the desired index
+std::vector<std::string> SharedTopic::GetFieldsAsString(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsString");
+    if (field_index < 0) return std::vector<std::string>();
+    return GetFieldsAsString(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the integer fields (Bool or Int64) of a desired number of messages starting from the desired index
+std::vector<long long> SharedTopic::GetFieldsAsLongLong(int field_index, int start_msg_index, int n_messages) const
+{
+    if (CheckNumericField(field_index, true, "GetFieldsAsLongLong") == NULL || !ClampRange(start_msg_index, n_messages))
+        return std::vector<long long>();
+    const long long *values = GetIntegerData(field_index) + start_msg_index;
+    return std::vector<long long>(values, values + n_messages);
+}
+
+// Retrieve the integer fields (Bool or Int64) of a desired number of messages starting from the desired index
+std::vector<long long> SharedTopic::GetFieldsAsLongLong(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsLongLong");
+    if (field_index < 0) return std::vector<long long>();
+    return GetFieldsAsLongLong(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the numeric fields (Bool, Int64 or Float64) of a desired number of messages starting from the desired index
+std::vector<double> SharedTopic::GetFieldsAsDouble(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<double> vec_output;
+    if (CheckNumericField(field_index, false, "GetFieldsAsDouble") == NULL || !ClampRange(start_msg_index, n_messages))
+        return vec_output;
+
+    if (GetNumberData(field_index) != NULL)
+        vec_output.assign(GetNumberData(field_index) + start_msg_index, GetNumberData(field_index) + start_msg_index + n_messages);
+    else
+    {
+        // The empty values of the integer fields are NaN (as in Topic)
+        vec_output.assign(GetIntegerData(field_index) + start_msg_index, GetIntegerData(field_index) + start_msg_index + n_messages);
+        const uint32_t *offsets = (const uint32_t *)(segment + GetColumnRecord(field_index)->Texts.Offsets);
+        for (int i = 0; i < n_messages; ++i)
+            if (offsets[start_msg_index + i + 1] == offsets[start_msg_index + i])
+                vec_output[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+    return vec_output;
+}
+
+// Retrieve the numeric fields (Bool, Int64 or Float64) of a desired number of messages starting from the desired index
+std::vector<double> SharedTopic::GetFieldsAsDouble(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsDouble");
+    if (field_index < 0) return std::vector<double>();
+    return GetFieldsAsDouble(field_index, start_msg_index, n_messages);
+}
+
+// Get the recording times of all the messages in nanoseconds (see DateTime::ToNanoseconds)
+const long long *SharedTopic::GetTimeData() const
+{
+    return (record == NULL) ? NULL : (const long long *)(segment + record->Times);
+}
+
+// Get the values of a Bool or Int64 field of all the messages
+const long long *SharedTopic::GetIntegerData(int field_index) const
+{
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    if (column == NULL || !column->HasValues || (column->Type != Topic::Bool && column->Type != Topic::Int64)) return NULL;
+    return (const long long *)(segment + column->Values);
+}
+
+// Get the values of a Float64 field of all the messages
+const double *SharedTopic::GetNumberData(int field_index) const
+{
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    if (column == NULL || !column->HasValues || column->Type != Topic::Float64) return NULL;
+    return (const double *)(segment + column->Values);
+}
+
+// Get the dictionary codes of a Category field of all the messages
+const int *SharedTopic::GetCodeData(int field_index) const
+{
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    if (column == NULL || !column->HasValues || column->Type != Topic::Category) return NULL;
+    return (const int *)(segment + column->Values);
+}
+
+/******************************************************************************/
+/****************** SharedTopic Local Function Definitions ********************/
+/******************************************************************************/
+
+// Point the view to a topic record of a mapped segment
+void SharedTopic::Attach(const char *segment, const TopicRecord *topic_record)
+{
+    this->segment = segment;
+    this->record = topic_record;
+    Name = GetText(record->Names, 0);
+    FileName = GetText(record->Names, 1);
+    FieldLabels = GetTexts(record->FieldLabels);
+
+    // Restore the table of the labels vs. their indices
+    labels_map.clear();
+    const int32_t *label_values = (const int32_t *)(segment + record->LabelValues);
+    for (size_t i = 0; i < record->LabelKeys.Count; ++i)
+        labels_map[GetText(record->LabelKeys, i)] = label_values[i];
+}
+
+// Get the record of a field, or NULL if the field has no record
+const SharedTopic::ColumnRecord *SharedTopic::GetColumnRecord(int field_index) const
+{
+    if (record == NULL || field_index < 0 || field_index >= record->NumberOfColumns) return NULL;
+    return (const ColumnRecord *)(segment + record->Columns) + field_index;
+}
+
+// Get a text of a table
+std::string SharedTopic::GetText(const TextTable &table, size_t text_index) const
+{
+    if (text_index >= table.Count) return "";
+    const uint32_t *offsets = (const uint32_t *)(segment + table.Offsets);
+    return std::string(segment + table.Data + offsets[text_index], offsets[text_index + 1] - offsets[text_index]);
+}
+
+// Get all the texts of a table
+VecString SharedTopic::GetTexts(const TextTable &table) const
+{
+    VecString texts((size_t)table.Count);
+    for (size_t i = 0; i < texts.size(); ++i)
+        texts[i] = GetText(table, i);
+    return texts;
+}
+
+// Limit a range of messages to the topic (a negative number is all the messages). Returns false if it is empty.
+bool SharedTopic::ClampRange(int &start_msg_index, int &n_messages) const
+{
+    if (start_msg_index < 0 || start_msg_index >= (int)Size()) return false;
+    if (n_messages < 0 || n_messages > (int)Size() - start_msg_index)
+        n_messages = (int)Size() - start_msg_index;
+    return n_messages > 0;
+}
+
+// Find the index of a field label. Prints an error and returns -1 if the field is not found.
+int SharedTopic::FindFieldIndex(const std::string &field_label, const std::string &function_name) const
+{
+    int field_index = FindLabelIndex(field_label);
+    if (field_index < 0)
+        std::cerr << function_name << " Error! '" << field_label << "' field not found." << std::endl;
+    return field_index;
+}
+
+// Get the record of a field that keeps numeric values (only integers if asked). Prints an error and returns
+// NULL otherwise.
+const SharedTopic::ColumnRecord *SharedTopic::CheckNumericField(int field_index, bool integer_only, const std::string &function_name) const
+{
+    const ColumnRecord *column = GetColumnRecord(field_index);
+    if (column == NULL)
+    {
+        std::cerr << function_name << " Error! Field index is out of range." << std::endl;
+        return NULL;
+    }
+
+    Topic::FieldType type = (Topic::FieldType)column->Type;
+    if (type == Topic::Category || type == Topic::String || (integer_only && type == Topic::Float64) || !column->HasValues)
+    {
+        std::cerr << function_name << " Error! '" << FieldLabels[field_index] << "' field is "
+            << Topic::FieldTypeToString(type) << ", not " << (integer_only ? "integer." : "numeric.") << std::endl;
+        return NULL;
+    }
+    return column;
+}
+
+/******************************************************************************/
+/******************** SharedSequence Function Definitions *********************/
+/******************************************************************************/
+
+const std::string SharedSequence::SegmentDirectory = "/dev/shm/";
+const uint32_t SharedSequence::SegmentVersion = 1;
+
+// Default constructor for SharedSequence
+SharedSequence::SharedSequence()
+{
+}
+
+// Destructor function for SharedSequence. Detaches from the segment.
+SharedSequence::~SharedSequence()
+{
+    Detach();
+}
+
+// Publish a loaded sequence to a shared memory segment and attach to it. A segment with the same name is
+// replaced (the processes attached to it keep the old one). If remove_when_unused is set, the segment is
+// removed when the last process detaches from it, so it should be attached by the other processes before
+// this one detaches.
+bool SharedSequence::Publish(const Sequence &sequence, const std::string &segment_name, bool remove_when_unused)
+{
+#if defined _WIN32
+    std::cerr << "Publish Error! Shared sequences are not supported on Windows." << std::endl;
+    return false;
+#else
+    Detach();
+
+    // Check that all the topics are loaded
+    for (int i = 0; i < (int)sequence.Topics.size(); ++i)
+        if (!sequence.Topics[i].IsLoaded())
+        {
+            std::cerr << "Publish Error! '" << sequence.Topics[i].Name << "' topic is unloaded." << std::endl;
+            return false;
+        }
+
+    // Measure the segment first, then write it to a temporary file
+    SegmentWriter writer;
+    if (!WriteSegment(sequence, remove_when_unused, writer)) return false;
+    std::string path = SegmentNameToPath(segment_name);
+    std::string temp_path = path + "." + std::to_string((long long)getpid()) + ".tmp";
+    int fd = open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Publish Error! Failed to create '" << temp_path << "' (" << std::strerror(errno) << ")." << std::endl;
+        return false;
+    }
+    size_t size = writer.Size;
+    void *data = (ftruncate(fd, (off_t)size) == 0) ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (data == MAP_FAILED)
+    {
+        std::cerr << "Publish Error! Failed to allocate " << size << " bytes for '" << temp_path << "' ("
+            << std::strerror(errno) << ")." << std::endl;
+        close(fd);
+        unlink(temp_path.c_str());
+        return false;
+    }
+    writer = SegmentWriter();
+    writer.Base = (char *)data;
+    WriteSegment(sequence, remove_when_unused, writer);
+    munmap(data, size);
+    close(fd);
+
+    // Replace the segment at once, so the other processes never see it half written
+    if (rename(temp_path.c_str(), path.c_str()) != 0)
+    {
+        std::cerr << "Publish Error! Failed to publish '" << path << "' (" << std::strerror(errno) << ")." << std::endl;
+        unlink(temp_path.c_str());
+        return false;
+    }
+
+    return Attach(segment_name);
+#endif
+}
+
+// Attach to a published segment. The topics and the messages are used in place from the segment.
+bool SharedSequence::Attach(const std::string &segment_name)
+{
+#if defined _WIN32
+    std::cerr << "Attach Error! Shared sequences are not supported on Windows." << std::endl;
+    return false;
+#else
+    Detach();
+    segment_path = SegmentNameToPath(segment_name);
+
+    // Hold a shared lock while attached, so the segment is not removed under the process
+    segment_fd = open(segment_path.c_str(), O_RDWR | O_CLOEXEC);
+    struct stat file_stat, path_stat;
+    if (segment_fd < 0 || flock(segment_fd, LOCK_SH) != 0 || fstat(segment_fd, &file_stat) != 0)
+    {
+        std::cerr << "Attach Error! Failed to open '" << segment_path << "' (" << std::strerror(errno) << ")." << std::endl;
+        Detach();
+        return false;
+    }
+
+    // The last process may have removed the segment before it was locked
+    if (stat(segment_path.c_str(), &path_stat) != 0 || path_stat.st_ino != file_stat.st_ino || path_stat.st_dev != file_stat.st_dev)
+    {
+        std::cerr << "Attach Error! '" << segment_path << "' was removed or replaced while attaching." << std::endl;
+        Detach();
+        return false;
+    }
+    segment_size = (size_t)file_stat.st_size;
+
+    // Map the whole segment read-only and the header writable
+    void *data = (segment_size >= sizeof(SegmentHeader)) ? mmap(NULL, segment_size, PROT_READ, MAP_SHARED, segment_fd, 0) : MAP_FAILED;
+    void *header_data = (data != MAP_FAILED) ?
+        mmap(NULL, sizeof(SegmentHeader), PROT_READ | PROT_WRITE, MAP_SHARED, segment_fd, 0) : MAP_FAILED;
+    if (data != MAP_FAILED) segment = (const char *)data;
+    if (header_data != MAP_FAILED) header = (SegmentHeader *)header_data;
+    if (segment == NULL || header == NULL || std::memcmp(header->Magic, "ALFASEQ", 8) != 0 ||
+        header->Version != SegmentVersion || header->TotalSize != segment_size || !CheckSegment())
+    {
+        std::cerr << "Attach Error! '" << segment_path << "' is not a valid shared sequence." << std::endl;
+
+        // The process is not counted in the segment yet
+        if (header != NULL) munmap(header, sizeof(SegmentHeader));
+        header = NULL;
+        Detach();
+        return false;
+    }
+    __atomic_add_fetch(&header->NumberOfAttachments, 1, __ATOMIC_ACQ_REL);
+
+    // Create the views of the topics
+    SharedTopic names;
+    names.segment = segment;
+    Name = names.GetText(header->Names, 0);
+    DirectoryPath = names.GetText(header->Names, 1);
+    Topics.resize((size_t)header->NumberOfTopics);
+    for (int i = 0; i < (int)Topics.size(); ++i)
+    {
+        Topics[i].Attach(segment, (const SharedTopic::TopicRecord *)(segment + header->Topics) + i);
+        topic_map.insert(std::make_pair(Topics[i].Name, i));
+    }
+
+    return true;
+#endif
+}
+
+// Detach from the segment. The last process removes the segment if it was published with remove_when_unused.
+void SharedSequence::Detach()
+{
+#if !defined _WIN32
+    if (header != NULL) __atomic_sub_fetch(&header->NumberOfAttachments, 1, __ATOMIC_ACQ_REL);
+    if (header != NULL && header->RemoveWhenUnused)
+    {
+        // Remove it if no other process holds its lock (the locks of the ended processes are released, even
+        // if they did not detach) and it was not replaced meanwhile
+        struct stat file_stat, path_stat;
+        if (flock(segment_fd, LOCK_EX | LOCK_NB) == 0 && fstat(segment_fd, &file_stat) == 0 &&
+            stat(segment_path.c_str(), &path_stat) == 0 && file_stat.st_ino == path_stat.st_ino &&
+            file_stat.st_dev == path_stat.st_dev)
+            unlink(segment_path.c_str());
+    }
+    if (header != NULL) munmap(header, sizeof(SegmentHeader));
+    if (segment != NULL) munmap((void *)segment, segment_size);
+    if (segment_fd >= 0) close(segment_fd);
+#endif
+
+    header = NULL;
+    segment = NULL;
+    segment_fd = -1;
+    segment_size = 0;
+    segment_path.clear();
+    Name = "N/A";
+    DirectoryPath.clear();
+    Topics.clear();
+    topic_map.clear();
+}
+
+// Returns true if the object is attached to a segment
+bool SharedSequence::IsAttached() const
+{
+    return segment != NULL;
+}
+
+// Returns the initialization status of the published sequence
+bool SharedSequence::IsInitialized() const
+{
+    return IsAttached() && header->IsInitialized != 0;
+}
+
+// Get the number of messages in the message index list
+size_t SharedSequence::GetNumberOfMessages() const
+{
+    return IsAttached() ? (size_t)header->NumberOfMessages : 0;
+}
+
+// Get the topic and message indices of a message in the list sorted by the recording time
+Sequence::MessageIndex SharedSequence::GetMessageIndex(size_t msg_idx) const
+{
+    if (msg_idx >= GetNumberOfMessages()) return Sequence::MessageIndex();
+    return GetMessageIndexList()[msg_idx];
+}
+
+// Get the whole message index list sorted by the recording time (GetNumberOfMessages entries)
+const Sequence::MessageIndex *SharedSequence::GetMessageIndexList() const
+{
+    return IsAttached() ? (const Sequence::MessageIndex *)(segment + header->MessageIndices) : NULL;
+}
+
+// Get messages by index from the message collection sorted by the recording time
+Message SharedSequence::GetMessage(size_t msg_idx) const
+{
+    // Check if the index is in range
+    if (msg_idx >= GetNumberOfMessages())
+        return Message();
+
+    Sequence::MessageIndex index = GetMessageIndex(msg_idx);
+    return Topics[index.TopicIdx].GetMessage(index.MessageIdx);
+}
+
+// Get a topic by index
+const SharedTopic &SharedSequence::GetTopic(int topic_idx) const
+{
+    return Topics[topic_idx];
+}
+
+// Find the index of a given topic (case sensitive)
+int SharedSequence::FindTopicIndex(const std::string &topic_name) const
+{
+    std::map<std::string, int>::const_iterator it = topic_map.find(topic_name);
+
+    // Return -1 if not found
+    if (it == topic_map.end()) return -1;
+
+    return it->second;
+}
+
+// Copy the shared sequence to a regular sequence (e.g., for the functions that need a Sequence object).
+// Nothing is parsed again, but the copy takes the memory of a loaded sequence.
+Sequence SharedSequence::ToSequence() const
+{
+    VecString topic_names;
+    for (int i = 0; i < (int)Topics.size(); ++i)
+        topic_names.push_back(Topics[i].Name);
+    return ToSequence(topic_names);
+}
+
+// Copy the given topics of the shared sequence to a regular sequence, e.g., for running a QueryEngine on
+// a few topics without copying the whole sequence. The topics keep their order in the shared sequence and
+// the message index list only has their messages. The fault topics are needed for the fault ground truth.
+Sequence SharedSequence::ToSequence(const VecString &topic_names) const
+{
+    Sequence sequence;
+    if (!IsAttached()) return sequence;
+
+    // Mark the desired topics
+    std::vector<int> new_indices(Topics.size(), -1);
+    for (int i = 0; i < (int)topic_names.size(); ++i)
+    {
+        int topic_idx = FindTopicIndex(topic_names[i]);
+        if (topic_idx < 0)
+            std::cerr << "ToSequence Error! There is no '" << topic_names[i] << "' topic in the shared sequence." << std::endl;
+        else
+            new_indices[topic_idx] = 0;
+    }
+
+    sequence.Name = Name;
+    sequence.DirectoryPath = DirectoryPath;
+    sequence.ordering_mode = (Sequence::OrderingMode)header->OrderingMode;
+
+    // Copy the topics and give them their indices in the copy
+    for (int i = 0; i < (int)Topics.size(); ++i)
+    {
+        if (new_indices[i] < 0) continue;
+        new_indices[i] = (int)sequence.Topics.size();
+        sequence.topic_map[Topics[i].Name] = new_indices[i];
+        sequence.Topics.push_back(Topics[i].ToTopic());
+    }
+
+    // Keep the messages of the copied topics in the message index list (it is already sorted)
+    const Sequence::MessageIndex *index_list = GetMessageIndexList();
+    for (size_t i = 0; i < GetNumberOfMessages(); ++i)
+        if (new_indices[index_list[i].TopicIdx] >= 0)
+            sequence.MessageIndexList.push_back(Sequence::MessageIndex(new_indices[index_list[i].TopicIdx], index_list[i].MessageIdx));
+
+    sequence.BuildFaultIndex();
+    sequence.is_initialized = IsInitialized();
+    return sequence;
+}
+
+// Get the path of the attached segment
+const std::string &SharedSequence::GetSegmentPath() const
+{
+    return segment_path;
+}
+
+// Get the size of the attached segment in bytes
+size_t SharedSequence::GetSegmentSize() const
+{
+    return segment_size;
+}
+
+// Get the number of processes attached to the segment (the processes that ended without detaching are
+// still counted; see RemoveIfUnused)
+int SharedSequence::GetNumberOfAttachments() const
+{
+#if defined _WIN32
+    return 0;
+#else
+    return IsAttached() ? __atomic_load_n(&header->NumberOfAttachments, __ATOMIC_ACQUIRE) : 0;
+#endif
+}
+
+// Get the path of a segment given its name. The names without a path separator are in the segment directory.
+std::string SharedSequence::SegmentNameToPath(const std::string &segment_name)
+{
+    if (segment_name.find('/') != std::string::npos) return segment_name;
+    return SegmentDirectory + segment_name;
+}
+
+// Remove a segment now. The processes attached to it can use it until they detach.
+bool SharedSequence::Remove(const std::string &segment_name)
+{
+#if defined _WIN32
+    (void)segment_name;
+    return false;
+#else
+    return unlink(SegmentNameToPath(segment_name).c_str()) == 0;
+#endif
+}
+
+// Remove a segment if no process is attached to it (e.g., after the processes ended without detaching).
+// Returns true if the segment was removed.
+bool SharedSequence::RemoveIfUnused(const std::string &segment_name)
+{
+#if defined _WIN32
+    (void)segment_name;
+    return false;
+#else
+    std::string path = SegmentNameToPath(segment_name);
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool is_removed = (flock(fd, LOCK_EX | LOCK_NB) == 0) && (unlink(path.c_str()) == 0);
+    close(fd);
+    return is_removed;
+#endif
+}
+
+/******************************************************************************/
+/**************** SharedSequence Local Function Definitions *******************/
+/******************************************************************************/
+
+// Reserve space for some bytes in the segment (aligned to 8 bytes). Returns the offset of the space.
+size_t SharedSequence::SegmentWriter::Reserve(size_t n_bytes)
+{
+    size_t offset = (Size + 7) & ~(size_t)7;
+    Size = offset + n_bytes;
+    return offset;
+}
+
+// Append some bytes to the segment. Returns the offset of the bytes.
+size_t SharedSequence::SegmentWriter::Append(const void *data, size_t n_bytes)
+{
+    size_t offset = Reserve(n_bytes);
+    Write(offset, data, n_bytes);
+    return offset;
+}
+
+// Write some bytes at an offset of the segment (nothing is written while measuring)
+void SharedSequence::SegmentWriter::Write(size_t offset, const void *data, size_t n_bytes)
+{
+    if (Base != NULL && n_bytes > 0)
+        std::memcpy(Base + offset, data, n_bytes);
+}
+
+// Lay out a whole sequence in the segment. Returns false if the sequence cannot be stored.
+bool SharedSequence::WriteSegment(const Sequence &sequence, bool remove_when_unused, SegmentWriter &writer)
+{
+    SegmentHeader segment_header;
+    size_t header_offset = writer.Reserve(sizeof(SegmentHeader));
+    std::memcpy(segment_header.Magic, "ALFASEQ", 8);
+    segment_header.Version = SegmentVersion;
+    segment_header.RemoveWhenUnused = remove_when_unused ? 1 : 0;
+    segment_header.IsInitialized = sequence.IsInitialized() ? 1 : 0;
+    segment_header.OrderingMode = (int32_t)sequence.GetOrderingMode();
+
+    // Write the names and the message index list
+    const std::string *names[] = { &sequence.Name, &sequence.DirectoryPath };
+    WriteTexts(2, [&names](size_t i) -> const std::string & { return *names[i]; }, writer, segment_header.Names);
+    std::vector<int32_t> indices(2 * sequence.MessageIndexList.size());
+    for (size_t i = 0; i < sequence.MessageIndexList.size(); ++i)
+    {
+        indices[2 * i] = sequence.MessageIndexList[i].TopicIdx;
+        indices[2 * i + 1] = sequence.MessageIndexList[i].MessageIdx;
+    }
+    segment_header.NumberOfMessages = sequence.MessageIndexList.size();
+    segment_header.MessageIndices = writer.Append(indices.data(), indices.size() * sizeof(int32_t));
+
+    // Write the topics after their records
+    std::vector<SharedTopic::TopicRecord> records(sequence.Topics.size());
+    segment_header.NumberOfTopics = records.size();
+    segment_header.Topics = writer.Reserve(records.size() * sizeof(SharedTopic::TopicRecord));
+    for (int i = 0; i < (int)records.size(); ++i)
+        if (!WriteTopic(sequence.Topics[i], writer, records[i]))
+            return false;
+    writer.Write(segment_header.Topics, records.data(), records.size() * sizeof(SharedTopic::TopicRecord));
+
+    segment_header.TotalSize = writer.Reserve(0);
+    writer.Write(header_offset, &segment_header, sizeof(segment_header));
+    return true;
+}
+
+// Lay out a topic in the segment and fill its record. Returns false if the topic cannot be stored.
+bool SharedSequence::WriteTopic(const Topic &topic, SegmentWriter &writer, SharedTopic::TopicRecord &out_record)
+{
+    size_t n_messages = topic.Messages.size();
+    out_record.NumberOfMessages = n_messages;
+    out_record.NumberOfFields = (int32_t)topic.FieldLabels.size();
+    out_record.NumberOfColumns = (int32_t)std::min(topic.columns.size(), topic.FieldLabels.size());
+    out_record.IsInitialized = topic.IsInitialized() ? 1 : 0;
+    out_record.IsFaultTopic = topic.IsFaultTopic() ? 1 : 0;
+    out_record.HasHeader = topic.HasHeaderField() ? 1 : 0;
+    out_record.ZoneMapBlockSize = topic.GetZoneMaps().BlockSize;
+    out_record.LenSeqID = topic.len_seqid;
+    out_record.LenStamp = topic.len_stamp;
+    out_record.LenFrameID = topic.len_frameid;
+
+    // Write the topic information
+    const std::string *names[] = { &topic.Name, &topic.FileName };
+    std::vector<const std::string *> label_keys;
+    std::vector<int32_t> label_values, len_fields(topic.len_fields.begin(), topic.len_fields.end());
+    for (std::map<std::string, int>::const_iterator it = topic.labels_map.begin(); it != topic.labels_map.end(); ++it)
+    {
+        label_keys.push_back(&it->first);
+        label_values.push_back(it->second);
+    }
+    bool is_written = WriteTexts(2, [&names](size_t i) -> const std::string & { return *names[i]; }, writer, out_record.Names) &&
+        WriteTexts(topic.FieldLabels.size(), [&topic](size_t i) -> const std::string & { return topic.FieldLabels[i]; },
+            writer, out_record.FieldLabels) &&
+        WriteTexts(topic.orig_field_labels.size(), [&topic](size_t i) -> const std::string & { return topic.orig_field_labels[i]; },
+            writer, out_record.OriginalLabels) &&
+        WriteTexts(label_keys.size(), [&label_keys](size_t i) -> const std::string & { return *label_keys[i]; },
+            writer, out_record.LabelKeys);
+    out_record.LabelValues = writer.Append(label_values.data(), label_values.size() * sizeof(int32_t));
+    out_record.NumberOfLenFields = (int32_t)len_fields.size();
+    out_record.LenFields = writer.Append(len_fields.data(), len_fields.size() * sizeof(int32_t));
+
+    // Write the recording times and the headers
+    std::vector<int64_t> values(n_messages);
+    for (size_t i = 0; i < n_messages; ++i)
+    {
+        values[i] = topic.Messages[i].DateTime.ToNanoseconds();
+        if (DateTime::NanosecondsToTime(values[i]) != topic.Messages[i].DateTime)
+        {
+            std::cerr << "Publish Error! Invalid recording time in message #" << i << " of '" << topic.Name << "' topic." << std::endl;
+            return false;
+        }
+    }
+    out_record.Times = writer.Append(values.data(), n_messages * sizeof(int64_t));
+    std::vector<int32_t> sequence_ids(n_messages);
+    for (size_t i = 0; i < n_messages; ++i)
+    {
+        sequence_ids[i] = topic.Messages[i].Header.SequenceID;
+        values[i] = topic.Messages[i].Header.Stamp;
+    }
+    out_record.SequenceIDs = writer.Append(sequence_ids.data(), n_messages * sizeof(int32_t));
+    out_record.Stamps = writer.Append(values.data(), n_messages * sizeof(int64_t));
+    is_written = is_written && WriteTexts(n_messages,
+        [&topic](size_t i) -> const std::string & { return topic.Messages[i].Header.FrameID; }, writer, out_record.FrameIDs);
+
+    // Write the texts and the typed values of the fields after their records
+    std::vector<SharedTopic::ColumnRecord> columns(out_record.NumberOfColumns);
+    out_record.Columns = writer.Reserve(columns.size() * sizeof(SharedTopic::ColumnRecord));
+    static const std::string empty_field;
+    for (int f = 0; f < (int)columns.size() && is_written; ++f)
+    {
+        // The values that the topic has not stored yet are converted only for the segment
+        Topic::Column converted_column;
+        const Topic::Column *stored_column = topic.FindStoredColumn(f);
+        if (stored_column == NULL)
+        {
+            converted_column.Type = topic.columns[f].Type;
+            converted_column.Dictionary = topic.columns[f].Dictionary;
+            topic.AppendColumnValues(converted_column, f, 0);
+            stored_column = &converted_column;
+        }
+        const Topic::Column &column = *stored_column;
+        columns[f].Type = (int32_t)column.Type;
+        if (column.Integers.size() == n_messages && n_messages > 0)
+            columns[f].Values = writer.Append(column.Integers.data(), n_messages * sizeof(long long));
+        else if (column.Numbers.size() == n_messages && n_messages > 0)
+            columns[f].Values = writer.Append(column.Numbers.data(), n_messages * sizeof(double));
+        else if (column.Codes.size() == n_messages && n_messages > 0)
+            columns[f].Values = writer.Append(column.Codes.data(), n_messages * sizeof(int));
+        columns[f].HasValues = (columns[f].Values != 0) ? 1 : 0;
+
+        is_written = WriteTexts(column.Dictionary.size(), [&column](size_t i) -> const std::string & { return column.Dictionary[i]; },
+            writer, columns[f].Dictionary) &&
+            WriteTexts(n_messages, [&topic, f](size_t i) -> const std::string &
+                { return (f < (int)topic.Messages[i].Fields.size()) ? topic.Messages[i].Fields[f] : empty_field; },
+                writer, columns[f].Texts);
+    }
+    writer.Write(out_record.Columns, columns.data(), columns.size() * sizeof(SharedTopic::ColumnRecord));
+
+    if (!is_written)
+        std::cerr << "Publish Error! The texts of '" << topic.Name << "' topic are too large." << std::endl;
+    return is_written;
+}
+
+// Lay out a list of texts in the segment. Returns false if the texts are too large for the 32-bit offsets.
+template <typename TextFunction>
+bool SharedSequence::WriteTexts(size_t n_texts, TextFunction text, SegmentWriter &writer, SharedTopic::TextTable &out_table)
+{
+    std::vector<uint32_t> offsets(n_texts + 1, 0);
+    for (size_t i = 0; i < n_texts; ++i)
+    {
+        uint64_t end = (uint64_t)offsets[i] + text(i).size();
+        if (end > 0xFFFFFFFFull) return false;
+        offsets[i + 1] = (uint32_t)end;
+    }
+
+    out_table.Count = n_texts;
+    out_table.Offsets = writer.Append(offsets.data(), offsets.size() * sizeof(uint32_t));
+    out_table.Data = writer.Reserve(offsets.back());
+    for (size_t i = 0; i < n_texts; ++i)
+        writer.Write(out_table.Data + offsets[i], text(i).data(), text(i).size());
+    return true;
+}
+
+// Check that all the offsets and the counts of the mapped segment are inside it, so a damaged or foreign
+// file cannot make the views read outside the mapping
+bool SharedSequence::CheckSegment() const
+{
+    if (!CheckTextTable(header->Names) || !CheckArray(header->MessageIndices, header->NumberOfMessages, 2 * sizeof(int32_t)) ||
+        !CheckArray(header->Topics, header->NumberOfTopics, sizeof(SharedTopic::TopicRecord)))
+        return false;
+
+    const SharedTopic::TopicRecord *records = (const SharedTopic::TopicRecord *)(segment + header->Topics);
+    for (size_t i = 0; i < (size_t)header->NumberOfTopics; ++i)
+        if (!CheckTopicRecord(records[i])) return false;
+
+    // The message index list should only point to the messages of the topics
+    const int32_t *indices = (const int32_t *)(segment + header->MessageIndices);
+    for (size_t i = 0; i < (size_t)header->NumberOfMessages; ++i)
+        if (indices[2 * i] < 0 || (uint64_t)indices[2 * i] >= header->NumberOfTopics || indices[2 * i + 1] < 0 ||
+            (uint64_t)indices[2 * i + 1] >= records[indices[2 * i]].NumberOfMessages)
+            return false;
+    return true;
+}
+
+// Check the offsets and the counts of a topic record and its columns
+bool SharedSequence::CheckTopicRecord(const SharedTopic::TopicRecord &record) const
+{
+    uint64_t n_messages = record.NumberOfMessages;
+    if (record.NumberOfFields < 0 || record.NumberOfColumns < 0 || record.NumberOfColumns > record.NumberOfFields ||
+        record.NumberOfLenFields < 0 || n_messages > (uint64_t)std::numeric_limits<int>::max())
+        return false;
+    if (!CheckTextTable(record.Names) || !CheckTextTable(record.FieldLabels) || !CheckTextTable(record.OriginalLabels) ||
+        !CheckTextTable(record.LabelKeys) || !CheckTextTable(record.FrameIDs) ||
+        record.FieldLabels.Count != (uint64_t)record.NumberOfFields ||
+        !CheckArray(record.LabelValues, record.LabelKeys.Count, sizeof(int32_t)) ||
+        !CheckArray(record.LenFields, record.NumberOfLenFields, sizeof(int32_t)) ||
+        !CheckArray(record.Times, n_messages, sizeof(int64_t)) || !CheckArray(record.SequenceIDs, n_messages, sizeof(int32_t)) ||
+        !CheckArray(record.Stamps, n_messages, sizeof(int64_t)) ||
+        !CheckArray(record.Columns, record.NumberOfColumns, sizeof(SharedTopic::ColumnRecord)))
+        return false;
+
+    // The labels should point to the fields
+    const int32_t *label_values = (const int32_t *)(segment + record.LabelValues);
+    for (size_t i = 0; i < (size_t)record.LabelKeys.Count; ++i)
+        if (label_values[i] < 0 || label_values[i] >= record.NumberOfFields) return false;
+
+    const SharedTopic::ColumnRecord *columns = (const SharedTopic::ColumnRecord *)(segment + record.Columns);
+    for (int f = 0; f < record.NumberOfColumns; ++f)
+    {
+        if (!CheckTextTable(columns[f].Dictionary) || !CheckTextTable(columns[f].Texts)) return false;
+        if (!columns[f].HasValues) continue;
+        Topic::FieldType type = (Topic::FieldType)columns[f].Type;
+        size_t item_size = (type == Topic::Bool || type == Topic::Int64) ? sizeof(long long) :
+            (type == Topic::Float64) ? sizeof(double) : (type == Topic::Category) ? sizeof(int) : 0;
+        if (item_size == 0 || !CheckArray(columns[f].Values, n_messages, item_size)) return false;
+    }
+    return true;
+}
+
+// Check that the offsets of a text table and its texts are inside the segment
+bool SharedSequence::CheckTextTable(const SharedTopic::TextTable &table) const
+{
+    if (table.Count == 0) return true;
+    if (table.Count >= segment_size || !CheckArray(table.Offsets, table.Count + 1, sizeof(uint32_t)) || table.Data > segment_size)
+        return false;
+
+    // The text boundaries should be in order and end inside the segment
+    const uint32_t *offsets = (const uint32_t *)(segment + table.Offsets);
+    for (size_t i = 0; i < (size_t)table.Count; ++i)
+        if (offsets[i] > offsets[i + 1]) return false;
+    return offsets[table.Count] <= segment_size - table.Data;
+}
+
+// Check that an array of the given number of items starts at an aligned offset and ends inside the segment
+bool SharedSequence::CheckArray(uint64_t offset, uint64_t count, size_t item_size) const
+{
+    if (count == 0) return true;
+    return offset % std::min(item_size, (size_t)8) == 0 && offset <= segment_size && count <= (segment_size - offset) / item_size;
+}
+
+}
+#endif
@@ -0,0 +1,238 @@
+/*  ***************************************************************************
+*   threadpool.h - Header for the work-stealing thread pool used to run ALFA
+*   processing tasks in parallel.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_THREADPOOL_H
+#define ALFA_THREADPOOL_H
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace alfa
+{
+
+// This class runs tasks on a fixed number of worker threads. Each worker has its own task queue:
+// a worker takes the newest task from its own queue and, when the queue is empty, steals the oldest
+// task from the queue of another worker. This keeps all the workers busy even if the tasks have very
+// different lengths. Tasks submitted from a worker thread go to the queue of that worker.
+class ThreadPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    // Constructors & Deconstructors
+    explicit ThreadPool(int n_threads = 0);
+    ~ThreadPool();
+
+    // Member Functions
+    void Submit(const Task &task);
+    void WaitAll();
+    int GetNumberOfThreads() const;
+    size_t GetNumberOfSteals() const;
+    static bool IsWorkerThread();
+
+private:
+    // Local struct definitions
+    struct WorkerQueue                  // Structure for the task queue of a worker
+    {
+        std::mutex Mutex;
+        std::deque<Task> Tasks;
+    };
+
+    // Member Functions
+    void RunWorker(int worker_idx);
+    bool TakeTask(int worker_idx, Task &out_task);
+
+    // The pool cannot be copied while the threads are running
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+
+    // Data Members
+    std::vector<std::unique_ptr<WorkerQueue> > queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next_queue, n_steals;
+
+    // Number of tasks waiting in the queues and not finished yet (protected by state_mutex)
+    size_t n_queued = 0, n_unfinished = 0;
+    bool stop_requested = false;
+    std::mutex state_mutex;
+    std::condition_variable work_available, all_done;
+
+    // The pool and the worker index of the current thread (for submitting from the workers)
+    static thread_local ThreadPool *current_pool;
+    static thread_local int current_worker;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+thread_local ThreadPool *ThreadPool::current_pool = NULL;
+thread_local int ThreadPool::current_worker = -1;
+
+// Constructor function for ThreadPool. Uses one thread per core if the number of threads is not given.
+ThreadPool::ThreadPool(int n_threads)
+    : next_queue(0), n_steals(0)
+{
+    if (n_threads <= 0) n_threads = std::max(1, (int)std::thread::hardware_concurrency());
+
+    for (int i = 0; i < n_threads; ++i)
+        queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    for (int i = 0; i < n_threads; ++i)
+        workers.push_back(std::thread(&ThreadPool::RunWorker, this, i));
+}
+
+// Destructor function for ThreadPool. Finishes the submitted tasks and stops the workers.
+ThreadPool::~ThreadPool()
+{
+    WaitAll();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stop_requested = true;
+    }
+    work_available.notify_all();
+    for (int i = 0; i < (int)workers.size(); ++i)
+        workers[i].join();
+}
+
+// Add a task to the pool. Can be called from the tasks themselves.
+void ThreadPool::Submit(const Task &task)
+{
+    // Workers keep their own tasks, other threads spread the tasks over the queues
+    int queue_idx = (current_pool == this) ? current_worker : (int)(next_queue++ % queues.size());
+
+    // Count the task before it becomes visible to the workers
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        ++n_queued;
+        ++n_unfinished;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[queue_idx]->Mutex);
+        queues[queue_idx]->Tasks.push_back(task);
+    }
+    work_available.notify_one();
+}
+
+// Wait until all the submitted tasks (including the ones they submit) are finished.
+// Should not be called from the tasks.
+void ThreadPool::WaitAll()
+{
+    std::unique_lock<std::mutex> lock(state_mutex);
+    all_done.wait(lock, [this]() { return n_unfinished == 0; });
+}
+
+// Get the number of worker threads
+int ThreadPool::GetNumberOfThreads() const
+{
+    return (int)workers.size();
+}
+
+// Get the number of tasks that were taken from the queue of another worker
+size_t ThreadPool::GetNumberOfSteals() const
+{
+    return n_steals;
+}
+
+// Returns true if the current thread is a worker of a pool (e.g., to avoid starting more threads in the tasks)
+bool ThreadPool::IsWorkerThread()
+{
+    return current_pool != NULL;
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Take the tasks from the queues and run them until the pool is destroyed
+void ThreadPool::RunWorker(int worker_idx)
+{
+    current_pool = this;
+    current_worker = worker_idx;
+
+    Task task;
+    while (true)
+    {
+        if (TakeTask(worker_idx, task))
+        {
+            task();
+            task = Task();
+
+            std::lock_guard<std::mutex> lock(state_mutex);
+            if (--n_unfinished == 0) all_done.notify_all();
+            continue;
+        }
+
+        // Sleep until a new task is submitted
+        std::unique_lock<std::mutex> lock(state_mutex);
+        work_available.wait(lock, [this]() { return stop_requested || n_queued > 0; });
+        if (stop_requested && n_queued == 0) break;
+    }
+}
+
+// Take the newest task of the worker's own queue or steal the oldest task of another queue
+bool ThreadPool::TakeTask(int worker_idx, Task &out_task)
+{
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(queues[worker_idx]->Mutex);
+        if (!queues[worker_idx]->Tasks.empty())
+        {
+            out_task = queues[worker_idx]->Tasks.back();
+            queues[worker_idx]->Tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // Look for a victim, starting from the next worker
+    for (int i = 1; i < (int)queues.size() && !found; ++i)
+    {
+        WorkerQueue &victim = *queues[(worker_idx + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.Mutex);
+        if (!victim.Tasks.empty())
+        {
+            out_task = victim.Tasks.front();
+            victim.Tasks.pop_front();
+            n_steals.fetch_add(1, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+
+    if (found)
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        --n_queued;
+    }
+    return found;
+}
+
+}
+#endif
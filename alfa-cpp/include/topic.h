@@ -33,8 +33,17 @@
 #include <iomanip>
 #include <map>
 #include <algorithm>
+#include <limits>
+#include <set>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+#include <mutex>
 #include "commons.h"
 #include "message.h"
+#include "threadpool.h"
+#include "csvscan.h"
+#include "numparse.h"
 
 namespace alfa
 {
@@ -44,10 +53,86 @@ class Topic
 {
 public:
 
+    // Local struct definitions
+    struct ZoneMap                      // Structure for the per-block summaries of the messages
+    {
+        int BlockSize = 0;                                  // Number of messages in each block (0 if not built)
+        std::vector<long long> MinTimes, MaxTimes;          // Time range of each block (nanoseconds)
+        std::vector<std::vector<double> > MinValues;        // Smallest number in each block of each field
+        std::vector<std::vector<double> > MaxValues;        // Largest number in each block of each field
+        std::vector<std::vector<int> > Counts;              // Count of the numbers in each block of each field
+    };
+
+    struct State                        // Structure for the topic information without the messages (see ExportState)
+    {
+        std::string Name, FileName;
+        VecString FieldLabels, OriginalFieldLabels;
+        bool IsInitialized = false, IsFaultTopic = false, HasHeader = false;
+        int LenSeqID = 0, LenStamp = 0, LenFrameID = 0;     // Widths of the columns for printing
+        std::vector<int> LenFields;
+        ZoneMap ZoneMaps;
+
+        // Reading state, so a restored topic can continue to read its file
+        VecString ColumnSelection;
+        std::vector<int> ReadColumns;
+        int NumberOfFileColumns = 0, NumberOfThreads = 0, LineNumber = 0;
+        bool FollowMode = false, HasFormatError = false;
+        std::streamoff FileOffset = 0;
+    };
+
+    // Local enum definitions
+    enum FieldType                      // Types of the field values (inferred when the messages are read)
+    {
+        Bool,                           // True/False values (stored as 1 and 0)
+        Int64,                          // Integer numbers
+        Float64,                        // Real numbers (the empty values are NaN)
+        Category,                       // Text with a few distinct values (stored as dictionary codes)
+        String                          // Free text (only kept in the message fields)
+    };
+
+    enum FieldAccess                    // Which field values can be converted to an output type of GetFields
+    {
+        TextAccess,                     // The texts of all the fields
+        IntegerAccess,                  // The stored values of the Bool and Int64 fields
+        NumericAccess                   // The stored values of the Bool, Int64 and Float64 fields
+    };
+
+    // Converters of the field values to the output types of GetFields (see the specializations below the
+    // class). Other output types can be supported by adding a specialization.
+    template <typename T> struct FieldConverter;
+
+    struct Column                       // Structure for the values of a field in their native type
+    {
+        FieldType Type = Bool;
+        std::vector<long long> Integers;                    // Values of the Bool and Int64 fields
+        std::vector<int> Missing;                           // Messages with empty Bool and Int64 values (in order)
+        std::vector<double> Numbers;                        // Values of the Float64 fields
+        std::vector<int> Codes;                             // Dictionary codes of the Category fields
+        VecString Dictionary;                               // Distinct values of the Category fields
+
+        double ToDouble(int msg_index) const;
+    };
+
+    // Default number of messages summarized by each zone map block
+    static const int DefaultZoneMapBlockSize;
+
+    // Smallest size of the new data (in bytes) parsed on several threads
+    static const size_t ParallelParseMinBytes;
+
+    // Size of the data (in bytes) scanned for the delimiters at once
+    static const size_t ScanWindowBytes;
+
+    // Number of messages sampled for inferring the field types
+    static const int SchemaSampleSize;
+
+    // Largest number of distinct values of a Category field
+    static const int MaxCategorySize;
+
     // Class Data Members
     std::string Name = "N/A";
     std::string FileName;
     VecString FieldLabels;
+    std::vector<FieldType> FieldTypes;
     std::vector<Message> Messages;
 
     // Constructors & Deconstructors
@@ -55,62 +140,157 @@ public:
 
     // Member Functions
     bool ReadFromFile(const std::string &filename);
+    bool ReadFromData(const std::string &filename, const std::string &data);
+    int ReadAppendedData();
+    void SetFollowMode(bool follow);
+    bool IsFollowMode() const;
+    void SetNumberOfThreads(int n_threads);
+    void SetColumnSelection(const VecString &field_patterns);
+    const VecString &GetColumnSelection() const;
     int Print(int n_start = 0, int n_messages = -1, const std::string &field_separator = " | ") const;
     int PrintHeader(const std::string &field_separator = " | ") const;
     bool IsInitialized() const;
-    bool IsFaultTopic();
-    bool HasHeaderField();
-    int FindLabelIndex(const std::string &label);
+    bool IsFaultTopic() const;
+    bool HasHeaderField() const;
+    const VecString &GetOriginalFieldLabels() const;
+    int FindLabelIndex(const std::string &label) const;
     void Clear();
-
-    std::vector<DateTime> GetTimes(int start_msg_index = 0, int n_messages = -1);
-    std::vector<Message::HeaderType> GetHeaders(int start_msg_index = 0, int n_messages = -1);
-
-    std::vector<std::string> GetFieldsAsString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1);
-    std::vector<std::string> GetFieldsAsString(int field_index, int start_msg_index = 0, int n_messages = -1);
-
-    std::vector<int> GetFieldsAsInt(const std::string &field_label, int start_msg_index = 0, int n_messages = -1);
-    std::vector<int> GetFieldsAsInt(int field_index, int start_msg_index = 0, int n_messages = -1);
-
-    std::vector<long long> GetFieldsAsLongLong(const std::string &field_label, int start_msg_index = 0, int n_messages = -1);
-    std::vector<long long> GetFieldsAsLongLong(int field_index, int start_msg_index = 0, int n_messages = -1);
-
-    std::vector<double> GetFieldsAsDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1);
-    std::vector<double> GetFieldsAsDouble(int field_index, int start_msg_index = 0, int n_messages = -1);
-
-    std::vector<long double> GetFieldsAsLongDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1);
-    std::vector<long double> GetFieldsAsLongDouble(int field_index, int start_msg_index = 0, int n_messages = -1);
+    void Unload();
+    bool Reload();
+    State ExportState() const;
+    void ImportState(const State &state);
+    void RestoreMessages(std::vector<Message> &messages);
+    bool IsLoaded() const;
+    size_t GetMemoryFootprint() const;
+    void BuildZoneMaps(int block_size = DefaultZoneMapBlockSize);
+    bool HasZoneMaps() const;
+    const ZoneMap &GetZoneMaps() const;
+    std::vector<int> FindMessagesInTimeRange(long long start_time, long long end_time) const;
+    std::vector<int> FindMessagesInValueRange(const std::string &field_label, double min_value, double max_value) const;
+    static double FieldToDouble(const std::string &field);
+    FieldType GetFieldType(int field_index) const;
+    const Column &GetColumn(int field_index) const;
+    int GetNumberOfStoredColumns() const;
+    static std::string FieldTypeToString(FieldType type);
+
+    std::vector<DateTime> GetTimes(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<long long> GetTimesInNanoseconds(int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<Message::HeaderType> GetHeaders(int start_msg_index = 0, int n_messages = -1) const;
+
+    std::vector<std::string> GetFieldsAsString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<std::string> GetFieldsAsString(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    std::vector<int> GetFieldsAsInt(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<int> GetFieldsAsInt(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    std::vector<long long> GetFieldsAsLongLong(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<long long> GetFieldsAsLongLong(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    std::vector<double> GetFieldsAsDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<double> GetFieldsAsDouble(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    std::vector<long double> GetFieldsAsLongDouble(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<long double> GetFieldsAsLongDouble(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    std::vector<float> GetFieldsAsFloat(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    std::vector<float> GetFieldsAsFloat(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+
+    template <typename T> std::vector<T> GetFields(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const;
+    template <typename T> std::vector<T> GetFields(int field_index, int start_msg_index = 0, int n_messages = -1) const;
+    template <typename T, typename OutputIterator>
+    int CopyFields(const std::string &field_label, OutputIterator out, int start_msg_index = 0, int n_messages = -1) const;
+    template <typename T, typename OutputIterator>
+    int CopyFields(int field_index, OutputIterator out, int start_msg_index = 0, int n_messages = -1) const;
+    template <typename T> int FillFields(const std::string &field_label, T *first, T *last, int start_msg_index = 0) const;
+    template <typename T> int FillFields(int field_index, T *first, T *last, int start_msg_index = 0) const;
 
     // These functions are for the alfa-python use and are duplicates of the ones above
-    std::vector<std::string> GetFieldsAsStringByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1)
+    std::vector<std::string> GetFieldsAsStringByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsString(field_label, start_msg_index, n_messages); }
-    std::vector<std::string> GetFieldsAsStringByIndex(int field_index, int start_msg_index = 0, int n_messages = -1)
+    std::vector<std::string> GetFieldsAsStringByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsString(field_index, start_msg_index, n_messages); }
 
-    std::vector<int> GetFieldsAsIntByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1)
+    std::vector<int> GetFieldsAsIntByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsInt(field_label, start_msg_index, n_messages); }
-    std::vector<int> GetFieldsAsIntByIndex(int field_index, int start_msg_index = 0, int n_messages = -1)
+    std::vector<int> GetFieldsAsIntByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsInt(field_index, start_msg_index, n_messages); }
 
-    std::vector<long long> GetFieldsAsLongLongByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1)
+    std::vector<long long> GetFieldsAsLongLongByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsLongLong(field_label, start_msg_index, n_messages); }
-    std::vector<long long> GetFieldsAsLongLongByIndex(int field_index, int start_msg_index = 0, int n_messages = -1)
+    std::vector<long long> GetFieldsAsLongLongByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsLongLong(field_index, start_msg_index, n_messages); }
 
-    std::vector<double> GetFieldsAsDoubleByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1)
+    std::vector<double> GetFieldsAsDoubleByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsDouble(field_label, start_msg_index, n_messages); }
-    std::vector<double> GetFieldsAsDoubleByIndex(int field_index, int start_msg_index = 0, int n_messages = -1)
+    std::vector<double> GetFieldsAsDoubleByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsDouble(field_index, start_msg_index, n_messages); }
 
-    std::vector<long double> GetFieldsAsLongDoubleByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1)
+    std::vector<long double> GetFieldsAsLongDoubleByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsLongDouble(field_label, start_msg_index, n_messages); }
-    std::vector<long double> GetFieldsAsLongDoubleByIndex(int field_index, int start_msg_index = 0, int n_messages = -1)
+    std::vector<long double> GetFieldsAsLongDoubleByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
     { return GetFieldsAsLongDouble(field_index, start_msg_index, n_messages); }
 
+    std::vector<float> GetFieldsAsFloatByString(const std::string &field_label, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsFloat(field_label, start_msg_index, n_messages); }
+    std::vector<float> GetFieldsAsFloatByIndex(int field_index, int start_msg_index = 0, int n_messages = -1) const
+    { return GetFieldsAsFloat(field_index, start_msg_index, n_messages); }
+
 private:
+    // Shared topics restore the private members on copying
+    friend class SharedTopic;
+    friend class SharedSequence;
+
+    // Local struct definitions
+    struct ParsedChunk                  // Structure for the messages parsed from a chunk of the file
+    {
+        std::vector<Message> Messages;
+        size_t End = 0;                 // Position after the last parsed line
+        int NumberOfLines = 0;          // Number of parsed lines (including the line with too many fields)
+        bool HasFormatError = false;    // Did the last line have too many fields
+        int LenSeqID = 0, LenStamp = 0, LenFrameID = 0;
+        std::vector<int> LenFields;     // Maximum length of the fields (for better printing)
+    };
+
+    struct ColumnLock                   // Structure for the lock of the typed values (a copy has its own lock)
+    {
+        std::mutex Mutex;
+        ColumnLock() {}
+        ColumnLock(const ColumnLock &) {}
+        ColumnLock &operator=(const ColumnLock &) { return *this; }
+    };
+
     // Member Functions
-    Message TokensToMessage(const VecString &tokens);
+    bool Initialize(const std::string &filename, const std::string *data);
+    int ParseData(const std::string &buffer);
+    void ParseLines(const std::string &buffer, size_t start, size_t end, ParsedChunk &out_chunk) const;
+    Message TokensToMessage(const VecString &tokens, ParsedChunk &chunk) const;
+    void SelectColumns(const VecString &file_labels);
+    int TokenizeLine(const char *data, size_t line_start, size_t line_end, const uint32_t *delimiters,
+        size_t n_delimiters, VecString &out_tokens) const;
     void ProcessHeader();
+    void UpdateZoneMaps(int first_msg_index);
+    void InferFieldTypes();
+    void UpdateColumns(int first_msg_index);
+    void PromoteColumn(int field_index, FieldType type, int n_values);
+    const Column &StoreColumnValues(int field_index) const;
+    void AppendColumnValues(Column &column, int field_index, int first_msg_index) const;
+    const Column *FindStoredColumn(int field_index) const;
+    double GetNumber(const Column *column, int field_index, int msg_index) const;
+    bool CheckNumericField(int field_index, bool integer_only, const std::string &function_name) const;
+    static FieldType ClassifyField(const std::string &field, long long &integer, double &number);
+    int FindFieldIndex(const std::string &field_label, const std::string &function_name) const;
+    template <typename T, typename OutputIterator>
+    int CopyFieldValues(int field_index, int start_msg_index, int n_messages, OutputIterator out,
+        const std::string &function_name) const;
+    template <typename T, typename OutputIterator>
+    void ConvertFieldValues(int field_index, int start, int end, OutputIterator &out,
+        std::integral_constant<FieldAccess, TextAccess>) const;
+    template <typename T, typename OutputIterator>
+    void ConvertFieldValues(int field_index, int start, int end, OutputIterator &out,
+        std::integral_constant<FieldAccess, IntegerAccess>) const;
+    template <typename T, typename OutputIterator>
+    void ConvertFieldValues(int field_index, int start, int end, OutputIterator &out,
+        std::integral_constant<FieldAccess, NumericAccess>) const;
 
     // Data Members
 
@@ -127,21 +307,121 @@ private:
     int len_seqid = 0, len_stamp = 0, len_frameid = 0;
     std::vector<int> len_fields;
 
-    // Pre-processed field labels from the CSV file
+    // Pre-processed field labels from the CSV file (only the columns that are read)
     VecString orig_field_labels;
 
-    // Header strings for printing
-    const std::string hdr_ind = "Index", hdr_datetime = "Date/Time Stamp";
-    const std::string hdr_seq = "SeqID", hdr_stamp = "Time Stamp", hdr_frid = "Frame";
+    // The fields to read (labels or glob patterns, all if empty), the indices of the columns that
+    // are read and the number of columns in the file
+    VecString column_selection;
+    std::vector<int> read_columns;
+    int n_file_columns = 0;
+
+    // Header strings for printing (static, so the topics can be assigned)
+    static const std::string hdr_ind, hdr_datetime;
+    static const std::string hdr_seq, hdr_stamp, hdr_frid;
 
     // Keep if the topic has header field
     bool has_header = false;
+
+    // Follow mode keeps the incomplete last line of the file for the next read
+    bool follow_mode = false;
+
+    // Number of threads for parsing large files (0 for one per core)
+    int n_threads = 0;
+
+    // Number of bytes and lines of the file already processed
+    std::streamoff file_offset = 0;
+    int line_number = 0;
+
+    // Stop reading the file after a line with too many fields
+    bool has_format_error = false;
+
+    // Optional block summaries for skipping the messages in the queries
+    ZoneMap zone_maps;
+
+    // Types of the fields (see FieldTypes) and their values in these types. The values of a field are only
+    // stored on the first typed access, so the fields that are only read as text are not kept twice.
+    mutable std::vector<Column> columns;
+    mutable std::vector<char> is_column_stored;
+    mutable ColumnLock column_lock;
+
+    // Are the messages freed to save memory (see Unload)
+    bool is_unloaded = false;
 };
 
 /******************************************************************************/
 /************************** Function Definitions ******************************/
 /******************************************************************************/
 
+// Convert the fields to texts
+template <> struct Topic::FieldConverter<std::string>
+{
+    static const FieldAccess Access = TextAccess;
+    static const std::string &FromText(const std::string &field) { return field; }
+};
+
+// Convert the fields to integers
+template <> struct Topic::FieldConverter<int>
+{
+    static const FieldAccess Access = IntegerAccess;
+    static int FromInteger(long long value) { return (int)value; }
+};
+
+// Convert the fields to long long integers
+template <> struct Topic::FieldConverter<long long>
+{
+    static const FieldAccess Access = IntegerAccess;
+    static long long FromInteger(long long value) { return value; }
+};
+
+// Convert the fields to single precision numbers
+template <> struct Topic::FieldConverter<float>
+{
+    static const FieldAccess Access = NumericAccess;
+    static float FromInteger(long long value) { return (float)value; }
+    static float FromReal(double number, const std::string &) { return (float)number; }
+};
+
+// Convert the fields to double precision numbers
+template <> struct Topic::FieldConverter<double>
+{
+    static const FieldAccess Access = NumericAccess;
+    static double FromInteger(long long value) { return (double)value; }
+    static double FromReal(double number, const std::string &) { return number; }
+};
+
+// Convert the fields to long double numbers (the real numbers are parsed again for the extra precision)
+template <> struct Topic::FieldConverter<long double>
+{
+    static const FieldAccess Access = NumericAccess;
+    static long double FromInteger(long long value) { return (long double)value; }
+    static long double FromReal(double, const std::string &field)
+    {
+        long double value = std::numeric_limits<long double>::quiet_NaN();
+        if (!field.empty()) Commons::StringToLongDouble(field, value);
+        return value;
+    }
+};
+
+// Blocks of 4096 messages are small enough to skip most of a selective query and cost little memory
+const int Topic::DefaultZoneMapBlockSize = 4096;
+
+// Below a few megabytes the threads cost more than they save
+const size_t Topic::ParallelParseMinBytes = 4 << 20;
+
+// The positions of a megabyte of data fit in the cache and are read right after they are found
+const size_t Topic::ScanWindowBytes = 1 << 20;
+
+// A thousand evenly spaced messages find the type of almost every field; the rest are promoted on conflict
+const int Topic::SchemaSampleSize = 1024;
+
+// Fields with more distinct values are kept as free text
+const int Topic::MaxCategorySize = 256;
+
+// Header strings for printing
+const std::string Topic::hdr_ind = "Index", Topic::hdr_datetime = "Date/Time Stamp";
+const std::string Topic::hdr_seq = "SeqID", Topic::hdr_stamp = "Time Stamp", Topic::hdr_frid = "Frame";
+
 // Contructor function for Topic. Loads a CSV file containing an ALFA dataset topic.
 Topic::Topic(const std::string &filename, const std::string &topic_name)
 {
@@ -156,72 +436,87 @@ Topic::Topic(const std::string &filename, const std::string &topic_name)
 // Load a CSV file containing an ALFA dataset topic.
 bool Topic::ReadFromFile(const std::string &filename)
 {
-    // Keep the topic name
-    std::string topic_name = Name;
+    return Initialize(filename, NULL);
+}
 
-    // Clear the previous data from the object
-    this->Clear();
+// Load an ALFA dataset topic from the contents of its CSV file that are already read (e.g., by a
+// FileIngestor). The filename is kept for the messages and for reloading the topic.
+bool Topic::ReadFromData(const std::string &filename, const std::string &data)
+{
+    return Initialize(filename, &data);
+}
 
-    // Save the filename and topic name
-    this->FileName = filename;
-    this->Name = topic_name;
+// Read the lines added to the CSV file since the last read. In the follow mode, the last line is
+// left for the next read until it is complete, so the file can still be written by another process.
+// Returns the number of new messages, or -1 if the file cannot be read.
+int Topic::ReadAppendedData()
+{
+    // Stop reading if the file was not formatted properly
+    if (has_format_error) return 0;
 
     // Open the CSV file
-    std::ifstream ifs (filename);
+    std::ifstream ifs (FileName, std::ios::binary);
 
     // Print an error if file did not open properly
     if (!ifs.is_open())
     {
-        std::cerr << "Failed to open '" << filename << "' file." << std::endl;
-        return false;
+        std::cerr << "Failed to open '" << FileName << "' file." << std::endl;
+        return -1;
     }
 
-    // Read the header line from the CSV file
-    std::string line;
-    if (std::getline(ifs, line))
-        this->orig_field_labels = Commons::Tokenize(line, Commons::CSVDelimiter);
-    else // Print an error if the file is not formatted properly
+    // Find the size of the new data
+    ifs.seekg(0, std::ios::end);
+    std::streamoff file_size = ifs.tellg();
+    if (file_size < file_offset)
     {
-        std::cerr << "Error reading the header from '" << filename << "' file." << std::endl;
-        return false;
+        std::cerr << "File '" << FileName << "' is shorter than the data already read." << std::endl;
+        return -1;
     }
 
-    // Read the data from the CSV file
-    int line_number = 0;
-    while (std::getline(ifs, line))
+    // Read the new data at once
+    std::string buffer((size_t)(file_size - file_offset), '\0');
+    ifs.seekg(file_offset);
+    if (!buffer.empty() && !ifs.read(&buffer[0], buffer.size()))
     {
-        line_number++;
-
-        // Break the line to tokens
-        auto tokens = Commons::Tokenize(line, Commons::CSVDelimiter);
-
-        // Add empty tokens if the line did not include all the fields
-        while (tokens.size() < this->orig_field_labels.size())
-            tokens.push_back("");
+        std::cerr << "Failed to read '" << FileName << "' file." << std::endl;
+        return -1;
+    }
 
-        // Print an error and stop operation if file is not formatted properly
-        if (tokens.size() > this->orig_field_labels.size())
-        {
-            std::cerr << "Error converting line #" << line_number << " of '" << filename << "'. Skipping this topic!" << std::endl;
-            break;
-        }
+    return ParseData(buffer);
+}
 
-        // Convert the tokens to a message and add to our collection
-        this->Messages.push_back(TokensToMessage(tokens));
-    }
+// Set the follow mode for reading the files that are still being written
+void Topic::SetFollowMode(bool follow)
+{
+    follow_mode = follow;
+}
 
-    // Postprocess the header labels
-    ProcessHeader();
+// Returns true if the topic is in the follow mode
+bool Topic::IsFollowMode() const
+{
+    return follow_mode;
+}
 
-    // It is not a fault topic if the topic name is shorter than the fault prefix
-    if (this->Name.length() >= Commons::FaultTopicPrefix.length()) 
-        // Check if the prefix of topic name is the fault prefix
-        is_fault_topic = (this->Name.substr(0, Commons::FaultTopicPrefix.length()) == Commons::FaultTopicPrefix);
+// Set the number of threads for parsing the files (0 for one per core, the default). The data is split at
+// the line boundaries and only the data larger than ParallelParseMinBytes is parsed in parallel.
+void Topic::SetNumberOfThreads(int n_threads)
+{
+    this->n_threads = n_threads;
+}
 
-    // Initialization done
-    is_initialized = true;
+// Set the fields to read from the file, as field labels or glob patterns (e.g., 'orientation.*'). The other
+// columns are skipped without being stored, which saves the time and memory of the fields that are not used.
+// The time and the header columns are always read. An empty list reads all the fields (the default).
+// Should be called before reading the file.
+void Topic::SetColumnSelection(const VecString &field_patterns)
+{
+    column_selection = field_patterns;
+}
 
-    return IsInitialized();
+// Get the fields selected to be read from the file (all the fields if empty)
+const VecString &Topic::GetColumnSelection() const
+{
+    return column_selection;
 }
 
 // Print a specified number of messages. Also prints the header first. 
@@ -299,12 +594,12 @@ bool Topic::IsInitialized() const
 }
 
 // Returns true if the current topic is a fault topic
-bool Topic::IsFaultTopic()
+bool Topic::IsFaultTopic() const
 {
     return is_fault_topic;
 }
 
-bool Topic::HasHeaderField()
+bool Topic::HasHeaderField() const
 {
     return has_header;
 }
@@ -315,6 +610,7 @@ void Topic::Clear()
     Name = "";
     FileName = "";
     FieldLabels.clear();
+    FieldTypes.clear();
     Messages.clear();
     is_initialized = false;
     is_fault_topic = false;
@@ -323,14 +619,331 @@ void Topic::Clear()
     len_frameid = 0;
     len_fields.clear();
     orig_field_labels.clear();
+    column_selection.clear();
+    read_columns.clear();
+    n_file_columns = 0;
     has_header = false;
     labels_map.clear();
+    follow_mode = false;
+    file_offset = 0;
+    line_number = 0;
+    has_format_error = false;
+    zone_maps = ZoneMap();
+    columns.clear();
+    is_column_stored.clear();
+    is_unloaded = false;
+}
+
+// Free the messages of the topic to save memory. The topic information (name, file, labels, field types,
+// zone maps, etc.) is kept, so the messages can be read again from the file with Reload.
+void Topic::Unload()
+{
+    std::vector<Message>().swap(Messages);
+    std::vector<Column>().swap(columns);
+    std::vector<char>().swap(is_column_stored);
+    is_unloaded = true;
+}
+
+// Read the messages of an unloaded topic again from its file. If the file cannot be read, the topic
+// stays unloaded with its information.
+bool Topic::Reload()
+{
+    // Copy the topic information (it has no messages), since reading the file clears the topic first
+    Topic unloaded = *this;
+    if (!ReadFromFile(unloaded.FileName))
+    {
+        *this = unloaded;
+        std::cerr << "Reload Error! Failed to read the messages of '" << Name << "' topic again." << std::endl;
+        return false;
+    }
+    if (unloaded.zone_maps.BlockSize > 0) BuildZoneMaps(unloaded.zone_maps.BlockSize);
+    return true;
+}
+
+// Get the information of the topic without its messages (e.g., to keep it with a compressed copy of the
+// messages). The typed values of the fields are not included; they are stored again with the messages.
+Topic::State Topic::ExportState() const
+{
+    State state;
+    state.Name = Name;
+    state.FileName = FileName;
+    state.FieldLabels = FieldLabels;
+    state.OriginalFieldLabels = orig_field_labels;
+    state.IsInitialized = is_initialized;
+    state.IsFaultTopic = is_fault_topic;
+    state.HasHeader = has_header;
+    state.LenSeqID = len_seqid;
+    state.LenStamp = len_stamp;
+    state.LenFrameID = len_frameid;
+    state.LenFields = len_fields;
+    state.ZoneMaps = zone_maps;
+    state.ColumnSelection = column_selection;
+    state.ReadColumns = read_columns;
+    state.NumberOfFileColumns = n_file_columns;
+    state.NumberOfThreads = n_threads;
+    state.LineNumber = line_number;
+    state.FollowMode = follow_mode;
+    state.HasFormatError = has_format_error;
+    state.FileOffset = file_offset;
+    return state;
+}
+
+// Restore the information of a topic exported with ExportState. The messages are not changed; they are
+// given back with RestoreMessages.
+void Topic::ImportState(const State &state)
+{
+    Name = state.Name;
+    FileName = state.FileName;
+    FieldLabels = state.FieldLabels;
+    labels_map.clear();
+    for (int i = 0; i < (int)FieldLabels.size(); ++i)
+        labels_map.insert(std::make_pair(FieldLabels[i], i));
+    orig_field_labels = state.OriginalFieldLabels;
+    is_initialized = state.IsInitialized;
+    is_fault_topic = state.IsFaultTopic;
+    has_header = state.HasHeader;
+    len_seqid = state.LenSeqID;
+    len_stamp = state.LenStamp;
+    len_frameid = state.LenFrameID;
+    len_fields = state.LenFields;
+    zone_maps = state.ZoneMaps;
+    column_selection = state.ColumnSelection;
+    read_columns = state.ReadColumns;
+    n_file_columns = state.NumberOfFileColumns;
+    n_threads = state.NumberOfThreads;
+    line_number = state.LineNumber;
+    follow_mode = state.FollowMode;
+    has_format_error = state.HasFormatError;
+    file_offset = state.FileOffset;
+}
+
+// Give the messages back to an unloaded topic (e.g., from a compressed copy). The given vector is emptied.
+void Topic::RestoreMessages(std::vector<Message> &messages)
+{
+    Messages.swap(messages);
+    std::vector<Message>().swap(messages);
+    is_unloaded = false;
+
+    // Infer the field types again
+    columns.clear();
+    is_column_stored.clear();
+    UpdateColumns(0);
+}
+
+// Returns false if the messages of the topic are unloaded
+bool Topic::IsLoaded() const
+{
+    return !is_unloaded;
+}
+
+// Estimate the number of bytes used by the topic in memory, including the heap-allocated message data
+size_t Topic::GetMemoryFootprint() const
+{
+    // Heap bytes used by a string (short strings are stored inline in the object)
+    auto heap_size = [](const std::string &str) -> size_t { return str.capacity() > 15 ? str.capacity() + 1 : 0; };
+
+    size_t total = sizeof(Topic) + Messages.capacity() * sizeof(Message);
+    for (int i = 0; i < (int)Messages.size(); ++i)
+    {
+        total += heap_size(Messages[i].Header.FrameID);
+        total += Messages[i].Fields.capacity() * sizeof(std::string);
+        for (int j = 0; j < (int)Messages[i].Fields.size(); ++j)
+            total += heap_size(Messages[i].Fields[j]);
+    }
+
+    // Add the zone maps
+    total += (zone_maps.MinTimes.capacity() + zone_maps.MaxTimes.capacity()) * sizeof(long long);
+    for (int i = 0; i < (int)zone_maps.Counts.size(); ++i)
+        total += (zone_maps.MinValues[i].capacity() + zone_maps.MaxValues[i].capacity()) * sizeof(double)
+            + zone_maps.Counts[i].capacity() * sizeof(int);
+
+    // Add the typed field values
+    total += columns.capacity() * sizeof(Column);
+    for (int i = 0; i < (int)columns.size(); ++i)
+    {
+        total += columns[i].Integers.capacity() * sizeof(long long) + columns[i].Numbers.capacity() * sizeof(double)
+            + (columns[i].Codes.capacity() + columns[i].Missing.capacity()) * sizeof(int) + columns[i].Dictionary.capacity() * sizeof(std::string);
+        for (int j = 0; j < (int)columns[i].Dictionary.size(); ++j)
+            total += heap_size(columns[i].Dictionary[j]);
+    }
+    return total;
+}
+
+// Build the min/max/count summaries of the times and the numeric fields for each block of messages.
+// The summaries let the queries skip the blocks that cannot match. A block size of 0 removes them.
+void Topic::BuildZoneMaps(int block_size)
+{
+    zone_maps = ZoneMap();
+    if (block_size <= 0) return;
+
+    zone_maps.BlockSize = block_size;
+    zone_maps.MinValues.resize(FieldLabels.size());
+    zone_maps.MaxValues.resize(FieldLabels.size());
+    zone_maps.Counts.resize(FieldLabels.size());
+    UpdateZoneMaps(0);
+}
+
+// Returns true if the zone maps are built
+bool Topic::HasZoneMaps() const
+{
+    return zone_maps.BlockSize > 0;
+}
+
+// Get the zone maps of the topic (the block size is 0 if they are not built)
+const Topic::ZoneMap &Topic::GetZoneMaps() const
+{
+    return zone_maps;
+}
+
+// Find the indices of the messages with the recorded time (nanoseconds) in the given range (both ends
+// included). The blocks outside the range are skipped if the zone maps are built.
+std::vector<int> Topic::FindMessagesInTimeRange(long long start_time, long long end_time) const
+{
+    std::vector<int> indices;
+    int n_messages = (int)Messages.size();
+    int block_size = HasZoneMaps() ? zone_maps.BlockSize : n_messages;
+
+    for (int b = 0, start = 0; start < n_messages; ++b, start += block_size)
+    {
+        int end = std::min(start + block_size, n_messages);
+        if (HasZoneMaps())
+        {
+            // Skip the blocks outside the range and take the blocks inside it
+            if (zone_maps.MaxTimes[b] < start_time || zone_maps.MinTimes[b] > end_time) continue;
+            if (zone_maps.MinTimes[b] >= start_time && zone_maps.MaxTimes[b] <= end_time)
+            {
+                for (int i = start; i < end; ++i) indices.push_back(i);
+                continue;
+            }
+        }
+
+        for (int i = start; i < end; ++i)
+        {
+            long long time = Messages[i].DateTime.ToNanoseconds();
+            if (time >= start_time && time <= end_time) indices.push_back(i);
+        }
+    }
+
+    return indices;
+}
+
+// Find the indices of the messages with a field value in the given range (both ends included). The
+// values that are not numbers never match. The blocks outside the range are skipped if the zone maps are built.
+std::vector<int> Topic::FindMessagesInValueRange(const std::string &field_label, double min_value, double max_value) const
+{
+    std::vector<int> indices;
+
+    // Find the field index
+    int field_index = FindLabelIndex(field_label);
+
+    // Print error if the field name is not found
+    if (field_index < 0)
+    {
+        std::cerr << "FindMessagesInValueRange Error! '" << field_label << "' field not found." << std::endl;
+        return indices;
+    }
+
+    const Column *column = FindStoredColumn(field_index);
+    int n_messages = (int)Messages.size();
+    int block_size = HasZoneMaps() ? zone_maps.BlockSize : n_messages;
+    for (int b = 0, start = 0; start < n_messages; ++b, start += block_size)
+    {
+        int end = std::min(start + block_size, n_messages);
+        if (HasZoneMaps())
+        {
+            // Skip the blocks without numbers in the range and take the blocks with only such numbers
+            const double block_min = zone_maps.MinValues[field_index][b], block_max = zone_maps.MaxValues[field_index][b];
+            if (zone_maps.Counts[field_index][b] == 0 || block_max < min_value || block_min > max_value) continue;
+            if (zone_maps.Counts[field_index][b] == end - start && block_min >= min_value && block_max <= max_value)
+            {
+                for (int i = start; i < end; ++i) indices.push_back(i);
+                continue;
+            }
+        }
+
+        for (int i = start; i < end; ++i)
+        {
+            double value = GetNumber(column, field_index, i);
+            if (value >= min_value && value <= max_value) indices.push_back(i);
+        }
+    }
+
+    return indices;
+}
+
+// Convert a field to a number in the same way as the stored values of the fields (see ClassifyField), so
+// a value is the same with or without the typed access. The boolean fields (e.g., of the fault topics) are
+// 1 and 0, and the empty fields and the fields that are not numbers are NaN.
+double Topic::FieldToDouble(const std::string &field)
+{
+    long long integer = 0;
+    double number = 0;
+    if (ClassifyField(field, integer, number) == String) return std::numeric_limits<double>::quiet_NaN();
+    return number;
+}
+
+// Get the inferred type of a field. Free text is assumed before the first messages are read.
+Topic::FieldType Topic::GetFieldType(int field_index) const
+{
+    if (field_index < 0 || field_index >= (int)FieldTypes.size()) return String;
+    return FieldTypes[field_index];
+}
+
+// Get the values of a field in their inferred type. The values of the Bool and Int64 fields are in
+// Integers (0 for the empty values, which are listed in Missing), the Float64 fields in Numbers and the
+// Category fields in Codes (indices to the Dictionary). The String fields (and the unloaded topics) have
+// no stored values. The values are stored on the first call. Column::ToDouble gets a value as a number.
+const Topic::Column &Topic::GetColumn(int field_index) const
+{
+    static const Column empty_column;
+    if (field_index < 0 || field_index >= (int)columns.size())
+    {
+        std::cerr << "GetColumn Error! Field index is out of range." << std::endl;
+        return empty_column;
+    }
+    return StoreColumnValues(field_index);
+}
+
+// Get the number of fields whose typed values are stored (the typed access adds to the memory footprint)
+int Topic::GetNumberOfStoredColumns() const
+{
+    std::lock_guard<std::mutex> lock(column_lock.Mutex);
+    return (int)std::count(is_column_stored.begin(), is_column_stored.end(), 1);
+}
+
+// Get a stored value of a Bool, Int64 or Float64 field as a number (NaN for the empty values)
+double Topic::Column::ToDouble(int msg_index) const
+{
+    if (Type == Float64) return Numbers[msg_index];
+    if (!Missing.empty() && std::binary_search(Missing.begin(), Missing.end(), msg_index))
+        return std::numeric_limits<double>::quiet_NaN();
+    return (double)Integers[msg_index];
+}
+
+// Get the name of a field type
+std::string Topic::FieldTypeToString(FieldType type)
+{
+    switch (type)
+    {
+        case Bool: return "bool";
+        case Int64: return "int64";
+        case Float64: return "float64";
+        case Category: return "category";
+        default: return "string";
+    }
+}
+
+// Get the column labels as they are in the CSV file (including the time and the header columns). Only the
+// columns that are read are included (see SetColumnSelection).
+const VecString &Topic::GetOriginalFieldLabels() const
+{
+    return orig_field_labels;
 }
 
 // Find the index of a given field label (case sensitive)
-int Topic::FindLabelIndex(const std::string &label)
+int Topic::FindLabelIndex(const std::string &label) const
 {
-    std::map<std::string, int>::iterator it = labels_map.find(label);
+    std::map<std::string, int>::const_iterator it = labels_map.find(label);
 
     // Return -1 if not found
     if (it == labels_map.end()) return -1;
@@ -339,7 +952,7 @@ int Topic::FindLabelIndex(const std::string &label)
 }
 
 // Retrieve the DateTime of a desired number of messages starting from the desired index
-std::vector<DateTime> Topic::GetTimes(int start_msg_index, int n_messages)
+std::vector<DateTime> Topic::GetTimes(int start_msg_index, int n_messages) const
 {
     // Initialize the output
     std::vector<DateTime> vec_output;
@@ -358,11 +971,12 @@ std::vector<DateTime> Topic::GetTimes(int start_msg_index, int n_messages)
     return vec_output;
 }
 
-// Retrieve the Header of a desired number of messages starting from the desired index
-std::vector<Message::HeaderType> Topic::GetHeaders(int start_msg_index, int n_messages)
+// Retrieve the recorded times (nanoseconds, see DateTime::ToNanoseconds) of a desired number of messages
+// starting from the desired index
+std::vector<long long> Topic::GetTimesInNanoseconds(int start_msg_index, int n_messages) const
 {
     // Initialize the output
-    std::vector<Message::HeaderType> vec_output;
+    std::vector<long long> vec_output;
 
     // Return if the start index is negative
     if (start_msg_index < 0) return vec_output;
@@ -371,297 +985,888 @@ std::vector<Message::HeaderType> Topic::GetHeaders(int start_msg_index, int n_me
     if (n_messages < 0)
         n_messages = Messages.size();
 
-    // Add the headers to the output vector
+    // Add the times to the output vector
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
-        vec_output.push_back(Messages[i].Header);
+        vec_output.push_back(Messages[i].DateTime.ToNanoseconds());
 
     return vec_output;
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<std::string> Topic::GetFieldsAsString(int field_index, int start_msg_index, int n_messages)
+// Retrieve the Header of a desired number of messages starting from the desired index
+std::vector<Message::HeaderType> Topic::GetHeaders(int start_msg_index, int n_messages) const
 {
     // Initialize the output
-    std::vector<std::string> vec_output;
-
-    // Print error if the field index is negative
-    if (field_index < 0)
-    {
-        std::cerr << "GetFieldsAsString Error! Field index is negative." << std::endl;
-        return vec_output;
-    }
+    std::vector<Message::HeaderType> vec_output;
 
-    // Print error if the start index is negative
-    if (start_msg_index < 0)
-    {
-        std::cerr << "GetFieldsAsString Error! Starting index is negative." << std::endl;
-        return vec_output;
-    }
+    // Return if the start index is negative
+    if (start_msg_index < 0) return vec_output;
 
     // If the number of messages is negative, use all the messages
     if (n_messages < 0)
         n_messages = Messages.size();
 
-    // Add the fields to the output vector
+    // Add the headers to the output vector
     for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
-        vec_output.push_back(Messages[i].Fields[field_index]);
+        vec_output.push_back(Messages[i].Header);
 
     return vec_output;
 }
 
 // Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<std::string> Topic::GetFieldsAsString(const std::string &field_label, int start_msg_index, int n_messages)
+std::vector<std::string> Topic::GetFieldsAsString(int field_index, int start_msg_index, int n_messages) const
 {
-    // Find the field index
-    int field_index = FindLabelIndex(field_label);
-
-    // Print error if the field name is not found
-    if (field_index < 0)
-    {
-        std::cerr << "GetFieldsAsString Error! '" << field_label << "' field not found." << std::endl;
-        return std::vector<std::string>();
-    }
+    std::vector<std::string> vec_output;
+    CopyFieldValues<std::string>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFieldsAsString");
+    return vec_output;
+}
 
-    // Return the desired output
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<std::string> Topic::GetFieldsAsString(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsString");
+    if (field_index < 0) return std::vector<std::string>();
     return GetFieldsAsString(field_index, start_msg_index, n_messages);
 }
 
 // Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<int> Topic::GetFieldsAsInt(int field_index, int start_msg_index, int n_messages)
+std::vector<int> Topic::GetFieldsAsInt(int field_index, int start_msg_index, int n_messages) const
 {
-    // Initialize the output
     std::vector<int> vec_output;
+    CopyFieldValues<int>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFieldsAsInt");
+    return vec_output;
+}
 
-    // Print error if the field index is negative
-    if (field_index < 0)
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<int> Topic::GetFieldsAsInt(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsInt");
+    if (field_index < 0) return std::vector<int>();
+    return GetFieldsAsInt(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<long long> Topic::GetFieldsAsLongLong(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<long long> vec_output;
+    CopyFieldValues<long long>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFieldsAsLongLong");
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<long long> Topic::GetFieldsAsLongLong(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsLongLong");
+    if (field_index < 0) return std::vector<long long>();
+    return GetFieldsAsLongLong(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<double> Topic::GetFieldsAsDouble(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<double> vec_output;
+    CopyFieldValues<double>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFieldsAsDouble");
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<double> Topic::GetFieldsAsDouble(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsDouble");
+    if (field_index < 0) return std::vector<double>();
+    return GetFieldsAsDouble(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index (the real numbers
+// are parsed again for the extra precision)
+std::vector<long double> Topic::GetFieldsAsLongDouble(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<long double> vec_output;
+    CopyFieldValues<long double>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFieldsAsLongDouble");
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index
+std::vector<long double> Topic::GetFieldsAsLongDouble(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsLongDouble");
+    if (field_index < 0) return std::vector<long double>();
+    return GetFieldsAsLongDouble(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index as single precision
+// numbers (e.g., for the machine learning tools)
+std::vector<float> Topic::GetFieldsAsFloat(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<float> vec_output;
+    CopyFieldValues<float>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFieldsAsFloat");
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index as single precision numbers
+std::vector<float> Topic::GetFieldsAsFloat(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFieldsAsFloat");
+    if (field_index < 0) return std::vector<float>();
+    return GetFieldsAsFloat(field_index, start_msg_index, n_messages);
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index, converted to the
+// given type (std::string, int, long long, float, double, long double or a type with a FieldConverter)
+template <typename T>
+std::vector<T> Topic::GetFields(int field_index, int start_msg_index, int n_messages) const
+{
+    std::vector<T> vec_output;
+    if (start_msg_index >= 0 && start_msg_index < (int)Messages.size())
+        vec_output.reserve(n_messages < 0 ? Messages.size() - start_msg_index
+            : std::min((size_t)n_messages, Messages.size() - start_msg_index));
+    CopyFieldValues<T>(field_index, start_msg_index, n_messages, std::back_inserter(vec_output), "GetFields");
+    return vec_output;
+}
+
+// Retrieve the fields of a desired number of messages starting from the desired index, converted to the given type
+template <typename T>
+std::vector<T> Topic::GetFields(const std::string &field_label, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "GetFields");
+    if (field_index < 0) return std::vector<T>();
+    return GetFields<T>(field_index, start_msg_index, n_messages);
+}
+
+// Write the fields of a desired number of messages starting from the desired index to an output iterator,
+// converted to the given type. Returns the number of values written, or -1 on errors.
+template <typename T, typename OutputIterator>
+int Topic::CopyFields(int field_index, OutputIterator out, int start_msg_index, int n_messages) const
+{
+    return CopyFieldValues<T>(field_index, start_msg_index, n_messages, out, "CopyFields");
+}
+
+// Write the fields of a desired number of messages starting from the desired index to an output iterator
+template <typename T, typename OutputIterator>
+int Topic::CopyFields(const std::string &field_label, OutputIterator out, int start_msg_index, int n_messages) const
+{
+    int field_index = FindFieldIndex(field_label, "CopyFields");
+    if (field_index < 0) return -1;
+    return CopyFieldValues<T>(field_index, start_msg_index, n_messages, out, "CopyFields");
+}
+
+// Fill a buffer with the fields of the messages starting from the desired index (until the buffer or the
+// messages end), without any allocations. Returns the number of values written, or -1 on errors.
+template <typename T>
+int Topic::FillFields(int field_index, T *first, T *last, int start_msg_index) const
+{
+    return CopyFieldValues<T>(field_index, start_msg_index, (int)(last - first), first, "FillFields");
+}
+
+// Fill a buffer with the fields of the messages starting from the desired index
+template <typename T>
+int Topic::FillFields(const std::string &field_label, T *first, T *last, int start_msg_index) const
+{
+    int field_index = FindFieldIndex(field_label, "FillFields");
+    if (field_index < 0) return -1;
+    return CopyFieldValues<T>(field_index, start_msg_index, (int)(last - first), first, "FillFields");
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Clear the topic and load it from its CSV file, or from the given contents of the file if they are not NULL
+bool Topic::Initialize(const std::string &filename, const std::string *data)
+{
+    // Keep the filename (it may be the member itself), topic name, the reading mode and the column selection
+    std::string file_name = filename, topic_name = Name;
+    bool follow = follow_mode;
+    VecString selection = column_selection;
+
+    // Clear the previous data from the object
+    this->Clear();
+
+    // Save the filename, topic name, the reading mode and the column selection
+    this->FileName = file_name;
+    this->Name = topic_name;
+    this->follow_mode = follow;
+    this->column_selection = selection;
+
+    // Read the header and the data from the CSV file (or the given contents)
+    if ((data != NULL ? ParseData(*data) : ReadAppendedData()) < 0)
+        return false;
+
+    // It is not a fault topic if the topic name is shorter than the fault prefix
+    if (this->Name.length() >= Commons::FaultTopicPrefix.length()) 
+        // Check if the prefix of topic name is the fault prefix
+        is_fault_topic = (this->Name.substr(0, Commons::FaultTopicPrefix.length()) == Commons::FaultTopicPrefix);
+
+    // Initialization done
+    is_initialized = true;
+
+    return IsInitialized();
+}
+
+// Parse the data read from the CSV file after the data already processed: the header if it is not read yet,
+// then the messages. In the follow mode, the last incomplete line is left for the next read.
+// Returns the number of new messages, or -1 if the header cannot be read.
+int Topic::ParseData(const std::string &buffer)
+{
+    // Only process the complete lines in the follow mode
+    size_t data_end = buffer.size();
+    if (follow_mode)
+        data_end = (buffer.find_last_of('\n') == std::string::npos) ? 0 : buffer.find_last_of('\n') + 1;
+
+    // Read the header line from the CSV file
+    size_t pos = 0;
+    while (pos < data_end && this->orig_field_labels.empty())
     {
-        std::cerr << "GetFieldsAsInt Error! Field index is negative." << std::endl;
-        return vec_output;
+        size_t line_end = std::min(buffer.find('\n', pos), data_end);
+        std::string line = buffer.substr(pos, line_end - pos);
+        pos = line_end + 1;
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+
+        SelectColumns(Commons::Tokenize(line, Commons::CSVDelimiter));
+
+        // Postprocess the header labels
+        ProcessHeader();
     }
 
-    // Print error if the start index is negative
-    if (start_msg_index < 0)
+    // Split the data to chunks of complete lines. Large data is parsed on several threads (except in the
+    // tasks of a thread pool, which already keep the cores busy).
+    std::vector<size_t> chunk_starts(1, std::min(pos, data_end));
+    int n_chunks = 1, threads = (n_threads > 0) ? n_threads : std::max(1, (int)std::thread::hardware_concurrency());
+    if (pos < data_end && threads > 1 && data_end - pos >= ParallelParseMinBytes && !ThreadPool::IsWorkerThread())
+        n_chunks = (int)std::min<size_t>(4 * threads, (data_end - pos) / (ParallelParseMinBytes / 4));
+    for (int c = 1; c < n_chunks; ++c)
     {
-        std::cerr << "GetFieldsAsInt Error! Starting index is negative." << std::endl;
-        return vec_output;
+        size_t split = pos + (data_end - pos) / n_chunks * c;
+        split = std::min(buffer.find('\n', std::max(split, chunk_starts.back())), data_end);
+        chunk_starts.push_back(std::min(split + 1, data_end));
     }
+    chunk_starts.push_back(data_end);
 
-    // If the number of messages is negative, use all the messages
-    if (n_messages < 0)
-        n_messages = Messages.size();
+    // Parse the chunks to separate buffers
+    std::vector<ParsedChunk> chunks(chunk_starts.size() - 1);
+    if (chunks.size() == 1)
+        ParseLines(buffer, chunk_starts[0], chunk_starts[1], chunks[0]);
+    else
+    {
+        ThreadPool pool(std::min(threads, (int)chunks.size()));
+        for (int c = 0; c < (int)chunks.size(); ++c)
+            pool.Submit([this, c, &buffer, &chunk_starts, &chunks]()
+                { ParseLines(buffer, chunk_starts[c], chunk_starts[c + 1], chunks[c]); });
+        pool.WaitAll();
+    }
 
-    // Add the fields to the output vector
-    for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
+    // Stitch the messages of the chunks in order, stopping at the first line with too many fields
+    int n_new_messages = 0;
+    for (int c = 0; c < (int)chunks.size(); ++c)
+        n_new_messages += (int)chunks[c].Messages.size();
+    this->Messages.reserve(this->Messages.size() + n_new_messages);
+    n_new_messages = 0;
+    for (int c = 0; c < (int)chunks.size(); ++c)
     {
-        int temp = 0;
-        Commons::StringToInt(Messages[i].Fields[field_index], temp);
-        vec_output.push_back(temp);
+        ParsedChunk &chunk = chunks[c];
+        this->Messages.insert(this->Messages.end(), std::make_move_iterator(chunk.Messages.begin()),
+            std::make_move_iterator(chunk.Messages.end()));
+        n_new_messages += (int)chunk.Messages.size();
+        line_number += chunk.NumberOfLines;
+        pos = chunk.End;
+
+        // Update the field lengths of the messages
+        len_seqid = std::max(len_seqid, chunk.LenSeqID);
+        len_stamp = std::max(len_stamp, chunk.LenStamp);
+        len_frameid = std::max(len_frameid, chunk.LenFrameID);
+        if (len_fields.size() < chunk.LenFields.size())
+            len_fields.resize(chunk.LenFields.size(), 0);
+        for (int i = 0; i < (int)chunk.LenFields.size(); ++i)
+            len_fields[i] = std::max(len_fields[i], chunk.LenFields[i]);
+
+        // Print an error and stop operation if file is not formatted properly
+        if (chunk.HasFormatError)
+        {
+            std::cerr << "Error converting line #" << line_number << " of '" << FileName << "'. Skipping this topic!" << std::endl;
+            has_format_error = true;
+            break;
+        }
     }
+    file_offset += std::min(pos, data_end);
 
-    return vec_output;
-}
+    // Store the new values in the field types (the types are inferred on the first messages)
+    if (n_new_messages > 0)
+        UpdateColumns((int)Messages.size() - n_new_messages);
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<int> Topic::GetFieldsAsInt(const std::string &field_label, int start_msg_index, int n_messages)
-{
-    // Find the field index
-    int field_index = FindLabelIndex(field_label);
+    // Keep the zone maps up to date with the new messages
+    if (HasZoneMaps() && n_new_messages > 0)
+        UpdateZoneMaps((int)Messages.size() - n_new_messages);
 
-    // Print error if the field name is not found
-    if (field_index < 0)
+    // Print an error if the file is not formatted properly
+    if (this->orig_field_labels.empty() && !follow_mode)
     {
-        std::cerr << "GetFieldsAsInt Error! '" << field_label << "' field not found." << std::endl;
-        return std::vector<int>();
+        std::cerr << "Error reading the header from '" << FileName << "' file." << std::endl;
+        return -1;
     }
 
-    // Return the desired output
-    return GetFieldsAsInt(field_index, start_msg_index, n_messages);
+    return n_new_messages;
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<long long> Topic::GetFieldsAsLongLong(int field_index, int start_msg_index, int n_messages)
+// Parse the lines of the data between the given positions to messages. Stops at the first line with too many
+// fields. Only reads the topic information, so the chunks of a file can be parsed at the same time.
+void Topic::ParseLines(const std::string &buffer, size_t start, size_t end, ParsedChunk &out_chunk) const
 {
-    // Initialize the output
-    std::vector<long long> vec_output;
-
-    // Print error if the field index is negative
-    if (field_index < 0)
+    VecString tokens;
+    std::vector<uint32_t> separators;
+    size_t pos = start;
+    while (pos < end && !out_chunk.HasFormatError)
     {
-        std::cerr << "GetFieldsAsLongLong Error! Field index is negative." << std::endl;
-        return vec_output;
+        // Find the delimiters and the newlines of a window of complete lines at once
+        size_t window_end = end;
+        if (end - pos > ScanWindowBytes)
+            window_end = std::min(buffer.find('\n', pos + ScanWindowBytes), end - 1) + 1;
+        const char *window = buffer.data() + pos;
+        CSVScanner::FindSeparators(window, window_end - pos, Commons::CSVDelimiter, separators);
+
+        // Break the window to lines
+        size_t line_start = 0, window_size = window_end - pos, s = 0;
+        while (line_start < window_size)
+        {
+            size_t first_delimiter = s;
+            while (s < separators.size() && window[separators[s]] != '\n') ++s;
+            size_t n_delimiters = s - first_delimiter;
+            size_t line_end = (s < separators.size()) ? separators[s++] : window_size;
+            size_t next_line = line_end + 1;
+            if (line_end > line_start && window[line_end - 1] == '\r')
+                --line_end;
+
+            out_chunk.NumberOfLines++;
+
+            // Break the line to the tokens of the selected columns (empty if the line did not include all the fields)
+            int n_columns = TokenizeLine(window, line_start, line_end, &separators[0] + first_delimiter, n_delimiters, tokens);
+            line_start = next_line;
+
+            // Stop at the line if the file is not formatted properly
+            if (n_columns > n_file_columns)
+            {
+                out_chunk.HasFormatError = true;
+                break;
+            }
+
+            // Convert the tokens to a message and add to the chunk
+            out_chunk.Messages.push_back(TokensToMessage(tokens, out_chunk));
+        }
+        pos += std::min(line_start, window_size);
     }
+    out_chunk.End = pos;
+}
 
-    // Print error if the start index is negative
-    if (start_msg_index < 0)
+// Convert a vector of tokens to a message
+Message Topic::TokensToMessage(const VecString &tokens, ParsedChunk &chunk) const
+{
+    // Define temporary variables for header field lengths
+    int l_seq = 0, l_stamp = 0, l_frid = 0;
+    std::vector<int> l_fields;
+
+    // Convert the tokens to a message
+    Message msg = Message::TokensToMessage(tokens, orig_field_labels, l_seq, l_stamp, l_frid, l_fields);
+
+    // Update the field lengths in the chunk
+    chunk.LenSeqID = std::max(chunk.LenSeqID, l_seq);
+    chunk.LenStamp = std::max(chunk.LenStamp, l_stamp);
+    chunk.LenFrameID = std::max(chunk.LenFrameID, l_frid);
+    for (int i = 0; i < (int)l_fields.size(); ++i)
     {
-        std::cerr << "GetFieldsAsLongLong Error! Starting index is negative." << std::endl;
-        return vec_output;
+        if (i == (int)chunk.LenFields.size())
+            chunk.LenFields.push_back(l_fields[i]);
+        else
+            chunk.LenFields[i] = std::max(chunk.LenFields[i], l_fields[i]);
     }
 
-    // If the number of messages is negative, use all the messages
-    if (n_messages < 0)
-        n_messages = Messages.size();
+    // Return the new message
+    return msg;
+}
 
-    // Add the fields to the output vector
-    for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
+// Update the zone maps from the block of the given message to the last message
+void Topic::UpdateZoneMaps(int first_msg_index)
+{
+    int block_size = zone_maps.BlockSize;
+    int n_messages = (int)Messages.size();
+    int n_blocks = (n_messages + block_size - 1) / block_size;
+    int first_block = first_msg_index / block_size;
+
+    // Make room for the new blocks and the new fields
+    zone_maps.MinTimes.resize(n_blocks);
+    zone_maps.MaxTimes.resize(n_blocks);
+    zone_maps.MinValues.resize(FieldLabels.size());
+    zone_maps.MaxValues.resize(FieldLabels.size());
+    zone_maps.Counts.resize(FieldLabels.size());
+    for (int f = 0; f < (int)FieldLabels.size(); ++f)
     {
-        long long temp = 0;
-        Commons::StringToLongLong(Messages[i].Fields[field_index], temp);
-        vec_output.push_back(temp);
+        zone_maps.MinValues[f].resize(n_blocks);
+        zone_maps.MaxValues[f].resize(n_blocks);
+        zone_maps.Counts[f].resize(n_blocks);
     }
 
-    return vec_output;
+    // Summarize the changed blocks
+    // Use the stored values of the fields that have them and the texts of the others
+    std::vector<const Column *> stored_columns(FieldLabels.size());
+    for (int f = 0; f < (int)FieldLabels.size(); ++f)
+        stored_columns[f] = FindStoredColumn(f);
+
+    std::vector<double> min_values(FieldLabels.size()), max_values(FieldLabels.size());
+    std::vector<int> counts(FieldLabels.size());
+    for (int b = first_block; b < n_blocks; ++b)
+    {
+        int start = b * block_size, end = std::min(start + block_size, n_messages);
+        long long min_time = Messages[start].DateTime.ToNanoseconds(), max_time = min_time;
+        std::fill(min_values.begin(), min_values.end(), std::numeric_limits<double>::infinity());
+        std::fill(max_values.begin(), max_values.end(), -std::numeric_limits<double>::infinity());
+        std::fill(counts.begin(), counts.end(), 0);
+
+        for (int i = start; i < end; ++i)
+        {
+            long long time = Messages[i].DateTime.ToNanoseconds();
+            min_time = std::min(min_time, time);
+            max_time = std::max(max_time, time);
+
+            for (int f = 0; f < (int)FieldLabels.size() && f < (int)Messages[i].Fields.size(); ++f)
+            {
+                double value = GetNumber(stored_columns[f], f, i);
+                if (value != value) continue;
+                min_values[f] = std::min(min_values[f], value);
+                max_values[f] = std::max(max_values[f], value);
+                counts[f]++;
+            }
+        }
+
+        zone_maps.MinTimes[b] = min_time;
+        zone_maps.MaxTimes[b] = max_time;
+        for (int f = 0; f < (int)FieldLabels.size(); ++f)
+        {
+            zone_maps.MinValues[f][b] = min_values[f];
+            zone_maps.MaxValues[f][b] = max_values[f];
+            zone_maps.Counts[f][b] = counts[f];
+        }
+    }
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<long long> Topic::GetFieldsAsLongLong(const std::string &field_label, int start_msg_index, int n_messages)
+// Infer the field types from a sample of evenly spaced messages. The types of the values are joined in the
+// order Bool < Int64 < Float64 < text, and the text fields with few distinct values become Category.
+void Topic::InferFieldTypes()
 {
-    // Find the field index
-    int field_index = FindLabelIndex(field_label);
+    int n_fields = (int)FieldLabels.size(), n_messages = (int)Messages.size();
+    int step = std::max(1, n_messages / SchemaSampleSize);
+
+    std::vector<FieldType> types(n_fields, Bool);
+    std::vector<std::set<std::string> > distinct_values(n_fields);
+    std::vector<char> has_values(n_fields, 0);
+    long long integer = 0;
+    double number = 0;
+    for (int i = 0; i < n_messages; i += step)
+        for (int f = 0; f < n_fields; ++f)
+        {
+            const std::string &field = Messages[i].Fields[f];
+            types[f] = std::max(types[f], ClassifyField(field, integer, number));
+            has_values[f] |= !field.empty();
+            if ((int)distinct_values[f].size() <= MaxCategorySize)
+                distinct_values[f].insert(field);
+        }
 
-    // Print error if the field name is not found
-    if (field_index < 0)
+    FieldTypes.assign(n_fields, Bool);
+    columns.assign(n_fields, Column());
+    is_column_stored.assign(n_fields, 0);
+    for (int f = 0; f < n_fields; ++f)
     {
-        std::cerr << "GetFieldsAsLongLong Error! '" << field_label << "' field not found." << std::endl;
-        return std::vector<long long>();
+        if (types[f] == String && (int)distinct_values[f].size() <= MaxCategorySize)
+            types[f] = Category;
+        if (!has_values[f]) types[f] = Float64;     // Only the empty values (NaN)
+        FieldTypes[f] = columns[f].Type = types[f];
     }
+}
 
-    // Return the desired output
-    return GetFieldsAsLongLong(field_index, start_msg_index, n_messages);
+// Check the field values from the given message to the last message against the field types (and store
+// them in the fields whose values are stored). The types are inferred on the first call, and a field is
+// promoted to a wider type when a value does not fit its type.
+void Topic::UpdateColumns(int first_msg_index)
+{
+    if (Messages.empty()) return;
+    if (columns.size() != FieldLabels.size())
+    {
+        InferFieldTypes();
+        first_msg_index = 0;
+    }
+
+    int n_messages = (int)Messages.size();
+    long long integer = 0;
+    double number = 0;
+    for (int f = 0; f < (int)columns.size(); ++f)
+    {
+        Column &column = columns[f];
+
+        // Codes of the dictionary values of a Category field
+        std::map<std::string, int> codes;
+        for (int d = 0; d < (int)column.Dictionary.size(); ++d)
+            codes[column.Dictionary[d]] = d;
+
+        for (int i = first_msg_index; i < n_messages && column.Type != String; ++i)
+        {
+            const std::string &field = Messages[i].Fields[f];
+            if (column.Type == Category)
+            {
+                std::map<std::string, int>::iterator it = codes.find(field);
+                if (it == codes.end())
+                {
+                    // Keep too many distinct values as free text
+                    if ((int)column.Dictionary.size() >= MaxCategorySize)
+                    {
+                        PromoteColumn(f, String, i);
+                        break;
+                    }
+                    it = codes.insert(std::make_pair(field, (int)column.Dictionary.size())).first;
+                    column.Dictionary.push_back(field);
+                }
+                if (is_column_stored[f]) column.Codes.push_back(it->second);
+                continue;
+            }
+
+            // Promote the field if the value does not fit its type, then store the value again
+            FieldType type = ClassifyField(field, integer, number);
+            if (type > column.Type)
+            {
+                PromoteColumn(f, type == String ? Category : type, i);
+                codes.clear();
+                for (int d = 0; d < (int)column.Dictionary.size(); ++d)
+                    codes[column.Dictionary[d]] = d;
+                --i;
+                continue;
+            }
+
+            if (!is_column_stored[f]) continue;
+            if (column.Type == Float64)
+                column.Numbers.push_back(number);
+            else
+            {
+                if (field.empty()) column.Missing.push_back(i);
+                column.Integers.push_back(integer);
+            }
+        }
+
+        FieldTypes[f] = column.Type;
+    }
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<double> Topic::GetFieldsAsDouble(int field_index, int start_msg_index, int n_messages)
+// Convert the first given number of values of a field to a wider type. The values are only converted if
+// they are stored, but the dictionary of a Category field is always built.
+void Topic::PromoteColumn(int field_index, FieldType type, int n_values)
 {
-    // Initialize the output
-    std::vector<double> vec_output;
+    Column &column = columns[field_index];
+    FieldType old_type = column.Type;
+    column.Type = type;
 
-    // Print error if the field index is negative
-    if (field_index < 0)
+    // The integers are converted to real numbers (NaN for the empty values) and the numbers to text
+    if (type == Float64)
     {
-        std::cerr << "GetFieldsAsDouble Error! Field index is negative." << std::endl;
-        return vec_output;
+        column.Numbers.assign(column.Integers.begin(), column.Integers.end());
+        for (int i = 0; i < (int)column.Missing.size(); ++i)
+            column.Numbers[column.Missing[i]] = std::numeric_limits<double>::quiet_NaN();
+        std::vector<long long>().swap(column.Integers);
+        std::vector<int>().swap(column.Missing);
     }
+    else if (type == Category && old_type != Category)
+    {
+        std::vector<long long>().swap(column.Integers);
+        std::vector<int>().swap(column.Missing);
+        std::vector<double>().swap(column.Numbers);
 
-    // Print error if the start index is negative
-    if (start_msg_index < 0)
+        std::map<std::string, int> codes;
+        for (int i = 0; i < n_values; ++i)
+        {
+            const std::string &field = Messages[i].Fields[field_index];
+            std::map<std::string, int>::iterator it = codes.find(field);
+            if (it == codes.end())
+            {
+                if ((int)column.Dictionary.size() >= MaxCategorySize)
+                {
+                    PromoteColumn(field_index, String, i);
+                    return;
+                }
+                it = codes.insert(std::make_pair(field, (int)column.Dictionary.size())).first;
+                column.Dictionary.push_back(field);
+            }
+            if (is_column_stored[field_index]) column.Codes.push_back(it->second);
+        }
+    }
+    else if (type == String)
     {
-        std::cerr << "GetFieldsAsDouble Error! Starting index is negative." << std::endl;
-        return vec_output;
+        column = Column();
+        column.Type = String;
     }
+}
 
-    // If the number of messages is negative, use all the messages
-    if (n_messages < 0)
-        n_messages = Messages.size();
+// Store the values of a field in its type if they are not stored yet, and get them. The lock lets several
+// threads read the fields of a shared topic at the same time.
+const Topic::Column &Topic::StoreColumnValues(int field_index) const
+{
+    std::lock_guard<std::mutex> lock(column_lock.Mutex);
+    if (!is_column_stored[field_index])
+    {
+        AppendColumnValues(columns[field_index], field_index, 0);
+        is_column_stored[field_index] = 1;
+    }
+    return columns[field_index];
+}
 
-    // Add the fields to the output vector
-    for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
+// Append the values of a field from the given message to the last message in the type of the field. The
+// type and the dictionary of the field must already fit all the values (see UpdateColumns).
+void Topic::AppendColumnValues(Column &column, int field_index, int first_msg_index) const
+{
+    int n_messages = (int)Messages.size();
+    long long integer = 0;
+    double number = 0;
+    if (column.Type == Category)
     {
-        double temp = 0;
-        Commons::StringToDouble(Messages[i].Fields[field_index], temp);
-        vec_output.push_back(temp);
+        std::map<std::string, int> codes;
+        for (int d = 0; d < (int)column.Dictionary.size(); ++d)
+            codes[column.Dictionary[d]] = d;
+        column.Codes.reserve(n_messages);
+        for (int i = first_msg_index; i < n_messages; ++i)
+            column.Codes.push_back(codes[Messages[i].Fields[field_index]]);
     }
+    else if (column.Type == Float64)
+    {
+        column.Numbers.reserve(n_messages);
+        for (int i = first_msg_index; i < n_messages; ++i)
+        {
+            ClassifyField(Messages[i].Fields[field_index], integer, number);
+            column.Numbers.push_back(number);
+        }
+    }
+    else if (column.Type == Bool || column.Type == Int64)
+    {
+        column.Integers.reserve(n_messages);
+        for (int i = first_msg_index; i < n_messages; ++i)
+        {
+            const std::string &field = Messages[i].Fields[field_index];
+            ClassifyField(field, integer, number);
+            if (field.empty()) column.Missing.push_back(i);
+            column.Integers.push_back(integer);
+        }
+    }
+}
 
-    return vec_output;
+// Get the column of a field if its values are stored, or NULL
+const Topic::Column *Topic::FindStoredColumn(int field_index) const
+{
+    std::lock_guard<std::mutex> lock(column_lock.Mutex);
+    if (field_index >= (int)is_column_stored.size() || !is_column_stored[field_index]) return NULL;
+    return &columns[field_index];
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<double> Topic::GetFieldsAsDouble(const std::string &field_label, int start_msg_index, int n_messages)
+// Get the value of a field as a number. Uses the stored values of the numeric fields (if the column is
+// given) and parses the text of the other fields (see FieldToDouble).
+double Topic::GetNumber(const Column *column, int field_index, int msg_index) const
 {
-    // Find the field index
-    int field_index = FindLabelIndex(field_label);
+    if (column != NULL && (column->Type == Bool || column->Type == Int64 || column->Type == Float64))
+        return column->ToDouble(msg_index);
+    return FieldToDouble(Messages[msg_index].Fields[field_index]);
+}
 
-    // Print error if the field name is not found
-    if (field_index < 0)
+// Check that the values of a field are stored as numbers (or integers). Prints an error for the wrong
+// types. Returns false without an error if there are no messages.
+bool Topic::CheckNumericField(int field_index, bool integer_only, const std::string &function_name) const
+{
+    if (field_index >= (int)FieldLabels.size())
     {
-        std::cerr << "GetFieldsAsLongDouble Error! '" << field_label << "' field not found." << std::endl;
-        return std::vector<double>();
+        std::cerr << function_name << " Error! Field index is out of range." << std::endl;
+        return false;
     }
+    if (field_index >= (int)columns.size()) return false;
 
-    // Return the desired output
-    return GetFieldsAsDouble(field_index, start_msg_index, n_messages);
+    FieldType type = columns[field_index].Type;
+    if (type == Category || type == String || (integer_only && type == Float64))
+    {
+        std::cerr << function_name << " Error! '" << FieldLabels[field_index] << "' field is "
+            << FieldTypeToString(type) << ", not " << (integer_only ? "integer." : "numeric.") << std::endl;
+        return false;
+    }
+    return true;
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<long double> Topic::GetFieldsAsLongDouble(int field_index, int start_msg_index, int n_messages)
+// Find the index of a field label. Prints an error and returns -1 if the field is not found.
+int Topic::FindFieldIndex(const std::string &field_label, const std::string &function_name) const
 {
-    // Initialize the output
-    std::vector<long double> vec_output;
+    int field_index = FindLabelIndex(field_label);
+    if (field_index < 0)
+        std::cerr << function_name << " Error! '" << field_label << "' field not found." << std::endl;
+    return field_index;
+}
 
+// Write the converted fields of a desired number of messages starting from the desired index to an output
+// iterator. The range and the type of the field are checked once, and the loop is chosen by the output type.
+// Returns the number of values written, or -1 on errors.
+template <typename T, typename OutputIterator>
+int Topic::CopyFieldValues(int field_index, int start_msg_index, int n_messages, OutputIterator out,
+    const std::string &function_name) const
+{
     // Print error if the field index is negative
     if (field_index < 0)
     {
-        std::cerr << "GetFieldsAsLongDouble Error! Field index is negative." << std::endl;
-        return vec_output;
+        std::cerr << function_name << " Error! Field index is negative." << std::endl;
+        return -1;
     }
 
     // Print error if the start index is negative
     if (start_msg_index < 0)
     {
-        std::cerr << "GetFieldsAsLongDouble Error! Starting index is negative." << std::endl;
-        return vec_output;
+        std::cerr << function_name << " Error! Starting index is negative." << std::endl;
+        return -1;
+    }
+
+    // Print error if the field does not keep the values of the type
+    const FieldAccess access = FieldConverter<T>::Access;
+    if (access == TextAccess && field_index >= (int)FieldLabels.size())
+    {
+        std::cerr << function_name << " Error! Field index is out of range." << std::endl;
+        return -1;
     }
+    if (access != TextAccess && !CheckNumericField(field_index, access == IntegerAccess, function_name))
+        return (field_index < (int)FieldLabels.size() && field_index >= (int)columns.size()) ? 0 : -1;
+    if (access != TextAccess) StoreColumnValues(field_index);
 
     // If the number of messages is negative, use all the messages
-    if (n_messages < 0)
-        n_messages = Messages.size();
+    int end = (int)Messages.size();
+    if (n_messages >= 0 && n_messages < end - start_msg_index) end = start_msg_index + n_messages;
+    if (start_msg_index >= end) return 0;
 
-    // Add the fields to the output vector
-    for (int i = start_msg_index; (i < start_msg_index + n_messages) && (i < (int)Messages.size()); ++i)
+    ConvertFieldValues<T>(field_index, start_msg_index, end, out, std::integral_constant<FieldAccess, FieldConverter<T>::Access>());
+    return end - start_msg_index;
+}
+
+// Convert the texts of the fields
+template <typename T, typename OutputIterator>
+void Topic::ConvertFieldValues(int field_index, int start, int end, OutputIterator &out,
+    std::integral_constant<FieldAccess, TextAccess>) const
+{
+    for (int i = start; i < end; ++i)
+        *out++ = FieldConverter<T>::FromText(Messages[i].Fields[field_index]);
+}
+
+// Convert the stored integers of the fields
+template <typename T, typename OutputIterator>
+void Topic::ConvertFieldValues(int field_index, int start, int end, OutputIterator &out,
+    std::integral_constant<FieldAccess, IntegerAccess>) const
+{
+    const long long *integers = columns[field_index].Integers.data();
+    for (int i = start; i < end; ++i)
+        *out++ = FieldConverter<T>::FromInteger(integers[i]);
+}
+
+// Convert the stored integers or real numbers of the fields
+template <typename T, typename OutputIterator>
+void Topic::ConvertFieldValues(int field_index, int start, int end, OutputIterator &out,
+    std::integral_constant<FieldAccess, NumericAccess>) const
+{
+    const Column &column = columns[field_index];
+    if (column.Type != Float64)
     {
-        long double temp = 0;
-        Commons::StringToLongDouble(Messages[i].Fields[field_index], temp);
-        vec_output.push_back(temp);
+        // The empty values are NaN
+        const long long *integers = column.Integers.data();
+        std::vector<int>::const_iterator missing = std::lower_bound(column.Missing.begin(), column.Missing.end(), start);
+        for (int i = start; i < end; ++i)
+        {
+            if (missing != column.Missing.end() && *missing == i)
+            {
+                *out++ = FieldConverter<T>::FromReal(std::numeric_limits<double>::quiet_NaN(), Messages[i].Fields[field_index]);
+                ++missing;
+            }
+            else
+                *out++ = FieldConverter<T>::FromInteger(integers[i]);
+        }
+        return;
     }
 
-    return vec_output;
+    const double *numbers = column.Numbers.data();
+    for (int i = start; i < end; ++i)
+        *out++ = FieldConverter<T>::FromReal(numbers[i], Messages[i].Fields[field_index]);
 }
 
-// Retrieve the fields of a desired number of messages starting from the desired index
-std::vector<long double> Topic::GetFieldsAsLongDouble(const std::string &field_label, int start_msg_index, int n_messages)
+// Find the type of a field value and convert it. The booleans and integers are returned in the integer,
+// and all the numeric values in the number. The empty values are missing: they are Bool, so they do not
+// widen the type of a field, with 0 in the integer and NaN in the number. The rest are String.
+Topic::FieldType Topic::ClassifyField(const std::string &field, long long &integer, double &number)
 {
-    // Find the field index
-    int field_index = FindLabelIndex(field_label);
+    if (field.empty())
+    {
+        integer = 0;
+        number = std::numeric_limits<double>::quiet_NaN();
+        return Bool;
+    }
+    if (field == "True" || field == "true") { integer = 1; number = 1; return Bool; }
+    if (field == "False" || field == "false") { integer = 0; number = 0; return Bool; }
 
-    // Print error if the field name is not found
-    if (field_index < 0)
+    // Integers must be exact (no overflow)
+    if (NumberParser::ParseInt64(field.data(), field.data() + field.size(), integer))
     {
-        std::cerr << "GetFieldsAsLongDouble Error! '" << field_label << "' field not found." << std::endl;
-        return std::vector<long double>();
+        number = (double)integer;
+        return Int64;
     }
 
-    // Return the desired output
-    return GetFieldsAsLongDouble(field_index, start_msg_index, n_messages);
+    // Real numbers are converted as in FieldToDouble
+    if (Commons::StringToDouble(field, number)) return Float64;
+    return String;
 }
 
-/******************************************************************************/
-/*********************** Local Function Definitions ***************************/
-/******************************************************************************/
-
-// Convert a vector of tokens to a message
-Message Topic::TokensToMessage(const VecString &tokens)
+// Find the columns of the file to read from the header labels. The time and the header columns are always
+// read, and the other columns only if they match the column selection.
+void Topic::SelectColumns(const VecString &file_labels)
 {
-    // Define temporary variables for header field lengths
-    int l_seq = 0, l_stamp = 0, l_frid = 0;
-    std::vector<int> l_fields;
+    n_file_columns = (int)file_labels.size();
+    read_columns.clear();
+    orig_field_labels.clear();
+    std::vector<bool> is_pattern_used(column_selection.size(), false);
 
-    // Convert the tokens to a message
-    Message msg = Message::TokensToMessage(tokens, orig_field_labels, l_seq, l_stamp, l_frid, l_fields);
+    for (int i = 0; i < n_file_columns; ++i)
+    {
+        const std::string &label = file_labels[i];
+        bool is_selected = column_selection.empty() || label == "%time"
+            || label == Commons::CSVFieldsPrefix + "header.seq" || label == Commons::CSVFieldsPrefix + "header.stamp"
+            || label == Commons::CSVFieldsPrefix + "header.frame_id";
+
+        // Match the field label without the prefix
+        std::string field_label = label;
+        if (label.substr(0, Commons::CSVFieldsPrefix.size()) == Commons::CSVFieldsPrefix)
+            field_label = label.substr(Commons::CSVFieldsPrefix.size());
+        for (int p = 0; p < (int)column_selection.size(); ++p)
+            if (Commons::MatchPattern(column_selection[p], field_label))
+                is_selected = is_pattern_used[p] = true;
+
+        if (!is_selected) continue;
+        read_columns.push_back(i);
+        orig_field_labels.push_back(label);
+    }
 
-    // Update the field lengths in the messages
-    len_seqid = std::max(len_seqid, l_seq);
-    len_stamp = std::max(len_stamp, l_stamp);
-    len_frameid = std::max(len_frameid, l_frid);
-    for (int i = 0; i < (int)l_fields.size(); ++i)
+    // Warn about the selected fields that are not in the file
+    for (int p = 0; p < (int)column_selection.size(); ++p)
+        if (!is_pattern_used[p])
+            std::cerr << "'" << column_selection[p] << "' field not found in '" << FileName << "'." << std::endl;
+}
+
+// Break a line to the tokens of the columns that are read, given the positions of its delimiters (found by
+// CSVScanner). The other columns are skipped without being copied. The missing columns are empty.
+// Returns the number of columns in the line.
+int Topic::TokenizeLine(const char *data, size_t line_start, size_t line_end, const uint32_t *delimiters,
+    size_t n_delimiters, VecString &out_tokens) const
+{
+    out_tokens.assign(read_columns.size(), std::string());
+
+    int n_columns = 0;
+    size_t start = line_start, next_token = 0;
+    for (size_t d = 0; d <= n_delimiters && start < line_end; ++d)
     {
-        if (i == (int)len_fields.size())
-            len_fields.push_back(l_fields[i]);
-        else
-            len_fields[i] = std::max(len_fields[i], l_fields[i]);
+        size_t end = (d < n_delimiters) ? delimiters[d] : line_end;
+        if (next_token < read_columns.size() && read_columns[next_token] == n_columns)
+            out_tokens[next_token++].assign(data + start, end - start);
+        ++n_columns;
+        start = end + 1;
     }
 
-    // Return the new message
-    return msg;
+    return n_columns;
 }
 
 // Postprocess the header of the CSV file (remove time, etc. from labels).
@@ -699,8 +1904,10 @@ void Topic::ProcessHeader()
     len_frameid = std::max(len_frameid, (int)hdr_frid.length());
     for (int i = 0; i < (int)FieldLabels.size(); ++i)
     {
-        if ((int)len_fields.size() < (i + 1)) break;
-        len_fields[i] = std::max(len_fields[i], (int)FieldLabels[i].length());
+        if ((int)len_fields.size() < (i + 1))
+            len_fields.push_back(FieldLabels[i].length());
+        else
+            len_fields[i] = std::max(len_fields[i], (int)FieldLabels[i].length());
     }
 }
 
@@ -0,0 +1,450 @@
+/*  ***************************************************************************
+*   windowing.h - Header for cutting aligned ALFA topic data into fixed-length
+*   windows (e.g., training data for learned fault detectors).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_WINDOWING_H
+#define ALFA_WINDOWING_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+#include "commons.h"
+#include "sequence.h"
+#include "faults.h"
+#include "threadpool.h"
+
+namespace alfa
+{
+
+// This structure keeps a set of windows cut from one or more sequences
+struct WindowSet
+{
+    std::vector<float> Data;            // Window samples, shape (NumWindows, WindowLength, NumFeatures)
+    std::vector<int> Labels;            // Fault label of each window (1 for faulty, 0 for normal)
+    std::vector<int> SequenceIndices;   // Index of the sequence each window was cut from
+    std::vector<long long> EndTimes;    // Time of the last sample of each window (nanoseconds)
+    VecString FeatureNames;             // Names of the features ("topic/field")
+    int NumWindows = 0, WindowLength = 0, NumFeatures = 0;
+
+    // Member Functions
+    bool SaveAsNpy(const std::string &path_prefix) const;
+    void Clear();
+};
+
+// This class cuts the data of a set of sequences into windows of the same length. The selected fields
+// are aligned on a common time grid by holding the last received value of each field, and each window
+// is labeled from the fault ground truth of its sequence. The sequences are processed in parallel and
+// the windows of all of them are written to a single contiguous float32 buffer.
+class WindowBuilder
+{
+public:
+
+    // Local enum definitions
+    enum LabelPolicy                    // How to label a window from the labels of its samples
+    {
+        LastSample,                     // The window is faulty if its last sample is faulty
+        AnySample,                      // The window is faulty if any of its samples is faulty
+        AllSamples                      // The window is faulty if all of its samples are faulty
+    };
+
+    // Constructors & Deconstructors
+    WindowBuilder();
+
+    // Member Functions
+    int AddField(const std::string &topic_name, const std::string &field_label);
+    int AddSequence(const Sequence &sequence);
+    int AddSequenceFile(const std::string &bag_path);
+    void SetWindow(int length, int stride);
+    void SetSamplePeriod(double sample_period);
+    void SetLabelPolicy(LabelPolicy policy);
+    void SetOnsetMargin(double onset_margin);
+    void SetNumberOfThreads(int n_threads);
+    bool Build(WindowSet &out_windows) const;
+    static bool WriteNpy(const std::string &filename, const void *data, const std::string &dtype, const std::vector<size_t> &shape);
+
+private:
+    // Local struct definitions
+    struct FieldSpec                    // Structure for a selected field
+    {
+        std::string TopicName;
+        std::string FieldLabel;
+    };
+
+    struct SequenceSource               // Structure for a registered sequence (loaded or a file)
+    {
+        const Sequence *Data = NULL;
+        std::string DirectoryPath, Name;
+    };
+
+    struct AlignedSequence              // Structure for the aligned data of a sequence
+    {
+        bool IsValid = false;
+        std::vector<float> Values;      // Aligned samples, shape (grid size, number of features)
+        std::vector<long long> Times;   // Time of each grid sample
+        std::vector<int> WindowStarts;  // First grid sample of each selected window
+        std::vector<int> WindowLabels;  // Label of each selected window
+        size_t FirstWindow = 0;         // Index of the first window of the sequence in the output
+    };
+
+    // Member Functions
+    void AlignSequence(const Sequence &sequence, AlignedSequence &out_aligned) const;
+    void SelectWindows(const FaultTimeline &faults, AlignedSequence &aligned) const;
+    void FillWindows(const AlignedSequence &aligned, int sequence_idx, WindowSet &out_windows) const;
+
+    // Data Members
+    std::vector<FieldSpec> fields;
+    std::vector<SequenceSource> sources;
+    int window_length = 50, window_stride = 10;
+    double sample_period = 0.04;
+    LabelPolicy label_policy = LastSample;
+    double onset_margin = 0;
+    int n_threads = 0;
+};
+
+/******************************************************************************/
+/************************** Function Definitions ******************************/
+/******************************************************************************/
+
+// Write all the arrays of the window set to .npy files named <path_prefix>_data.npy, _labels.npy,
+// _sequences.npy and _times.npy. Returns false if any of the files cannot be written.
+bool WindowSet::SaveAsNpy(const std::string &path_prefix) const
+{
+    std::vector<size_t> data_shape(1, NumWindows), vec_shape(1, NumWindows);
+    data_shape.push_back(WindowLength);
+    data_shape.push_back(NumFeatures);
+
+    return WindowBuilder::WriteNpy(path_prefix + "_data.npy", Data.data(), "f4", data_shape)
+        && WindowBuilder::WriteNpy(path_prefix + "_labels.npy", Labels.data(), "i4", vec_shape)
+        && WindowBuilder::WriteNpy(path_prefix + "_sequences.npy", SequenceIndices.data(), "i4", vec_shape)
+        && WindowBuilder::WriteNpy(path_prefix + "_times.npy", EndTimes.data(), "i8", vec_shape);
+}
+
+// Remove all the windows
+void WindowSet::Clear()
+{
+    Data.clear();
+    Labels.clear();
+    SequenceIndices.clear();
+    EndTimes.clear();
+    FeatureNames.clear();
+    NumWindows = WindowLength = NumFeatures = 0;
+}
+
+// Constructor function for WindowBuilder
+WindowBuilder::WindowBuilder()
+{
+}
+
+// Select a field of a topic as the next feature. Returns the index of the feature.
+int WindowBuilder::AddField(const std::string &topic_name, const std::string &field_label)
+{
+    FieldSpec spec;
+    spec.TopicName = topic_name;
+    spec.FieldLabel = field_label;
+    fields.push_back(spec);
+    return (int)fields.size() - 1;
+}
+
+// Add a loaded sequence. The sequence should stay valid until the windows are built.
+int WindowBuilder::AddSequence(const Sequence &sequence)
+{
+    SequenceSource source;
+    source.Data = &sequence;
+    sources.push_back(source);
+    return (int)sources.size() - 1;
+}
+
+// Add a sequence by the path of its bag file. The sequence is loaded (in parallel) while building.
+// Returns the index of the sequence, or -1 if the path is not valid.
+int WindowBuilder::AddSequenceFile(const std::string &bag_path)
+{
+    SequenceSource source;
+    if (!Sequence::ParseBagPath(bag_path, source.DirectoryPath, source.Name))
+    {
+        std::cerr << "AddSequenceFile Error! '" << bag_path << "' is not a path to a bag file." << std::endl;
+        return -1;
+    }
+    sources.push_back(source);
+    return (int)sources.size() - 1;
+}
+
+// Set the number of samples in each window and the number of samples between the starts of the windows
+void WindowBuilder::SetWindow(int length, int stride)
+{
+    window_length = std::max(length, 1);
+    window_stride = std::max(stride, 1);
+}
+
+// Set the time between the samples of the aligned data (seconds)
+void WindowBuilder::SetSamplePeriod(double sample_period)
+{
+    if (sample_period > 0) this->sample_period = sample_period;
+}
+
+// Set how the windows are labeled from the fault labels of their samples
+void WindowBuilder::SetLabelPolicy(LabelPolicy policy)
+{
+    label_policy = policy;
+}
+
+// Skip the normal windows that end less than the given time (seconds) before a fault onset, so the
+// normal windows are taken away from the transition to the fault
+void WindowBuilder::SetOnsetMargin(double onset_margin)
+{
+    this->onset_margin = std::max(onset_margin, 0.0);
+}
+
+// Set the number of threads (0 for one thread per core)
+void WindowBuilder::SetNumberOfThreads(int n_threads)
+{
+    this->n_threads = n_threads;
+}
+
+// Build the windows of all the sequences. The sequences missing a selected field are skipped.
+// Returns false if no fields or sequences are given.
+bool WindowBuilder::Build(WindowSet &out_windows) const
+{
+    out_windows.Clear();
+    if (fields.empty() || sources.empty())
+    {
+        std::cerr << "Build Error! At least one field and one sequence are needed." << std::endl;
+        return false;
+    }
+
+    // Load and align the sequences and select their windows in parallel
+    std::vector<AlignedSequence> aligned(sources.size());
+    {
+        ThreadPool pool(n_threads);
+        for (int s = 0; s < (int)sources.size(); ++s)
+            pool.Submit([this, s, &aligned]()
+            {
+                const SequenceSource &source = sources[s];
+                std::unique_ptr<Sequence> loaded;
+                if (source.Data == NULL) loaded.reset(new Sequence(source.DirectoryPath, source.Name));
+                const Sequence &sequence = (source.Data != NULL) ? *source.Data : *loaded;
+                if (!sequence.IsInitialized()) return;
+
+                AlignSequence(sequence, aligned[s]);
+                if (aligned[s].IsValid) SelectWindows(sequence.GetFaultTimeline(), aligned[s]);
+            });
+        pool.WaitAll();
+
+        // Allocate the output once and let each sequence fill its own part of it
+        size_t n_windows = 0;
+        for (int s = 0; s < (int)aligned.size(); ++s)
+        {
+            aligned[s].FirstWindow = n_windows;
+            n_windows += aligned[s].WindowStarts.size();
+        }
+
+        out_windows.NumWindows = (int)n_windows;
+        out_windows.WindowLength = window_length;
+        out_windows.NumFeatures = (int)fields.size();
+        out_windows.Data.resize(n_windows * window_length * fields.size());
+        out_windows.Labels.resize(n_windows);
+        out_windows.SequenceIndices.resize(n_windows);
+        out_windows.EndTimes.resize(n_windows);
+        for (int f = 0; f < (int)fields.size(); ++f)
+            out_windows.FeatureNames.push_back(fields[f].TopicName + "/" + fields[f].FieldLabel);
+
+        for (int s = 0; s < (int)aligned.size(); ++s)
+            pool.Submit([this, s, &aligned, &out_windows]() { FillWindows(aligned[s], s, out_windows); });
+        pool.WaitAll();
+    }
+
+    return true;
+}
+
+// Write an array to a .npy file (format version 1.0). The dtype is given without the byte order (e.g., "f4").
+bool WindowBuilder::WriteNpy(const std::string &filename, const void *data, const std::string &dtype, const std::vector<size_t> &shape)
+{
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "WriteNpy Error! Failed to open '" << filename << "' file." << std::endl;
+        return false;
+    }
+
+    // Describe the array in the header (single bytes have no byte order)
+    const unsigned int endian_test = 1;
+    char byte_order = (*(const char *)&endian_test == 1) ? '<' : '>';
+    if (dtype.size() > 1 && dtype[1] == '1') byte_order = '|';
+
+    size_t n_items = 1, item_size = (size_t)std::atoi(dtype.c_str() + 1);
+    std::ostringstream header;
+    header << "{'descr': '" << byte_order << dtype << "', 'fortran_order': False, 'shape': (";
+    for (int i = 0; i < (int)shape.size(); ++i)
+    {
+        header << shape[i] << ((shape.size() == 1 || i + 1 < (int)shape.size()) ? "," : "");
+        if (i + 1 < (int)shape.size()) header << " ";
+        n_items *= shape[i];
+    }
+    header << "), }";
+
+    // Pad the header with spaces, so the data starts at a multiple of 64 bytes
+    std::string header_str = header.str();
+    size_t total_size = 10 + header_str.size() + 1;
+    header_str.append((64 - total_size % 64) % 64, ' ');
+    header_str.push_back('\n');
+
+    unsigned short header_len = (unsigned short)header_str.size();
+    const char magic[] = "\x93NUMPY\x01\x00";
+    file.write(magic, 8);
+    file.put((char)(header_len & 0xFF));
+    file.put((char)(header_len >> 8));
+    file.write(header_str.data(), header_str.size());
+    file.write((const char *)data, n_items * item_size);
+
+    return file.good();
+}
+
+/******************************************************************************/
+/*********************** Local Function Definitions ***************************/
+/******************************************************************************/
+
+// Sample the selected fields on a regular time grid, holding the last received value of each field (the
+// empty values, which are NaN, do not replace it). The grid times before the first number of a field hold
+// that number, so a field is NaN only if it has no numbers. The grid covers the time span in which all the
+// fields have data.
+void WindowBuilder::AlignSequence(const Sequence &sequence, AlignedSequence &out_aligned) const
+{
+    int n_fields = (int)fields.size();
+    std::vector<std::vector<long long> > times(n_fields);
+    std::vector<std::vector<double> > values(n_fields);
+    long long start_time = 0, end_time = 0;
+
+    // Read the times and the values of the fields
+    for (int f = 0; f < n_fields; ++f)
+    {
+        int topic_idx = sequence.FindTopicIndex(fields[f].TopicName);
+        const Topic *topic = (topic_idx >= 0) ? &sequence.Topics[topic_idx] : NULL;
+        if (topic == NULL || topic->FindLabelIndex(fields[f].FieldLabel) < 0 || topic->Messages.empty())
+        {
+            std::cerr << "Build Error! Field '" << fields[f].TopicName << "/" << fields[f].FieldLabel <<
+                "' not found in sequence '" << sequence.Name << "'. Skipping this sequence!" << std::endl;
+            return;
+        }
+
+        times[f] = topic->GetTimesInNanoseconds();
+        values[f] = topic->GetFieldsAsDouble(fields[f].FieldLabel);
+        if (values[f].size() != times[f].size())
+        {
+            std::cerr << "Build Error! Field '" << fields[f].TopicName << "/" << fields[f].FieldLabel <<
+                "' is not numeric in sequence '" << sequence.Name << "'. Skipping this sequence!" << std::endl;
+            return;
+        }
+        if (f == 0 || times[f].front() > start_time) start_time = times[f].front();
+        if (f == 0 || times[f].back() < end_time) end_time = times[f].back();
+    }
+    if (end_time < start_time) return;
+
+    // Hold the last value of each field at each grid time
+    long long period = (long long)(sample_period * 1e9);
+    size_t grid_size = (size_t)((end_time - start_time) / period) + 1;
+    out_aligned.Times.resize(grid_size);
+    out_aligned.Values.resize(grid_size * n_fields);
+    for (size_t g = 0; g < grid_size; ++g)
+        out_aligned.Times[g] = start_time + (long long)g * period;
+
+    for (int f = 0; f < n_fields; ++f)
+    {
+        // Start with the first number of the field (its first values may be empty)
+        size_t curr = 0, first = 0;
+        while (first + 1 < values[f].size() && values[f][first] != values[f][first]) ++first;
+        double held_value = values[f][first];
+        for (size_t g = 0; g < grid_size; ++g)
+        {
+            while (curr + 1 < times[f].size() && times[f][curr + 1] <= out_aligned.Times[g])
+            {
+                ++curr;
+                if (values[f][curr] == values[f][curr]) held_value = values[f][curr];
+            }
+            out_aligned.Values[g * n_fields + f] = (float)held_value;
+        }
+    }
+
+    out_aligned.IsValid = true;
+}
+
+// Find the windows of an aligned sequence and label them according to the label policy
+void WindowBuilder::SelectWindows(const FaultTimeline &faults, AlignedSequence &aligned) const
+{
+    std::vector<unsigned char> labels = faults.GetLabels(aligned.Times);
+
+    // Count the faulty samples with a running sum to label each window in constant time
+    std::vector<int> n_faulty(labels.size() + 1, 0);
+    for (size_t i = 0; i < labels.size(); ++i)
+        n_faulty[i + 1] = n_faulty[i] + labels[i];
+
+    long long margin = (long long)(onset_margin * 1e9);
+    for (int start = 0; start + window_length <= (int)aligned.Times.size(); start += window_stride)
+    {
+        int end = start + window_length - 1;
+        int faulty = n_faulty[end + 1] - n_faulty[start];
+        int label = 0;
+        if (label_policy == LastSample) label = labels[end];
+        else if (label_policy == AnySample) label = (faulty > 0);
+        else label = (faulty == window_length);
+
+        // Skip the normal windows that end right before a fault onset
+        if (label == 0 && margin > 0)
+        {
+            bool near_onset = false;
+            for (int c = 0; c < faults.GetNumberOfChannels() && !near_onset; ++c)
+            {
+                const std::vector<FaultTimeline::Interval> &intervals = faults.GetChannel(c).Intervals;
+                for (int i = 0; i < (int)intervals.size() && !near_onset; ++i)
+                    near_onset = (aligned.Times[end] < intervals[i].Onset && intervals[i].Onset - aligned.Times[end] <= margin);
+            }
+            if (near_onset) continue;
+        }
+
+        aligned.WindowStarts.push_back(start);
+        aligned.WindowLabels.push_back(label);
+    }
+}
+
+// Copy the selected windows of an aligned sequence to their place in the output
+void WindowBuilder::FillWindows(const AlignedSequence &aligned, int sequence_idx, WindowSet &out_windows) const
+{
+    size_t window_size = (size_t)window_length * fields.size();
+    for (size_t w = 0; w < aligned.WindowStarts.size(); ++w)
+    {
+        size_t out_idx = aligned.FirstWindow + w;
+        int start = aligned.WindowStarts[w];
+        std::copy(aligned.Values.begin() + start * fields.size(), aligned.Values.begin() + start * fields.size() + window_size,
+            out_windows.Data.begin() + out_idx * window_size);
+        out_windows.Labels[out_idx] = aligned.WindowLabels[w];
+        out_windows.SequenceIndices[out_idx] = sequence_idx;
+        out_windows.EndTimes[out_idx] = aligned.Times[start + window_length - 1];
+    }
+}
+
+}
+#endif
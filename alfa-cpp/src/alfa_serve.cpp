@@ -0,0 +1,102 @@
+/*  ***************************************************************************
+*   alfa_serve.cpp - Keeps ALFA dataset sequences loaded and serves them to
+*   other local processes over a Unix domain socket.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <signal.h>
+#include "commons.h"
+#include "sequence.h"
+#include "serve.h"
+
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the socket path, the sequence paths and the number of workers from command-line arguments
+    if (argc < 3)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    std::string socket_path = argv[1];
+    alfa::VecString sequence_dirs, sequence_names;
+    int n_threads = 0;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option = argv[i], sequence_dir, sequence_name;
+        if (i + 1 < argc && option == "-j")
+            n_threads = std::atoi(argv[++i]);
+        else if (alfa::Sequence::ParseBagPath(option, sequence_dir, sequence_name))
+        {
+            sequence_dirs.push_back(sequence_dir);
+            sequence_names.push_back(sequence_name);
+        }
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Wait for the termination signals here instead of handling them (blocked before the threads start,
+    // so the threads inherit the mask)
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+    // Load all the sequences once
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    alfa::DatasetServer server(n_threads);
+    int n_loaded = server.LoadSequences(sequence_dirs, sequence_names);
+    double load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Loaded " << n_loaded << " of " << sequence_dirs.size() << " sequences in " << load_time << " s." << std::endl;
+    if (n_loaded == 0) return 0;
+
+    // Serve them until the daemon is stopped
+    if (!server.Start(socket_path)) return 1;
+    std::cout << "Serving on '" << socket_path << "' (press Ctrl+C to stop)..." << std::endl;
+    int signal_number;
+    sigwait(&signals, &signal_number);
+
+    server.Stop();
+    std::cout << "Stopped after " << server.GetNumberOfRequests() << " requests from " << server.GetNumberOfConnections()
+        << " clients." << std::endl;
+    return 0;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the socket path and the paths to one or more sequence bag files!" << std::endl;
+    std::cout << "Options: -j workers (default: one per core)" << std::endl;
+    std::cout << "Usage (in Linux):" << std::endl;
+    std::cout << "./alfa_serve /tmp/alfa.sock path/to/sequence1.bag [path/to/sequence2.bag ...] [-j workers]" << std::endl;
+}
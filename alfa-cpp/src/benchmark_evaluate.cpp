@@ -0,0 +1,218 @@
+/*  ***************************************************************************
+*   benchmark_evaluate.cpp - Measures the throughput of the multi-stream
+*   evaluation server (see evalserver.h) with simulated runs, fault channels
+*   and detectors, and checks its results against the simulated ones.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include "evaluator.h"
+#include "evalserver.h"
+
+// Structure for the simulated fault and detector of a stream (times in nanoseconds since the start of the run)
+struct StreamScenario
+{
+    long long FaultStart, FaultEnd;
+    long long DetectionTime = -1;       // Negative if the detector misses the fault
+    long long FalsePositiveTime = -1;   // Negative if the detector has no false alarm
+};
+
+// Structure for the expected results of the simulated streams
+struct ExpectedResults
+{
+    int NumDetected = 0, NumMissed = 0, NumFalsePositives = 0;
+    long long TotalDelay = 0;
+};
+
+const long long Second = 1000000000LL;
+const long long MessagePeriod = 200000000LL;    // The ground truth topics are published at 5 Hz
+
+StreamScenario CreateScenario(long long run_id, int channel, long long duration);
+void RunProducer(alfa::EvaluationServer &server, int producer, int n_producers, int n_runs, int n_channels,
+    long long duration, ExpectedResults &out_expected, size_t &out_published);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the options from command-line arguments
+    int n_runs = 1000, n_channels = 4, n_producers = 4, n_shards = 0;
+    double duration = 60;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 < argc && option == "-r") n_runs = std::max(1, std::atoi(argv[++i]));
+        else if (i + 1 < argc && option == "-c") n_channels = std::max(1, std::atoi(argv[++i]));
+        else if (i + 1 < argc && option == "-p") n_producers = std::max(1, std::atoi(argv[++i]));
+        else if (i + 1 < argc && option == "-j") n_shards = std::atoi(argv[++i]);
+        else if (i + 1 < argc && option == "-s") duration = std::max(10.0, std::atof(argv[++i]));
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Collect the results like a publisher would (the batches come from all the shards at the same time)
+    alfa::EvaluationServer server(n_shards);
+    std::atomic<long long> total_delay(0);
+    std::atomic<size_t> max_batch(0);
+    server.SetBatchFunction([&total_delay, &max_batch](const std::vector<alfa::EvaluationServer::StreamResult> &batch)
+    {
+        long long delay = 0;
+        for (const alfa::EvaluationServer::StreamResult &result : batch)
+            delay += result.Result.Delay;
+        total_delay.fetch_add(delay, std::memory_order_relaxed);
+        size_t size = max_batch.load(std::memory_order_relaxed);
+        while (batch.size() > size && !max_batch.compare_exchange_weak(size, batch.size(), std::memory_order_relaxed)) {}
+    });
+
+    // Run all the producers at the same time and wait for the server to finish the events
+    std::cout << "Runs: " << n_runs << ", channels: " << n_channels << " (" << (long long)n_runs * n_channels
+        << " streams, " << duration << " s each), producers: " << n_producers << ", shards: " << server.GetNumberOfShards() << std::endl;
+    server.Start();
+    std::vector<ExpectedResults> expected(n_producers);
+    std::vector<size_t> published(n_producers, 0);
+    std::vector<std::thread> producers;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int p = 0; p < n_producers; ++p)
+        producers.push_back(std::thread(RunProducer, std::ref(server), p, n_producers, n_runs, n_channels,
+            (long long)(duration * Second), std::ref(expected[p]), std::ref(published[p])));
+    for (std::thread &thread : producers)
+        thread.join();
+    double publish_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.Close();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Compare the results with the simulated ones
+    ExpectedResults total;
+    size_t n_published = 0;
+    for (int p = 0; p < n_producers; ++p)
+    {
+        total.NumDetected += expected[p].NumDetected;
+        total.NumMissed += expected[p].NumMissed;
+        total.NumFalsePositives += expected[p].NumFalsePositives;
+        total.TotalDelay += expected[p].TotalDelay;
+        n_published += published[p];
+    }
+    alfa::EvaluationServer::ServerStats stats = server.GetStats();
+    bool is_correct = stats.NumDetected == total.NumDetected && stats.NumMissed == total.NumMissed &&
+        stats.NumFalsePositives == total.NumFalsePositives && total_delay == total.TotalDelay;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Published " << n_published << " events in " << publish_time * 1e3 << " ms, evaluated in "
+        << elapsed * 1e3 << " ms: " << n_published / elapsed << " events/s (" << stats.Events << " shard events)" << std::endl;
+    std::cout << "Results: " << stats.Results << " in " << stats.Batches << " batches (largest " << max_batch << "), max lag: "
+        << stats.MaxLag << " events, publishers blocked: " << stats.BlockedTime * 1e3 << " ms" << std::endl;
+    std::cout << "Detected: " << stats.NumDetected << "/" << total.NumDetected << ", missed: " << stats.NumMissed << "/"
+        << total.NumMissed << ", false positives: " << stats.NumFalsePositives << "/" << total.NumFalsePositives
+        << ", total delay: " << total_delay / 1e9 << "/" << total.TotalDelay / 1e9 << " s -> "
+        << (is_correct ? "correct" : "MISMATCH") << std::endl;
+
+    return is_correct ? 0 : 1;
+}
+
+// Create the fault of a stream: it starts between 10% and 60% of the run and lasts 5 to 30 seconds. Most
+// detectors find it within 4 seconds, a quarter miss it, and some raise a false alarm before it.
+StreamScenario CreateScenario(long long run_id, int channel, long long duration)
+{
+    std::mt19937_64 random((unsigned long long)run_id * 1000003ULL + (unsigned long long)channel);
+    StreamScenario scenario;
+    long long n_periods = duration / MessagePeriod;
+    scenario.FaultStart = (n_periods / 10 + (long long)(random() % (unsigned long long)(n_periods / 2))) * MessagePeriod;
+    scenario.FaultEnd = std::min(duration, scenario.FaultStart + 5 * Second + (long long)(random() % (25 * Second)));
+    if (random() % 4 != 0)
+        scenario.DetectionTime = scenario.FaultStart + Second / 10 + (long long)(random() % (4 * Second - Second / 10));
+    if (random() % 7 == 0 && scenario.FaultStart > 3 * Second)
+        scenario.FalsePositiveTime = Second + (long long)(random() % (unsigned long long)(scenario.FaultStart - 2 * Second));
+    return scenario;
+}
+
+// Publish the simulated runs of a producer in the order of their times, as many flights that are running
+// at the same time: each tick has the ground truth messages of all the channels and a clock event of each run
+void RunProducer(alfa::EvaluationServer &server, int producer, int n_producers, int n_runs, int n_channels,
+    long long duration, ExpectedResults &out_expected, size_t &out_published)
+{
+    std::vector<long long> run_ids;
+    std::vector<StreamScenario> scenarios;
+    for (long long run_id = producer; run_id < n_runs; run_id += n_producers)
+    {
+        run_ids.push_back(run_id);
+        for (int c = 0; c < n_channels; ++c)
+        {
+            StreamScenario scenario = CreateScenario(run_id, c, duration);
+            if (scenario.DetectionTime >= 0)
+            {
+                ++out_expected.NumDetected;
+                out_expected.TotalDelay += scenario.DetectionTime - scenario.FaultStart;
+            }
+            else
+                ++out_expected.NumMissed;
+            if (scenario.FalsePositiveTime >= 0) ++out_expected.NumFalsePositives;
+            scenarios.push_back(scenario);
+        }
+    }
+
+    size_t n_published = 0;
+    for (long long time = 0; time <= duration; time += MessagePeriod)
+        for (size_t r = 0; r < run_ids.size(); ++r)
+        {
+            for (int c = 0; c < n_channels; ++c)
+            {
+                // The detections since the previous tick come before the ground truth of this tick
+                const StreamScenario &scenario = scenarios[r * n_channels + c];
+                for (long long detection_time : { scenario.FalsePositiveTime, scenario.DetectionTime })
+                    if (detection_time >= 0 && detection_time > time - MessagePeriod && detection_time <= time)
+                    {
+                        server.AddDetection(run_ids[r], c, detection_time);
+                        ++n_published;
+                    }
+                server.AddGroundTruth(run_ids[r], c, time, time >= scenario.FaultStart && time < scenario.FaultEnd);
+                ++n_published;
+            }
+            server.AdvanceRun(run_ids[r], time);
+            ++n_published;
+        }
+
+    for (size_t r = 0; r < run_ids.size(); ++r)
+        server.FinishRun(run_ids[r], duration);
+    out_published = n_published + run_ids.size();
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Options: -r runs (default: 1000), -c fault channels per run (default: 4), -p producers (default: 4)," << std::endl;
+    std::cout << "         -j shards (default: one per core), -s duration of the runs in seconds (default: 60)" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./benchmark_evaluate [-r runs] [-c channels] [-p producers] [-j shards] [-s seconds]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "benchmark_evaluate.exe [-r runs] [-c channels] [-p producers] [-j shards] [-s seconds]" << std::endl;
+}
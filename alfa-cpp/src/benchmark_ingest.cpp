@@ -0,0 +1,188 @@
+/*  ***************************************************************************
+*   benchmark_ingest.cpp - Compares reading the topic files of ALFA dataset
+*   sequences one by one with the batched reading (io_uring, or readahead
+*   hints and a thread pool) on a cold page cache.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <cstdlib>
+#include "commons.h"
+#include "sequence.h"
+#include "ingest.h"
+
+size_t ReadFilesOneByOne(const alfa::VecString &paths);
+size_t ReadFilesInBatch(const alfa::VecString &paths, bool use_io_uring);
+size_t LoadSequencesOneByOne(const alfa::VecString &dirs, const alfa::VecString &names);
+size_t LoadSequencesInBatch(const alfa::VecString &dirs, const alfa::VecString &names);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence paths and the number of repetitions from command-line arguments
+    alfa::VecString sequence_dirs, sequence_names, topic_paths;
+    int n_repeats = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i], sequence_dir, sequence_name;
+        if (i + 1 < argc && option == "-r")
+            n_repeats = std::max(1, std::atoi(argv[++i]));
+        else if (alfa::Sequence::ParseBagPath(option, sequence_dir, sequence_name))
+        {
+            sequence_dirs.push_back(sequence_dir);
+            sequence_names.push_back(sequence_name);
+        }
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+    if (sequence_dirs.empty())
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Find the topic files of the sequences (the CSV files starting with the sequence names)
+    for (int s = 0; s < (int)sequence_dirs.size(); ++s)
+    {
+        alfa::VecString files = alfa::Commons::FilterFileList(alfa::Commons::GetFileList(sequence_dirs[s]),
+            alfa::Commons::CSVFileExtension);
+        for (const std::string &file : files)
+            if (file.compare(0, sequence_names[s].size(), sequence_names[s]) == 0)
+                topic_paths.push_back(sequence_dirs[s] + file);
+    }
+    size_t total_bytes = 0;
+    for (const std::string &path : topic_paths)
+    {
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        total_bytes += (size_t)ifs.tellg();
+    }
+
+    // Check that the pages of the files can be dropped
+    if (topic_paths.empty() || !alfa::FileIngestor::EvictFromPageCache(topic_paths[0]))
+        std::cerr << "Warning! The page cache cannot be dropped, so the runs are not on a cold cache." << std::endl;
+
+    // Each method starts on a cold page cache: the pages of the topic files are dropped before every run
+    struct Method { std::string Name; std::function<size_t()> Run; };
+    std::vector<Method> methods = {
+        { "Read files one by one", [&]() { return ReadFilesOneByOne(topic_paths); } },
+        { "Read in batch (readahead)", [&]() { return ReadFilesInBatch(topic_paths, false); } },
+    };
+    if (alfa::FileIngestor::IsIOUringAvailable())
+        methods.push_back({ "Read in batch (io_uring)", [&]() { return ReadFilesInBatch(topic_paths, true); } });
+    methods.push_back({ "Load sequences one by one", [&]() { return LoadSequencesOneByOne(sequence_dirs, sequence_names); } });
+    methods.push_back({ "Load sequences in batch", [&]() { return LoadSequencesInBatch(sequence_dirs, sequence_names); } });
+
+    std::cout << "Sequences: " << sequence_dirs.size() << ", topic files: " << topic_paths.size() << " ("
+        << total_bytes / 1e6 << " MB), best of " << n_repeats << " cold runs" << std::endl;
+    double read_baseline = 0, load_baseline = 0;
+    for (const Method &method : methods)
+    {
+        double best = 1e30;
+        size_t result = 0;
+        for (int r = 0; r < n_repeats; ++r)
+        {
+            for (const std::string &path : topic_paths)
+                alfa::FileIngestor::EvictFromPageCache(path);
+
+            auto start = std::chrono::steady_clock::now();
+            result = method.Run();
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        // The reading methods are compared with the first one and the loading methods with the first load
+        bool is_load = (method.Name.compare(0, 4, "Load") == 0);
+        double &baseline = is_load ? load_baseline : read_baseline;
+        if (baseline == 0) baseline = best;
+
+        std::cout << std::left << std::setw(30) << method.Name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(9) << total_bytes / best / 1e6 << " MB/s" << std::setw(8) << baseline / best << "x"
+            << std::setw(12) << result << (is_load ? " messages" : " bytes") << std::endl;
+    }
+
+    return 0;
+}
+
+// Read the files one after another with ifstream (as Topic::ReadFromFile does). Returns the number of bytes.
+size_t ReadFilesOneByOne(const alfa::VecString &paths)
+{
+    size_t n_bytes = 0;
+    for (const std::string &path : paths)
+    {
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        std::string data((size_t)ifs.tellg(), '\0');
+        ifs.seekg(0);
+        ifs.read(&data[0], data.size());
+        n_bytes += data.size();
+    }
+    return n_bytes;
+}
+
+// Read the files in one batch without processing them. Returns the number of bytes.
+size_t ReadFilesInBatch(const alfa::VecString &paths, bool use_io_uring)
+{
+    alfa::FileIngestor ingestor;
+    ingestor.SetUseIOUring(use_io_uring);
+    for (const std::string &path : paths)
+        ingestor.AddFile(path);
+    ingestor.ReadAll([](int, std::string &) {});
+    return ingestor.GetBytesRead();
+}
+
+// Load the sequences one after another, reading their topic files one by one. Returns the number of messages.
+size_t LoadSequencesOneByOne(const alfa::VecString &dirs, const alfa::VecString &names)
+{
+    size_t n_messages = 0;
+    for (int s = 0; s < (int)dirs.size(); ++s)
+        n_messages += alfa::Sequence(dirs[s], names[s]).MessageIndexList.size();
+    return n_messages;
+}
+
+// Load all the sequences at once, reading all their topic files in one batch. Returns the number of messages.
+size_t LoadSequencesInBatch(const alfa::VecString &dirs, const alfa::VecString &names)
+{
+    std::vector<alfa::Sequence> sequences;
+    alfa::Sequence::LoadSequences(sequences, dirs, names);
+    size_t n_messages = 0;
+    for (const alfa::Sequence &sequence : sequences)
+        n_messages += sequence.MessageIndexList.size();
+    return n_messages;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the paths to one or more sequence bag files!" << std::endl;
+    std::cout << "Options: -r repetitions (default: 3)" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./benchmark_ingest path/to/sequence1.bag [path/to/sequence2.bag ...] [-r repetitions]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "benchmark_ingest.exe path\\to\\sequence1.bag [path\\to\\sequence2.bag ...] [-r repetitions]" << std::endl;
+}
@@ -0,0 +1,199 @@
+/*  ***************************************************************************
+*   benchmark_parse.cpp - Compares the speed of the number and the epoch
+*   timestamp parsers with the previous (strtold/strtoll based) conversions
+*   on the fields of an ALFA dataset topic file.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include "commons.h"
+#include "numparse.h"
+
+double LegacyStringToDouble(const std::string &str);
+long long LegacyStringToLongLong(const std::string &str);
+alfa::DateTime LegacyEpochStringToTime(const std::string &epoch);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the topic file path and the number of repetitions from command-line arguments
+    if (argc < 2)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    int n_repeats = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 5;
+
+    // Read the fields of the file: the time, the header integers and the real numbers
+    std::ifstream ifs(argv[1]);
+    if (!ifs.is_open())
+    {
+        std::cerr << "Failed to open '" << argv[1] << "' file." << std::endl;
+        return 0;
+    }
+    alfa::VecString times, integers, reals;
+    std::string line;
+    std::getline(ifs, line);
+    while (std::getline(ifs, line))
+    {
+        alfa::VecString tokens = alfa::Commons::Tokenize(line, alfa::Commons::CSVDelimiter);
+        if (tokens.size() < 4) continue;
+        times.push_back(tokens[0]);
+        integers.push_back(tokens[1]);
+        integers.push_back(tokens[2]);
+        for (size_t i = 4; i < tokens.size(); ++i)
+            reals.push_back(tokens[i]);
+    }
+
+    // Each benchmark converts all the values of a kind and sums them (so the work is not optimized away)
+    struct Method { std::string Name; const alfa::VecString *Values; double (*Run)(const alfa::VecString &); bool IsBaseline; };
+    Method methods[] = {
+        { "strtold (narrowed) doubles", &reals, [](const alfa::VecString &v) {
+            double sum = 0;
+            for (const std::string &s : v) sum += LegacyStringToDouble(s);
+            return sum; }, true },
+        { "NumberParser::ParseDouble", &reals, [](const alfa::VecString &v) {
+            double sum = 0, number = 0;
+            for (const std::string &s : v)
+                if (alfa::NumberParser::ParseDouble(s.data(), s.data() + s.size(), number)) sum += number;
+            return sum; }, false },
+        { "Commons::StringToDouble", &reals, [](const alfa::VecString &v) {
+            double sum = 0, number = 0;
+            for (const std::string &s : v)
+                if (alfa::Commons::StringToDouble(s, number)) sum += number;
+            return sum; }, false },
+        { "strtoll integers", &integers, [](const alfa::VecString &v) {
+            double sum = 0;
+            for (const std::string &s : v) sum += (double)LegacyStringToLongLong(s);
+            return sum; }, true },
+        { "NumberParser::ParseInt64", &integers, [](const alfa::VecString &v) {
+            double sum = 0;
+            long long number = 0;
+            for (const std::string &s : v)
+                if (alfa::NumberParser::ParseInt64(s.data(), s.data() + s.size(), number)) sum += (double)number;
+            return sum; }, false },
+        { "substr + localtime epochs", &times, [](const alfa::VecString &v) {
+            double sum = 0;
+            for (const std::string &s : v) sum += LegacyEpochStringToTime(s).Second;
+            return sum; }, true },
+        { "DateTime::EpochStringToTime", &times, [](const alfa::VecString &v) {
+            double sum = 0;
+            for (const std::string &s : v) sum += alfa::DateTime::EpochStringToTime(s).Second;
+            return sum; }, false },
+    };
+
+    std::cout << "File: " << argv[1] << ", best of " << n_repeats << " runs" << std::endl;
+    double baseline = 0;
+    for (const Method &method : methods)
+    {
+        double best = 1e30;
+        for (int r = 0; r < n_repeats; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            volatile double sum = method.Run(*method.Values);
+            (void)sum;
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        if (method.IsBaseline) baseline = best;
+
+        std::cout << std::left << std::setw(30) << method.Name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(9) << method.Values->size() / best / 1e6 << " M values/s" << std::setw(8) << baseline / best << "x"
+            << std::setw(12) << method.Values->size() << " values" << std::endl;
+    }
+
+    // Count the values that are converted differently (the narrowed long doubles may be 1 ulp off)
+    size_t n_different = 0, n_different_times = 0;
+    for (const std::string &s : reals)
+    {
+        double number = 0, legacy_number = LegacyStringToDouble(s);
+        alfa::Commons::StringToDouble(s, number);
+        if (std::memcmp(&number, &legacy_number, sizeof(number)) != 0) ++n_different;
+    }
+    for (const std::string &s : times)
+        if (alfa::DateTime::EpochStringToTime(s) != LegacyEpochStringToTime(s)) ++n_different_times;
+    std::cout << "Different doubles: " << n_different << " of " << reals.size() << ", different times: "
+        << n_different_times << " of " << times.size() << std::endl;
+
+    return 0;
+}
+
+// The previous conversion of a string to a double (through a long double)
+double LegacyStringToDouble(const std::string &str)
+{
+    char *endptr;
+    long double value = std::strtold(str.c_str(), &endptr);
+    return (*endptr != '\0') ? 0 : (double)value;
+}
+
+// The previous conversion of a string to a long long integer
+long long LegacyStringToLongLong(const std::string &str)
+{
+    char *endptr;
+    long long value = std::strtoll(str.c_str(), &endptr, 10);
+    return (*endptr != '\0') ? 0 : value;
+}
+
+// The previous conversion of a UNIX epoch string in nanoseconds to a DateTime object
+alfa::DateTime LegacyEpochStringToTime(const std::string &epoch)
+{
+    alfa::DateTime dt;
+
+    // Split the seconds and the nanoseconds (last 9 digits) and convert them
+    std::string nano_str = (epoch.size() < 9) ? epoch : epoch.substr(epoch.size() - 9, 9);
+    std::string sec_str = epoch.substr(0, epoch.size() - nano_str.size());
+    dt.Nanosecond = (int)LegacyStringToLongLong(nano_str);
+    std::time_t time = (std::time_t)LegacyStringToLongLong(sec_str);
+
+    // Convert to the local time
+    std::tm temp_tm;
+#if defined _WIN32
+    localtime_s(&temp_tm, &time);
+#else
+    localtime_r(&time, &temp_tm);
+#endif
+    dt.Year = 1900 + temp_tm.tm_year;
+    dt.Month = temp_tm.tm_mon + 1;
+    dt.Day = temp_tm.tm_mday;
+    dt.Hour = temp_tm.tm_hour;
+    dt.Minute = temp_tm.tm_min;
+    dt.Second = temp_tm.tm_sec;
+
+    return dt;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the path to a topic CSV file!" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./benchmark_parse path/to/topic.csv [repetitions]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "benchmark_parse.exe path\\to\\topic.csv [repetitions]" << std::endl;
+}
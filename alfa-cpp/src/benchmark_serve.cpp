@@ -0,0 +1,226 @@
+/*  ***************************************************************************
+*   benchmark_serve.cpp - Measures the latency and the throughput of the
+*   dataset server (see serve.h) with many concurrent local clients.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+#include "commons.h"
+#include "sequence.h"
+#include "serve.h"
+
+// Structure for the measurements of a request type
+struct RequestStats
+{
+    std::vector<double> Latencies;      // Latency of each request in microseconds
+    size_t Bytes = 0;                   // Total size of the responses
+    size_t Failures = 0;
+};
+
+// Structure for a numeric field to request
+struct FieldChoice
+{
+    std::string SequenceName, TopicName, FieldLabel;
+    long long StartTime, EndTime;
+};
+
+void RunClient(const std::string &socket_path, const std::vector<FieldChoice> &fields, int n_requests, int seed,
+    std::vector<RequestStats> &out_stats);
+void PrintStats(const std::string &title, RequestStats &stats, double elapsed);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence paths and the options from command-line arguments
+    alfa::VecString sequence_dirs, sequence_names;
+    int n_clients = 32, n_requests = 300, n_threads = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i], sequence_dir, sequence_name;
+        if (i + 1 < argc && option == "-c") n_clients = std::max(1, std::atoi(argv[++i]));
+        else if (i + 1 < argc && option == "-n") n_requests = std::max(1, std::atoi(argv[++i]));
+        else if (i + 1 < argc && option == "-j") n_threads = std::atoi(argv[++i]);
+        else if (alfa::Sequence::ParseBagPath(option, sequence_dir, sequence_name))
+        {
+            sequence_dirs.push_back(sequence_dir);
+            sequence_names.push_back(sequence_name);
+        }
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+    if (sequence_dirs.empty())
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Load the sequences in the server (this is what each tool pays without the server)
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    alfa::DatasetServer server(n_threads);
+    if (server.LoadSequences(sequence_dirs, sequence_names) == 0) return 0;
+    double load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::string socket_path = "/tmp/alfa_benchmark_serve_" + std::to_string((long long)getpid()) + ".sock";
+    if (!server.Start(socket_path)) return 0;
+
+    // A new client gets the list of the numeric fields (also the time to the first answer of a new tool)
+    start = std::chrono::steady_clock::now();
+    alfa::DatasetClient client;
+    std::vector<alfa::DatasetClient::SequenceInfo> sequences;
+    std::vector<FieldChoice> fields;
+    if (!client.Connect(socket_path) || !client.ListSequences(sequences)) return 0;
+    for (const alfa::DatasetClient::SequenceInfo &sequence : sequences)
+    {
+        std::vector<alfa::DatasetClient::TopicInfo> topics;
+        client.ListTopics(sequence.Name, topics);
+        for (const alfa::DatasetClient::TopicInfo &topic : topics)
+            for (size_t f = 0; f < topic.FieldLabels.size(); ++f)
+                if (topic.FieldTypes[f] == alfa::Topic::Float64 && topic.NumberOfMessages > 1)
+                    fields.push_back({ sequence.Name, topic.Name, topic.FieldLabels[f], topic.StartTime, topic.EndTime });
+    }
+    double first_answer_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    client.Disconnect();
+    if (fields.empty())
+    {
+        std::cerr << "No numeric fields found in the sequences." << std::endl;
+        return 0;
+    }
+
+    // Run all the clients at the same time
+    std::cout << "Sequences: " << sequences.size() << " (loaded in " << load_time << " s, listed by a new client in "
+        << first_answer_time * 1e3 << " ms), numeric fields: " << fields.size() << std::endl;
+    std::cout << "Clients: " << n_clients << ", requests per client: " << n_requests << std::endl;
+    std::vector<std::vector<RequestStats> > client_stats(n_clients);
+    std::vector<std::thread> clients;
+    start = std::chrono::steady_clock::now();
+    for (int c = 0; c < n_clients; ++c)
+        clients.push_back(std::thread(RunClient, socket_path, std::cref(fields), n_requests, c, std::ref(client_stats[c])));
+    for (std::thread &thread : clients)
+        thread.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.Stop();
+
+    // Merge the measurements of the clients
+    const char *titles[] = { "ListTopics", "GetFieldSlice", "GetAlignedMatrix", "All requests" };
+    std::vector<RequestStats> stats(4);
+    for (int c = 0; c < n_clients; ++c)
+        for (int t = 0; t < 3; ++t)
+        {
+            const RequestStats &client_stat = client_stats[c][t];
+            for (RequestStats *merged : { &stats[t], &stats[3] })
+            {
+                merged->Latencies.insert(merged->Latencies.end(), client_stat.Latencies.begin(), client_stat.Latencies.end());
+                merged->Bytes += client_stat.Bytes;
+                merged->Failures += client_stat.Failures;
+            }
+        }
+    for (int t = 0; t < 4; ++t)
+        PrintStats(titles[t], stats[t], elapsed);
+
+    return 0;
+}
+
+// Send a mix of requests: a tenth lists the topics, and the rest get the values of a random field (or an
+// aligned matrix of three random fields at 25 Hz) in a random window of 10 seconds
+void RunClient(const std::string &socket_path, const std::vector<FieldChoice> &fields, int n_requests, int seed,
+    std::vector<RequestStats> &out_stats)
+{
+    out_stats.assign(3, RequestStats());
+    alfa::DatasetClient client;
+    if (!client.Connect(socket_path)) return;
+
+    std::mt19937 random(seed);
+    const long long window = 10000000000LL, period = 40000000LL;
+    for (int i = 0; i < n_requests; ++i)
+    {
+        const FieldChoice &field = fields[random() % fields.size()];
+        long long span = std::max(1LL, field.EndTime - field.StartTime - window);
+        long long start_time = field.StartTime + (long long)(random() % (unsigned long long)span);
+        int type = (i % 10 == 0) ? 0 : 1 + (int)(random() % 2);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool is_served;
+        if (type == 0)
+        {
+            std::vector<alfa::DatasetClient::TopicInfo> topics;
+            is_served = client.ListTopics(field.SequenceName, topics);
+        }
+        else if (type == 1)
+        {
+            alfa::DatasetClient::FieldSlice slice;
+            is_served = client.GetFieldSlice(field.SequenceName, field.TopicName, field.FieldLabel, slice,
+                start_time, start_time + window);
+        }
+        else
+        {
+            // Take the other fields of the matrix from the same sequence
+            alfa::VecString topic_names, field_labels;
+            for (int k = 0; k < 3; ++k)
+            {
+                const FieldChoice *other = &fields[random() % fields.size()];
+                if (other->SequenceName != field.SequenceName) other = &field;
+                topic_names.push_back(other->TopicName);
+                field_labels.push_back(other->FieldLabel);
+            }
+            alfa::DatasetClient::AlignedMatrix matrix;
+            is_served = client.GetAlignedMatrix(field.SequenceName, topic_names, field_labels, period, matrix,
+                start_time, start_time + window);
+        }
+        double latency = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        out_stats[type].Latencies.push_back(latency);
+        out_stats[type].Bytes += client.GetLastResponseSize();
+        if (!is_served) ++out_stats[type].Failures;
+    }
+}
+
+// Print the throughput and the latency percentiles of a request type
+void PrintStats(const std::string &title, RequestStats &stats, double elapsed)
+{
+    if (stats.Latencies.empty()) return;
+    std::sort(stats.Latencies.begin(), stats.Latencies.end());
+    size_t n = stats.Latencies.size();
+    std::cout << std::left << std::setw(18) << title << std::right << std::fixed << std::setprecision(1)
+        << std::setw(9) << n / elapsed << " req/s" << std::setw(8) << stats.Bytes / elapsed / 1e6 << " MB/s"
+        << "   latency (us): median " << stats.Latencies[n / 2] << ", 99% " << stats.Latencies[std::min(n - 1, n * 99 / 100)]
+        << ", max " << stats.Latencies.back() << "   failures: " << stats.Failures << std::endl;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the paths to one or more sequence bag files!" << std::endl;
+    std::cout << "Options: -c clients (default: 32), -n requests per client (default: 300), -j server workers" << std::endl;
+    std::cout << "Usage (in Linux):" << std::endl;
+    std::cout << "./benchmark_serve path/to/sequence1.bag [path/to/sequence2.bag ...] [-c clients] [-n requests] [-j workers]" << std::endl;
+}
@@ -0,0 +1,154 @@
+/*  ***************************************************************************
+*   benchmark_tokenize.cpp - Compares the speed of the vectorized CSV scanner
+*   with the line tokenizer on the lines of an ALFA dataset topic file.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include "commons.h"
+#include "csvscan.h"
+
+size_t TokenizeLines(const std::string &data);
+size_t ScanAndTokenize(const std::string &data, bool use_vector_instructions);
+size_t ScanOnly(const std::string &data, bool use_vector_instructions);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the topic file path and the number of repetitions from command-line arguments
+    if (argc < 2)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    int n_repeats = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 5;
+
+    // Read the whole file
+    std::ifstream ifs(argv[1], std::ios::binary);
+    if (!ifs.is_open())
+    {
+        std::cerr << "Failed to open '" << argv[1] << "' file." << std::endl;
+        return 0;
+    }
+    std::stringstream contents;
+    contents << ifs.rdbuf();
+    std::string data = contents.str();
+
+    // Run each method a few times and keep the best time
+    struct Method { std::string Name; size_t (*Run)(const std::string &); };
+    Method methods[] = {
+        { "Commons::Tokenize per line", [](const std::string &d) { return TokenizeLines(d); } },
+        { "Scalar scan + tokens", [](const std::string &d) { return ScanAndTokenize(d, false); } },
+        { alfa::CSVScanner::GetInstructionSet() + " scan + tokens", [](const std::string &d) { return ScanAndTokenize(d, true); } },
+        { "Scalar scan only", [](const std::string &d) { return ScanOnly(d, false); } },
+        { alfa::CSVScanner::GetInstructionSet() + " scan only", [](const std::string &d) { return ScanOnly(d, true); } },
+    };
+
+    std::cout << "File: " << argv[1] << " (" << data.size() / 1e6 << " MB), best of " << n_repeats << " runs" << std::endl;
+    double baseline = 0;
+    for (const Method &method : methods)
+    {
+        double best = 1e30;
+        size_t n_tokens = 0;
+        for (int r = 0; r < n_repeats; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            n_tokens = method.Run(data);
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        if (baseline == 0) baseline = best;
+
+        std::cout << std::left << std::setw(30) << method.Name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(9) << data.size() / best / 1e6 << " MB/s" << std::setw(8) << baseline / best << "x"
+            << std::setw(12) << n_tokens << " separators/tokens" << std::endl;
+    }
+
+    return 0;
+}
+
+// Split the data to lines and tokenize each line with Commons::Tokenize. Returns the number of tokens.
+size_t TokenizeLines(const std::string &data)
+{
+    size_t n_tokens = 0, pos = 0;
+    while (pos < data.size())
+    {
+        size_t line_end = std::min(data.find('\n', pos), data.size());
+        n_tokens += alfa::Commons::Tokenize(data.substr(pos, line_end - pos), alfa::Commons::CSVDelimiter).size();
+        pos = line_end + 1;
+    }
+    return n_tokens;
+}
+
+// Find the separators of the data and copy the tokens of each line. Returns the number of tokens.
+size_t ScanAndTokenize(const std::string &data, bool use_vector_instructions)
+{
+    std::vector<uint32_t> separators;
+    if (use_vector_instructions)
+        alfa::CSVScanner::FindSeparators(data.data(), data.size(), alfa::Commons::CSVDelimiter, separators);
+    else
+        alfa::CSVScanner::FindSeparatorsScalar(data.data(), data.size(), alfa::Commons::CSVDelimiter, separators);
+
+    // Copy the tokens between the separators (the last empty token of a line is dropped, as in Commons::Tokenize)
+    size_t n_tokens = 0, start = 0;
+    std::vector<std::string> tokens;
+    for (size_t s = 0; s <= separators.size(); ++s)
+    {
+        size_t end = (s < separators.size()) ? separators[s] : data.size();
+        if (start < end || (end < data.size() && data[end] != '\n'))
+            tokens.push_back(data.substr(start, end - start));
+        if (end == data.size() || data[end] == '\n')
+        {
+            n_tokens += tokens.size();
+            tokens.clear();
+        }
+        start = end + 1;
+    }
+    return n_tokens;
+}
+
+// Only find the separators of the data. Returns the number of separators.
+size_t ScanOnly(const std::string &data, bool use_vector_instructions)
+{
+    std::vector<uint32_t> separators;
+    if (use_vector_instructions)
+        alfa::CSVScanner::FindSeparators(data.data(), data.size(), alfa::Commons::CSVDelimiter, separators);
+    else
+        alfa::CSVScanner::FindSeparatorsScalar(data.data(), data.size(), alfa::Commons::CSVDelimiter, separators);
+    return separators.size();
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the path to a topic CSV file!" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./benchmark_tokenize path/to/topic.csv [repetitions]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "benchmark_tokenize.exe path\\to\\topic.csv [repetitions]" << std::endl;
+}
@@ -0,0 +1,189 @@
+/*  ***************************************************************************
+*   evaluate.cpp - Evaluates the detections of a fault detector against the
+*   fault ground truth of an ALFA dataset sequence offline (as alfa-evaluate
+*   does on the live topics).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cctype>
+#include "commons.h"
+#include "sequence.h"
+#include "faults.h"
+#include "evaluator.h"
+
+bool ReadDetectionFile(const std::string &filename, std::vector<long long> &out_times);
+void PrintResult(const alfa::FaultEvaluator::Result &result, long long start_time);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence path and the options from command-line arguments
+    std::string sequence_dir, sequence_name;
+    if (argc < 2 || !alfa::Sequence::ParseBagPath(argv[1], sequence_dir, sequence_name))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    std::string detection_file, detection_topic;
+    double timeout = alfa::FaultEvaluator::DefaultTimeout, gap_threshold = alfa::FaultEvaluator::DefaultGapThreshold;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 < argc && option == "-d") detection_file = argv[++i];
+        else if (i + 1 < argc && option == "-t") detection_topic = argv[++i];
+        else if (i + 1 < argc && option == "-o") timeout = std::atof(argv[++i]);
+        else if (i + 1 < argc && option == "-g") gap_threshold = std::atof(argv[++i]);
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Read the sequence from the given directory
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 0;
+
+    // Read the detection times from a file or a topic of the sequence
+    std::vector<long long> detection_times;
+    if (!detection_file.empty() && !ReadDetectionFile(detection_file, detection_times)) return 0;
+    int detection_topic_idx = detection_topic.empty() ? -1 : sequence.FindTopicIndex(detection_topic);
+    if (!detection_topic.empty() && detection_topic_idx < 0)
+    {
+        std::cerr << "Error! '" << detection_topic << "' topic not found in the sequence." << std::endl;
+        return 0;
+    }
+    if (detection_topic_idx >= 0 && sequence.Topics[detection_topic_idx].IsFaultTopic())
+    {
+        std::cerr << "Error! '" << detection_topic << "' topic is a fault ground truth topic." << std::endl;
+        return 0;
+    }
+    std::sort(detection_times.begin(), detection_times.end());
+
+    // Feed the fault messages and the detections to the evaluator in the order of their times
+    alfa::FaultEvaluator evaluator(timeout);
+    evaluator.SetGapThreshold(gap_threshold);
+    std::vector<alfa::FaultEvaluator::Result> results;
+    evaluator.SetResultFunction([&results](const alfa::FaultEvaluator::Result &result) { results.push_back(result); });
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t next_detection = 0, n_events = 0;
+    for (const alfa::Sequence::MessageIndex &index : sequence.MessageIndexList)
+    {
+        const alfa::Topic &topic = sequence.Topics[index.TopicIdx];
+        if (!topic.IsFaultTopic() && index.TopicIdx != detection_topic_idx) continue;
+        const alfa::Message &message = topic.Messages[index.MessageIdx];
+        long long time = message.DateTime.ToNanoseconds();
+
+        for (; next_detection < detection_times.size() && detection_times[next_detection] <= time; ++next_detection, ++n_events)
+            evaluator.AddDetection(detection_times[next_detection]);
+
+        bool is_active = alfa::FaultTimeline::IsActiveMessage(message);
+        if (index.TopicIdx == detection_topic_idx)
+        {
+            if (is_active) evaluator.AddDetection(time);
+        }
+        else
+            evaluator.AddGroundTruth(time, is_active, index.TopicIdx);     // Each fault topic is a channel
+        ++n_events;
+    }
+    for (; next_detection < detection_times.size(); ++next_detection, ++n_events)
+        evaluator.AddDetection(detection_times[next_detection]);
+    evaluator.Finish();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Print the results with the times since the start of the sequence
+    long long start_time = 0;
+    if (!sequence.MessageIndexList.empty())
+        start_time = sequence.GetMessage(0).DateTime.ToNanoseconds();
+    std::cout << "Sequence: " << sequence.Name << " (timeout " << timeout << " s)" << std::endl;
+    for (const alfa::FaultEvaluator::Result &result : results)
+        PrintResult(result, start_time);
+
+    const alfa::FaultEvaluator::Summary &summary = evaluator.GetSummary();
+    std::cout << "Detected: " << summary.NumDetected << ", missed: " << summary.NumMissed << ", false positives: "
+        << summary.NumFalsePositives;
+    if (summary.NumDetected > 0)
+        std::cout << std::fixed << std::setprecision(9) << ", mean delay: " << summary.TotalDelay / 1e9 / summary.NumDetected
+            << " s, max delay: " << summary.MaxDelay / 1e9 << " s";
+    std::cout << std::endl;
+    std::cout << std::defaultfloat << n_events << " events evaluated in " << elapsed * 1e3 << " ms" << std::endl;
+
+    return 0;
+}
+
+// Read the detection times (nanoseconds) from the first column of a CSV file, e.g., a /detection topic
+// saved with "rostopic echo -p". The lines that do not start with a number (e.g., the header) are skipped.
+bool ReadDetectionFile(const std::string &filename, std::vector<long long> &out_times)
+{
+    std::ifstream ifs(filename);
+    if (!ifs.is_open())
+    {
+        std::cerr << "Error! Failed to open '" << filename << "' file." << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        if (line.empty() || !std::isdigit((unsigned char)line[0])) continue;
+        long long time;
+        if (alfa::Commons::StringToLongLong(line.substr(0, line.find(',')), time))
+            out_times.push_back(time);
+    }
+    return true;
+}
+
+// Print an evaluation result with the times since the start of the sequence (seconds)
+void PrintResult(const alfa::FaultEvaluator::Result &result, long long start_time)
+{
+    std::cout << std::fixed << std::setprecision(9);
+    if (result.Type == alfa::FaultEvaluator::Detected)
+        std::cout << "Fault at " << (result.FaultTime - start_time) / 1e9 << " s detected at "
+            << (result.DetectionTime - start_time) / 1e9 << " s (delay " << result.Delay / 1e9 << " s)" << std::endl;
+    else if (result.Type == alfa::FaultEvaluator::Missed)
+        std::cout << "Fault at " << (result.FaultTime - start_time) / 1e9 << " s missed" << std::endl;
+    else
+        std::cout << "False positive at " << (result.DetectionTime - start_time) / 1e9 << " s" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the path to the sequence bag file and the detections!" << std::endl;
+    std::cout << "Options: -d detections.csv (detection times in nanoseconds in the first column)," << std::endl;
+    std::cout << "         -t topic (a topic of the sequence with the detections)," << std::endl;
+    std::cout << "         -o timeout (seconds, default: 5), -g gap threshold (seconds, default: 1)" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./evaluate path/to/sequence/bagfile.bag [-d detections.csv] [-t topic] [-o timeout] [-g gap]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "evaluate.exe path\\to\\sequence\\bagfile.bag [-d detections.csv] [-t topic] [-o timeout] [-g gap]" << std::endl;
+}
@@ -0,0 +1,131 @@
+/*  ***************************************************************************
+*   harness.cpp - Evaluates a set of simple fault detectors on multiple ALFA
+*   dataset sequences in parallel and reports their detection delays and
+*   false alarms.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include "sequence.h"
+#include "harness.h"
+
+alfa::DetectorHarness::DetectorFunction CreateTrackingDetector(const std::string &topic_name, double threshold, int persistence);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the number of threads and the sequence paths from command-line arguments
+    int n_threads = 0, first_path = 1;
+    if (argc > 2 && std::string(argv[1]) == "-j")
+    {
+        n_threads = std::atoi(argv[2]);
+        first_path = 3;
+    }
+    if (first_path >= argc)
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    alfa::DetectorHarness harness(n_threads);
+    for (int i = first_path; i < argc; ++i)
+    {
+        std::string sequence_dir, sequence_name;
+        if (!alfa::Sequence::ParseBagPath(argv[i], sequence_dir, sequence_name))
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+        harness.AddSequence(sequence_dir, sequence_name);
+    }
+
+    // Add the detector variants: the commanded and measured values of a controller should stay close
+    const char *topics[] = {"mavros-nav_info-roll", "mavros-nav_info-pitch", "mavros-nav_info-airspeed"};
+    const char *short_names[] = {"roll", "pitch", "airspeed"};
+    const double thresholds[] = {5, 10, 20};
+    const int persistences[] = {1, 10};
+    for (int t = 0; t < 3; ++t)
+        for (int i = 0; i < 3; ++i)
+            for (int p = 0; p < 2; ++p)
+            {
+                std::ostringstream name;
+                name << short_names[t] << "-err>" << thresholds[i] << "x" << persistences[p];
+                harness.AddDetector(name.str(), CreateTrackingDetector(topics[t], thresholds[i], persistences[p]));
+            }
+
+    // Run all the pairs and print the report
+    if (!harness.Run()) return 0;
+    harness.PrintReport();
+
+    return 0;
+}
+
+// Create a detector that raises an alarm when the difference between the commanded and the measured
+// values of a topic is larger than the threshold for the given number of consecutive messages
+alfa::DetectorHarness::DetectorFunction CreateTrackingDetector(const std::string &topic_name, double threshold, int persistence)
+{
+    return [topic_name, threshold, persistence](const alfa::Sequence &sequence)
+    {
+        std::vector<int> alarms;
+
+        // Find the topic and its fields
+        int topic_idx = sequence.FindTopicIndex(topic_name);
+        if (topic_idx < 0) return alarms;
+        const alfa::Topic &topic = sequence.Topics[topic_idx];
+        int commanded_idx = topic.FindLabelIndex("commanded"), measured_idx = topic.FindLabelIndex("measured");
+        if (commanded_idx < 0 || measured_idx < 0) return alarms;
+
+        // Go through the messages of the topic in the sequence order
+        int count = 0;
+        for (int i = 0; i < (int)sequence.MessageIndexList.size(); ++i)
+        {
+            if (sequence.MessageIndexList[i].TopicIdx != topic_idx) continue;
+            const alfa::Message &msg = topic.Messages[sequence.MessageIndexList[i].MessageIdx];
+
+            double commanded = 0, measured = 0;
+            alfa::Commons::StringToDouble(msg.Fields[commanded_idx], commanded);
+            alfa::Commons::StringToDouble(msg.Fields[measured_idx], measured);
+            count = (std::fabs(commanded - measured) > threshold) ? count + 1 : 0;
+            if (count == persistence)
+            {
+                alarms.push_back(i);
+                count = 0;
+            }
+        }
+        return alarms;
+    };
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the paths to the sequence bag files and optionally the number of threads!" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./harness [-j threads] path/to/sequence1/bagfile.bag [path/to/sequence2/bagfile.bag ...]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "harness.exe [-j threads] path\\to\\sequence1\\bagfile.bag [path\\to\\sequence2\\bagfile.bag ...]" << std::endl;
+}
@@ -108,22 +108,13 @@ bool ParseCommandLine(int argc, char** argv, std::string &out_sequence_path, std
         return false;
     }
 
-    // Extract the path and the sequence name
-    std::string bag_path = std::string(argv[1]);
-    std::string extension;
-    bool extracted = alfa::Commons::ExtractFilenameAndExtension(bag_path, out_sequence_name, extension, out_sequence_path);
-
-    // Check that the file exists and extension is correct
-    if (!extracted || (extension != "bag"))
+    // Extract the path and the sequence name and check that the extension is correct
+    if (!alfa::Sequence::ParseBagPath(std::string(argv[1]), out_sequence_path, out_sequence_name))
     {
         PrintHelpMessage();
         return false;
     }
 
-    // Add the path separator to the path
-    if (out_sequence_path.empty() || out_sequence_path[out_sequence_path.length() - 1] != alfa::Commons::FilePathSeparator) 
-        out_sequence_path += alfa::Commons::FilePathSeparator;
-
     return true;
 }
 
@@ -0,0 +1,84 @@
+/*  ***************************************************************************
+*   profile.cpp - Computes the statistics and the data-quality checks of an
+*   ALFA dataset sequence and writes them as JSON.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include "sequence.h"
+#include "profile.h"
+
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence path from command-line arguments
+    std::string sequence_dir, sequence_name;
+    if (argc < 2 || !alfa::Sequence::ParseBagPath(argv[1], sequence_dir, sequence_name))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+
+    // Read the options
+    alfa::SequenceProfiler profiler;
+    std::string output_file;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (i + 1 < argc && option == "-o") output_file = argv[++i];
+        else if (i + 1 < argc && option == "-g") profiler.SetGapThreshold(std::atof(argv[++i]));
+        else if (i + 1 < argc && option == "-j") profiler.SetNumberOfThreads(std::atoi(argv[++i]));
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Read the sequence from the given directory
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 0;
+
+    // Profile the sequence and write the result to the file or the standard output
+    alfa::SequenceProfile profile;
+    if (!profiler.Profile(sequence, profile)) return 0;
+    if (output_file.empty())
+        std::cout << profile.ToJson();
+    else
+        profile.SaveJson(output_file);
+
+    return 0;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the path to the sequence bag file!" << std::endl;
+    std::cout << "Options: -o output.json (default: standard output), -g gap threshold in seconds, -j threads" << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./profile path/to/sequence/bagfile.bag [-o output.json] [-g seconds] [-j threads]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "profile.exe path\\to\\sequence\\bagfile.bag [-o output.json] [-g seconds] [-j threads]" << std::endl;
+}
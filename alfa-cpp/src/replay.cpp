@@ -0,0 +1,95 @@
+/*  ***************************************************************************
+*   replay.cpp - Replays an ALFA dataset sequence in real time and reports the
+*   pacing accuracy and the delivery latency.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "sequence.h"
+#include "replay.h"
+
+void PrintTimingStats(const std::string &title, const alfa::Replayer::TimingStats &stats);
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence path and the replay speed from command-line arguments
+    std::string sequence_dir, sequence_name;
+    if (argc < 2 || argc > 3 || !alfa::Sequence::ParseBagPath(argv[1], sequence_dir, sequence_name))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    double speed = (argc == 3) ? std::atof(argv[2]) : 1.0;
+
+    // Read the sequence from the given directory
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 0;
+
+    // Count the messages of each topic as they arrive
+    std::vector<size_t> topic_counts(sequence.Topics.size(), 0);
+    alfa::Replayer replayer(sequence);
+    replayer.SetSpeed(speed);
+    replayer.AddConsumer([&topic_counts](const alfa::Replayer::Event &event) { topic_counts[event.TopicIdx]++; });
+
+    // Replay the whole sequence
+    std::cout << "Replaying " << sequence.MessageIndexList.size() << " messages of '" << sequence.Name << "' at ";
+    if (speed > 0) std::cout << speed << "x speed..." << std::endl; else std::cout << "full speed..." << std::endl;
+    replayer.Start();
+    replayer.Wait();
+
+    // Print the results
+    std::cout << std::endl;
+    PrintTimingStats("Pacing jitter", replayer.GetPacingStats());
+    alfa::Replayer::ConsumerStats stats = replayer.GetConsumerStats(0);
+    PrintTimingStats("Delivery latency", stats.Latency);
+    std::cout << "Delivered messages: " << stats.Delivered << ", dropped messages: " << stats.Dropped << std::endl;
+    std::cout << std::endl;
+
+    for (int i = 0; i < (int)sequence.Topics.size(); ++i)
+        std::cout << std::setw(2) << i << ": " << sequence.Topics[i].Name << " (Received: " << topic_counts[i] << ")" << std::endl;
+
+    return 0;
+}
+
+// Print the timing statistics in microseconds
+void PrintTimingStats(const std::string &title, const alfa::Replayer::TimingStats &stats)
+{
+    std::cout << std::left << std::setw(18) << title << std::right << std::fixed << std::setprecision(1) <<
+        ": mean " << stats.Mean << " us, median " << stats.Median << " us, 99% " << stats.Percentile99 <<
+        " us, max " << stats.Max << " us" << std::endl;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the path to the sequence bag file and optionally the replay speed!" << std::endl;
+    std::cout << "The speed is 1 for real time, N for N times faster and 0 for as fast as possible." << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./replay path/to/sequence/bagfile.bag [speed]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "replay.exe path\\to\\sequence\\bagfile.bag [speed]" << std::endl;
+}
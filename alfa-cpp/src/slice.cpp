@@ -0,0 +1,111 @@
+/*  ***************************************************************************
+*   slice.cpp - Exports selected topics, fields and time ranges of an ALFA
+*   dataset sequence to CSV or TSV files.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "commons.h"
+#include "sequence.h"
+#include "export.h"
+
+void PrintHelpMessage();
+
+int main(int argc, char** argv)
+{
+    // Read the sequence path and the output directory from command-line arguments
+    std::string sequence_dir, sequence_name;
+    if (argc < 3 || !alfa::Sequence::ParseBagPath(argv[1], sequence_dir, sequence_name))
+    {
+        PrintHelpMessage();
+        return 0;
+    }
+    std::string output_dir = argv[2];
+    if (output_dir.back() != alfa::Commons::FilePathSeparator) output_dir += alfa::Commons::FilePathSeparator;
+
+    // Read the options (the topics are selected after loading the sequence)
+    std::vector<std::string> topic_options;
+    double start_time = -1, end_time = -1;
+    int n_threads = 0;
+    std::string output_name;
+    alfa::SequenceExporter::FileFormat format = alfa::SequenceExporter::CSV;
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        if (option == "--tsv") format = alfa::SequenceExporter::TSV;
+        else if (i + 1 < argc && option == "-t") topic_options.push_back(argv[++i]);
+        else if (i + 1 < argc && option == "-s") start_time = std::atof(argv[++i]);
+        else if (i + 1 < argc && option == "-e") end_time = std::atof(argv[++i]);
+        else if (i + 1 < argc && option == "-j") n_threads = std::atoi(argv[++i]);
+        else if (i + 1 < argc && option == "-n") output_name = argv[++i];
+        else
+        {
+            PrintHelpMessage();
+            return 0;
+        }
+    }
+
+    // Read the sequence from the given directory
+    alfa::Sequence sequence(sequence_dir, sequence_name);
+    if (!sequence.IsInitialized()) return 0;
+
+    // Select the topics and the fields (given as topic:field1,field2)
+    alfa::SequenceExporter exporter(sequence);
+    for (int i = 0; i < (int)topic_options.size(); ++i)
+    {
+        size_t colon_pos = topic_options[i].find(':');
+        alfa::VecString fields;
+        if (colon_pos != std::string::npos)
+            fields = alfa::Commons::Tokenize(topic_options[i].substr(colon_pos + 1), ',');
+        if (!exporter.SelectTopic(topic_options[i].substr(0, colon_pos), fields)) return 0;
+    }
+    exporter.SetTimeRange(start_time, end_time);
+    exporter.SetFormat(format);
+    exporter.SetNumberOfThreads(n_threads);
+
+    // Write the files
+    int n_exported = exporter.Export(output_dir, output_name);
+    if (n_exported >= 0)
+        std::cout << "Exported " << n_exported << " topics to '" << output_dir << "'." << std::endl;
+
+    return 0;
+}
+
+// Print a message for the user about the command line input format
+void PrintHelpMessage()
+{
+    std::cout << "Please provide the path to the sequence bag file and the output directory!" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  -t topic[:field1,field2,...]  Export the topic (only the given fields). Can be repeated; all topics by default." << std::endl;
+    std::cout << "  -s seconds                    Start of the time range since the start of the sequence." << std::endl;
+    std::cout << "  -e seconds                    End of the time range since the start of the sequence." << std::endl;
+    std::cout << "  -n name                       Name of the output sequence (the input name by default)." << std::endl;
+    std::cout << "  -j threads                    Number of topics exported at the same time (one per core by default)." << std::endl;
+    std::cout << "  --tsv                         Write tab-separated files instead of CSV files." << std::endl;
+    std::cout << "Usage (in Linux/Mac):" << std::endl;
+    std::cout << "./slice path/to/sequence/bagfile.bag path/to/output [options]" << std::endl;
+    std::cout << "Usage (in Windows):" << std::endl;
+    std::cout << "slice.exe path\\to\\sequence\\bagfile.bag path\\to\\output [options]" << std::endl;
+}
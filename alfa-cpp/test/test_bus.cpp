@@ -0,0 +1,87 @@
+/*  ***************************************************************************
+*   test_bus.cpp - Tests broadcasting the messages of the sequences to the
+*   subscribers (see bus.h), including the sequences in a memory budget.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include "sequence.h"
+#include "memorybudget.h"
+#include "bus.h"
+#include "test_utils.h"
+
+const int NumRows = 1000, NumTopics = 3;
+const std::string SequenceName = "test_bus";
+
+std::string MakeRow(int row);
+void TestPublishBudgetedSequence();
+
+int main()
+{
+    for (int t = 0; t < NumTopics; ++t)
+        if (!WriteTestFile(SequenceName + "-topic" + std::to_string(t) + ".csv", MakeTopicData("field.value", NumRows, MakeRow)))
+            return FinishTest("test_bus");
+
+    TestPublishBudgetedSequence();
+    return FinishTest("test_bus");
+}
+
+// A row of the test topics: the row number
+std::string MakeRow(int row)
+{
+    return std::to_string(row);
+}
+
+// Publishing a sequence whose topics are unloaded by a budget reads the topics through the budget
+// and delivers all their messages to the subscribers
+void TestPublishBudgetedSequence()
+{
+    alfa::Sequence sequence("./", SequenceName);
+    if (!Check(sequence.IsInitialized() && (int)sequence.Topics.size() == NumTopics, "The test sequence is not loaded.")) return;
+    alfa::MemoryBudget budget(1);
+    if (!Check(budget.AddSequence(sequence), "The test sequence is not added to the budget.")) return;
+    budget.ResetStatistics();
+
+    alfa::VecString topic_names;
+    for (int t = 0; t < NumTopics; ++t)
+        topic_names.push_back(sequence.Topics[t].Name);
+
+    std::atomic<int> n_received(0), n_wrong(0);
+    std::vector<int> next_row(NumTopics, 0);
+    alfa::TopicBus bus(sequence);
+    bus.Subscribe(topic_names, [&](const alfa::TopicBus::BusMessage &bus_msg)
+    {
+        ++n_received;
+        if (bus_msg.Msg->Fields.size() != 1 || bus_msg.Msg->Fields[0] != std::to_string(next_row[bus_msg.TopicIdx]++)) ++n_wrong;
+    });
+    if (!Check(bus.Start(), "The bus is not started.")) return;
+
+    size_t n_published = bus.PublishSequence();
+    bus.Close();
+    Check(n_published == sequence.MessageIndexList.size(), "The bus published " + std::to_string(n_published) + " messages.");
+    Check(n_received == NumTopics * NumRows, "The subscriber received " + std::to_string(n_received)
+        + " of " + std::to_string(NumTopics * NumRows) + " messages.");
+    Check(n_wrong == 0, std::to_string(n_wrong) + " received messages are wrong.");
+    Check(budget.GetStatistics().Misses > 0, "The bus did not read the topics through the budget.");
+}
@@ -0,0 +1,94 @@
+/*  ***************************************************************************
+*   test_compression.cpp - Tests that a compressed topic (see compression.h)
+*   gives the same values as the topic it was compressed from.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "topic.h"
+#include "compression.h"
+#include "test_utils.h"
+
+const int NumRows = 300;
+
+std::string MakeRow(int row);
+bool IsSameNumbers(const std::vector<double> &values1, const std::vector<double> &values2);
+void TestRoundTripWithEmptyFields();
+
+int main()
+{
+    TestRoundTripWithEmptyFields();
+    return FinishTest("test_compression");
+}
+
+// A row of the test topic: a real, an integer and a text field, each empty in some rows
+std::string MakeRow(int row)
+{
+    std::string number = (row % 17 == 3) ? "" : std::to_string(row) + ".25";
+    std::string count = (row % 23 == 5) ? "" : std::to_string(row * 7);
+    std::string name = (row % 11 == 1) ? "" : (row % 2 ? "on" : "off");
+    return number + "," + count + "," + name;
+}
+
+// Compare two vectors of numbers (the NaN values are equal)
+bool IsSameNumbers(const std::vector<double> &values1, const std::vector<double> &values2)
+{
+    if (values1.size() != values2.size()) return false;
+    for (size_t i = 0; i < values1.size(); ++i)
+        if (values1[i] != values2[i] && (values1[i] == values1[i] || values2[i] == values2[i])) return false;
+    return true;
+}
+
+// A compressed topic and its decompressed copy give the same values as the original topic, including the
+// empty values (NaN as numbers), and the decompressed topic keeps the information and the reading state
+void TestRoundTripWithEmptyFields()
+{
+    alfa::Topic topic;
+    topic.SetFollowMode(true);
+    topic.ReadFromData("test_compression_empty.csv", MakeTopicData("field.number,field.count,field.name", NumRows, MakeRow));
+    if (!Check(topic.IsInitialized() && (int)topic.Messages.size() == NumRows, "The test topic is not loaded.")) return;
+
+    alfa::CompressedTopic compressed(topic, 64);
+    if (!Check(compressed.IsInitialized(), "The test topic is not compressed.")) return;
+    alfa::Topic decompressed = compressed.Decompress();
+
+    for (const char *label : { "number", "count" })
+    {
+        std::vector<double> values = topic.GetFieldsAsDouble(label);
+        Check(values.size() == NumRows, "The '" + std::string(label) + "' field has no numeric values.");
+        Check(IsSameNumbers(compressed.GetFieldsAsDouble(label), values),
+            "The compressed '" + std::string(label) + "' field has different numbers.");
+        Check(IsSameNumbers(decompressed.GetFieldsAsDouble(label), values),
+            "The decompressed '" + std::string(label) + "' field has different numbers.");
+    }
+    for (const char *label : { "number", "count", "name" })
+        Check(compressed.GetFieldsAsString(label) == topic.GetFieldsAsString(label)
+            && decompressed.GetFieldsAsString(label) == topic.GetFieldsAsString(label),
+            "The compressed '" + std::string(label) + "' field has different texts.");
+
+    Check(decompressed.IsInitialized() && decompressed.IsFollowMode() && decompressed.Name == topic.Name
+        && decompressed.FieldTypes == topic.FieldTypes && decompressed.FindLabelIndex("name") == 2
+        && decompressed.GetOriginalFieldLabels() == topic.GetOriginalFieldLabels(),
+        "The decompressed topic lost its information.");
+}
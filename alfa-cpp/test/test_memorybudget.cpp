@@ -0,0 +1,122 @@
+/*  ***************************************************************************
+*   test_memorybudget.cpp - Tests that the memory budget of the sequences (see
+*   memorybudget.h) follows the memory actually used by the topics.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "sequence.h"
+#include "memorybudget.h"
+#include "test_utils.h"
+
+const int NumRows = 2000, NumTopics = 3;
+const std::string SequenceName = "test_budget";
+
+std::string MakeRow(int row);
+bool WriteTestSequence();
+size_t GetTopicsFootprint(const alfa::Sequence &sequence);
+void TestTypedColumnGrowth();
+void TestCopyOfBudgetedSequence();
+
+int main()
+{
+    if (!WriteTestSequence()) return FinishTest("test_memorybudget");
+    TestTypedColumnGrowth();
+    TestCopyOfBudgetedSequence();
+    return FinishTest("test_memorybudget");
+}
+
+// A row of the test topics: three numeric fields
+std::string MakeRow(int row)
+{
+    return std::to_string(row) + "," + std::to_string(row % 7) + "," + std::to_string(row) + ".5";
+}
+
+// Write the topic files of the test sequence
+bool WriteTestSequence()
+{
+    for (int t = 0; t < NumTopics; ++t)
+        if (!WriteTestFile(SequenceName + "-topic" + std::to_string(t) + ".csv",
+            MakeTopicData("field.a,field.b,field.c", NumRows, MakeRow))) return false;
+    return true;
+}
+
+// Get the memory actually used by the topics of a sequence
+size_t GetTopicsFootprint(const alfa::Sequence &sequence)
+{
+    size_t total = 0;
+    for (int t = 0; t < (int)sequence.Topics.size(); ++t)
+        total += sequence.Topics[t].GetMemoryFootprint();
+    return total;
+}
+
+// The typed values of the fields are counted in the budget, so the typed access alone can unload topics
+void TestTypedColumnGrowth()
+{
+    alfa::Sequence sequence("./", SequenceName);
+    if (!Check(sequence.IsInitialized() && (int)sequence.Topics.size() == NumTopics, "The test sequence is not loaded.")) return;
+
+    size_t budget_bytes = GetTopicsFootprint(sequence) + 1000;
+    alfa::MemoryBudget budget(budget_bytes);
+    if (!Check(budget.AddSequence(sequence), "The test sequence is not added to the budget.")) return;
+    Check(budget.GetStatistics().Evictions == 0, "The budget unloaded topics before the typed access.");
+
+    for (int t = 0; t < NumTopics; ++t)
+    {
+        const alfa::Topic &topic = sequence.GetTopic(t);
+        for (int f = 0; f < (int)topic.FieldLabels.size(); ++f)
+            topic.GetFieldsAsDouble(f);
+        sequence.GetTopic(t);
+    }
+
+    size_t used_bytes = budget.GetUsedBytes(), actual_bytes = GetTopicsFootprint(sequence);
+    Check(used_bytes == actual_bytes, "The budget counts " + std::to_string(used_bytes) + " bytes but the topics use "
+        + std::to_string(actual_bytes) + " bytes.");
+    Check(used_bytes <= budget_bytes, "The topics use " + std::to_string(used_bytes) + " bytes with a budget of "
+        + std::to_string(budget_bytes) + " bytes.");
+    Check(budget.GetStatistics().Evictions > 0, "The typed access did not unload any topics.");
+}
+
+// A copy of a sequence in a budget is not tracked, but it reads its unloaded topics from the files again
+void TestCopyOfBudgetedSequence()
+{
+    alfa::Sequence sequence("./", SequenceName);
+    if (!Check(sequence.IsInitialized() && (int)sequence.Topics.size() == NumTopics, "The test sequence is not loaded.")) return;
+
+    alfa::MemoryBudget budget(1);
+    if (!Check(budget.AddSequence(sequence), "The test sequence is not added to the budget.")) return;
+    if (!Check(!sequence.Topics[0].IsLoaded(), "The budget did not unload the topics.")) return;
+
+    alfa::Sequence copy = sequence;
+    Check(copy.GetTopicTracker() == NULL, "The copy of the sequence is tracked.");
+    const alfa::Topic &topic = copy.GetTopic(0);
+    if (!Check(topic.IsLoaded() && (int)topic.Messages.size() == NumRows, "The unloaded topic of the copy is not read again.")) return;
+    std::vector<double> values = topic.GetFieldsAsDouble("c");
+    Check(values.size() == NumRows && values[NumRows - 1] == NumRows - 0.5, "The topic of the copy has wrong values.");
+
+    alfa::Message message = copy.GetMessage(copy.MessageIndexList.size() - 1);
+    Check(message.Fields.size() == 3 && message.Fields[0] == std::to_string(NumRows - 1),
+        "GetMessage of the copy gives a wrong message.");
+    Check(!sequence.Topics[0].IsLoaded(), "Reading the topic of the copy loaded the topic of the tracked sequence.");
+}
@@ -0,0 +1,75 @@
+/*  ***************************************************************************
+*   test_query.cpp - Tests the queries over the fields of a sequence (see
+*   query.h), with and without the zone maps of the topics.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "sequence.h"
+#include "query.h"
+#include "test_utils.h"
+
+const int NumRows = 20000;
+
+std::string MakeRow(int row);
+void TestEmptyCells();
+
+int main()
+{
+    TestEmptyCells();
+    return FinishTest("test_query");
+}
+
+// A row of the test topic: an integer field that is empty in every thousandth row
+std::string MakeRow(int row)
+{
+    return (row % 1000 == 7) ? std::string() : std::to_string(row % 100);
+}
+
+// The empty cells are NaN on every path: the filters match the same rows with and without the zone maps,
+// and the value range searches find the same messages before and after the typed access
+void TestEmptyCells()
+{
+    if (!WriteTestFile("test_query_empty-data.csv", MakeTopicData("field.maybe", NumRows, MakeRow))) return;
+
+    alfa::Expression predicate = alfa::Expression::Field("data", "maybe") >= 0;
+    size_t expected = NumRows - NumRows / 1000;
+    for (int block_size : { 0, 256 })
+    {
+        alfa::Sequence sequence("./", "test_query_empty");
+        if (!Check(sequence.IsInitialized(), "The test sequence is not loaded.")) return;
+        sequence.SetZoneMapBlockSize(block_size);
+
+        const alfa::Topic &topic = sequence.Topics[sequence.FindTopicIndex("data")];
+        size_t before = topic.FindMessagesInValueRange("maybe", 0, 0).size();
+        topic.GetFieldsAsDouble("maybe");
+        size_t after = topic.FindMessagesInValueRange("maybe", 0, 0).size();
+        Check(before == (size_t)NumRows / 100 && after == before, "FindMessagesInValueRange found " + std::to_string(before)
+            + " messages before and " + std::to_string(after) + " after the typed access.");
+
+        alfa::QueryEngine engine(sequence);
+        size_t count = engine.Filter(predicate).Count();
+        Check(count == expected, "Filter found " + std::to_string(count) + " of " + std::to_string(expected)
+            + " rows with the zone map blocks of " + std::to_string(block_size) + " messages.");
+    }
+}
@@ -0,0 +1,91 @@
+/*  ***************************************************************************
+*   test_replay.cpp - Tests replaying the sequences (see replay.h), including
+*   the sequences in a memory budget.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "sequence.h"
+#include "memorybudget.h"
+#include "replay.h"
+#include "test_utils.h"
+
+const int NumRows = 1000, NumTopics = 3;
+const std::string SequenceName = "test_replay";
+
+std::string MakeRow(int row);
+bool WaitUntilFinished(const alfa::Replayer &replayer);
+void TestReplayOfBudgetedSequence();
+
+int main()
+{
+    for (int t = 0; t < NumTopics; ++t)
+        if (!WriteTestFile(SequenceName + "-topic" + std::to_string(t) + ".csv", MakeTopicData("field.value", NumRows, MakeRow)))
+            return FinishTest("test_replay");
+
+    TestReplayOfBudgetedSequence();
+    return FinishTest("test_replay");
+}
+
+// A row of the test topics: the row number
+std::string MakeRow(int row)
+{
+    return std::to_string(row);
+}
+
+// Wait (up to 10 seconds) until the replay is no longer running, without calling Replayer::Wait
+bool WaitUntilFinished(const alfa::Replayer &replayer)
+{
+    for (int i = 0; i < 1000 && replayer.IsRunning(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return !replayer.IsRunning();
+}
+
+// The replay of a sequence whose topics are unloaded by a budget reads the topics through the budget and
+// delivers their messages, and the replay stops running by itself when all the messages are processed
+void TestReplayOfBudgetedSequence()
+{
+    alfa::Sequence sequence("./", SequenceName);
+    if (!Check(sequence.IsInitialized() && (int)sequence.Topics.size() == NumTopics, "The test sequence is not loaded.")) return;
+    alfa::MemoryBudget budget(1);
+    if (!Check(budget.AddSequence(sequence), "The test sequence is not added to the budget.")) return;
+    budget.ResetStatistics();
+
+    std::atomic<int> n_wrong(0);
+    alfa::Replayer replayer(sequence);
+    replayer.SetSpeed(0);
+    replayer.AddConsumer([&n_wrong](const alfa::Replayer::Event &event)
+        { if (event.Msg->Fields.size() != 1 || event.Msg->Fields[0] != std::to_string(event.TopicMessageIdx)) ++n_wrong; },
+        2 * NumTopics * NumRows);
+    if (!Check(replayer.Start(), "The replay is not started.")) return;
+
+    if (!Check(WaitUntilFinished(replayer), "The replay is still running after all the messages are replayed.")) replayer.Stop();
+    alfa::Replayer::ConsumerStats stats = replayer.GetConsumerStats(0);
+    Check(stats.Delivered == (size_t)NumTopics * NumRows, "The replay delivered " + std::to_string(stats.Delivered)
+        + " of " + std::to_string(NumTopics * NumRows) + " messages.");
+    Check(n_wrong == 0, std::to_string(n_wrong) + " replayed messages are wrong.");
+    Check(budget.GetStatistics().Misses > 0, "The replay did not read the topics through the budget.");
+}
@@ -0,0 +1,79 @@
+/*  ***************************************************************************
+*   test_shared.cpp - Tests the regular copies of the sequences shared between
+*   processes (see shared.h), which the classes built on Sequence use.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "sequence.h"
+#include "shared.h"
+#include "query.h"
+#include "test_utils.h"
+
+const int NumRows = 1000, NumTopics = 3;
+const std::string SequenceName = "test_shared";
+const std::string SegmentName = "alfa_test_shared";
+
+std::string MakeRow(int row);
+void TestQueryOnSharedTopics();
+
+int main()
+{
+    for (int t = 0; t < NumTopics; ++t)
+        if (!WriteTestFile(SequenceName + "-topic" + std::to_string(t) + ".csv", MakeTopicData("field.value", NumRows, MakeRow)))
+            return FinishTest("test_shared");
+
+    TestQueryOnSharedTopics();
+    return FinishTest("test_shared");
+}
+
+// A row of the test topics: the row number
+std::string MakeRow(int row)
+{
+    return std::to_string(row);
+}
+
+// A QueryEngine runs on a copy of some topics of a shared sequence and finds the same rows as on the sequence
+void TestQueryOnSharedTopics()
+{
+    alfa::Sequence sequence("./", SequenceName);
+    if (!Check(sequence.IsInitialized() && (int)sequence.Topics.size() == NumTopics, "The test sequence is not loaded.")) return;
+
+    alfa::SharedSequence publisher, shared;
+    if (!Check(publisher.Publish(sequence, SegmentName) && shared.Attach(SegmentName), "The test sequence is not shared.")) return;
+
+    alfa::Sequence copy = shared.ToSequence({ "topic2", "topic0" });
+    if (!Check(copy.IsInitialized() && copy.Topics.size() == 2, "The copy of the shared topics is not made.")) return;
+    Check(copy.FindTopicIndex("topic0") == 0 && copy.FindTopicIndex("topic2") == 1 && copy.FindTopicIndex("topic1") == -1,
+        "The copy has wrong topics.");
+    Check(copy.MessageIndexList.size() == 2 * NumRows, "The copy lists " + std::to_string(copy.MessageIndexList.size())
+        + " messages.");
+    alfa::Message last = copy.GetMessage(copy.MessageIndexList.size() - 1);
+    Check(last.Fields.size() == 1 && last.Fields[0] == std::to_string(NumRows - 1), "The last message of the copy is wrong.");
+
+    alfa::Expression predicate = alfa::Expression::Field("topic2", "value") >= NumRows / 2;
+    size_t count = alfa::QueryEngine(copy).Filter(predicate).Count();
+    size_t expected = alfa::QueryEngine(sequence).Filter(predicate).Count();
+    Check(count == expected && count == NumRows / 2, "Filter found " + std::to_string(count) + " rows in the copy and "
+        + std::to_string(expected) + " rows in the sequence.");
+}
@@ -0,0 +1,103 @@
+/*  ***************************************************************************
+*   test_topic.cpp - Tests the typed access to the fields of a topic (see
+*   topic.h), including the empty values of the fields.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "topic.h"
+#include "test_utils.h"
+
+const int NumRows = 100, EmptyRow = 10;
+
+std::string MakeRow(int row);
+void TestEmptyIntegerCells();
+void TestPromotionWithEmptyCells();
+
+int main()
+{
+    TestEmptyIntegerCells();
+    TestPromotionWithEmptyCells();
+    return FinishTest("test_topic");
+}
+
+// A row of the test topic: a Bool and an Int64 field, both empty in one row
+std::string MakeRow(int row)
+{
+    if (row == EmptyRow) return ",";
+    return std::string(row % 2 ? "True" : "False") + "," + std::to_string(row * 3);
+}
+
+// An empty value does not widen a Bool or Int64 field: it is 0 as an integer and NaN as a number
+void TestEmptyIntegerCells()
+{
+    alfa::Topic topic;
+    topic.ReadFromData("test_topic_empty.csv", MakeTopicData("field.flag,field.count", NumRows, MakeRow));
+    if (!Check(topic.IsInitialized() && (int)topic.Messages.size() == NumRows, "The test topic is not loaded.")) return;
+
+    Check(topic.GetFieldType(0) == alfa::Topic::Bool, "The Bool field with an empty value is " +
+        alfa::Topic::FieldTypeToString(topic.GetFieldType(0)) + ".");
+    Check(topic.GetFieldType(1) == alfa::Topic::Int64, "The Int64 field with an empty value is " +
+        alfa::Topic::FieldTypeToString(topic.GetFieldType(1)) + ".");
+
+    std::vector<int> flags = topic.GetFieldsAsInt("flag");
+    std::vector<long long> counts = topic.GetFieldsAsLongLong("count");
+    std::vector<double> numbers = topic.GetFieldsAsDouble("count");
+    std::vector<float> floats = topic.GetFieldsAsFloat("flag");
+    std::vector<long double> long_numbers = topic.GetFieldsAsLongDouble("count");
+    if (!Check(flags.size() == NumRows && counts.size() == NumRows && numbers.size() == NumRows && floats.size() == NumRows
+        && long_numbers.size() == NumRows, "The typed access to the fields with an empty value failed.")) return;
+
+    Check(flags[EmptyRow] == 0 && counts[EmptyRow] == 0, "The empty integer values are not 0.");
+    Check(numbers[EmptyRow] != numbers[EmptyRow] && floats[EmptyRow] != floats[EmptyRow]
+        && long_numbers[EmptyRow] != long_numbers[EmptyRow], "The empty values are not NaN as numbers.");
+    Check(flags[EmptyRow + 1] == 1 && counts[EmptyRow + 1] == 3 * (EmptyRow + 1) && numbers[EmptyRow + 1] == 3 * (EmptyRow + 1),
+        "The values after the empty value are wrong.");
+    Check(topic.GetColumn(1).ToDouble(EmptyRow) != topic.GetColumn(1).ToDouble(EmptyRow), "Column::ToDouble of the empty value is not NaN.");
+    Check(alfa::Topic::FieldToDouble("") != alfa::Topic::FieldToDouble(""), "FieldToDouble of an empty value is not NaN.");
+}
+
+// The empty values of a stored Int64 field become NaN when the field is promoted to Float64
+void TestPromotionWithEmptyCells()
+{
+    const std::string filename = "test_topic_promotion.csv";
+    if (!WriteTestFile(filename, MakeTopicData("field.flag,field.count", NumRows, MakeRow))) return;
+
+    alfa::Topic topic;
+    topic.SetFollowMode(true);
+    if (!Check(topic.ReadFromFile(filename), "The test topic is not loaded.")) return;
+    topic.GetFieldsAsDouble("count");
+
+    std::ofstream ofs(filename, std::ios::binary | std::ios::app);
+    ofs << "99000000000,True,2.5\n";
+    ofs.close();
+    Check(topic.ReadAppendedData() == 1, "The appended message is not read.");
+
+    std::vector<double> numbers = topic.GetFieldsAsDouble("count");
+    Check(topic.GetFieldType(1) == alfa::Topic::Float64, "The field is not promoted to float64.");
+    if (!Check(numbers.size() == NumRows + 1, "The promoted field has " + std::to_string(numbers.size()) + " values.")) return;
+    Check(numbers[EmptyRow] != numbers[EmptyRow], "The empty value is not NaN after the promotion.");
+    Check(numbers[EmptyRow + 1] == 3 * (EmptyRow + 1) && numbers[NumRows] == 2.5, "The promoted values are wrong.");
+}
@@ -0,0 +1,72 @@
+/*  ***************************************************************************
+*   test_utils.h - Helpers shared by the tests of the ALFA dataset libraries
+*   (checks and the small sequences written for the tests).
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#ifndef ALFA_TEST_UTILS_H
+#define ALFA_TEST_UTILS_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+// Number of the failed checks of the test
+int n_failed_checks = 0;
+
+// Check a condition of the test. Prints an error with the description if it does not hold.
+bool Check(bool condition, const std::string &description)
+{
+    if (condition) return true;
+    std::cerr << "Test Error! " << description << std::endl;
+    ++n_failed_checks;
+    return false;
+}
+
+// Print the result of the test and get the exit code for ctest
+int FinishTest(const std::string &test_name)
+{
+    if (n_failed_checks == 0)
+        std::cout << test_name << ": all checks passed" << std::endl;
+    else
+        std::cout << test_name << ": " << n_failed_checks << " checks failed" << std::endl;
+    return n_failed_checks == 0 ? 0 : 1;
+}
+
+// Write a topic file of a test sequence (in the working directory, which is the build directory in ctest)
+bool WriteTestFile(const std::string &filename, const std::string &contents)
+{
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs << contents;
+    return Check(ofs.good(), "Failed to write '" + filename + "' file.");
+}
+
+// Create the contents of a topic file with a time column (0.1 s apart) and the given rows of the fields
+std::string MakeTopicData(const std::string &header, int n_rows, std::string (*make_row)(int row))
+{
+    std::string data = "%time," + header + "\n";
+    for (int i = 0; i < n_rows; ++i)
+        data += std::to_string(1000000000LL + i * 100000000LL) + "," + make_row(i) + "\n";
+    return data;
+}
+
+#endif
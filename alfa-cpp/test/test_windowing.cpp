@@ -0,0 +1,85 @@
+/*  ***************************************************************************
+*   test_windowing.cpp - Tests cutting the sequences into windows (see
+*   windowing.h), including the fields that start with empty values.
+*
+*   For more information about the dataset, please refer to:
+*   http://theairlab.org/alfa-dataset
+*
+*   For more information about this project and the publications related to
+*   the dataset and this work, please refer to:
+*   http://theairlab.org/fault-detection-project
+*
+*   Air Lab, Robotics Institute, Carnegie Mellon University
+*
+*   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
+*   Contact: keipour@cmu.edu
+*
+*   Last Modified: October 19, 2026
+*
+*   Copyright (c) 2019 Carnegie Mellon University,
+*   Azarakhsh Keipour <keipour@cmu.edu>
+*
+*   For License information please see the README file in the root directory.
+*
+*   ***************************************************************************/
+
+#include <iostream>
+#include <string>
+#include "sequence.h"
+#include "windowing.h"
+#include "test_utils.h"
+
+const int NumRows = 100, NumEmptyRows = 3, WindowLength = 10;
+const std::string SequenceName = "test_windowing";
+
+std::string MakeRow(int row);
+std::string MakeLateRow(int row);
+void TestLeadingEmptyValues();
+
+int main()
+{
+    if (!WriteTestFile(SequenceName + "-full.csv", MakeTopicData("field.value", NumRows, MakeRow))
+        || !WriteTestFile(SequenceName + "-late.csv", MakeTopicData("field.value", NumRows, MakeLateRow)))
+        return FinishTest("test_windowing");
+
+    TestLeadingEmptyValues();
+    return FinishTest("test_windowing");
+}
+
+// A row of the topic with all the values: the row number
+std::string MakeRow(int row)
+{
+    return std::to_string(row);
+}
+
+// A row of the topic whose first values are empty: the row number plus 1000
+std::string MakeLateRow(int row)
+{
+    return (row < NumEmptyRows) ? std::string() : std::to_string(row + 1000);
+}
+
+// The grid times before the first number of a field hold that number instead of NaN
+void TestLeadingEmptyValues()
+{
+    alfa::Sequence sequence("./", SequenceName);
+    if (!Check(sequence.IsInitialized() && sequence.Topics.size() == 2, "The test sequence is not loaded.")) return;
+
+    alfa::WindowBuilder builder;
+    builder.AddField("full", "value");
+    builder.AddField("late", "value");
+    builder.AddSequence(sequence);
+    builder.SetSamplePeriod(0.1);
+    builder.SetWindow(WindowLength, WindowLength);
+
+    alfa::WindowSet windows;
+    if (!Check(builder.Build(windows) && windows.NumWindows > 0 && windows.NumFeatures == 2, "No windows are built.")) return;
+
+    int n_nan = 0;
+    for (size_t i = 0; i < windows.Data.size(); ++i)
+        if (windows.Data[i] != windows.Data[i]) ++n_nan;
+    Check(n_nan == 0, std::to_string(n_nan) + " window samples are NaN.");
+    Check(windows.Data[1] == 1000 + NumEmptyRows, "The first sample of the field with the empty values is "
+        + std::to_string(windows.Data[1]) + ".");
+    Check(windows.Data[2 * NumEmptyRows + 1] == 1000 + NumEmptyRows && windows.Data[2 * (NumEmptyRows + 1) + 1] == 1001 + NumEmptyRows,
+        "The samples after the empty values are wrong.");
+}
@@ -14,7 +14,7 @@
 *   Authors: Azarakhsh Keipour, Mohammadreza Mousaei, Sebastian Scherer
 *   Contact: keipour@cmu.edu
 *
-*   Last Modified: May 19, 2019
+*   Last Modified: October 19, 2026
 *
 *   Copyright (c) 2019 Carnegie Mellon University,
 *   Azarakhsh Keipour <keipour@cmu.edu>
@@ -23,59 +23,67 @@
 *
 *   ***************************************************************************/
 #include "ros/ros.h"
-#include "std_msgs/String.h"
 #include "eval_msg/evaluate.h"
 #include "std_msgs/Bool.h"
 #include "std_msgs/Int8.h"
-#include <sstream>
+#include "evaluator.h"
 
-double timeout = 5;
-ros::Time gt_time;
-ros::Time detection_time;
-ros::Time detection_delay;
-bool gt_trig = false;
-bool detection_trig = false;
-bool fault_detected = false;
+// The evaluation state machine (shared with the offline evaluation of the alfa-cpp library). The callbacks
+// and the timer run in the same spinner thread, so it needs no locking.
+alfa::FaultEvaluator evaluator;
+ros::Publisher evalPub;
 
-void engineFailHandler(const std_msgs::Bool::ConstPtr& data)
+// The failure_status topics are separate ground truth channels of the evaluator, so a fault lasts while
+// any of them reports it (an inactive message of one topic does not end the fault of another)
+enum FaultChannel { EngineChannel, AileronChannel, RudderChannel, ElevatorChannel };
+
+// The std_msgs messages have no header, so the events are timed when the messages are received (the
+// simulated time of the bag when it is played with --clock and use_sim_time) instead of when the callbacks run
+long long eventTime(const ros::Time &receipt_time)
+{
+  return (long long)receipt_time.toNSec();
+}
+
+void engineFailHandler(const ros::MessageEvent<std_msgs::Bool const>& event)
+{
+  evaluator.AddGroundTruth(eventTime(event.getReceiptTime()), event.getMessage()->data, EngineChannel);
+}
+void aileronFailHandler(const ros::MessageEvent<std_msgs::Int8 const>& event)
+{
+  evaluator.AddGroundTruth(eventTime(event.getReceiptTime()), event.getMessage()->data != 0, AileronChannel);
+}
+void rudderFailHandler(const ros::MessageEvent<std_msgs::Int8 const>& event)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  evaluator.AddGroundTruth(eventTime(event.getReceiptTime()), event.getMessage()->data != 0, RudderChannel);
 }
-void aileronFailHandler(const std_msgs::Int8::ConstPtr& data)
+void elevatorFailHandler(const ros::MessageEvent<std_msgs::Int8 const>& event)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  evaluator.AddGroundTruth(eventTime(event.getReceiptTime()), event.getMessage()->data != 0, ElevatorChannel);
 }
-void rudderFailHandler(const std_msgs::Int8::ConstPtr& data)
+
+// Only the non-zero messages are detections, so a method can keep publishing 0 while it sees no fault
+void detectionHandler(const ros::MessageEvent<std_msgs::Int8 const>& event)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  if(event.getMessage()->data != 0)
+    evaluator.AddDetection(eventTime(event.getReceiptTime()));
 }
-void elevatorFailHandler(const std_msgs::Int8::ConstPtr& data)
+
+// Report the faults that were not detected within the timeout even if no more messages arrive
+void timeoutHandler(const ros::TimerEvent&)
 {
-  if(data)
-  {
-    gt_time = ros::Time::now();
-    gt_trig = true;
-  }
+  evaluator.AdvanceTo(eventTime(ros::Time::now()));
 }
-void detectionHandler(const std_msgs::Int8::ConstPtr& data)
+
+// Publish each result as soon as the evaluator decides it
+void publishResult(const alfa::FaultEvaluator::Result &result)
 {
-  if(data)
-  {
-    detection_time = ros::Time::now();
-    detection_trig = true;
-  }
+  eval_msg::evaluate eval;
+  eval.header.stamp.fromNSec(result.Type == alfa::FaultEvaluator::Missed ? result.FaultTime : result.DetectionTime);
+  eval.fault_detected = (result.Type == alfa::FaultEvaluator::Detected);
+  eval.detection_delay.fromNSec(result.Delay);
+  eval.false_positive = (result.Type == alfa::FaultEvaluator::FalsePositive);
+  evalPub.publish(eval);
+  ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
 }
 
 int main(int argc, char **argv)
@@ -84,80 +92,23 @@ int main(int argc, char **argv)
   ros::NodeHandle n;
   ros::NodeHandle nhPrivate = ros::NodeHandle("~");
 
-  ros::Publisher evalPub = n.advertise<eval_msg::evaluate>("/evaluation", 1);
-  
-  ros::Subscriber enginesSub = n.subscribe("/failure_status/engines", 1, engineFailHandler);
-  ros::Subscriber aileronSub = n.subscribe("/failure_status/aileron", 1, aileronFailHandler);
-  ros::Subscriber rudderSub = n.subscribe("/failure_status/rudder", 1, rudderFailHandler);
-  ros::Subscriber elevatorSub = n.subscribe("/failure_status/elevator", 1, elevatorFailHandler);
-  ros::Subscriber detectionSub = n.subscribe("/detection", 1, detectionHandler);
-
+  double timeout = alfa::FaultEvaluator::DefaultTimeout;
+  nhPrivate.getParam("timeout", timeout);
+  evaluator.SetTimeout(timeout);
+  evaluator.SetResultFunction(publishResult);
 
-  ros::Rate loop_rate(10);
+  evalPub = n.advertise<eval_msg::evaluate>("/evaluation", 10);
 
-  nhPrivate.getParam("timeout", timeout);
+  // Keep the queued messages, so none of the events is lost when the callbacks are late
+  ros::Subscriber enginesSub = n.subscribe("/failure_status/engines", 100, engineFailHandler);
+  ros::Subscriber aileronSub = n.subscribe("/failure_status/aileron", 100, aileronFailHandler);
+  ros::Subscriber rudderSub = n.subscribe("/failure_status/rudder", 100, rudderFailHandler);
+  ros::Subscriber elevatorSub = n.subscribe("/failure_status/elevator", 100, elevatorFailHandler);
+  ros::Subscriber detectionSub = n.subscribe("/detection", 100, detectionHandler);
 
-  eval_msg::evaluate eval;
+  ros::Timer timeoutTimer = n.createTimer(ros::Duration(0.1), timeoutHandler);
 
-  int count = 0;
-  while (ros::ok())
-  {
-    
-    if(gt_trig)
-    {
-      if(detection_trig)
-      {
-        fault_detected = true;
-        detection_delay.sec = detection_time.sec - gt_time.sec;
-        detection_delay.nsec = detection_time.nsec - gt_time.nsec;
-        if(detection_delay.nsec < 0)
-        {
-          detection_delay.sec -= 1;
-          detection_delay.nsec = 1000000000 + detection_delay.nsec;
-        }
-        eval.fault_detected = fault_detected;
-        eval.detection_delay = detection_delay;
-        eval.false_positive = false;
-        evalPub.publish(eval);
-        ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
-        gt_trig = false;
-        detection_trig = false;
-      }
-      else
-      {
-        eval.fault_detected = false;
-        eval.false_positive = false;
-        detection_delay.sec = 0;
-        detection_delay.nsec = 0;
-        eval.detection_delay = detection_delay;
-        if( (ros::Time::now().sec - gt_time.sec) > timeout )
-        {
-          fault_detected = false;
-          detection_trig = false;
-          gt_trig = false;
-          evalPub.publish(eval);
-          ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
-        }
-      }
-    }
-    else
-    {
-      if(detection_trig)
-      {
-        eval.false_positive = true;
-        eval.fault_detected = false;
-        detection_delay.sec = 0;
-        detection_delay.nsec = 0;
-        eval.detection_delay = detection_delay;
-        evalPub.publish(eval);
-        ROS_INFO("fault_detected = %d, detection_delay.sec = %d, detection_delay.nsec = %d, false_positive = %d", eval.fault_detected, eval.detection_delay.sec, eval.detection_delay.nsec, eval.false_positive);
-        detection_trig = false;
-      }
-    }
-    
-    ros::spinOnce();
-    loop_rate.sleep();
-  }
+  ros::spin();
 
   return 0;
 }
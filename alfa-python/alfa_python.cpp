@@ -29,13 +29,109 @@
 #include "commons.h"
 #include "topic.h"
 #include "message.h"
+#include "windowing.h"
+#include "query.h"
+#include "prefetch.h"
+#include "profile.h"
+#include "memorybudget.h"
+#include "loadspec.h"
+#include "shared.h"
+#include "serve.h"
 
 
 using namespace boost::python;
+namespace np = boost::python::numpy;
+
+// Wrap the window samples as a numpy array without copying (the array keeps the window set alive)
+np::ndarray GetWindowData(object window_set)
+{
+	alfa::WindowSet &windows = extract<alfa::WindowSet &>(window_set);
+	return np::from_data(windows.Data.data(), np::dtype::get_builtin<float>(),
+		make_tuple(windows.NumWindows, windows.WindowLength, windows.NumFeatures),
+		make_tuple(windows.WindowLength * windows.NumFeatures * sizeof(float), windows.NumFeatures * sizeof(float), sizeof(float)),
+		window_set);
+}
+
+// Wrap the window labels as a numpy array without copying (the array keeps the window set alive)
+np::ndarray GetWindowLabels(object window_set)
+{
+	alfa::WindowSet &windows = extract<alfa::WindowSet &>(window_set);
+	return np::from_data(windows.Labels.data(), np::dtype::get_builtin<int>(),
+		make_tuple(windows.NumWindows), make_tuple(sizeof(int)), window_set);
+}
+
+// Read a field of a topic as a float32 numpy array (the values are written in place, without copying)
+np::ndarray GetFieldsAsFloatArray(const alfa::Topic &topic, const std::string &field_label)
+{
+	int n_messages = (int)topic.Messages.size();
+	np::ndarray array = np::empty(make_tuple(n_messages), np::dtype::get_builtin<float>());
+	float *data = reinterpret_cast<float *>(array.get_data());
+	if (topic.FillFields<float>(field_label, data, data + n_messages) != n_messages)
+		return np::empty(make_tuple(0), np::dtype::get_builtin<float>());
+	return array;
+}
+
+// Take the next prefetched sequence (None after the last one). Python owns the returned sequence.
+alfa::Sequence *NextPrefetchedSequence(alfa::SequencePrefetcher &prefetcher)
+{
+	std::unique_ptr<alfa::Sequence> sequence(new alfa::Sequence());
+	int sequence_idx;
+	if (!prefetcher.Next(*sequence, sequence_idx)) return NULL;
+	return sequence.release();
+}
+
+// Get the times and the values of a field from the dataset server as numpy arrays (copied, since the
+// client reuses its buffer for the next request)
+tuple GetServedFieldSlice(alfa::DatasetClient &client, const std::string &sequence_name, const std::string &topic_name,
+	const std::string &field_label, long long start_time, long long end_time)
+{
+	alfa::DatasetClient::FieldSlice slice;
+	client.GetFieldSlice(sequence_name, topic_name, field_label, slice, start_time, end_time);
+	np::ndarray times = np::empty(make_tuple(slice.Size), np::dtype::get_builtin<long long>());
+	np::ndarray values = np::empty(make_tuple(slice.Size), np::dtype::get_builtin<double>());
+	std::copy(slice.Times, slice.Times + slice.Size, reinterpret_cast<long long *>(times.get_data()));
+	std::copy(slice.Values, slice.Values + slice.Size, reinterpret_cast<double *>(values.get_data()));
+	return make_tuple(times, values);
+}
+
+// Get the values of several fields aligned on a time grid from the dataset server as numpy arrays (the grid
+// times and a matrix with a column for each (topic, field) pair)
+tuple GetServedAlignedMatrix(alfa::DatasetClient &client, const std::string &sequence_name, list topic_names,
+	list field_labels, long long period, long long start_time, long long end_time)
+{
+	alfa::VecString topics, fields;
+	for (int i = 0; i < len(topic_names); ++i) topics.push_back(extract<std::string>(topic_names[i]));
+	for (int i = 0; i < len(field_labels); ++i) fields.push_back(extract<std::string>(field_labels[i]));
+
+	alfa::DatasetClient::AlignedMatrix matrix;
+	client.GetAlignedMatrix(sequence_name, topics, fields, period, matrix, start_time, end_time);
+	size_t n_values = matrix.NumberOfRows * matrix.NumberOfColumns;
+	np::ndarray times = np::empty(make_tuple(matrix.NumberOfRows), np::dtype::get_builtin<long long>());
+	np::ndarray values = np::empty(make_tuple(matrix.NumberOfRows, matrix.NumberOfColumns), np::dtype::get_builtin<double>());
+	std::copy(matrix.Times, matrix.Times + matrix.NumberOfRows, reinterpret_cast<long long *>(times.get_data()));
+	std::copy(matrix.Values, matrix.Values + n_values, reinterpret_cast<double *>(values.get_data()));
+	return make_tuple(times, values);
+}
 
 // Defines a python module which will be named "alfa-python"
 BOOST_PYTHON_MODULE(alfa_python)
 {
+	np::initialize();
+
+	enum_<alfa::Sequence::OrderingMode>("OrderingMode")
+		.value("FullMessage", alfa::Sequence::FullMessage)
+		.value("TimeOnly", alfa::Sequence::TimeOnly)
+		;
+
+	class_<alfa::LoadSpec>("LoadSpec")
+	  // Member Functions
+		.def("AddTopic", &alfa::LoadSpec::AddTopic)
+		.def("SetIncludeFaultTopics", &alfa::LoadSpec::SetIncludeFaultTopics)
+		.def("IsEmpty", &alfa::LoadSpec::IsEmpty)
+		.def("IsTopicSelected", &alfa::LoadSpec::IsTopicSelected)
+		.def("GetFieldPatterns", &alfa::LoadSpec::GetFieldPatterns)
+		.def("Clear", &alfa::LoadSpec::Clear)
+		;
 
 	class_<alfa::Sequence>("Sequence", init<std::string, std::string>())
 		// Class Data Members
@@ -45,9 +141,20 @@ BOOST_PYTHON_MODULE(alfa_python)
 		.def_readonly("MessageIndexList", &alfa::Sequence::MessageIndexList)
 	  // Member Functions
 		.def("LoadSequence", &alfa::Sequence::LoadSequence)
+		.def("FollowSequence", &alfa::Sequence::FollowSequence)
+		.def("Refresh", &alfa::Sequence::Refresh)
 	  .def("IsInitialized", &alfa::Sequence::IsInitialized)
 	  .def("Clear", &alfa::Sequence::Clear)
+	  .def("SetOrderingMode", &alfa::Sequence::SetOrderingMode)
+	  .def("GetOrderingMode", &alfa::Sequence::GetOrderingMode)
+	  .def("SetZoneMapBlockSize", &alfa::Sequence::SetZoneMapBlockSize)
+	  .def("SetLoadSpec", &alfa::Sequence::SetLoadSpec)
+	  .def("SetNumberOfThreads", &alfa::Sequence::SetNumberOfThreads)
+	  .def("SetBatchedReading", &alfa::Sequence::SetBatchedReading)
+	  .def("GetLoadSpec", &alfa::Sequence::GetLoadSpec, return_value_policy<copy_const_reference>())
 	  .def("GetMessage", &alfa::Sequence::GetMessage)
+	  .def("GetTopic", &alfa::Sequence::GetTopic, return_internal_reference<>())
+	  .def("GetMemoryFootprint", &alfa::Sequence::GetMemoryFootprint)
 	  .def("PrintBriefInfo", &alfa::Sequence::PrintBriefInfo)
 	  .def("GetFaultTopics", &alfa::Sequence::GetFaultTopics)
 	  .def("GetTotalDuration", &alfa::Sequence::GetTotalDuration)
@@ -56,22 +163,49 @@ BOOST_PYTHON_MODULE(alfa_python)
 	  .def("FindTopicIndex", &alfa::Sequence::FindTopicIndex)
 		;
 
+	enum_<alfa::Topic::FieldType>("FieldType")
+		.value("Bool", alfa::Topic::Bool)
+		.value("Int64", alfa::Topic::Int64)
+		.value("Float64", alfa::Topic::Float64)
+		.value("Category", alfa::Topic::Category)
+		.value("String", alfa::Topic::String)
+		;
+
 	class_<alfa::Topic>("Topic", init<std::string, std::string>())
 		// Class Data Members
 		.def_readwrite("Name", &alfa::Topic::Name)
 		.def_readwrite("FileName", &alfa::Topic::FileName)
 		.def_readwrite("Messages", &alfa::Topic::Messages)
 		.def_readonly("FieldLabels", &alfa::Topic::FieldLabels)
+		.def_readonly("FieldTypes", &alfa::Topic::FieldTypes)
 	  // Member Functions
 		.def("ReadFromFile", &alfa::Topic::ReadFromFile)
+		.def("ReadFromData", &alfa::Topic::ReadFromData)
+		.def("ReadAppendedData", &alfa::Topic::ReadAppendedData)
+		.def("SetFollowMode", &alfa::Topic::SetFollowMode)
+		.def("IsFollowMode", &alfa::Topic::IsFollowMode)
+		.def("SetNumberOfThreads", &alfa::Topic::SetNumberOfThreads)
+		.def("SetColumnSelection", &alfa::Topic::SetColumnSelection)
+		.def("GetColumnSelection", &alfa::Topic::GetColumnSelection, return_value_policy<copy_const_reference>())
 		.def("Print", &alfa::Topic::Print)
 		.def("PrintHeader", &alfa::Topic::PrintHeader)
 		.def("IsInitialized", &alfa::Topic::IsInitialized)
 		.def("IsFaultTopic", &alfa::Topic::IsFaultTopic)
 		.def("HasHeaderField", &alfa::Topic::HasHeaderField)
 		.def("FindLabelIndex", &alfa::Topic::FindLabelIndex)
+		.def("GetFieldType", &alfa::Topic::GetFieldType)
+		.def("FieldTypeToString", &alfa::Topic::FieldTypeToString).staticmethod("FieldTypeToString")
 		.def("Clear", &alfa::Topic::Clear)
+		.def("Unload", &alfa::Topic::Unload)
+		.def("Reload", &alfa::Topic::Reload)
+		.def("IsLoaded", &alfa::Topic::IsLoaded)
+		.def("GetMemoryFootprint", &alfa::Topic::GetMemoryFootprint)
+		.def("BuildZoneMaps", &alfa::Topic::BuildZoneMaps)
+		.def("HasZoneMaps", &alfa::Topic::HasZoneMaps)
+		.def("FindMessagesInTimeRange", &alfa::Topic::FindMessagesInTimeRange)
+		.def("FindMessagesInValueRange", &alfa::Topic::FindMessagesInValueRange)
 		.def("GetTimes", &alfa::Topic::GetTimes)
+		.def("GetTimesInNanoseconds", &alfa::Topic::GetTimesInNanoseconds)
 		.def("GetHeaders", &alfa::Topic::GetHeaders)
 		.def("GetFieldsAsStringByString", &alfa::Topic::GetFieldsAsStringByString)
 		.def("GetFieldsAsStringByIndex", &alfa::Topic::GetFieldsAsStringByIndex)
@@ -83,6 +217,216 @@ BOOST_PYTHON_MODULE(alfa_python)
 		.def("GetFieldsAsDoubleByIndex", &alfa::Topic::GetFieldsAsDoubleByIndex)
 		.def("GetFieldsAsLongDoubleByString", &alfa::Topic::GetFieldsAsLongDoubleByString)
 		.def("GetFieldsAsLongDoubleByIndex", &alfa::Topic::GetFieldsAsLongDoubleByIndex)
+		.def("GetFieldsAsFloatByString", &alfa::Topic::GetFieldsAsFloatByString)
+		.def("GetFieldsAsFloatByIndex", &alfa::Topic::GetFieldsAsFloatByIndex)
+		.def("GetFieldsAsFloatArray", &GetFieldsAsFloatArray)
+		;
+
+	class_<alfa::WindowSet>("WindowSet")
+		// Class Data Members
+		.def_readonly("NumWindows", &alfa::WindowSet::NumWindows)
+		.def_readonly("WindowLength", &alfa::WindowSet::WindowLength)
+		.def_readonly("NumFeatures", &alfa::WindowSet::NumFeatures)
+	  // Member Functions
+		.def("GetData", &GetWindowData)
+		.def("GetLabels", &GetWindowLabels)
+		.def("SaveAsNpy", &alfa::WindowSet::SaveAsNpy)
+		.def("Clear", &alfa::WindowSet::Clear)
+		;
+
+	enum_<alfa::WindowBuilder::LabelPolicy>("LabelPolicy")
+		.value("LastSample", alfa::WindowBuilder::LastSample)
+		.value("AnySample", alfa::WindowBuilder::AnySample)
+		.value("AllSamples", alfa::WindowBuilder::AllSamples)
+		;
+
+	class_<alfa::WindowBuilder>("WindowBuilder")
+	  // Member Functions
+		.def("AddField", &alfa::WindowBuilder::AddField)
+		.def("AddSequence", &alfa::WindowBuilder::AddSequence, with_custodian_and_ward<1, 2>())
+		.def("AddSequenceFile", &alfa::WindowBuilder::AddSequenceFile)
+		.def("SetWindow", &alfa::WindowBuilder::SetWindow)
+		.def("SetSamplePeriod", &alfa::WindowBuilder::SetSamplePeriod)
+		.def("SetLabelPolicy", &alfa::WindowBuilder::SetLabelPolicy)
+		.def("SetOnsetMargin", &alfa::WindowBuilder::SetOnsetMargin)
+		.def("SetNumberOfThreads", &alfa::WindowBuilder::SetNumberOfThreads)
+		.def("Build", &alfa::WindowBuilder::Build)
+		;
+
+	class_<alfa::Expression>("Expression", init<double>())
+	  // Member Functions
+		.def("Value", &alfa::Expression::Value).staticmethod("Value")
+		.def("Field", &alfa::Expression::Field).staticmethod("Field")
+		.def("Time", &alfa::Expression::Time).staticmethod("Time")
+		.def("Abs", &alfa::Expression::Abs).staticmethod("Abs")
+		.def("And", &alfa::Expression::And).staticmethod("And")
+		.def("Or", &alfa::Expression::Or).staticmethod("Or")
+		.def("Not", &alfa::Expression::Not).staticmethod("Not")
+		.def("ToString", &alfa::Expression::ToString)
+		.def("__str__", &alfa::Expression::ToString)
+		// Operators (& | ~ are used for the logical operators)
+		.def(self + self)
+		.def(self - self)
+		.def(self * self)
+		.def(self / self)
+		.def(-self)
+		.def(self < self)
+		.def(self <= self)
+		.def(self > self)
+		.def(self >= self)
+		.def(self == self)
+		.def(self != self)
+		.def(other<double>() + self)
+		.def(other<double>() - self)
+		.def(other<double>() * self)
+		.def(other<double>() / self)
+		.def("__and__", &alfa::Expression::And)
+		.def("__or__", &alfa::Expression::Or)
+		.def("__invert__", &alfa::Expression::Not)
+		;
+	implicitly_convertible<double, alfa::Expression>();
+
+	class_<alfa::Selection>("Selection")
+		// Class Data Members
+		.def_readonly("TopicIdx", &alfa::Selection::TopicIdx)
+		.def_readonly("Size", &alfa::Selection::Size)
+	  // Member Functions
+		.def("IsSelected", &alfa::Selection::IsSelected)
+		.def("Count", &alfa::Selection::Count)
+		.def("GetIndices", &alfa::Selection::GetIndices)
+		.def("Intersect", &alfa::Selection::Intersect)
+		.def("Unite", &alfa::Selection::Unite)
+		.def("Clear", &alfa::Selection::Clear)
+		;
+
+	class_<alfa::QueryEngine, boost::noncopyable>("QueryEngine", init<const alfa::Sequence&>()[with_custodian_and_ward<1, 2>()])
+	  // Member Functions
+		.def("Filter", &alfa::QueryEngine::Filter)
+		.def("Evaluate", &alfa::QueryEngine::Evaluate)
+		.def("Align", &alfa::QueryEngine::Align)
+		.def("ToMessageList", &alfa::QueryEngine::ToMessageList)
+		.def("GetNumberOfSkippedMessages", &alfa::QueryEngine::GetNumberOfSkippedMessages)
+		.def("ClearCache", &alfa::QueryEngine::ClearCache)
+		;
+
+	class_<alfa::SequenceProfile>("SequenceProfile")
+		// Class Data Members
+		.def_readonly("Name", &alfa::SequenceProfile::Name)
+		.def_readonly("NumMessages", &alfa::SequenceProfile::NumMessages)
+		.def_readonly("Duration", &alfa::SequenceProfile::Duration)
+	  // Member Functions
+		.def("ToJson", &alfa::SequenceProfile::ToJson)
+		.def("SaveJson", &alfa::SequenceProfile::SaveJson)
+		.def("Clear", &alfa::SequenceProfile::Clear)
+		;
+
+	class_<alfa::SequenceProfiler>("SequenceProfiler")
+	  // Member Functions
+		.def("SetGapThreshold", &alfa::SequenceProfiler::SetGapThreshold)
+		.def("SetNumberOfThreads", &alfa::SequenceProfiler::SetNumberOfThreads)
+		.def("Profile", &alfa::SequenceProfiler::Profile)
+		;
+
+	enum_<alfa::MemoryBudget::UnloadMode>("UnloadMode")
+		.value("ReloadFromFile", alfa::MemoryBudget::ReloadFromFile)
+		.value("KeepCompressed", alfa::MemoryBudget::KeepCompressed)
+		;
+
+	class_<alfa::MemoryBudget::Statistics>("MemoryStatistics")
+		// Class Data Members
+		.def_readonly("Hits", &alfa::MemoryBudget::Statistics::Hits)
+		.def_readonly("Misses", &alfa::MemoryBudget::Statistics::Misses)
+		.def_readonly("Evictions", &alfa::MemoryBudget::Statistics::Evictions)
+		.def_readonly("UsedBytes", &alfa::MemoryBudget::Statistics::UsedBytes)
+		.def_readonly("PeakBytes", &alfa::MemoryBudget::Statistics::PeakBytes)
+		.def_readonly("BudgetBytes", &alfa::MemoryBudget::Statistics::BudgetBytes)
+		;
+
+	class_<alfa::MemoryBudget, boost::noncopyable>("MemoryBudget", init<size_t, alfa::MemoryBudget::UnloadMode>())
+	  // Member Functions
+		.def("GetGlobal", &alfa::MemoryBudget::GetGlobal, return_value_policy<reference_existing_object>()).staticmethod("GetGlobal")
+		.def("SetBudget", &alfa::MemoryBudget::SetBudget)
+		.def("SetUnloadMode", &alfa::MemoryBudget::SetUnloadMode)
+		.def("AddSequence", &alfa::MemoryBudget::AddSequence)
+		.def("RemoveSequence", &alfa::MemoryBudget::RemoveSequence)
+		.def("GetUsedBytes", &alfa::MemoryBudget::GetUsedBytes)
+		.def("GetSequenceFootprint", &alfa::MemoryBudget::GetSequenceFootprint)
+		.def("GetStatistics", &alfa::MemoryBudget::GetStatistics)
+		.def("ResetStatistics", &alfa::MemoryBudget::ResetStatistics)
+		;
+
+	class_<alfa::SequencePrefetcher, boost::noncopyable>("SequencePrefetcher", init<int>())
+	  // Member Functions
+		.def("AddSequence", &alfa::SequencePrefetcher::AddSequence)
+		.def("AddSequenceFile", &alfa::SequencePrefetcher::AddSequenceFile)
+		.def("SetPrefetchDepth", &alfa::SequencePrefetcher::SetPrefetchDepth)
+		.def("SetNumberOfLoaders", &alfa::SequencePrefetcher::SetNumberOfLoaders)
+		.def("SetLoadSpec", &alfa::SequencePrefetcher::SetLoadSpec)
+		.def("Start", &alfa::SequencePrefetcher::Start)
+		.def("Next", &NextPrefetchedSequence, return_value_policy<manage_new_object>())
+		.def("Stop", &alfa::SequencePrefetcher::Stop)
+		.def("GetNumberOfSequences", &alfa::SequencePrefetcher::GetNumberOfSequences)
+		.def("GetLoadTime", &alfa::SequencePrefetcher::GetLoadTime)
+		.def("GetWaitTime", &alfa::SequencePrefetcher::GetWaitTime)
+		;
+
+	class_<alfa::SharedTopic>("SharedTopic")
+		// Class Data Members
+		.def_readonly("Name", &alfa::SharedTopic::Name)
+		.def_readonly("FileName", &alfa::SharedTopic::FileName)
+		.def_readonly("FieldLabels", &alfa::SharedTopic::FieldLabels)
+	  // Member Functions
+		.def("IsInitialized", &alfa::SharedTopic::IsInitialized)
+		.def("IsFaultTopic", &alfa::SharedTopic::IsFaultTopic)
+		.def("HasHeaderField", &alfa::SharedTopic::HasHeaderField)
+		.def("Size", &alfa::SharedTopic::Size)
+		.def("FindLabelIndex", &alfa::SharedTopic::FindLabelIndex)
+		.def("GetFieldType", &alfa::SharedTopic::GetFieldType)
+		.def("GetMessage", &alfa::SharedTopic::GetMessage)
+		.def("GetFieldText", &alfa::SharedTopic::GetFieldText)
+		.def("ToTopic", &alfa::SharedTopic::ToTopic)
+		.def("GetTimes", &alfa::SharedTopic::GetTimes)
+		.def("GetTimesInNanoseconds", &alfa::SharedTopic::GetTimesInNanoseconds)
+		.def("GetHeaders", &alfa::SharedTopic::GetHeaders)
+		.def("GetFieldsAsString", &alfa::SharedTopic::GetFieldsAsStringByString)
+		.def("GetFieldsAsString", &alfa::SharedTopic::GetFieldsAsStringByIndex)
+		.def("GetFieldsAsLongLong", &alfa::SharedTopic::GetFieldsAsLongLongByString)
+		.def("GetFieldsAsLongLong", &alfa::SharedTopic::GetFieldsAsLongLongByIndex)
+		.def("GetFieldsAsDouble", &alfa::SharedTopic::GetFieldsAsDoubleByString)
+		.def("GetFieldsAsDouble", &alfa::SharedTopic::GetFieldsAsDoubleByIndex)
+		;
+
+	class_<alfa::SharedSequence, boost::noncopyable>("SharedSequence")
+		// Class Data Members
+		.def_readonly("Name", &alfa::SharedSequence::Name)
+		.def_readonly("DirectoryPath", &alfa::SharedSequence::DirectoryPath)
+	  // Member Functions
+		.def("Publish", &alfa::SharedSequence::Publish)
+		.def("Attach", &alfa::SharedSequence::Attach)
+		.def("Detach", &alfa::SharedSequence::Detach)
+		.def("IsAttached", &alfa::SharedSequence::IsAttached)
+		.def("IsInitialized", &alfa::SharedSequence::IsInitialized)
+		.def("GetNumberOfMessages", &alfa::SharedSequence::GetNumberOfMessages)
+		.def("GetMessageIndex", &alfa::SharedSequence::GetMessageIndex)
+		.def("GetMessage", &alfa::SharedSequence::GetMessage)
+		.def("GetTopic", &alfa::SharedSequence::GetTopic, return_internal_reference<>())
+		.def("FindTopicIndex", &alfa::SharedSequence::FindTopicIndex)
+		.def("ToSequence", (alfa::Sequence (alfa::SharedSequence::*)() const)&alfa::SharedSequence::ToSequence)
+		.def("GetSegmentPath", &alfa::SharedSequence::GetSegmentPath, return_value_policy<copy_const_reference>())
+		.def("GetSegmentSize", &alfa::SharedSequence::GetSegmentSize)
+		.def("GetNumberOfAttachments", &alfa::SharedSequence::GetNumberOfAttachments)
+		.def("Remove", &alfa::SharedSequence::Remove).staticmethod("Remove")
+		.def("RemoveIfUnused", &alfa::SharedSequence::RemoveIfUnused).staticmethod("RemoveIfUnused")
+		;
+
+	class_<alfa::DatasetClient, boost::noncopyable>("DatasetClient")
+	  // Member Functions
+		.def("Connect", &alfa::DatasetClient::Connect)
+		.def("Disconnect", &alfa::DatasetClient::Disconnect)
+		.def("IsConnected", &alfa::DatasetClient::IsConnected)
+		.def("GetFieldSlice", &GetServedFieldSlice)
+		.def("GetAlignedMatrix", &GetServedAlignedMatrix)
+		.def("GetLastResponseSize", &alfa::DatasetClient::GetLastResponseSize)
 		;
 
 	// class_<alfa::Commons>("Commons")